@@ -0,0 +1,75 @@
+#!/usr/bin/env bash
+
+# Compares 2 JSON files written by the benchmark executables using option '--json'.
+# Exits with code 1 when a benchmark median regressed more than the threshold.
+
+# Bailout on first error.
+set -e
+
+function usage()
+{
+	echo "Usage: $(basename "${0}") [--threshold <percent>] <baseline.json> <current.json>
+
+Compares the median time per iteration of the benchmarks having the same name.
+Regressions beyond the threshold (default 10%) are flagged and make the exit code 1.
+"
+}
+
+threshold=10
+files=()
+while [[ $# -gt 0 ]]; do
+	case "${1}" in
+		-h | --help)
+			usage
+			exit 0
+			;;
+		-t | --threshold)
+			threshold="${2}"
+			shift 2
+			;;
+		*)
+			files+=("${1}")
+			shift
+			;;
+	esac
+done
+
+if [[ ${#files[@]} -ne 2 ]]; then
+	usage
+	exit 2
+fi
+
+if ! command -v jq >/dev/null; then
+	echo "Command 'jq' is required for this script."
+	exit 2
+fi
+
+# Produces tab separated lines: name, baseline median, current median, change in percent and a flag.
+# shellcheck disable=SC2016
+report="$(jq -r -n --argjson threshold "${threshold}" --slurpfile base "${files[0]}" --slurpfile curr "${files[1]}" '
+	($base[0].benchmarks | map({(.name): .median_ns}) | add // {}) as $b |
+	($curr[0].benchmarks | map({(.name): .median_ns}) | add // {}) as $c |
+	(($b | keys) + ($c | keys) | unique)[] as $name |
+	if ($b[$name] == null) then [$name, "-", ($c[$name] | tostring), "-", "new"]
+	elif ($c[$name] == null) then [$name, ($b[$name] | tostring), "-", "-", "missing"]
+	elif ($b[$name] == 0) then [$name, ($b[$name] | tostring), ($c[$name] | tostring), "n/a", "zero baseline"]
+	else
+		(($c[$name] - $b[$name]) * 100 / $b[$name]) as $pct |
+		[$name, ($b[$name] | tostring), ($c[$name] | tostring), ($pct * 10 | round / 10 | tostring),
+			(if $pct > $threshold then "REGRESSION" elif $pct < -$threshold then "improved" else "" end)]
+	end | @tsv
+')"
+
+printf "%-48s %16s %16s %10s  %s\n" "Benchmark" "Baseline(ns)" "Current(ns)" "Change(%)" ""
+regressions=0
+while IFS=$'\t' read -r name base curr pct flag; do
+	printf "%-48s %16s %16s %10s  %s\n" "${name}" "${base}" "${curr}" "${pct}" "${flag}"
+	if [[ "${flag}" == "REGRESSION" ]]; then
+		regressions=$((regressions + 1))
+	fi
+done <<<"${report}"
+
+if [[ ${regressions} -gt 0 ]]; then
+	echo "${regressions} benchmark(s) regressed more than ${threshold}%."
+	exit 1
+fi
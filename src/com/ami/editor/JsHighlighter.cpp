@@ -6,8 +6,6 @@ namespace sf
 JsHighlighter::JsHighlighter(QTextDocument* parent, bool dark_mode)
 	:QSyntaxHighlighter(parent)
 {
-	// The order of appending rules is important otherwise functions in commented lines are highlighted too.
-	HighlightingRule rule;
 	if (dark_mode)
 	{
 		keywordFormat.setForeground(QColor(QColorConstants::Blue).lighter());
@@ -17,7 +15,7 @@ JsHighlighter::JsHighlighter(QTextDocument* parent, bool dark_mode)
 		keywordFormat.setForeground(QColor(QColorConstants::DarkBlue));
 	}
 	keywordFormat.setFontWeight(QFont::Bold);
-	auto keywords = R"(
+	auto keyword_list = R"(
 let
 var
 new
@@ -48,79 +46,65 @@ void
 while
 with
 )";
-	for (const QString& keyword : QString(keywords).split('\n'))
+	for (const QString& keyword : QString(keyword_list).split('\n'))
 	{
 		if (keyword.length())
 		{
-			rule.pattern = QRegularExpression(QString("\\b%1\\b").arg(keyword));
-			rule.format = keywordFormat;
-			highlightingRules.append(rule);
+			keywords.insert(keyword);
 		}
 	}
 
 	quotationFormat.setForeground(Qt::darkGreen);
-	rule.pattern = QRegularExpression(QStringLiteral("\".*\""));
-	rule.format = quotationFormat;
-	highlightingRules.append(rule);
 
 	functionFormat.setFontItalic(true);
 	functionFormat.setForeground(Qt::magenta);
-	rule.pattern = QRegularExpression(QStringLiteral("\\b[A-Za-z0-9_]+(?=\\()"));
-	rule.format = functionFormat;
-	highlightingRules.append(rule);
 
 	singleLineCommentFormat.setForeground(Qt::gray);
-	rule.pattern = QRegularExpression(QStringLiteral("//[^\n]*"));
-	rule.format = singleLineCommentFormat;
-	highlightingRules.append(rule);
 
 	multiLineCommentFormat.setForeground(Qt::gray);
 
 	doubleQuotationFormat.setForeground(Qt::darkGreen);
-	rule.pattern = QRegularExpression(QStringLiteral("'.*'"));
-	rule.format = doubleQuotationFormat;
-	highlightingRules.append(rule);
-
-	commentStartExpression = QRegularExpression(QStringLiteral("/\\*"));
-	commentEndExpression = QRegularExpression(QStringLiteral("\\*/"));
 }
 
 void JsHighlighter::highlightBlock(const QString& text)
 {
-	for (const HighlightingRule& rule : std::as_const(highlightingRules))
-	{
-		QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
-		while (matchIterator.hasNext())
-		{
-			QRegularExpressionMatch match = matchIterator.next();
-			setFormat(match.capturedStart(), match.capturedLength(), rule.format);
-		}
-	}
-	setCurrentBlockState(0);
-
-	int startIndex = 0;
-	if (previousBlockState() != 1)
+	// Block state 1 means the block ends inside a multi line comment.
+	auto state = tokenizer.tokenize(text.utf16(), text.length(),
+		previousBlockState() == 1 ? ScriptTokenizer::tsComment : ScriptTokenizer::tsCode, tokens);
+	for (size_t i = 0; i < tokens.count(); i++)
 	{
-		startIndex = text.indexOf(commentStartExpression);
-	}
-
-	while (startIndex >= 0)
-	{
-		QRegularExpressionMatch match = commentEndExpression.match(text, startIndex);
-		int endIndex = match.capturedStart();
-		int commentLength = 0;
-		if (endIndex == -1)
-		{
-			setCurrentBlockState(1);
-			commentLength = text.length() - startIndex;
-		}
-		else
+		auto& token = tokens[i];
+		auto start = static_cast<int>(token.start);
+		auto length = static_cast<int>(token.length);
+		switch (token.type)
 		{
-			commentLength = endIndex - startIndex + match.capturedLength();
+			case ScriptTokenizer::tkName:
+			{
+				// Functions are names directly followed by a parenthesis.
+				if (i + 1 < tokens.count() && tokens[i + 1].start == token.end() && text[static_cast<int>(token.end())] == '(')
+				{
+					setFormat(start, length, functionFormat);
+				}
+				else if (keywords.contains(QStringView(text).mid(start, length).toString()))
+				{
+					setFormat(start, length, keywordFormat);
+				}
+				break;
+			}
+			case ScriptTokenizer::tkString:
+				setFormat(start, length, text[start] == '"' ? quotationFormat : doubleQuotationFormat);
+				break;
+			case ScriptTokenizer::tkComment:
+			{
+				auto multi = text.mid(start, 2) == QStringLiteral("/*") || (i == 0 && previousBlockState() == 1);
+				setFormat(start, length, multi ? multiLineCommentFormat : singleLineCommentFormat);
+				break;
+			}
+			default:
+				break;
 		}
-		setFormat(startIndex, commentLength, multiLineCommentFormat);
-		startIndex = text.indexOf(commentStartExpression, startIndex + commentLength);
 	}
+	setCurrentBlockState(state == ScriptTokenizer::tsComment ? 1 : 0);
 }
 
 }
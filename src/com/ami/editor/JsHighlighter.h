@@ -2,7 +2,8 @@
 
 #include <QSyntaxHighlighter>
 #include <QTextCharFormat>
-#include <QRegularExpression>
+#include <QSet>
+#include <misc/gen/ScriptTokenizer.h>
 
 class QTextDocument;
 
@@ -20,15 +21,10 @@ class JsHighlighter :public QSyntaxHighlighter
 		void highlightBlock(const QString& text) override;
 
 	private:
-		struct HighlightingRule
-		{
-			QRegularExpression pattern;
-			QTextCharFormat format;
-		};
-		QVector<HighlightingRule> highlightingRules;
-
-		QRegularExpression commentStartExpression;
-		QRegularExpression commentEndExpression;
+		// Single pass tokenizer knowing single, double and back quoted strings.
+		ScriptTokenizer tokenizer{"\"'`"};
+		ScriptTokenizer::Vector tokens;
+		QSet<QString> keywords;
 
 		QTextCharFormat keywordFormat;
 		QTextCharFormat singleLineCommentFormat;
@@ -6,8 +6,10 @@ namespace sf
 {
 
 // Declaration of the dynamic library information.
-SF_DL_INFORMATION("Text/Code Editors",
-	R"(Editors MDI for code and text using syntax highlighting.)"
+// Only loaded when a file of one of the handled types is opened.
+SF_DL_INFORMATION_EX("Text/Code Editors",
+	R"(Editors MDI for code and text using syntax highlighting.)",
+	"lazy;provides=*.txt,*.ini,*.js"
 )
 
 // Register this derived class.
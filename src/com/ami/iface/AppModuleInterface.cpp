@@ -210,21 +210,30 @@ AppModuleInterface* AppModuleInterface::findByFile(const QString& filename)
 {
 	QFileInfo fi(filename);
 	auto mime = QMimeDatabase().mimeTypeForFile(filename);
-	//
-	for (auto entry: getMap())
+	auto find = [&]() -> AppModuleInterface*
 	{
-		if (std::any_of(entry->_fileTypes.begin(), entry->_fileTypes.end(),
-			[mime](const AppModuleFileType& ft) -> bool {return ft.isMime(mime);}))
-		{
-			return entry;
-		}
-		if (std::any_of(entry->_fileTypes.begin(), entry->_fileTypes.end(),
-			[fi](const AppModuleFileType& ft) -> bool {return ft.isSuffix(fi.suffix());}))
+		for (auto entry: getMap())
 		{
-			return entry;
+			if (std::any_of(entry->_fileTypes.begin(), entry->_fileTypes.end(),
+				[mime](const AppModuleFileType& ft) -> bool {return ft.isMime(mime);}))
+			{
+				return entry;
+			}
+			if (std::any_of(entry->_fileTypes.begin(), entry->_fileTypes.end(),
+				[fi](const AppModuleFileType& ft) -> bool {return ft.isSuffix(fi.suffix());}))
+			{
+				return entry;
+			}
 		}
+		return nullptr;
+	};
+	auto rv = find();
+	// A pending library could handle the file which instantiates its module when loaded.
+	if (!rv && requireProvider(QString("*.%1").arg(fi.suffix()).toStdString()))
+	{
+		rv = find();
 	}
-	return nullptr;
+	return rv;
 }
 
 QAbstractItemModel* AppModuleInterface::getListModel(bool file_only, QObject* parent)
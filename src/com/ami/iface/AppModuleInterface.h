@@ -208,6 +208,8 @@ class _AMI_CLASS AppModuleInterface :public QObject
 		/**
 		 * @brief Find the instance handling the file using the file suffix.
 		 *
+		 * When none handles it the pending library providing "*.<suffix>" is loaded using #sf::requireProvider().
+		 *
 		 * @return nullptr when not found.
 		 */
 		static AppModuleInterface* findByFile(const QString& filename);
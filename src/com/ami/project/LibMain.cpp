@@ -5,8 +5,10 @@ namespace sf
 {
 
 // Declaration of the dynamic library information.
-SF_DL_INFORMATION("Project",
-	R"(Project application module where controllers and acquisition devices can be configured.)"
+// The configured acquisition implementations are created on initialization.
+SF_DL_INFORMATION_EX("Project",
+	R"(Project application module where controllers and acquisition devices can be configured.)",
+	"depends=RSA Emulator"
 )
 
 // Register this derived class.
@@ -5,8 +5,10 @@ namespace sf
 {
 
 // Declaration of the dynamic library information.
-SF_DL_INFORMATION("Scripting",
-	R"(Scripting in AMI applications for manipulating GII.)"
+// Scripts started at initialization manipulate the information of the project servers.
+SF_DL_INFORMATION_EX("Scripting",
+	R"(Scripting in AMI applications for manipulating GII.)",
+	"depends=Project"
 )
 
 // Register this derived class.
@@ -72,7 +72,7 @@ void VariableCollector::variableEventHandler(VariableTypes::EEvent event, const
 					_fifo.push(d);
 					d._type = Data::dtFlags;
 					d._value.set(v->getCurFlags());
-					_fifo.push(d);
+					_fifo.push(std::move(d));
 				}
 			}
 			break;
@@ -86,7 +86,7 @@ void VariableCollector::variableEventHandler(VariableTypes::EEvent event, const
 			d._id = caller.getId();
 			d._type = Data::dtValue;
 			d._value.set(caller.getCur(false));
-			_fifo.push(d);
+			_fifo.push(std::move(d));
 			break;
 		}
 
@@ -98,7 +98,7 @@ void VariableCollector::variableEventHandler(VariableTypes::EEvent event, const
 			d._id = caller.getId();
 			d._type = Data::dtFlags;
 			d._value.set(caller.getCurFlags());
-			_fifo.push(d);
+			_fifo.push(std::move(d));
 			break;
 		}
 	}
@@ -0,0 +1,64 @@
+#include <gii/gen/FileMappedStorage.h>
+#include <vector>
+#include <test/benchmark.h>
+
+namespace
+{
+
+// Session of 64 MiB in blocks of 4 KiB and segments of 1 MiB.
+constexpr sf::FileMappedStorage::size_type BlockSize = 4096;
+constexpr sf::FileMappedStorage::size_type SegmentBlocks = 256;
+constexpr sf::FileMappedStorage::size_type SessionBlocks = 16 * 1024;
+
+}// namespace
+
+SF_BENCHMARK("gii/FileMappedStorage/write-session")
+{
+	std::vector<uint8_t> buffer(BlockSize, 0x55);
+	state.setBytes(SessionBlocks * BlockSize);
+	state.run(1, [&]() {
+		sf::FileMappedStorage fms(SegmentBlocks, BlockSize);
+		fms.reserve(SessionBlocks);
+		for (sf::FileMappedStorage::size_type ofs = 0; ofs < SessionBlocks; ofs++)
+		{
+			fms.blockWrite(ofs, 1, buffer.data());
+		}
+	});
+}
+
+SF_BENCHMARK("gii/FileMappedStorage/read-sequential")
+{
+	std::vector<uint8_t> buffer(BlockSize * 16, 0x55);
+	sf::FileMappedStorage fms(SegmentBlocks, BlockSize);
+	fms.reserve(SessionBlocks);
+	for (sf::FileMappedStorage::size_type ofs = 0; ofs < SessionBlocks; ofs += 16)
+	{
+		fms.blockWrite(ofs, 16, buffer.data());
+	}
+	state.setBytes(SessionBlocks * BlockSize);
+	state.run(1, [&]() {
+		for (sf::FileMappedStorage::size_type ofs = 0; ofs < SessionBlocks; ofs += 16)
+		{
+			fms.blockRead(ofs, 16, buffer.data());
+		}
+		sf::bench::keep(buffer);
+	});
+}
+
+SF_BENCHMARK("gii/FileMappedStorage/read-random")
+{
+	std::vector<uint8_t> buffer(BlockSize, 0x55);
+	sf::FileMappedStorage fms(SegmentBlocks, BlockSize);
+	fms.reserve(SessionBlocks);
+	for (sf::FileMappedStorage::size_type ofs = 0; ofs < SessionBlocks; ofs++)
+	{
+		fms.blockWrite(ofs, 1, buffer.data());
+	}
+	sf::FileMappedStorage::size_type ofs = 0;
+	state.setBytes(BlockSize);
+	state.run(100000, [&]() {
+		ofs = (ofs * 1103515245 + 12345) % SessionBlocks;
+		fms.blockRead(ofs, 1, buffer.data());
+		sf::bench::keep(buffer);
+	});
+}
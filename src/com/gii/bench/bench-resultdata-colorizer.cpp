@@ -0,0 +1,54 @@
+#include <gii/gen/ResultDataColorizer.h>
+#include <vector>
+#include <test/benchmark.h>
+
+namespace
+{
+
+// Image of 1024 by 1024 values.
+constexpr size_t Width = 1024;
+constexpr size_t Rows = 1024;
+
+/**
+ * Colorizes an image of values of the passed type through a grayscale palette.
+ */
+void colorizeImage(sf::bench::State& state, sf::ResultData::EType type)
+{
+	using Colorizer = sf::ResultDataColorizer;
+	std::vector<uint64_t> src(Width * Rows);
+	for (size_t i = 0; i < src.size(); i++)
+	{
+		src[i] = i * 2654435761u;
+	}
+	std::vector<Colorizer::color_type> dest(Width * Rows);
+	Colorizer colorizer;
+	colorizer.setFormat(type, 0, 0);
+	colorizer.setPalette(Colorizer::grayscale());
+	state.setItems(Width * Rows);
+	state.run(10, [&]() {
+		colorizer.colorize(src.data(), Width, Rows, dest.data(), Width * sizeof(Colorizer::color_type));
+		sf::bench::keep(dest);
+	});
+}
+
+}// namespace
+
+SF_BENCHMARK("gii/ResultDataColorizer/int8")
+{
+	colorizeImage(state, sf::ResultData::rtInt8);
+}
+
+SF_BENCHMARK("gii/ResultDataColorizer/int16")
+{
+	colorizeImage(state, sf::ResultData::rtInt16);
+}
+
+SF_BENCHMARK("gii/ResultDataColorizer/int32")
+{
+	colorizeImage(state, sf::ResultData::rtInt32);
+}
+
+SF_BENCHMARK("gii/ResultDataColorizer/int64")
+{
+	colorizeImage(state, sf::ResultData::rtInt64);
+}
@@ -0,0 +1,70 @@
+#include <gii/gen/ResultDataExporter.h>
+#include <sstream>
+#include <test/benchmark.h>
+
+namespace
+{
+
+// Blocks of 64 32-bit values in segments of 4096 blocks.
+const std::string Definition("0x40,Benchmark,,Export benchmark.,INT32,64,32,4096,0");
+// Amount of blocks exported being 8 MiB of values.
+constexpr sf::ResultData::size_type ExportBlocks = 32 * 1024;
+
+/**
+ * Exports the filled result in the passed format to memory so only the export itself is measured.
+ * The throughput is reported on the values read from the result so formats compare.
+ */
+void exportResult(sf::bench::State& state, sf::ResultDataExporter::EFormat format, unsigned threads)
+{
+	sf::ResultData::initialize();
+	{
+		sf::ResultData rd(Definition);
+		const sf::Range range(0, ExportBlocks);
+		rd.setAccessRange(range, false);
+		sf::TVector<int32_t> buffer(64 * 4096);
+		for (auto ofs = range.getStart(); ofs < range.getStop(); ofs += 4096)
+		{
+			for (size_t i = 0; i < buffer.count(); i++)
+			{
+				buffer[i] = static_cast<int32_t>(ofs * 64 + i);
+			}
+			rd.blockWrite(ofs, 4096, buffer.data());
+		}
+		rd.commitValidations();
+		sf::ResultDataExporter exporter;
+		exporter.add(0x40);
+		sf::ResultDataExporter::Options options;
+		options.format = format;
+		options.threads = threads;
+		exporter.setOptions(options);
+		state.setBytes(rd.getBufferSize(ExportBlocks));
+		state.run(1, [&]() {
+			std::ostringstream os;
+			exporter.write(os, range);
+			sf::bench::keep(os);
+		});
+	}
+	sf::ResultData::uninitialize();
+}
+
+}// namespace
+
+SF_BENCHMARK("gii/ResultDataExporter/csv")
+{
+	exportResult(state, sf::ResultDataExporter::efCsv, 1);
+}
+
+SF_BENCHMARK("gii/ResultDataExporter/csv-threaded")
+{
+	exportResult(state, sf::ResultDataExporter::efCsv, 0);
+}
+
+SF_BENCHMARK("gii/ResultDataExporter/raw")
+{
+	exportResult(state, sf::ResultDataExporter::efRaw, 1);
+}
+
+SF_BENCHMARK("gii/ResultDataExporter/columnar")
+{
+	exportResult(state, sf::ResultDataExporter::efColumnar, 1);
+}
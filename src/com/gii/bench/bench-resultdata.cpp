@@ -0,0 +1,138 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <gii/gen/ResultData.h>
+#include <test/benchmark.h>
+
+namespace
+{
+
+// Blocks of 1024 32-bit samples in segments of 256 blocks like an A-scan result.
+const std::string Definition("0x10,Bench,,Benchmark result.,INT32,1024,256,32,0");
+// Amount of blocks for a session of 64 MiB.
+constexpr sf::ResultData::size_type SessionBlocks = 16 * 1024;
+
+/**
+ * Writes a session paced like an acquisition thread waiting for its data in between blocks.
+ * Next to the timing the spare segment misses, the worst write latency and a histogram of the write latencies
+ * in buckets of powers of 2 micro seconds are reported on the log stream.
+ */
+void writeLatency(sf::bench::State& state, sf::FileMappedStorage::size_type preallocate)
+{
+	// Histogram buckets with the last one holding the rest.
+	constexpr size_t Buckets = 16;
+	sf::ResultData::initialize();
+	{
+		sf::FileMappedStorage::Options options;
+		options.preallocate = preallocate;
+		options.watermark = preallocate / 2;
+		std::vector<uint8_t> buffer(sf::ResultData(Definition).getBufferSize(1), 0x55);
+		std::vector<size_t> histogram(Buckets, 0);
+		sf::FileMappedStorage::size_type misses = 0;
+		double maximum = 0;
+		state.setBytes(SessionBlocks * buffer.size());
+		state.run(1, [&]() {
+			auto default_options = sf::FileMappedStorage::getDefaultOptions();
+			sf::FileMappedStorage::setDefaultOptions(options);
+			sf::ResultData rd(Definition);
+			sf::FileMappedStorage::setDefaultOptions(default_options);
+			// Give the pre-allocator time for the initial spares.
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			auto next = std::chrono::steady_clock::now();
+			for (sf::ResultData::size_type ofs = 0; ofs < SessionBlocks; ofs++)
+			{
+				next += std::chrono::microseconds(20);
+				std::this_thread::sleep_until(next);
+				auto t0 = std::chrono::steady_clock::now();
+				rd.blockWrite(ofs, 1, buffer.data(), true);
+				auto us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+				maximum = std::max(maximum, us);
+				size_t bucket = 0;
+				while (bucket < Buckets - 1 && us >= double(1 << bucket))
+				{
+					bucket++;
+				}
+				histogram[bucket]++;
+			}
+			misses += rd.getDataStore().getSpareMisses();
+		});
+		std::clog << "Preallocate " << preallocate << ": misses " << misses << ", max " << std::fixed << std::setprecision(1)
+			<< maximum << "us, histogram(us) <1 <2 <4 ... >=" << (1 << (Buckets - 2)) << ":";
+		for (auto count: histogram)
+		{
+			std::clog << ' ' << count;
+		}
+		std::clog << std::endl;
+	}
+	sf::ResultData::uninitialize();
+}
+
+}// namespace
+
+SF_BENCHMARK("gii/ResultData/block-write-session")
+{
+	sf::ResultData::initialize();
+	{
+		std::vector<uint8_t> buffer(sf::ResultData(Definition).getBufferSize(1), 0x55);
+		state.setBytes(SessionBlocks * buffer.size());
+		state.run(1, [&]() {
+			sf::ResultData rd(Definition);
+			// Written a block at the time as an acquisition does.
+			for (sf::ResultData::size_type ofs = 0; ofs < SessionBlocks; ofs++)
+			{
+				rd.blockWrite(ofs, 1, buffer.data(), true);
+			}
+		});
+	}
+	sf::ResultData::uninitialize();
+}
+
+SF_BENCHMARK("gii/ResultData/block-write-batch")
+{
+	sf::ResultData::initialize();
+	{
+		std::vector<uint8_t> buffer(sf::ResultData(Definition).getBufferSize(64), 0x55);
+		state.setBytes(SessionBlocks * buffer.size() / 64);
+		state.run(1, [&]() {
+			sf::ResultData rd(Definition);
+			for (sf::ResultData::size_type ofs = 0; ofs < SessionBlocks; ofs += 64)
+			{
+				rd.blockWrite(ofs, 64, buffer.data(), true);
+			}
+		});
+	}
+	sf::ResultData::uninitialize();
+}
+
+SF_BENCHMARK("gii/ResultData/block-read-random")
+{
+	sf::ResultData::initialize();
+	{
+		sf::ResultData rd(Definition);
+		std::vector<uint8_t> buffer(rd.getBufferSize(16), 0x55);
+		for (sf::ResultData::size_type ofs = 0; ofs < SessionBlocks; ofs += 16)
+		{
+			rd.blockWrite(ofs, 16, buffer.data(), true);
+		}
+		sf::ResultData::size_type ofs = 0;
+		state.setBytes(buffer.size());
+		state.run(100000, [&]() {
+			ofs = (ofs * 1103515245 + 12345) % (SessionBlocks - 16);
+			rd.blockRead(ofs, 16, buffer.data(), true);
+			sf::bench::keep(buffer);
+		});
+	}
+	sf::ResultData::uninitialize();
+}
+
+SF_BENCHMARK("gii/ResultData/block-write-latency")
+{
+	writeLatency(state, 0);
+}
+
+SF_BENCHMARK("gii/ResultData/block-write-latency-preallocated")
+{
+	writeLatency(state, 8);
+}
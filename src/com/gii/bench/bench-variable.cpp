@@ -0,0 +1,108 @@
+#include <gii/gen/Variable.h>
+#include <sstream>
+#include <test/benchmark.h>
+
+namespace
+{
+
+// Amount of variables like in a large project.
+constexpr int SnapshotCount = 20000;
+
+/**
+ * Creates the parameters having a value and restores them from the stream written by the passed function.
+ */
+template<typename Write, typename Read>
+void restore(sf::bench::State& state, Write write, Read read)
+{
+	sf::Variable::initialize();
+	{
+		sf::Variable::PtrVector list;
+		for (int i = 0; i < SnapshotCount; i++)
+		{
+			std::ostringstream os;
+			os << "0x" << std::hex << (0x100000 + i) << std::dec << ",Group " << (i / 100) << "|Parameter " << i
+				<< ",m,AP,Benchmark parameter,FLOAT,,0.001,0,0,1000";
+			auto var = new sf::Variable(os.str());
+			var->setCur(sf::Value(sf::Value::flt_type(i & 0x3FF)));
+			list.add(var);
+		}
+		std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+		write(ss, list);
+		state.setItems(SnapshotCount);
+		state.run(1, [&]() {
+			ss.clear();
+			ss.seekg(0);
+			sf::bench::keep(read(ss));
+		});
+		for (auto var: list)
+		{
+			delete var;
+		}
+	}
+	sf::Variable::uninitialize();
+}
+
+}// namespace
+
+SF_BENCHMARK("gii/Variable/set-cur-float")
+{
+	sf::Variable::initialize();
+	{
+		sf::Variable owner("0x1000,Speed,m/s,A,Speed setting,FLOAT,,0.001,10,0,1000", 0x200000);
+		sf::Variable client;
+		client.setup(0x201000, true);
+		double value = 0;
+		state.run(100000, [&]() {
+			value = value < 999 ? value + 0.5 : 0;
+			client.setCur(sf::Value(value));
+		});
+	}
+	sf::Variable::uninitialize();
+}
+
+SF_BENCHMARK("gii/Variable/set-cur-string")
+{
+	sf::Variable::initialize();
+	{
+		// Short strings like state names and identifiers.
+		sf::Variable owner("0x1001,State,,A,State name,STRING,,32,Idle,,", 0x200000);
+		sf::Variable client;
+		client.setup(0x201001, true);
+		const char* states[] = {"Idle", "Running", "Paused", "Stopped"};
+		size_t n = 0;
+		state.run(100000, [&]() {
+			client.setCur(sf::Value(states[n++ % 4]));
+		});
+	}
+	sf::Variable::uninitialize();
+}
+
+SF_BENCHMARK("gii/Variable/restore-text")
+{
+	restore(state, [](std::ostream& os, const sf::Variable::PtrVector& list)
+	{
+		for (auto var: list)
+		{
+			var->writeUpdate(os);
+		}
+	}, [](std::istream& is)
+	{
+		int n = 0;
+		while (sf::Variable::readUpdate(is))
+		{
+			n++;
+		}
+		return n;
+	});
+}
+
+SF_BENCHMARK("gii/Variable/restore-binary")
+{
+	restore(state, [](std::ostream& os, const sf::Variable::PtrVector&)
+	{
+		sf::Variable::writeSnapshot(os);
+	}, [](std::istream& is)
+	{
+		return sf::Variable::readSnapshot(is);
+	});
+}
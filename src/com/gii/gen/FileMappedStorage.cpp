@@ -1,5 +1,11 @@
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
 
 #include <misc/gen/dbgutils.h>
 #include <misc/gen/gen_utils.h>
@@ -10,20 +16,202 @@ namespace sf
 
 Mutex FileMappedStorage::_staticSync; // NOLINT(cert-err58-cpp)
 
+FileMappedStorage::Options FileMappedStorage::_defaultOptions;
+
+namespace
+{
+
+/**
+ * @brief Bytes of all existing segments.
+ */
+std::atomic<FileMappedStorage::size_type> total_size{0};
+
+/**
+ * @brief Gets the arena for the passed options.
+ *
+ * Must be called with the static sync mutex locked.
+ */
+std::shared_ptr<IFileMapper::Arena> acquireArena(const FileMappedStorage::Options& options)
+{
+	if (options.backing == FileMappedStorage::bkTemporaryFiles)
+	{
+		return {};
+	}
+	auto memory = options.backing == FileMappedStorage::bkArenaMemory;
+	if (!options.shared)
+	{
+		return IFileMapper::createArena(memory, options.hugePages);
+	}
+	// Shared arenas per memory and huge page combination which are released when no storage uses them.
+	static std::weak_ptr<IFileMapper::Arena> arenas[2][2];
+	auto& weak = arenas[memory][options.hugePages];
+	auto rv = weak.lock();
+	if (!rv)
+	{
+		rv = IFileMapper::createArena(memory, options.hugePages);
+		weak = rv;
+	}
+	return rv;
+}
+
+}// namespace
+
+class FileMappedStorage::Preallocator
+{
+	public:
+		/**
+		 * @brief Gets the single instance.
+		 *
+		 * Intentionally never deleted so storages destructed during static destruction can still cancel.
+		 */
+		static Preallocator& instance()
+		{
+			static auto* rv = new Preallocator();
+			return *rv;
+		}
+
+		/**
+		 * @brief Queues the reference for filling up its spare segments.
+		 */
+		void request(Reference* ref)
+		{
+			std::lock_guard lock(_mutex);
+			if (std::find(_queue.begin(), _queue.end(), ref) == _queue.end())
+			{
+				_queue.push_back(ref);
+			}
+			// Start the thread on first use.
+			if (!_thread.joinable())
+			{
+				_thread = std::thread(&Preallocator::run, this);
+			}
+			_condition.notify_all();
+		}
+
+		/**
+		 * @brief Removes the reference from the queue and waits when it is being filled.
+		 */
+		void cancel(Reference* ref)
+		{
+			std::unique_lock lock(_mutex);
+			_queue.erase(std::remove(_queue.begin(), _queue.end(), ref), _queue.end());
+			_condition.wait(lock, [&] {return _current != ref;});
+		}
+
+	private:
+		/**
+		 * @brief Thread function.
+		 */
+		void run()
+		{
+			std::unique_lock lock(_mutex);
+			for (;;)
+			{
+				_condition.wait(lock, [&] {return !_queue.empty();});
+				_current = _queue.front();
+				_queue.pop_front();
+				lock.unlock();
+				fill(_current);
+				lock.lock();
+				_current = nullptr;
+				// Release a waiting cancel.
+				_condition.notify_all();
+			}
+		}
+
+		/**
+		 * @brief Creates segments outside the reference lock until the target amount is reached.
+		 */
+		static void fill(Reference* ref)
+		{
+			for (;;)
+			{
+				{
+					Reference::MtLock lock(ref->_mutex);
+					if (ref->_spareList.count() >= ref->_spareTarget)
+					{
+						break;
+					}
+				}
+				Segment* seg;
+				try
+				{
+					// Sizes and arena do not change after construction.
+					seg = new Segment(ref->_segmentSize * ref->_blockSize, ref->_arena);
+				}
+				catch (std::exception& ex)
+				{
+					SF_NORM_NOTIFY(DO_DEFAULT, "Pre-allocating segment failed: " << ex.what())
+					break;
+				}
+				seg->prefault();
+				Reference::MtLock lock(ref->_mutex);
+				ref->_spareList.add(seg);
+			}
+		}
+
+		/**
+		 * @brief Guards the queue and the current reference.
+		 */
+		std::mutex _mutex;
+		/**
+		 * @brief Wakes the thread on requests and cancel calls when a fill finished.
+		 */
+		std::condition_variable _condition;
+		/**
+		 * @brief References waiting for their spare segments to be filled.
+		 */
+		std::deque<Reference*> _queue;
+		/**
+		 * @brief Reference being filled.
+		 */
+		Reference* _current{nullptr};
+		/**
+		 * @brief Thread which is never joined.
+		 */
+		std::thread _thread;
+};
+
+void FileMappedStorage::setDefaultOptions(const FileMappedStorage::Options& options)
+{
+	Mutex::Lock static_lock(_staticSync);
+	_defaultOptions = options;
+}
+
+const FileMappedStorage::Options& FileMappedStorage::getDefaultOptions()
+{
+	return _defaultOptions;
+}
+
 FileMappedStorage::FileMappedStorage(FileMappedStorage::size_type seg_sz, FileMappedStorage::size_type blk_sz,
 	FileMappedStorage::size_type recycle)
-	:_segmentRecycleCount(recycle)
+	:FileMappedStorage(seg_sz, blk_sz, recycle, getDefaultOptions())
+{
+}
+
+FileMappedStorage::FileMappedStorage(FileMappedStorage::size_type seg_sz, FileMappedStorage::size_type blk_sz,
+	FileMappedStorage::size_type recycle, const FileMappedStorage::Options& options)
 {
 	_reference = new Reference();
 	_reference->_threadId = Thread::getCurrentId();
 	_reference->_referenceCount = 1;
 	_reference->_blockSize = blk_sz;
 	_reference->_segmentSize = seg_sz;
+	_reference->_segmentRecycleCount = recycle;
+	_reference->_preallocate = options.preallocate;
+	_reference->_watermark = options.watermark;
 	// Segment and block size are not allowed to be zero.
 	if (!_reference->_blockSize || !_reference->_segmentSize)
 	{
 		throw Exception("Segment and block size are not allowed to be zero!");
 	}
+	{
+		Mutex::Lock static_lock(_staticSync);
+		_reference->_arena = acquireArena(options);
+	}
+	// Have spare segments ready before the first reserve.
+	Reference::MtLock lock(_reference->_mutex);
+	requestSpares();
 }
 
 FileMappedStorage::FileMappedStorage(const FileMappedStorage& ds)
@@ -54,13 +242,17 @@ FileMappedStorage::~FileMappedStorage()
 			return;
 		}
 	}
-	// Delete all segments instances belonging to this instance.
-	unsigned count = _reference->_segmentList.count();
-	if (_segmentRecycleCount && _reference->_segmentList.count() >= _segmentRecycleCount)
+	// Make sure the pre-allocator is no longer using the reference.
+	if (_reference->_preallocate)
 	{
-		count = _segmentRecycleCount;
+		Preallocator::instance().cancel(_reference);
 	}
-	for (unsigned i = 0; i < count; i++)
+	for (auto seg: _reference->_spareList)
+	{
+		delete seg;
+	}
+	// Delete all segments instances belonging to this instance.
+	for (auto i = _reference->_ringStart; i < getRealStop(); i++)
 	{
 		delete_null(_reference->_segmentList[i]);
 	}
@@ -76,18 +268,13 @@ void FileMappedStorage::flush()
 	if (_reference->_threadId == Thread::getCurrentHandle())
 	{
 		// Delete all segments instances belonging to this instance.
-		unsigned count = _reference->_segmentList.count();
-		// When recycling the count is different.
-		if (_segmentRecycleCount && _reference->_segmentList.count() >= _segmentRecycleCount)
-		{
-			count = _segmentRecycleCount;
-		}
-		for (unsigned i = 0; i < count; i++)
+		for (auto i = _reference->_ringStart; i < getRealStop(); i++)
 		{
 			delete_null(_reference->_segmentList[i]);
 		}
 		// Remove all entries in the dynamic list.
 		_reference->_segmentList.flush();
+		_reference->_ringStart = 0;
 		// Set locked segment to none.
 		_cachedSegmentIndex = npos;
 	}
@@ -98,13 +285,72 @@ bool FileMappedStorage::setRecycleCount(FileMappedStorage::size_type count)
 	Reference::MtLock lock(_reference->_mutex);
 	if (_reference->_segmentList.count() == 0)
 	{
-		_segmentRecycleCount = count;
+		_reference->_segmentRecycleCount = count;
+		requestSpares();
 		return true;
 	}
 	SF_RTTI_NOTIFY(DO_DEFAULT, "Not allowed to set recycle count when data is already stored!")
 	return false;
 }
 
+bool FileMappedStorage::limitSegments(FileMappedStorage::size_type count)
+{
+	Reference::MtLock lock(_reference->_mutex);
+	if (!count || _reference->_segmentRecycleCount)
+	{
+		SF_RTTI_NOTIFY(DO_DEFAULT, "Not allowed to limit segments when recycling already or to zero!")
+		return false;
+	}
+	// Segments before the start are evicted.
+	auto stop = _reference->_segmentList.count();
+	size_type start = stop > count ? stop - count : 0;
+	// Release the segment cached by this instance.
+	if (_cachedSegmentIndex != npos && _cachedSegmentIndex < start)
+	{
+		_reference->_segmentList[_cachedSegmentIndex]->doUnlockMemory();
+		_cachedSegmentIndex = npos;
+	}
+	// Segments locked by others cannot be evicted.
+	for (size_type i = 0; i < start; i++)
+	{
+		_reference->_segmentList[i]->releasePrefault();
+		if (_reference->_segmentList[i]->isLocked())
+		{
+			return false;
+		}
+	}
+	for (size_type i = 0; i < start; i++)
+	{
+		delete_null(_reference->_segmentList[i]);
+	}
+	_reference->_ringStart = start;
+	_reference->_segmentRecycleCount = count;
+	requestSpares();
+	return true;
+}
+
+FileMappedStorage::size_type FileMappedStorage::getEvictedCount() const
+{
+	Reference::MtLock lock(_reference->_mutex);
+	return _reference->_ringStart;
+}
+
+FileMappedStorage::size_type FileMappedStorage::getTotalSize()
+{
+	return total_size;
+}
+
+FileMappedStorage::size_type FileMappedStorage::getRealStop() const
+{
+	auto stop = _reference->_segmentList.count();
+	// When recycling the amount of real segments is limited.
+	if (_reference->_segmentRecycleCount && stop - _reference->_ringStart > _reference->_segmentRecycleCount)
+	{
+		stop = _reference->_ringStart + _reference->_segmentRecycleCount;
+	}
+	return stop;
+}
+
 bool FileMappedStorage::reserve(FileMappedStorage::size_type block_count)
 {
 	Reference::MtLock lock(_reference->_mutex);
@@ -122,21 +368,58 @@ bool FileMappedStorage::reserve(FileMappedStorage::size_type block_count)
 	{
 		// When segments must be recycled and the current segment count is over
 		// recycle amount.
-		if (_segmentRecycleCount && _reference->_segmentList.count() >= _segmentRecycleCount)
+		if (_reference->_segmentRecycleCount && _reference->_segmentList.count() - _reference->_ringStart >= _reference->_segmentRecycleCount)
 		{
-			size_type seg = _reference->_segmentList.count() % _segmentRecycleCount;
-			//_RTTI_NOTIFY(DO_DEFAULT, "Reusing segment " << seg << " as " << Ref->SegList.Count())
+			// Reuse the segment a ring length back which is the oldest one.
+			size_type seg = _reference->_segmentList.count() - _reference->_segmentRecycleCount;
 			_reference->_segmentList.add(_reference->_segmentList[seg]);
 		}
 		else
 		{
-			_reference->_segmentList.add(new Segment(_reference->_segmentSize * _reference->_blockSize));
+			Segment* seg;
+			// Take a pre-allocated segment when one is ready.
+			if (_reference->_spareList.count())
+			{
+				seg = _reference->_spareList[0];
+				_reference->_spareList.detachAt(0);
+			}
+			else
+			{
+				if (_reference->_preallocate)
+				{
+					_reference->_spareMisses++;
+				}
+				seg = new Segment(_reference->_segmentSize * _reference->_blockSize, _reference->_arena);
+			}
+			_reference->_segmentList.add(seg);
 		}
 	}
+	requestSpares();
 	// Return true to indicate success.
 	return true;
 }
 
+void FileMappedStorage::requestSpares()
+{
+	if (!_reference->_preallocate)
+	{
+		return;
+	}
+	auto target = _reference->_preallocate;
+	// Spare segments become real ones so the total may not exceed the recycle count.
+	if (_reference->_segmentRecycleCount)
+	{
+		auto count = _reference->_segmentList.count() - _reference->_ringStart;
+		target = count >= _reference->_segmentRecycleCount ? 0 : std::min<size_type>(target, _reference->_segmentRecycleCount - count);
+	}
+	_reference->_spareTarget = target;
+	auto spares = _reference->_spareList.count();
+	if (spares < target && spares <= _reference->_watermark)
+	{
+		Preallocator::instance().request(_reference);
+	}
+}
+
 bool FileMappedStorage::cacheSegment(FileMappedStorage::size_type idx)
 {
 	// TODO: Could improve the cashed segment when recycling.
@@ -144,9 +427,11 @@ bool FileMappedStorage::cacheSegment(FileMappedStorage::size_type idx)
 	if (_cachedSegmentIndex != idx)
 	{
 		// Check if a previous locked segment must be unlocked.
-		if (_cachedSegmentIndex != std::numeric_limits<size_type>::max())
+		if (_cachedSegmentIndex != std::numeric_limits<size_type>::max() && _reference->_segmentList[_cachedSegmentIndex])
 		{ // Unlock the segment,
 			_reference->_segmentList[_cachedSegmentIndex]->doUnlockMemory();
+			// Drop the mapping kept from pre-faulting now that the segment has been used.
+			_reference->_segmentList[_cachedSegmentIndex]->releasePrefault();
 			// Set the cached segment index to none.
 			_cachedSegmentIndex = npos;
 		}
@@ -204,7 +489,13 @@ bool FileMappedStorage::blockReadWrite(bool rd, FileMappedStorage::size_type ofs
 	{
 		// Write as long as count is larger than zero.
 		do
-		{ // Lock the segment if it hasn't been locked yet.
+		{ // Evicted segments have no data.
+			if (seg_i < _reference->_ringStart)
+			{
+				SF_RTTI_NOTIFY(DO_DEFAULT, (rd ? "load(" : "read(") << ofs << ',' << sz << ") evicted segment!")
+				return false;
+			}
+			// Lock the segment if it hasn't been locked yet.
 			cacheSegment(seg_i);
 			// Calculate the amount of blocks to write for write in loop.
 			// Calculate the amount of blocks to write for first write in loop.
@@ -274,31 +565,62 @@ FileMappedStorage::size_type FileMappedStorage::getSegmentSize() const
 FileMappedStorage::size_type FileMappedStorage::getSize() const
 {
 	Reference::MtLock lock(_reference->_mutex);
-	auto seg_count = getSegmentCount();
 	// When recycling is enabled the maximum of real segments is limited.
-	if (_segmentRecycleCount && (size_type) seg_count > _segmentRecycleCount)
-	{
-		seg_count = _segmentRecycleCount;
-	}
-	return seg_count * _reference->_segmentSize * _reference->_blockSize;
+	return (getRealStop() - _reference->_ringStart) * _reference->_segmentSize * _reference->_blockSize;
 }
 
 FileMappedStorage::size_type FileMappedStorage::getSegmentLocks() const
 {
 	Reference::MtLock lock(_reference->_mutex);
 	size_type rv = 0;
-	size_type count = _reference->_segmentList.count();
-	if (_segmentRecycleCount && _reference->_segmentList.count() >= _segmentRecycleCount)
-	{
-		count = _segmentRecycleCount;
-	}
-	for (size_type i = 0; i < count; i++)
+	for (auto i = _reference->_ringStart; i < getRealStop(); i++)
 	{
 		rv += _reference->_segmentList[i]->_lockCount;
 	}
 	return rv;
 }
 
+std::shared_ptr<IFileMapper::Arena> FileMappedStorage::getArena() const
+{
+	Reference::MtLock lock(_reference->_mutex);
+	return _reference->_arena;
+}
+
+std::string FileMappedStorage::getSharedPath() const
+{
+	Reference::MtLock lock(_reference->_mutex);
+	return _reference->_arena ? _reference->_arena->getSharedPath() : std::string();
+}
+
+FileMappedStorage::size_type FileMappedStorage::getSegmentOffset(size_type seg_idx) const
+{
+	Reference::MtLock lock(_reference->_mutex);
+	auto count = _reference->_segmentList.count();
+	// Segments reused by newer ones when recycling hold the newer data.
+	auto first = _reference->_ringStart;
+	if (_reference->_segmentRecycleCount && count - first > _reference->_segmentRecycleCount)
+	{
+		first = count - _reference->_segmentRecycleCount;
+	}
+	if (!_reference->_arena || seg_idx < first || seg_idx >= count)
+	{
+		return npos;
+	}
+	return _reference->_segmentList[seg_idx]->getOffset();
+}
+
+FileMappedStorage::size_type FileMappedStorage::getSpareCount() const
+{
+	Reference::MtLock lock(_reference->_mutex);
+	return _reference->_spareList.count();
+}
+
+FileMappedStorage::size_type FileMappedStorage::getSpareMisses() const
+{
+	Reference::MtLock lock(_reference->_mutex);
+	return _reference->_spareMisses;
+}
+
 std::ostream& FileMappedStorage::writeStatus(std::ostream& os) const
 {
 	return os
@@ -309,8 +631,8 @@ std::ostream& FileMappedStorage::writeStatus(std::ostream& os) const
 		<< "Block Count: " << this->getBlockCount() << std::endl;
 }
 
-FileMappedStorage::Segment::Segment(FileMappedStorage::size_type sz)
-	:_fileMapper(*IFileMapper::instantiate(true))
+FileMappedStorage::Segment::Segment(FileMappedStorage::size_type sz, const std::shared_ptr<IFileMapper::Arena>& arena)
+	:_fileMapper(arena ? *IFileMapper::instantiate(arena) : *IFileMapper::instantiate(true))
 	 , _size(sz)
 {
 	// Use the system page file.
@@ -321,6 +643,8 @@ FileMappedStorage::Segment::Segment(FileMappedStorage::size_type sz)
 		// Added extra size (the largest integer) to file map to allow casting at the end of memory possible without getting an exception.
 		_fileMapper.createView(sz + sizeof(int64_t));
 	}
+	// Counted after creating the view which could throw.
+	total_size += _size;
 }
 
 FileMappedStorage::Segment::~Segment()
@@ -331,6 +655,7 @@ FileMappedStorage::Segment::~Segment()
 		doUnlockMemory();
 	}
 	delete &_fileMapper;
+	total_size -= _size;
 }
 
 bool FileMappedStorage::Segment::doLockMemory()
@@ -376,6 +701,29 @@ void FileMappedStorage::Segment::doUnlockMemory()
 	}
 }
 
+void FileMappedStorage::Segment::prefault()
+{
+	// The lock keeps the mapping and its populated pages until released by the first user moving on.
+	if (!_prefaulted && doLockMemory())
+	{
+		// Writing a zero to each page allocates it and populates the page table entry.
+		for (size_type ofs = 0; ofs < _size; ofs += 4096)
+		{
+			static_cast<volatile char*>(_dataPtr)[ofs] = 0;
+		}
+		_prefaulted = true;
+	}
+}
+
+void FileMappedStorage::Segment::releasePrefault()
+{
+	if (_prefaulted)
+	{
+		_prefaulted = false;
+		doUnlockMemory();
+	}
+}
+
 bool
 FileMappedStorage::Segment::write(FileMappedStorage::size_type ofs, FileMappedStorage::size_type sz, const void* src)
 {
@@ -454,7 +802,7 @@ bool FileMappedStorage::Lock::acquire(FileMappedStorage::size_type seg_idx)
 	// Lock the reference so we can do work safely.
 	FileMappedStorage::Reference::MtLock(_store._reference->_mutex);
 	// Check if the segment can be locked.
-	if (seg_idx >= 0 && seg_idx < (size_type) _store._reference->_segmentList.count())
+	if (seg_idx < (size_type) _store._reference->_segmentList.count() && _store._reference->_segmentList[seg_idx])
 	{ // Get the segment pointer.
 		_segment = _store._reference->_segmentList[seg_idx];
 		// Lock the segment memory.
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 #include <misc/gen/TVector.h>
 #include <misc/gen/Thread.h>
 #include <misc/gen/IFileMapper.h>
@@ -65,6 +66,58 @@ class _GII_CLASS FileMappedStorage
 		 */
 		static constexpr size_t npos = std::numeric_limits<size_type>::max();
 
+		/**
+		 * @brief What the segments are backed by.
+		 */
+		enum EBacking : int
+		{
+			/** Each segment has its own temporary file. */
+			bkTemporaryFiles = 0,
+			/** Segments are ranges in a single sparse temporary file. */
+			bkArenaFile,
+			/** Segments are ranges in a single anonymous memory file. */
+			bkArenaMemory
+		};
+
+		/**
+		 * @brief Options on how segments are stored.
+		 */
+		struct Options
+		{
+			/**
+			 * @brief Backing of the segments.
+			 */
+			EBacking backing{bkTemporaryFiles};
+			/**
+			 * @brief When true all storages with the same options share the same arena.
+			 */
+			bool shared{false};
+			/**
+			 * @brief Advises transparent huge pages for arena backed segments.
+			 */
+			bool hugePages{false};
+			/**
+			 * @brief Amount of segments a background thread keeps allocated and pre-faulted ahead of the reserved ones.
+			 *
+			 * Zero disables pre-allocation and segments are created by #reserve() itself.
+			 */
+			size_type preallocate{0};
+			/**
+			 * @brief The background thread refills the pre-allocated segments when their amount drops to this value.
+			 */
+			size_type watermark{0};
+		};
+
+		/**
+		 * @brief Sets the options used by the constructor when none are passed.
+		 */
+		static void setDefaultOptions(const Options& options);
+
+		/**
+		 * @brief Gets the options used by the constructor when none are passed.
+		 */
+		static const Options& getDefaultOptions();
+
 		/**
 		 * Initializing constructor.
 		 * @param seg_sz Sets the segment size of storage in blocks.
@@ -73,6 +126,16 @@ class _GII_CLASS FileMappedStorage
 		 */
 		FileMappedStorage(size_type seg_sz, size_type blk_sz, size_type recycle = 0);
 
+		/**
+		 * Initializing constructor.
+		 * @param seg_sz Sets the segment size of storage in blocks.
+		 * @param blk_sz Is in bytes.
+		 * @param recycle Is the maximum amount of segments allowed to be used for storing.
+		 * @param options Options for storing the segments.
+		 * When an arena is not available on the platform the segments fall back to temporary files.
+		 */
+		FileMappedStorage(size_type seg_sz, size_type blk_sz, size_type recycle, const Options& options);
+
 		/**
 		 * @brief Copy constructor.
 		 */
@@ -165,6 +228,60 @@ class _GII_CLASS FileMappedStorage
 		 */
 		bool setRecycleCount(size_type count);
 
+		/**
+		 * @brief Converts the storage into a ring of the passed amount of segments while data is stored.
+		 *
+		 * The newest segments are kept and older ones are evicted so reading blocks of them fails.
+		 * New blocks beyond the ring reuse the oldest kept segment like when recycling from the start.
+		 * @param count Amount of segments to keep which must be non-zero.
+		 * @return False when already recycling or a segment to evict is locked.
+		 */
+		bool limitSegments(size_type count);
+
+		/**
+		 * @brief Gets the amount of segments evicted by #limitSegments().
+		 */
+		[[nodiscard]] size_type getEvictedCount() const;
+
+		/**
+		 * @brief Gets the amount of bytes of all segments of all instances including pre-allocated ones.
+		 */
+		static size_type getTotalSize();
+
+		/**
+		 * @brief Gets the arena the segments are allocated from.
+		 *
+		 * @return Null when segments use temporary files.
+		 */
+		[[nodiscard]] std::shared_ptr<IFileMapper::Arena> getArena() const;
+
+		/**
+		 * @brief Gets the path through which another process is able to open the file holding the segments.
+		 *
+		 * @return Empty when segments use temporary files.
+		 */
+		[[nodiscard]] std::string getSharedPath() const;
+
+		/**
+		 * @brief Gets the offset of a segment in the file of #getSharedPath().
+		 *
+		 * @param seg_idx Index of the segment.
+		 * @return #npos when out of range, evicted, reused by a newer segment or when segments use temporary files.
+		 */
+		[[nodiscard]] size_type getSegmentOffset(size_type seg_idx) const;
+
+		/**
+		 * @brief Gets the amount of pre-allocated segments ready to be taken by #reserve().
+		 */
+		[[nodiscard]] size_type getSpareCount() const;
+
+		/**
+		 * @brief Gets the amount of segments #reserve() had to create itself since no pre-allocated one was ready.
+		 *
+		 * Always zero when pre-allocation is disabled.
+		 */
+		[[nodiscard]] size_type getSpareMisses() const;
+
 		/**
 		 * @brief Writes the status to the output stream.
 		 */
@@ -181,6 +298,26 @@ class _GII_CLASS FileMappedStorage
 		 */
 		bool blockReadWrite(bool rd, size_type ofs, size_type sz, void* src);
 
+		/**
+		 * @brief Gets the index after the last segment which is not a reused one when recycling.
+		 *
+		 * Segments before Reference::_ringStart were evicted and are null.
+		 * Must be called with the reference mutex locked.
+		 */
+		[[nodiscard]] size_type getRealStop() const;
+
+		/**
+		 * @brief Updates the amount of spare segments wanted and requests a refill when at or below the watermark.
+		 *
+		 * Must be called with the reference mutex locked.
+		 */
+		void requestSpares();
+
+		/**
+		 * @brief Background thread shared by all instances creating the spare segments.
+		 */
+		class Preallocator;
+
 		/**
 		 * This class is used to hook data
 		 */
@@ -190,8 +327,9 @@ class _GII_CLASS FileMappedStorage
 				/**
 				 * @brief Constructor passing the size.
 				 * @param sz Size in bytes.
+				 * @param arena Optional arena to allocate the segment from.
 				 */
-				explicit Segment(size_type sz);
+				Segment(size_type sz, const std::shared_ptr<IFileMapper::Arena>& arena);
 
 				/**
 				 * @brief Destructor.
@@ -212,6 +350,13 @@ class _GII_CLASS FileMappedStorage
 				 */
 				[[nodiscard]] inline size_type getSize() const;
 
+				/**
+				 * @brief Gets the offset of the segment in the file of the arena.
+				 *
+				 * @return #npos when not allocated from an arena.
+				 */
+				[[nodiscard]] inline size_type getOffset() const;
+
 				/**
 				 * @brief Locks the global handle and returns the pointer to it.
 				 *
@@ -249,6 +394,18 @@ class _GII_CLASS FileMappedStorage
 				 */
 				bool read(size_type ofs, size_type sz, void* dst) const;
 
+				/**
+				 * @brief Maps the segment and writes each page so the backing is allocated before it is used.
+				 *
+				 * The mapping is kept until #releasePrefault() is called.
+				 */
+				void prefault();
+
+				/**
+				 * @brief Releases the mapping kept by #prefault().
+				 */
+				void releasePrefault();
+
 				/**
 				 * @brief Prevents copying of this class.
 				 */
@@ -285,6 +442,10 @@ class _GII_CLASS FileMappedStorage
 				 * Pointer to the data when it is locked.
 				 */
 				char* _dataPtr{nullptr};
+				/**
+				 * True when a lock is held from pre-faulting.
+				 */
+				bool _prefaulted{false};
 				/**
 				 * Underlying class for storing data on the page/swap file to be accessed by other processes too.
 				 */
@@ -328,6 +489,40 @@ class _GII_CLASS FileMappedStorage
 			 * @brief Contains a vector of pointers to all segments of this instance.
 			 */
 			TVector<Segment*> _segmentList;
+			/**
+			 * @brief Arena the segments are allocated from when not null.
+			 */
+			std::shared_ptr<IFileMapper::Arena> _arena;
+			/**
+			 * @brief Segments created ahead by the pre-allocator and taken by #reserve().
+			 */
+			TVector<Segment*> _spareList;
+			/**
+			 * @brief Amount of spare segments to keep when pre-allocating.
+			 */
+			size_type _preallocate{0};
+			/**
+			 * @brief Amount of spare segments at which a refill is requested.
+			 */
+			size_type _watermark{0};
+			/**
+			 * @brief Amount of spare segments the pre-allocator fills up to taking recycling into account.
+			 */
+			size_type _spareTarget{0};
+			/**
+			 * @brief Amount of segments created by #reserve() because no spare was ready.
+			 */
+			size_type _spareMisses{0};
+			/**
+			 * @brief Maximum amount of segments to be used when storage is recycled.
+			 */
+			size_type _segmentRecycleCount{0};
+			/**
+			 * @brief Index of the first segment not evicted by #limitSegments().
+			 *
+			 * Part of the reference since the evicted segments are shared by all instances.
+			 */
+			size_type _ringStart{0};
 			/**
 			 * @brief Mutex for MT safety.
 			 */
@@ -456,14 +651,14 @@ class _GII_CLASS FileMappedStorage
 		 * Where max() means no segment is locked.
 		 */
 		size_type _cachedSegmentIndex{npos};
-		/**
-		 * Maximum amount of segments to be used when storage is recycled.
-		 */
-		size_type _segmentRecycleCount{0};
 		/**
 		 * Should prevent changing a refs reference counter.
 		 */
 		static Mutex _staticSync;
+		/**
+		 * Holds the default options.
+		 */
+		static Options _defaultOptions;
 };
 
 inline
@@ -472,6 +667,12 @@ FileMappedStorage::size_type FileMappedStorage::Segment::getSize() const
 	return _size;
 }
 
+FileMappedStorage::size_type FileMappedStorage::Segment::getOffset() const
+{
+	auto ofs = _fileMapper.getOffset();
+	return ofs == std::numeric_limits<size_t>::max() ? npos : ofs;
+}
+
 inline
 bool FileMappedStorage::Segment::isLocked() const
 {
@@ -513,7 +714,7 @@ bool FileMappedStorage::blockRead(FileMappedStorage::size_type ofs, FileMappedSt
 inline
 FileMappedStorage::size_type FileMappedStorage::getRecycleCount() const
 {
-	return _segmentRecycleCount;
+	return _reference->_segmentRecycleCount;
 }
 
 inline
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <misc/gen/TVector.h>
 #include <misc/gen/TVector.h>
 #include <misc/gen/dbgutils.h>
@@ -75,6 +78,8 @@ ResultData::~ResultData()
 		clearRequests();
 	}
 */
+	// Remove queued events referring to this instance.
+	ResultDataHandler::purgeAll(this);
 	// If a handler exist notify removal of this instance.
 	emitEvent(reRemove, *this, Range());
 	// Remove the link if there was one and doing so generating an event.
@@ -98,6 +103,10 @@ bool ResultData::recycleEnable(bool recycle)
 		{
 			if (_reference->_data->setRecycleCount(ResultDataStatic::_recycleSize))
 			{
+				if (_reference->_times)
+				{
+					_reference->_times->setRecycleCount(ResultDataStatic::_recycleSize);
+				}
 				// Make the function return success.
 				return true;
 			}
@@ -110,6 +119,10 @@ bool ResultData::recycleEnable(bool recycle)
 				// Disable by setting zero.
 				if (_reference->_data->setRecycleCount(0))
 				{
+					if (_reference->_times)
+					{
+						_reference->_times->setRecycleCount(0);
+					}
 					// Make the function return success.
 					return true;
 				}
@@ -128,6 +141,147 @@ ResultData::size_type ResultData::getCount()
 	return ResultDataStatic::_references->count() - 1;
 }
 
+void ResultData::setSegmentSizeLimit(ResultData::size_type bytes)
+{
+	ResultDataStatic::_segmentSizeLimit = bytes;
+}
+
+ResultData::size_type ResultData::getSegmentSizeLimit()
+{
+	return ResultDataStatic::_segmentSizeLimit;
+}
+
+void ResultData::setStorageBudget(ResultData::size_type bytes)
+{
+	ResultDataStatic::_storageBudget = bytes;
+	// Apply a lowered budget immediately.
+	governStorage();
+}
+
+ResultData::size_type ResultData::getStorageBudget()
+{
+	return ResultDataStatic::_storageBudget;
+}
+
+ResultData::StorageUsage ResultData::getStorageUsage()
+{
+	StorageUsage rv;
+	rv.budget = ResultDataStatic::_storageBudget;
+	rv.used = FileMappedStorage::getTotalSize();
+	ResultDataStatic::_storagePeak = std::max(ResultDataStatic::_storagePeak, rv.used);
+	rv.peak = ResultDataStatic::_storagePeak;
+	rv.limited = ResultDataStatic::_storageLimited;
+	rv.evicted = ResultDataStatic::_storageEvicted;
+	return rv;
+}
+
+bool ResultData::setPriority(int priority)
+{
+	// Only the owner is allowed to set the priority.
+	if (!isOwner() || priority < 0)
+	{
+		return false;
+	}
+	_reference->_priority = priority;
+	return true;
+}
+
+int ResultData::getPriority() const
+{
+	return _reference->_priority;
+}
+
+ResultData::size_type ResultData::getStorageQuota() const
+{
+	return getStorageQuota(_reference, getStorageWeight());
+}
+
+ResultData::size_type ResultData::getStorageWeight()
+{
+	// Each result weighs its priority plus one.
+	size_type rv = 0;
+	for (auto i: *ResultDataStatic::_references)
+	{
+		if (i->_id && i->_data)
+		{
+			rv += i->_priority + 1;
+		}
+	}
+	return rv;
+}
+
+ResultData::size_type ResultData::getStorageQuota(const ResultDataReference* ref, size_type weight)
+{
+	return weight ? ResultDataStatic::_storageBudget / weight * (ref->_priority + 1) : 0;
+}
+
+void ResultData::governStorage()
+{
+	auto used = FileMappedStorage::getTotalSize();
+	ResultDataStatic::_storagePeak = std::max(ResultDataStatic::_storagePeak, used);
+	if (!ResultDataStatic::_storageBudget || used <= ResultDataStatic::_storageBudget)
+	{
+		return;
+	}
+	// Results not recycling yet and exceeding their quota are candidates.
+	TVector<std::pair<ResultDataReference*, size_type>> candidates;
+	auto weight = getStorageWeight();
+	for (auto ref: *ResultDataStatic::_references)
+	{
+		if (ref->_id && ref->_data && !ref->_data->getRecycleCount())
+		{
+			auto quota = getStorageQuota(ref, weight);
+			if (ref->_data->getSize() > quota)
+			{
+				candidates.add({ref, quota});
+			}
+		}
+	}
+	// Lowest priority first and then the largest.
+	std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b)
+	{
+		if (a.first->_priority != b.first->_priority)
+		{
+			return a.first->_priority < b.first->_priority;
+		}
+		return a.first->_data->getSize() > b.first->_data->getSize();
+	});
+	for (auto& candidate: candidates)
+	{
+		auto ref = candidate.first;
+		auto segment_bytes = ref->_data->getSegmentSize() * ref->_data->getBlockSize();
+		// Keep at least the amount of segments used for recycling.
+		auto keep = std::max<size_type>(ResultDataStatic::_recycleSize, candidate.second / segment_bytes);
+		auto size = ref->_data->getSize();
+		if (ref->_data->limitSegments(keep))
+		{
+			// Timestamps follow the ring of the data.
+			if (ref->_times)
+			{
+				ref->_times->limitSegments(keep);
+			}
+			ResultDataStatic::_storageLimited++;
+			ResultDataStatic::_storageEvicted += size - ref->_data->getSize();
+			SF_NORM_NOTIFY(DO_DEFAULT, "Storage budget exceeded, result '" << ref->_name << "' limited to " << keep << " segments.")
+			// The users of the result are signaled of the ring mode by the owner.
+			ref->_curFlags |= flgRecycle;
+			ref->_storageLimited = true;
+			if (FileMappedStorage::getTotalSize() <= ResultDataStatic::_storageBudget)
+			{
+				break;
+			}
+		}
+	}
+}
+
+void ResultData::signalStorageLimit()
+{
+	if (_reference->_storageLimited.exchange(false))
+	{
+		emitLocalEvent(reFlagsChange, _reference->_rangeManager->getManaged(), false);
+	}
+}
+
 ResultData::size_type ResultData::getTotalReservedSize()
 {
 	size_type rv = 0;
@@ -282,9 +436,9 @@ bool ResultData::attachRef(ResultDataReference* ref)
 bool ResultData::createDataStore(ResultDataReference* ref, ResultData::size_type segment_size, ResultData::size_type block_size)
 {
 	// Limit the size of the segment.
-	if (segment_size > (10L * 1024L * 1024L) / block_size)
+	if (segment_size > ResultDataStatic::_segmentSizeLimit / block_size)
 	{
-		segment_size = (10L * 1024L * 1024L) / block_size;
+		segment_size = std::max<size_type>(ResultDataStatic::_segmentSizeLimit / block_size, 1);
 	}
 	// Change the segment size for debugging purposes.
 	if (ResultDataStatic::_debugSegmentSize)
@@ -298,6 +452,11 @@ bool ResultData::createDataStore(ResultDataReference* ref, ResultData::size_type
 	// The block size is the size of the type times the given type instances per block.
 	ref->_data = new FileMappedStorage(segment_size,
 		block_size * ResultDataStatic::_typeInfoArray[ref->_type].Size, recycle);
+	// Timestamp deltas are stored using the same segmentation so a block index maps the same in both.
+	if (ref->_flags & flgTimestamp)
+	{
+		ref->_times = new FileMappedStorage(ref->_data->getSegmentSize(), sizeof(uint32_t), recycle);
+	}
 	// Attach ref to this result instance.
 	if (attachRef(ref))
 	{
@@ -399,7 +558,11 @@ bool ResultData::emitEvent(EEvent event, const ResultData& caller, const Range&
 	// Check if a handler was linked and if so call it.
 	if (_handler)
 	{
-		_handler->resultDataEventHandler(event, caller, *this, rng, &caller == this);
+		// Call it directly when not queued for delivery on another thread.
+		if (!_handler->queueEvent(event, caller, *this, rng))
+		{
+			_handler->resultDataEventHandler(event, caller, *this, rng, &caller == this);
+		}
 		return true;
 	}
 	return false;
@@ -528,6 +691,11 @@ void ResultData::setHandler(ResultDataHandler* handler)
 	// Only generate events if there is a change of handler.
 	if (_handler != handler)
 	{
+		// Queued events of the previous handler are meant for that one only.
+		if (_handler)
+		{
+			_handler->purge(this);
+		}
 		if (handler)
 		{
 			// Notify instance getting event link
@@ -633,6 +801,9 @@ bool ResultData::setAccessRange(const Range& rng, bool skip_self)
 				// The new value is passed in the 'Stop' Value of the passed 'Range' argument.
 				emitLocalEvent(reReserve, Range(0, _reference->_data->getBlockCount(),
 					(Range::id_type) _reference->_id), skip_self);
+				// Keep the storage of all results within the budget.
+				governStorage();
+				signalStorageLimit();
 			}
 			// Set the new managed range.
 			_reference->_rangeManager->setManaged(nr);
@@ -776,7 +947,7 @@ bool ResultData::setFlag(int flag, bool skip_self)
 			}
 		}
 		// Save the current flags for comparison.
-		auto flags = _reference->_curFlags;
+		flags_type flags = _reference->_curFlags;
 		// Set the flag bit.
 		_reference->_curFlags |= flag;
 		// Check for a change in flags.
@@ -807,7 +978,7 @@ bool ResultData::unsetFlag(int flag, bool skip_self)
 			}
 		}
 		// Save the current flags for comparison.
-		auto flags = _reference->_curFlags;
+		flags_type flags = _reference->_curFlags;
 		// Unset the flag bit.
 		_reference->_curFlags &= ~flag;
 		// Check for a change in flags.
@@ -896,11 +1067,117 @@ bool ResultData::setReservedBlockCount(Range::size_type sz, bool skip_self)
 		// Generate an event to notify users of the change in reserved blocks.
 		// The new value is put in the Stop Value of the passed Range value.
 		emitLocalEvent(reReserve, {0, (Range::size_type) _reference->_data->getBlockCount()}, skip_self);
+		// Keep the storage of all results within the budget.
+		governStorage();
+		signalStorageLimit();
 	}
 	return true;
 }
 
-bool ResultData::blockWrite(Range::size_type ofs, Range::size_type sz, const void* src, bool auto_reserve)
+namespace
+{
+
+/**
+ * @brief Gets the position in the sorted bases of the first base beyond the passed block index.
+ */
+size_t upperBase(const ResultDataReference& ref, ResultData::size_type index)
+{
+	return std::upper_bound(ref._timeBases.begin(), ref._timeBases.end(), index, [](ResultData::size_type idx, const auto& base)
+	{
+		return idx < base.first;
+	}) - ref._timeBases.begin();
+}
+
+/**
+ * @brief Stores the timestamp deltas of written blocks while the time mutex is locked.
+ */
+bool writeTimes(ResultDataReference& ref, ResultData::size_type ofs, ResultData::size_type sz, ResultData::timestamp_type ts)
+{
+	auto& times(*ref._times);
+	if (times.getBlockCount() < ofs + sz && !times.reserve(ofs + sz))
+	{
+		return false;
+	}
+	auto& bases(ref._timeBases);
+	auto seg_sz = times.getSegmentSize();
+	std::vector<uint32_t> deltas;
+	while (sz)
+	{
+		// A base never applies beyond its segment so evicted or recycled segments take their bases with them.
+		auto seg_start = ofs - ofs % seg_sz;
+		auto seg_stop = seg_start + seg_sz;
+		auto stop = std::min(ofs + sz, seg_stop);
+		// Blocks stamped before and following the written ones keep the base applying to them.
+		if (stop < seg_stop && stop < ref._timeRange.getStop())
+		{
+			auto pos = upperBase(ref, stop);
+			if (pos && bases[pos - 1].first >= seg_start && bases[pos - 1].first < stop)
+			{
+				bases.insert(bases.begin() + static_cast<std::ptrdiff_t>(pos), {stop, bases[pos - 1].second});
+			}
+		}
+		// Bases within the written blocks are replaced.
+		auto first = upperBase(ref, ofs);
+		auto last = upperBase(ref, stop - 1);
+		bases.erase(bases.begin() + static_cast<std::ptrdiff_t>(first), bases.begin() + static_cast<std::ptrdiff_t>(last));
+		// Reuse the applying base when the delta fits.
+		auto base = (first && bases[first - 1].first >= seg_start) ? &bases[first - 1] : nullptr;
+		if (!base || ts < base->second || static_cast<uint64_t>(ts - base->second) > std::numeric_limits<uint32_t>::max())
+		{
+			if (base && base->first == ofs)
+			{
+				base->second = ts;
+			}
+			else
+			{
+				base = &*bases.insert(bases.begin() + static_cast<std::ptrdiff_t>(first), {ofs, ts});
+			}
+		}
+		deltas.assign(stop - ofs, static_cast<uint32_t>(ts - base->second));
+		if (!times.blockWrite(ofs, stop - ofs, deltas.data()))
+		{
+			return false;
+		}
+		ref._timeRange += Range(ofs, stop);
+		sz -= stop - ofs;
+		ofs = stop;
+	}
+	// Drop the bases not applying to accessible blocks anymore.
+	auto keep = upperBase(ref, ref._rangeManager->getManaged().getStart());
+	if (keep > 1)
+	{
+		bases.erase(bases.begin(), bases.begin() + static_cast<std::ptrdiff_t>(keep - 1));
+	}
+	return true;
+}
+
+/**
+ * @brief Reads the timestamp of a block while the time mutex is locked.
+ */
+bool readTime(const ResultDataReference& ref, ResultData::size_type index, ResultData::timestamp_type& ts)
+{
+	if (!ref._timeRange.isInRange(index))
+	{
+		return false;
+	}
+	auto pos = upperBase(ref, index);
+	auto seg_sz = ref._times->getSegmentSize();
+	if (!pos || ref._timeBases[pos - 1].first / seg_sz != index / seg_sz)
+	{
+		return false;
+	}
+	uint32_t delta;
+	if (!ref._times->blockRead(index, 1, &delta))
+	{
+		return false;
+	}
+	ts = ref._timeBases[pos - 1].second + delta;
+	return true;
+}
+
+}
+
+bool ResultData::blockWrite(Range::size_type ofs, Range::size_type sz, const void* src, bool auto_reserve, timestamp_type timestamp)
 {
 	// Only the owner of the instance may write to it.
 	if (!isOwner())
@@ -909,6 +1186,8 @@ bool ResultData::blockWrite(Range::size_type ofs, Range::size_type sz, const voi
 		// Bail out
 		return false;
 	}
+	// Limited by the storage governor from the thread of another result.
+	signalStorageLimit();
 	// When the passed offset is max the data must be appended.
 	if (ofs == npos)
 	{
@@ -947,11 +1226,75 @@ bool ResultData::blockWrite(Range::size_type ofs, Range::size_type sz, const voi
 	//LocalEvent(reUserLocal, Range(ofs, ofs + sz, FRef->Id), false);
 	//LocalEvent(reUserLocal, Range(ofs, ofs + sz, FRef->Id), false);
 
+	// Stamp the blocks before they are validated so readers always find a timestamp.
+	if (_reference->_times)
+	{
+		std::lock_guard lock(_reference->_timeMutex);
+		if (!writeTimes(*_reference, ofs, sz, timestamp ? timestamp : getTimestamp()))
+		{
+			SF_COND_RTTI_NOTIFY(isDebug(), DO_DEFAULT, "Writing block timestamps failed!")
+			// Bail out
+			return false;
+		}
+	}
 	// Add this range to the 'validate cache' that will be processed when commitValidations() is called for.
 	_reference->_validatedCache.add(Range(ofs, ofs + sz, (Range::id_type) _reference->_id));
 	return true;
 }
 
+ResultData::timestamp_type ResultData::getTimestamp()
+{
+	// The steady clock is the same monotonic clock as used by getTime() but at full resolution.
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool ResultData::hasTimestamps() const
+{
+	return _reference->_times != nullptr;
+}
+
+bool ResultData::getBlockTime(Range::size_type index, timestamp_type& timestamp) const
+{
+	if (!_reference->_times || !_reference->_rangeManager->getManaged().isInRange(index))
+	{
+		return false;
+	}
+	std::lock_guard lock(_reference->_timeMutex);
+	return readTime(*_reference, index, timestamp);
+}
+
+Range::size_type ResultData::findBlock(timestamp_type timestamp) const
+{
+	if (!_reference->_times)
+	{
+		return npos;
+	}
+	std::lock_guard lock(_reference->_timeMutex);
+	auto rng = _reference->_timeRange & _reference->_rangeManager->getManaged();
+	// Search the first block beyond the timestamp where unreadable blocks only precede the readable ones.
+	auto lo = rng.getStart();
+	auto hi = rng.getStop();
+	while (lo < hi)
+	{
+		auto mid = lo + (hi - lo) / 2;
+		timestamp_type ts;
+		if (!readTime(*_reference, mid, ts) || ts <= timestamp)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	timestamp_type ts;
+	if (lo == rng.getStart() || !readTime(*_reference, lo - 1, ts))
+	{
+		return npos;
+	}
+	return lo - 1;
+}
+
 void ResultData::validateRange(Range rng)
 {
 	// Only the owner can validate ranges.
@@ -1045,6 +1388,14 @@ bool ResultData::clearValidations(bool skip_self)
 			// Flush al allocated segments too.
 			// This seems to improve performance for Windows.
 			_reference->_data->flush();
+			// Timestamps are cleared with the data.
+			if (_reference->_times)
+			{
+				std::lock_guard lock(_reference->_timeMutex);
+				_reference->_timeBases.clear();
+				_reference->_timeRange.clear();
+				_reference->_times->flush();
+			}
 			// Notify clients of change of accessible range
 			emitLocalEvent(reAccessChange, _reference->_rangeManager->getManaged(), skip_self);
 			// Signal flush performed.
@@ -1087,6 +1438,173 @@ bool ResultData::blockRead(Range::size_type ofs, Range::size_type sz, void* src,
 	return ret_val;
 }
 
+namespace
+{
+
+// Size in bytes of the buffer the reductions read the data in chunks into.
+constexpr size_t ReduceBufferSize = 64 * 1024;
+
+// Reads the range in chunks and calls the function with the raw typed elements, amount and first element index.
+template<typename T, typename F>
+bool reduceChunks(const ResultData& rd, const Range& rng, F& fn)
+{
+	auto block_size = rd.getBlockSize();
+	Range::size_type chunk = std::max<Range::size_type>(1, ReduceBufferSize / (block_size * sizeof(T)));
+	TVector<T> buf(chunk * block_size);
+	for (auto ofs = rng.getStart(); ofs < rng.getStop(); ofs += chunk)
+	{
+		auto sz = std::min(chunk, rng.getStop() - ofs);
+		if (!rd.blockRead(ofs, sz, buf.data(), true))
+		{
+			return false;
+		}
+		fn(buf.data(), sz * block_size, ofs * block_size);
+	}
+	return true;
+}
+
+// Selects the unsigned type of the result for reading the raw values.
+template<typename F>
+bool reduceTyped(const ResultData& rd, const Range& rng, F&& fn)
+{
+	switch (rd.getType())
+	{
+		case ResultData::rtInt8:
+			return reduceChunks<uint8_t>(rd, rng, fn);
+		case ResultData::rtInt16:
+			return reduceChunks<uint16_t>(rd, rng, fn);
+		case ResultData::rtInt32:
+			return reduceChunks<uint32_t>(rd, rng, fn);
+		case ResultData::rtInt64:
+			return reduceChunks<uint64_t>(rd, rng, fn);
+		default:
+			return false;
+	}
+}
+
+// Gets the mask of the significant bits the same way as ResultData::getValue() does.
+ResultData::data_type significantMask(ResultData::size_type bits)
+{
+	return bits < sizeof(ResultData::data_type) * 8 ? (ResultData::data_type(1) << bits) - 1 : ResultData::data_type(-1);
+}
+
+}
+
+bool ResultData::getStatistics(const Range& rng, Statistics& stats, sdata_type threshold, bool force) const
+{
+	stats = {};
+	if (!_reference->_id || rng.isEmpty() || (!force && !isRangeValid(rng)))
+	{
+		return false;
+	}
+	auto mask = significantMask(_reference->_significantBits);
+	auto offset = static_cast<sdata_type>(_reference->_offset);
+	// Work on the masked raw values which keeps the loops free of the offset correction.
+	auto raw_threshold = threshold + offset;
+	data_type raw_min = std::numeric_limits<data_type>::max();
+	data_type raw_max = 0;
+	data_type raw_sum = 0;
+	auto fn = [&](auto* p, size_type n, size_type first)
+	{
+		using T = std::remove_pointer_t<decltype(p)>;
+		auto m = static_cast<T>(mask);
+		// Tight loops without branches depending on the data so the compiler is able to vectorize them.
+		T lo = std::numeric_limits<T>::max();
+		T hi = 0;
+		data_type sum = 0;
+		size_type above = 0;
+		double squares = 0;
+		for (size_type i = 0; i < n; i++)
+		{
+			T v = p[i] & m;
+			lo = std::min(lo, v);
+			hi = std::max(hi, v);
+			sum += v;
+			above += static_cast<sdata_type>(v) >= raw_threshold;
+		}
+		for (size_type i = 0; i < n; i++)
+		{
+			auto d = static_cast<double>(p[i] & m) - static_cast<double>(offset);
+			squares += d * d;
+		}
+		raw_sum += sum;
+		stats.squares += squares;
+		stats.above += above;
+		// Only locate the position when the chunk holds a new extreme.
+		if (lo < raw_min || !stats.count)
+		{
+			raw_min = lo;
+			for (size_type i = 0; i < n; i++)
+			{
+				if ((p[i] & m) == lo)
+				{
+					stats.minimumIndex = first + i;
+					break;
+				}
+			}
+		}
+		if (hi > raw_max || !stats.count)
+		{
+			raw_max = hi;
+			for (size_type i = 0; i < n; i++)
+			{
+				if ((p[i] & m) == hi)
+				{
+					stats.maximumIndex = first + i;
+					break;
+				}
+			}
+		}
+		stats.count += n;
+	};
+	if (!reduceTyped(*this, rng, fn))
+	{
+		SF_COND_RTTI_NOTIFY(isDebug(), DO_DEFAULT, "(" << rng << ") failed!")
+		stats = {};
+		return false;
+	}
+	stats.sum = static_cast<sdata_type>(raw_sum) - offset * static_cast<sdata_type>(stats.count);
+	stats.minimum = static_cast<sdata_type>(raw_min) - offset;
+	stats.maximum = static_cast<sdata_type>(raw_max) - offset;
+	return true;
+}
+
+bool ResultData::getHistogram(const Range& rng, sdata_type lower, sdata_type upper, TVector<size_type>& bins, bool force) const
+{
+	for (auto& bin: bins)
+	{
+		bin = 0;
+	}
+	if (!_reference->_id || rng.isEmpty() || bins.isEmpty() || upper <= lower || (!force && !isRangeValid(rng)))
+	{
+		return false;
+	}
+	auto mask = significantMask(_reference->_significantBits);
+	auto offset = static_cast<sdata_type>(_reference->_offset);
+	auto count = bins.count();
+	auto scale = static_cast<double>(count) / static_cast<double>(upper - lower);
+	auto fn = [&](auto* p, size_type n, size_type)
+	{
+		using T = std::remove_pointer_t<decltype(p)>;
+		auto m = static_cast<T>(mask);
+		for (size_type i = 0; i < n; i++)
+		{
+			auto v = static_cast<sdata_type>(p[i] & m) - offset;
+			if (v >= lower && v < upper)
+			{
+				// Clip for rounding errors of the scale.
+				bins[std::min(static_cast<size_type>(static_cast<double>(v - lower) * scale), count - 1)]++;
+			}
+		}
+	};
+	if (!reduceTyped(*this, rng, fn))
+	{
+		SF_COND_RTTI_NOTIFY(isDebug(), DO_DEFAULT, "(" << rng << ") failed!")
+		return false;
+	}
+	return true;
+}
+
 bool ResultData::readIndexRange(Range::size_type ofs, Range& range)
 {
 	// TODO: This needs a solution for an index based on 16, 32 and 64 in stead of only 64 bits use getValueU().
@@ -1262,14 +1780,37 @@ bool ResultData::isIndexRangeValid(const Range& r) const
 
 bool ResultData::requestIndexRange(const Range& rng)
 {
-	// Apply an offset to the passed index range because it is an index.
-	RANGE range{rng.getStart() - 1, rng.getStop()};
+	// Apply an offset to the passed index range start because it is an index.
+	RANGE range{rng.getStart(), rng.getStop(), 0};
 	// Negative values are not allowed.
-	if (range._start < 0)
+	if (range._start > 0)
+	{
+		range._start -= 1;
+	}
+	return requestRange(Range(range));
+}
+
+bool ResultData::cancelRange(const Range& rng)
+{
+	if (!_reference->_id)
+	{
+		return false;
+	}
+	// Requests are made using the transaction id.
+	Range r(rng);
+	r.setId(getTransId());
+	return _reference->_rangeManager->flushRequest(r);
+}
+
+bool ResultData::cancelIndexRange(const Range& rng)
+{
+	// Apply the same offset as #requestIndexRange().
+	RANGE range{rng.getStart(), rng.getStop(), 0};
+	if (range._start > 0)
 	{
-		range._start = 0;
+		range._start -= 1;
 	}
-	return requestRange(Range(rng));
+	return cancelRange(Range(range));
 }
 
 const char* ResultData::getEventName(EEvent event)
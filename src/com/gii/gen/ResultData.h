@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+
 #include "FileMappedStorage.h"
 #include "ResultDataHandler.h"
 #include "ResultDataReference.h"
@@ -406,6 +408,89 @@ class _GII_CLASS ResultData : public InformationBase
 		 */
 		inline bool blockRead(const Range& rng, void* dest, bool force = false) const;
 
+		/**
+		 * @brief Statistics of the values in a range of blocks returned by #getStatistics().
+		 *
+		 * Values are corrected with the value offset like #getValue() does.
+		 * Indices are element indices being the block offset times the block size plus the index in the block.
+		 */
+		struct Statistics
+		{
+			/**
+			 * @brief Amount of values.
+			 */
+			size_type count{0};
+			/**
+			 * @brief Sum of the values.
+			 */
+			sdata_type sum{0};
+			/**
+			 * @brief Sum of the squared values.
+			 */
+			double squares{0};
+			/**
+			 * @brief Lowest value.
+			 */
+			sdata_type minimum{0};
+			/**
+			 * @brief Element index of the first lowest value.
+			 */
+			size_type minimumIndex{0};
+			/**
+			 * @brief Highest value.
+			 */
+			sdata_type maximum{0};
+			/**
+			 * @brief Element index of the first highest value.
+			 */
+			size_type maximumIndex{0};
+			/**
+			 * @brief Amount of values equal or above the threshold.
+			 */
+			size_type above{0};
+
+			/**
+			 * @brief Gets the mean of the values.
+			 */
+			[[nodiscard]] double getMean() const
+			{
+				return count ? double(sum) / double(count) : 0.0;
+			}
+
+			/**
+			 * @brief Gets the root mean square of the values.
+			 */
+			[[nodiscard]] double getRms() const
+			{
+				return count ? std::sqrt(squares / double(count)) : 0.0;
+			}
+		};
+
+		/**
+		 * @brief Calculates the statistics of all values in a range of blocks in a single pass.
+		 *
+		 * The data is read in chunks and reduced in typed loops the compiler is able to vectorize.
+		 * @param rng Range of blocks.
+		 * @param stats Receives the statistics.
+		 * @param threshold Value from which on values are counted in Statistics::above.
+		 * @param force When true the function won't check the validity of the range but only the block count.
+		 * @return True on success false when the range is empty, not valid or the type is not an integer.
+		 */
+		bool getStatistics(const Range& rng, Statistics& stats, sdata_type threshold = 0, bool force = false) const;
+
+		/**
+		 * @brief Counts the values in a range of blocks into equally sized bins.
+		 *
+		 * Values outside the lower and upper limit are not counted.
+		 * @param rng Range of blocks.
+		 * @param lower Lower limit of the first bin.
+		 * @param upper Upper limit of the last bin which is exclusive.
+		 * @param bins Bins which are cleared and counted where the amount of bins is the passed count.
+		 * @param force When true the function won't check the validity of the range but only the block count.
+		 * @return True on success false when the range is empty, not valid, the type is not an integer or no bins are passed.
+		 */
+		bool getHistogram(const Range& rng, sdata_type lower, sdata_type upper, TVector<size_type>& bins, bool force = false) const;
+
 		/**
 		 * @brief Reads a range when this instance holds indices.
 		 *
@@ -497,9 +582,10 @@ class _GII_CLASS ResultData : public InformationBase
 		 * @param sz Size in blocks to write.
 		 * @param src Source pointer to data to read from.
 		 * @param auto_reserve Reserve file mapped memory when needed.
+		 * @param timestamp Acquisition time of the blocks for flag #flgTimestamp where zero means the current time.
 		 * @return True if it succeeds to write/store the data.
 		 */
-		bool blockWrite(Range::size_type ofs, Range::size_type sz, const void* src, bool auto_reserve = false);
+		bool blockWrite(Range::size_type ofs, Range::size_type sz, const void* src, bool auto_reserve = false, timestamp_type timestamp = 0);
 
 		/**
 		 * @brief For owners to writes data to storage in using a range in blocks.
@@ -508,9 +594,41 @@ class _GII_CLASS ResultData : public InformationBase
 		 * @param rng Range to write in blocks.
 		 * @param src Source pointer to data to read from.
 		 * @param auto_reserve Reserve file mapped memory when needed.
+		 * @param timestamp Acquisition time of the blocks where zero means the current time.
 		 * @see #blockWrite()
 		 */
-		inline bool blockWrite(const Range& rng, const void* src, bool auto_reserve = false);
+		inline bool blockWrite(const Range& rng, const void* src, bool auto_reserve = false, timestamp_type timestamp = 0);
+
+		/**
+		 * @brief Gets the current time of the clock used for block timestamps.
+		 *
+		 * @return Nanoseconds of the monotonic steady clock.
+		 */
+		static timestamp_type getTimestamp();
+
+		/**
+		 * @brief Gets whether timestamps are stored for written blocks which is the case when flag #flgTimestamp is set.
+		 */
+		[[nodiscard]] bool hasTimestamps() const;
+
+		/**
+		 * @brief Gets the timestamp of a written block.
+		 *
+		 * Blocks written in a single call to #blockWrite() share the same timestamp.
+		 * @param index Block index.
+		 * @param timestamp Receives the timestamp in nanoseconds.
+		 * @return True when the block has a timestamp.
+		 */
+		bool getBlockTime(Range::size_type index, timestamp_type& timestamp) const;
+
+		/**
+		 * @brief Finds the last accessible block written at or before the passed time using a binary search.
+		 *
+		 * Requires the timestamps to increase with the block index as is the case for acquired data.
+		 * @param timestamp Time in nanoseconds.
+		 * @return Block index or #npos when there is no such block.
+		 */
+		[[nodiscard]] Range::size_type findBlock(timestamp_type timestamp) const;
 
 		/**
 		 * @brief Commits all validated ranges and to notifies assigned handlers.
@@ -601,6 +719,23 @@ class _GII_CLASS ResultData : public InformationBase
 		 */
 		bool requestIndexRange(const Range& rng);
 
+		/**
+		 * @brief Cancels a single outstanding request made with #requestRange().
+		 *
+		 * The request is not answered anymore with a #reGotRange event.
+		 * @param rng Range as passed to #requestRange().
+		 * @return True when the request was outstanding.
+		 */
+		bool cancelRange(const Range& rng);
+
+		/**
+		 * @brief Same as #cancelRange() but for a request made with #requestIndexRange().
+		 *
+		 * @param rng Index range as passed to #requestIndexRange().
+		 * @return True when the request was outstanding.
+		 */
+		bool cancelIndexRange(const Range& rng);
+
 		/**
 		 * @brief Clears the outstanding requests for only this instance.
 		 *
@@ -772,6 +907,92 @@ class _GII_CLASS ResultData : public InformationBase
 		 */
 		static ResultData::size_type getTotalReservedSize();
 
+		/**
+		 * @brief Sets the maximum size of a storage segment.
+		 *
+		 * Larger segments reduce the amount of file mappings for long recordings.
+		 * Only affects instances setup afterwards.
+		 * @param bytes Maximum size in bytes which defaults to 10 MiB.
+		 */
+		static void setSegmentSizeLimit(size_type bytes);
+
+		/**
+		 * @brief Gets the maximum size of a storage segment.
+		 *
+		 * @return Size in bytes.
+		 */
+		static size_type getSegmentSizeLimit();
+
+		/**
+		 * @brief Storage usage information returned by #getStorageUsage().
+		 */
+		struct StorageUsage
+		{
+			/**
+			 * @brief Budget in bytes where zero is unlimited.
+			 */
+			size_type budget{0};
+			/**
+			 * @brief Bytes of all storage segments.
+			 */
+			size_type used{0};
+			/**
+			 * @brief Highest amount of used bytes seen.
+			 */
+			size_type peak{0};
+			/**
+			 * @brief Amount of results converted to ring mode to stay within the budget.
+			 */
+			size_type limited{0};
+			/**
+			 * @brief Bytes of segments evicted to stay within the budget.
+			 */
+			size_type evicted{0};
+		};
+
+		/**
+		 * @brief Sets the global storage budget for all results.
+		 *
+		 * When reserving storage exceeds the budget results not recycling yet and using more than their quota are
+		 * converted to ring mode having their quota in segments which evicts their oldest segments.
+		 * Results having the lowest priority are converted first.
+		 * @param bytes Budget in bytes where zero is unlimited which is the default.
+		 * @see #setPriority()
+		 */
+		static void setStorageBudget(size_type bytes);
+
+		/**
+		 * @brief Gets the global storage budget.
+		 */
+		static size_type getStorageBudget();
+
+		/**
+		 * @brief Gets the storage usage of all results.
+		 */
+		static StorageUsage getStorageUsage();
+
+		/**
+		 * @brief Sets the priority of this result for dividing the storage budget.
+		 *
+		 * The quota of a result is its share of the budget weighted by its priority plus one.
+		 * Only the owner is allowed to set it.
+		 * @param priority Positive priority which defaults to zero.
+		 * @return True on success.
+		 */
+		bool setPriority(int priority);
+
+		/**
+		 * @brief Gets the priority of this result for dividing the storage budget.
+		 */
+		[[nodiscard]] int getPriority() const;
+
+		/**
+		 * @brief Gets the share of the storage budget of this result.
+		 *
+		 * @return Bytes where zero means no budget is set.
+		 */
+		[[nodiscard]] size_type getStorageQuota() const;
+
 		/**
 		 * @brief Setup multiple instances from an input stream.
 		 *
@@ -886,7 +1107,7 @@ class _GII_CLASS ResultData : public InformationBase
 		/**
 		 * @brief Emits an event to a handler when one is assigned.
 		 *
-		 * This is the only function which calls this assigned instance handler directly.
+		 * This is the only function which calls this assigned instance handler directly or queues the event for it.
 		 * @param event Event passed to handler.
 		 * @param caller Instance passed as caller to handler.
 		 * @param rng Range passed to handler.
@@ -924,6 +1145,35 @@ class _GII_CLASS ResultData : public InformationBase
 		 */
 		ResultData::size_type attachDesired();
 
+		/**
+		 * @brief Converts results to ring mode when the storage budget is exceeded.
+		 *
+		 * Called from the thread reserving blocks which is not the thread of the limited results.
+		 * The recycle flag is set right away but the #reFlagsChange event is left to #signalStorageLimit()
+		 * so the handlers of a limited result are called from the thread owning it.
+		 */
+		static void governStorage();
+
+		/**
+		 * @brief Emits the #reFlagsChange event when the storage governor limited this result.
+		 *
+		 * Called by the owner when reserving and writing blocks.
+		 */
+		void signalStorageLimit();
+
+		/**
+		 * @brief Gets the sum of the storage weights of all results being their priority plus one.
+		 */
+		static size_type getStorageWeight();
+
+		/**
+		 * @brief Gets the share of the storage budget of the passed reference.
+		 *
+		 * @param ref Reference of the result.
+		 * @param weight Sum of the weights from #getStorageWeight().
+		 */
+		static size_type getStorageQuota(const ResultDataReference* ref, size_type weight);
+
 		/**
 		 * @brief Enables or disables recycling mode and flag. Does not generate an event.
 		 *
@@ -1096,9 +1346,9 @@ inline bool ResultData::blockRead(const Range& rng, void* dest, bool force) cons
 	return blockRead(rng.getStart(), rng.getSize(), dest, force);
 }
 
-inline bool ResultData::blockWrite(const Range& rng, const void* src, bool auto_reserve)
+inline bool ResultData::blockWrite(const Range& rng, const void* src, bool auto_reserve, timestamp_type timestamp)
 {
-	return blockWrite(rng.getStart(), rng.getSize(), src, auto_reserve);
+	return blockWrite(rng.getStart(), rng.getSize(), src, auto_reserve, timestamp);
 }
 
 inline Range::id_type ResultData::getTransId() const
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include "ResultDataColorizer.h"
+
+namespace sf
+{
+
+bool ResultDataColorizer::setFormat(const ResultData& rd)
+{
+	return setFormat(rd.getType(), rd.getSignificantBits(), rd.getValueOffset());
+}
+
+bool ResultDataColorizer::setFormat(EType type, size_type significant_bits, data_type offset)
+{
+	size_type bits = 0;
+	switch (type)
+	{
+		case rtInt8:
+			bits = 8;
+			break;
+
+		case rtInt16:
+			bits = 16;
+			break;
+
+		case rtInt32:
+			bits = 32;
+			break;
+
+		case rtInt64:
+			bits = 64;
+			break;
+
+		default:
+			_type = rtInvalid;
+			return false;
+	}
+	// Zero significant bits means all bits are significant.
+	bits = significant_bits ? std::min(significant_bits, bits) : bits;
+	auto mask = bits < sizeof(data_type) * 8 ? (data_type(1) << bits) - 1 : data_type(-1);
+	if (_type != type || _mask != mask || _offset != offset)
+	{
+		_type = type;
+		_mask = mask;
+		_offset = offset;
+		resetWindow();
+	}
+	return true;
+}
+
+void ResultDataColorizer::setWindow(sdata_type low, sdata_type high)
+{
+	if (low > high)
+	{
+		std::swap(low, high);
+	}
+	if (_low != low || _high != high)
+	{
+		_low = low;
+		_high = high;
+		_dirty = true;
+	}
+}
+
+void ResultDataColorizer::setWindowLevel(sdata_type level, data_type width)
+{
+	width = std::clamp<data_type>(width, 1, std::numeric_limits<sdata_type>::max());
+	auto low = level - static_cast<sdata_type>(width / 2);
+	setWindow(low, low + static_cast<sdata_type>(width - 1));
+}
+
+void ResultDataColorizer::resetWindow()
+{
+	// Limited to the signed range for 64-bit values.
+	auto high = std::min<data_type>(_mask, std::numeric_limits<sdata_type>::max());
+	setWindow(-static_cast<sdata_type>(_offset), static_cast<sdata_type>(high - _offset));
+}
+
+void ResultDataColorizer::setPalette(const std::vector<color_type>& palette)
+{
+	if (_palette != palette)
+	{
+		_palette = palette;
+		_dirty = true;
+	}
+}
+
+std::vector<ResultDataColorizer::color_type> ResultDataColorizer::grayscale(size_t count)
+{
+	std::vector<color_type> rv(std::max<size_t>(count, 1));
+	for (size_t i = 0; i < rv.size(); i++)
+	{
+		auto gray = static_cast<color_type>(rv.size() > 1 ? i * 255 / (rv.size() - 1) : 255);
+		rv[i] = 0xFF000000 | gray << 16 | gray << 8 | gray;
+	}
+	return rv;
+}
+
+size_t ResultDataColorizer::indexOf(sdata_type value) const
+{
+	value = std::clamp(value, _low, _high);
+	auto idx = ((static_cast<uint64_t>(value) - static_cast<uint64_t>(_low)) >> _shift) * _scale >> 32;
+	return static_cast<size_t>(std::min<uint64_t>(idx, _palette.size() - 1));
+}
+
+void ResultDataColorizer::update()
+{
+	if (!_dirty || !isValid())
+	{
+		return;
+	}
+	_dirty = false;
+	// Shift the span of the window so the scaled index fits 64 bits.
+	auto span = static_cast<uint64_t>(_high) - static_cast<uint64_t>(_low);
+	_shift = 0;
+	while ((span >> _shift) >= std::numeric_limits<uint32_t>::max())
+	{
+		_shift++;
+	}
+	_scale = (static_cast<uint64_t>(_palette.size()) << 32) / ((span >> _shift) + 1);
+	// Only the narrow types have a table of a color per stored value.
+	size_t entries = 0;
+	if (_type == rtInt8)
+	{
+		entries = 1 << 8;
+	}
+	else if (_type == rtInt16)
+	{
+		entries = 1 << 16;
+	}
+	_lut.resize(entries);
+	for (size_t raw = 0; raw < entries; raw++)
+	{
+		_lut[raw] = _palette[indexOf(static_cast<sdata_type>(raw & _mask) - static_cast<sdata_type>(_offset))];
+	}
+}
+
+template<typename T>
+void ResultDataColorizer::colorizeRow(const T* src, size_type count, color_type* dest) const
+{
+	if constexpr (sizeof(T) <= 2)
+	{
+		auto lut = _lut.data();
+		for (size_type i = 0; i < count; i++)
+		{
+			dest[i] = lut[src[i]];
+		}
+	}
+	else
+	{
+		auto palette = _palette.data();
+		auto mask = static_cast<T>(_mask);
+		auto offset = static_cast<sdata_type>(_offset);
+		auto low = _low;
+		auto high = _high;
+		auto shift = _shift;
+		auto scale = _scale;
+		auto last = static_cast<uint64_t>(_palette.size() - 1);
+		for (size_type i = 0; i < count; i++)
+		{
+			auto value = std::clamp(static_cast<sdata_type>(src[i] & mask) - offset, low, high);
+			auto idx = ((static_cast<uint64_t>(value) - static_cast<uint64_t>(low)) >> shift) * scale >> 32;
+			dest[i] = palette[std::min(idx, last)];
+		}
+	}
+}
+
+bool ResultDataColorizer::colorize(const void* src, size_type count, color_type* dest)
+{
+	return colorize(src, count, 1, dest, count * sizeof(color_type));
+}
+
+bool ResultDataColorizer::colorize(const void* src, size_type width, size_type rows, color_type* dest, size_type stride)
+{
+	if (!isValid())
+	{
+		return false;
+	}
+	update();
+	auto start = std::chrono::steady_clock::now();
+	auto out = reinterpret_cast<uint8_t*>(dest);
+	for (size_type r = 0; r < rows; r++, out += stride)
+	{
+		auto row = reinterpret_cast<color_type*>(out);
+		switch (_type)
+		{
+			case rtInt8:
+				colorizeRow(static_cast<const uint8_t*>(src) + r * width, width, row);
+				break;
+
+			case rtInt16:
+				colorizeRow(static_cast<const uint16_t*>(src) + r * width, width, row);
+				break;
+
+			case rtInt32:
+				colorizeRow(static_cast<const uint32_t*>(src) + r * width, width, row);
+				break;
+
+			case rtInt64:
+				colorizeRow(static_cast<const uint64_t*>(src) + r * width, width, row);
+				break;
+
+			default:
+				break;
+		}
+	}
+	_statistics.pixels += width * rows;
+	_statistics.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return true;
+}
+
+}
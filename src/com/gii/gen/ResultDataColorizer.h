@@ -0,0 +1,243 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "ResultData.h"
+
+namespace sf
+{
+
+/**
+ * @brief Maps values of result blocks through a window and a palette onto 32-bit ARGB pixels.
+ *
+ * The window selects the range of values spread over the palette where values outside it get the first or last color.
+ * Window and palette are combined into a lookup table which is only rebuilt when one of them or the format changes.
+ * For 8 and 16-bit types the table is indexed by the stored value so the significant bits mask and value offset are part of it.
+ * For 32 and 64-bit types the values are scaled onto the palette in fixed point before the palette is looked up.
+ * The inner loops have no branches so the compiler is able to vectorize them.
+ */
+class _GII_CLASS ResultDataColorizer :public ResultDataTypes
+{
+	public:
+		/**
+		 * @brief Type of a pixel having the same layout as a QRgb being 0xAARRGGBB.
+		 */
+		typedef uint32_t color_type;
+
+		/**
+		 * @brief Statistics of the colorized pixels since the last reset.
+		 */
+		struct Statistics
+		{
+			/**
+			 * @brief Amount of pixels colorized.
+			 */
+			uint64_t pixels{0};
+			/**
+			 * @brief Duration of the colorizing in seconds.
+			 */
+			double seconds{0};
+
+			/**
+			 * @brief Gets the rate in Mpixels/s.
+			 */
+			[[nodiscard]] double getRate() const
+			{
+				return seconds > 0 ? double(pixels) / seconds / 1e6 : 0;
+			}
+		};
+
+		/**
+		 * @brief Default constructor.
+		 */
+		ResultDataColorizer() = default;
+
+		/**
+		 * @brief Sets the format of the values from the passed result.
+		 *
+		 * @return True when the result type can be colorized.
+		 */
+		bool setFormat(const ResultData& rd);
+
+		/**
+		 * @brief Sets the format of the values.
+		 *
+		 * The window is reset to the full range of the significant bits when the format changes.
+		 * @param type Integer type of the values.
+		 * @param significant_bits Bits of the stored value used.
+		 * @param offset Value subtracted from the masked stored value.
+		 * @return True when the type can be colorized.
+		 */
+		bool setFormat(EType type, size_type significant_bits, data_type offset);
+
+		/**
+		 * @brief Sets the window of values spread over the palette.
+		 */
+		void setWindow(sdata_type low, sdata_type high);
+
+		/**
+		 * @brief Sets the window using the center level and the width of it.
+		 */
+		void setWindowLevel(sdata_type level, data_type width);
+
+		/**
+		 * @brief Resets the window to the full range of the significant bits.
+		 */
+		void resetWindow();
+
+		/**
+		 * @brief Gets the lowest value of the window.
+		 */
+		[[nodiscard]] sdata_type getWindowLow() const;
+
+		/**
+		 * @brief Gets the highest value of the window.
+		 */
+		[[nodiscard]] sdata_type getWindowHigh() const;
+
+		/**
+		 * @brief Sets the palette colors from low to high values.
+		 */
+		void setPalette(const std::vector<color_type>& palette);
+
+		/**
+		 * @brief Gets the palette.
+		 */
+		[[nodiscard]] const std::vector<color_type>& getPalette() const;
+
+		/**
+		 * @brief Creates a grayscale palette of opaque colors from black to white.
+		 */
+		static std::vector<color_type> grayscale(size_t count = 256);
+
+		/**
+		 * @brief Gets whether the format and palette allow colorizing.
+		 */
+		[[nodiscard]] bool isValid() const;
+
+		/**
+		 * @brief Colorizes consecutive values.
+		 *
+		 * @param src Values as read from the result.
+		 * @param count Amount of values.
+		 * @param dest Receives a pixel for each value.
+		 * @return True when valid.
+		 */
+		bool colorize(const void* src, size_type count, color_type* dest);
+
+		/**
+		 * @brief Colorizes rows of values into an image having a row stride.
+		 *
+		 * @param src Rows of values as read from the result.
+		 * @param width Amount of values in a row.
+		 * @param rows Amount of rows.
+		 * @param dest Receives the pixels of the first row.
+		 * @param stride Distance in bytes between the rows of the destination.
+		 * @return True when valid.
+		 */
+		bool colorize(const void* src, size_type width, size_type rows, color_type* dest, size_type stride);
+
+		/**
+		 * @brief Gets the statistics since the last reset.
+		 */
+		[[nodiscard]] const Statistics& getStatistics() const;
+
+		/**
+		 * @brief Resets the statistics.
+		 */
+		void resetStatistics();
+
+	private:
+		/**
+		 * @brief Rebuilds the lookup table when needed.
+		 */
+		void update();
+
+		/**
+		 * @brief Gets the palette index of a value.
+		 */
+		[[nodiscard]] size_t indexOf(sdata_type value) const;
+
+		/**
+		 * @brief Colorizes a single row of a specific type.
+		 */
+		template<typename T>
+		void colorizeRow(const T* src, size_type count, color_type* dest) const;
+
+		/**
+		 * @brief Type of the values.
+		 */
+		EType _type{rtInvalid};
+		/**
+		 * @brief Mask of the significant bits.
+		 */
+		data_type _mask{0};
+		/**
+		 * @brief Offset subtracted from the masked value.
+		 */
+		data_type _offset{0};
+		/**
+		 * @brief Lowest value of the window.
+		 */
+		sdata_type _low{0};
+		/**
+		 * @brief Highest value of the window.
+		 */
+		sdata_type _high{0};
+		/**
+		 * @brief Right shift bringing the window span within 32 bits.
+		 */
+		unsigned _shift{0};
+		/**
+		 * @brief Fixed point 32.32 factor scaling the shifted window span onto the palette.
+		 */
+		uint64_t _scale{0};
+		/**
+		 * @brief Colors from low to high.
+		 */
+		std::vector<color_type> _palette;
+		/**
+		 * @brief Color for each stored value of 8 and 16-bit types.
+		 */
+		std::vector<color_type> _lut;
+		/**
+		 * @brief True when the lookup table must be rebuilt.
+		 */
+		bool _dirty{true};
+		/**
+		 * @brief Statistics since the last reset.
+		 */
+		Statistics _statistics;
+};
+
+inline ResultDataColorizer::sdata_type ResultDataColorizer::getWindowLow() const
+{
+	return _low;
+}
+
+inline ResultDataColorizer::sdata_type ResultDataColorizer::getWindowHigh() const
+{
+	return _high;
+}
+
+inline const std::vector<ResultDataColorizer::color_type>& ResultDataColorizer::getPalette() const
+{
+	return _palette;
+}
+
+inline bool ResultDataColorizer::isValid() const
+{
+	return _type >= rtInt8 && _type <= rtInt64 && !_palette.empty();
+}
+
+inline const ResultDataColorizer::Statistics& ResultDataColorizer::getStatistics() const
+{
+	return _statistics;
+}
+
+inline void ResultDataColorizer::resetStatistics()
+{
+	_statistics = {};
+}
+
+}
@@ -0,0 +1,498 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <misc/gen/dbgutils.h>
+#include "ResultDataExporter.h"
+
+namespace sf
+{
+
+namespace
+{
+
+/**
+ * @brief Minimum amount of rows formatted by a single thread so small chunks are not split.
+ */
+constexpr ResultData::size_type MinimumRowsPerThread = 4096;
+
+/**
+ * @brief Layout of a column for formatting.
+ */
+struct Column
+{
+	const uint8_t* data;
+	ResultData::EType type;
+	ResultData::size_type blockSize;
+	ResultData::size_type blockBytes;
+	ResultData::data_type mask;
+	ResultData::sdata_type offset;
+};
+
+/**
+ * @brief Appends the values of a single block using the unsigned storage type.
+ */
+template<typename T>
+inline void appendValues(std::string& text, char separator, const T* p, const Column& col)
+{
+	auto m = static_cast<T>(col.mask);
+	char buf[24];
+	for (ResultData::size_type i = 0; i < col.blockSize; i++)
+	{
+		auto value = static_cast<ResultData::sdata_type>(p[i] & m) - col.offset;
+		auto res = std::to_chars(buf, buf + sizeof(buf), value);
+		text += separator;
+		text.append(buf, res.ptr);
+	}
+}
+
+/**
+ * @brief Appends a CSV field which is quoted when needed.
+ */
+void appendField(std::string& text, const std::string& field, char separator)
+{
+	if (field.find_first_of(std::string{separator, '"', '\n'}) == std::string::npos)
+	{
+		text += field;
+		return;
+	}
+	text += '"';
+	for (auto ch: field)
+	{
+		if (ch == '"')
+		{
+			text += '"';
+		}
+		text += ch;
+	}
+	text += '"';
+}
+
+/**
+ * @brief Writes a 64-bit value in native byte order.
+ */
+inline void writeValue(std::ostream& os, uint64_t value)
+{
+	os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+}
+
+/**
+ * @brief Fixed set of threads formatting the parts of the CSV chunks.
+ *
+ * The threads are started once per export so formatting a chunk does not create any threads.
+ */
+class ResultDataExporter::Workers
+{
+	public:
+		/**
+		 * @brief Starts the threads where the calling thread of #run() counts as one of them.
+		 */
+		explicit Workers(unsigned threads);
+
+		/**
+		 * @brief Stops and joins the threads.
+		 */
+		~Workers();
+
+		/**
+		 * @brief Gets the amount of threads including the calling one.
+		 */
+		[[nodiscard]] unsigned getThreads() const;
+
+		/**
+		 * @brief Calls the function for each part and returns when all parts are done.
+		 */
+		void run(size_t parts, const std::function<void(size_t)>& func);
+
+	private:
+		/**
+		 * @brief Loop of a worker thread.
+		 */
+		void work();
+
+		std::mutex _mutex;
+		/**
+		 * @brief Signals the threads new parts or termination.
+		 */
+		std::condition_variable _condition;
+		/**
+		 * @brief Signals #run() all parts are done.
+		 */
+		std::condition_variable _finished;
+		const std::function<void(size_t)>* _func{nullptr};
+		size_t _parts{0};
+		/**
+		 * @brief Next part to take.
+		 */
+		size_t _next{0};
+		/**
+		 * @brief Amount of parts done.
+		 */
+		size_t _done{0};
+		bool _terminate{false};
+		std::vector<std::thread> _threads;
+};
+
+ResultDataExporter::Workers::Workers(unsigned threads)
+{
+	for (unsigned i = 1; i < threads; i++)
+	{
+		_threads.emplace_back(&Workers::work, this);
+	}
+}
+
+ResultDataExporter::Workers::~Workers()
+{
+	{
+		std::lock_guard lock(_mutex);
+		_terminate = true;
+		_condition.notify_all();
+	}
+	for (auto& thread: _threads)
+	{
+		thread.join();
+	}
+}
+
+unsigned ResultDataExporter::Workers::getThreads() const
+{
+	return static_cast<unsigned>(_threads.size() + 1);
+}
+
+void ResultDataExporter::Workers::run(size_t parts, const std::function<void(size_t)>& func)
+{
+	std::unique_lock lock(_mutex);
+	_func = &func;
+	_parts = parts;
+	_next = 0;
+	_done = 0;
+	_condition.notify_all();
+	// The calling thread takes parts as well.
+	while (_next < _parts)
+	{
+		auto part = _next++;
+		lock.unlock();
+		func(part);
+		lock.lock();
+		_done++;
+	}
+	_finished.wait(lock, [&] {return _done == _parts;});
+	_func = nullptr;
+	_parts = _next = _done = 0;
+}
+
+void ResultDataExporter::Workers::work()
+{
+	std::unique_lock lock(_mutex);
+	for (;;)
+	{
+		_condition.wait(lock, [&] {return _terminate || _next < _parts;});
+		if (_terminate)
+		{
+			return;
+		}
+		auto part = _next++;
+		auto func = _func;
+		lock.unlock();
+		(*func)(part);
+		lock.lock();
+		if (++_done == _parts)
+		{
+			_finished.notify_all();
+		}
+	}
+}
+
+bool ResultDataExporter::add(id_type id)
+{
+	auto rd = std::make_unique<ResultData>();
+	// Only existing results since a desired id would wait for it to be created.
+	if (!rd->setup(id) || !rd->getId())
+	{
+		return fail("Result with id " + std::to_string(id) + " does not exist");
+	}
+	_results.push_back(std::move(rd));
+	return true;
+}
+
+void ResultDataExporter::clear()
+{
+	_results.clear();
+}
+
+bool ResultDataExporter::fail(const std::string& error)
+{
+	_error = error;
+	SF_COND_RTTI_NOTIFY(isDebug(), DO_DEFAULT, error)
+	return false;
+}
+
+bool ResultDataExporter::write(const std::string& filename, const Range& range)
+{
+	// A large stream buffer reduces the amount of system calls.
+	// Declared before the stream so it outlives the flush on destruction.
+	std::vector<char> buffer(1 << 20);
+	std::ofstream os;
+	os.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	os.open(filename, std::ios::binary | std::ios::trunc);
+	if (!os)
+	{
+		return fail("Unable to create file '" + filename + "'");
+	}
+	if (!write(os, range))
+	{
+		return false;
+	}
+	os.close();
+	if (!os)
+	{
+		return fail("Failed to close file '" + filename + "'");
+	}
+	return true;
+}
+
+bool ResultDataExporter::write(std::ostream& os, const Range& range)
+{
+	_statistics = {};
+	_error.clear();
+	if (_results.empty())
+	{
+		return fail("No results to export");
+	}
+	if (range.isEmpty())
+	{
+		return fail("Empty range to export");
+	}
+	// The chunk size is limited by the smallest segment so a read never spans more than 2 segments.
+	auto chunk = _options.chunkSize;
+	for (auto& rd: _results)
+	{
+		if (!rd->getId())
+		{
+			return fail("Result '" + rd->getName() + "' was removed");
+		}
+		if (_options.format == efCsv && rd->getType() == rtString)
+		{
+			return fail("Result '" + rd->getName() + "' of type string cannot be exported as CSV");
+		}
+		if (!_options.force && !rd->isRangeValid(range))
+		{
+			return fail("Range is not valid for result '" + rd->getName() + "'");
+		}
+		if (!_options.chunkSize)
+		{
+			chunk = chunk ? std::min<size_type>(chunk, rd->getSegmentSize()) : rd->getSegmentSize();
+		}
+	}
+	chunk = std::max<size_type>(chunk, 1);
+	auto start = std::chrono::steady_clock::now();
+	auto pos = os.tellp();
+	writeHeader(os, range);
+	// Buffers are reused for each chunk which bounds the memory used.
+	std::vector<std::vector<uint8_t>> buffers(_results.size());
+	std::vector<const uint8_t*> data(_results.size());
+	std::vector<uint8_t> rows;
+	// Threads formatting CSV are started once for all chunks and not more than the chunks can use.
+	std::unique_ptr<Workers> workers;
+	if (_options.format == efCsv)
+	{
+		unsigned threads = _options.threads ? _options.threads : std::max(std::thread::hardware_concurrency(), 1u);
+		auto parts = (std::min(chunk, range.getSize()) + MinimumRowsPerThread - 1) / MinimumRowsPerThread;
+		workers = std::make_unique<Workers>(static_cast<unsigned>(std::clamp<size_type>(parts, 1, threads)));
+	}
+	for (auto ofs = range.getStart(); ofs < range.getStop() && os; ofs += chunk)
+	{
+		Range rng(ofs, std::min(ofs + chunk, range.getStop()));
+		for (size_t i = 0; i < _results.size(); i++)
+		{
+			auto& rd(_results[i]);
+			buffers[i].resize(rd->getBufferSize(rng));
+			if (!rd->blockRead(rng, buffers[i].data(), _options.force))
+			{
+				return fail("Reading range " + std::to_string(rng.getStart()) + "-" + std::to_string(rng.getStop()) + " of result '" + rd->getName() + "' failed");
+			}
+			data[i] = buffers[i].data();
+			_statistics.readBytes += buffers[i].size();
+		}
+		switch (_options.format)
+		{
+			case efCsv:
+				writeCsv(os, rng, data, *workers);
+				break;
+
+			case efRaw:
+				if (_results.size() == 1)
+				{
+					os.write(reinterpret_cast<const char*>(data[0]), static_cast<std::streamsize>(buffers[0].size()));
+				}
+				else
+				{
+					// Interleave the blocks of the results per index.
+					size_t row_size = 0;
+					for (auto& rd: _results)
+					{
+						row_size += rd->getBufferSize(1);
+					}
+					rows.resize(row_size * rng.getSize());
+					auto dest = rows.data();
+					for (size_type r = 0; r < rng.getSize(); r++)
+					{
+						for (size_t i = 0; i < _results.size(); i++)
+						{
+							auto sz = _results[i]->getBufferSize(1);
+							std::memcpy(dest, data[i] + r * sz, sz);
+							dest += sz;
+						}
+					}
+					os.write(reinterpret_cast<const char*>(rows.data()), static_cast<std::streamsize>(rows.size()));
+				}
+				break;
+
+			case efColumnar:
+				writeValue(os, rng.getStart());
+				writeValue(os, rng.getSize());
+				for (size_t i = 0; i < _results.size(); i++)
+				{
+					os.write(reinterpret_cast<const char*>(data[i]), static_cast<std::streamsize>(buffers[i].size()));
+				}
+				break;
+		}
+		_statistics.blocks += rng.getSize();
+	}
+	os.flush();
+	_statistics.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (!os)
+	{
+		return fail("Writing to the output failed");
+	}
+	auto written = os.tellp();
+	if (pos >= 0 && written >= pos)
+	{
+		_statistics.writtenBytes = static_cast<uint64_t>(written - pos);
+	}
+	SF_COND_RTTI_NOTIFY(isDebug(), DO_CLOG, "Exported " << _statistics.blocks << " blocks in " << _statistics.seconds
+		<< "s at " << _statistics.getWriteRate() << " MB/s")
+	return true;
+}
+
+void ResultDataExporter::writeHeader(std::ostream& os, const Range& range)
+{
+	switch (_options.format)
+	{
+		case efCsv:
+			if (_options.header)
+			{
+				std::string text("Index");
+				for (auto& rd: _results)
+				{
+					auto name = rd->getName();
+					auto block_size = rd->getBlockSize();
+					for (size_type i = 0; i < block_size; i++)
+					{
+						text += _options.separator;
+						appendField(text, block_size > 1 ? name + '[' + std::to_string(i) + ']' : name, _options.separator);
+					}
+				}
+				text += '\n';
+				os.write(text.data(), static_cast<std::streamsize>(text.size()));
+			}
+			break;
+
+		case efRaw:
+			break;
+
+		case efColumnar:
+			writeValue(os, ColumnarMagic);
+			writeValue(os, ColumnarVersion);
+			writeValue(os, static_cast<uint64_t>(_results.size()));
+			writeValue(os, range.getStart());
+			writeValue(os, range.getStop());
+			for (auto& rd: _results)
+			{
+				auto setup = rd->getSetupString();
+				writeValue(os, static_cast<uint64_t>(setup.size()));
+				os.write(setup.data(), static_cast<std::streamsize>(setup.size()));
+			}
+			break;
+	}
+}
+
+void ResultDataExporter::writeCsv(std::ostream& os, const Range& range, const std::vector<const uint8_t*>& data, Workers& workers)
+{
+	std::vector<Column> columns;
+	size_t values = 0;
+	for (size_t i = 0; i < _results.size(); i++)
+	{
+		auto& rd(_results[i]);
+		auto bits = rd->getSignificantBits();
+		columns.push_back({
+			data[i],
+			rd->getType(),
+			rd->getBlockSize(),
+			rd->getBufferSize(1),
+			bits < sizeof(data_type) * 8 ? (data_type(1) << bits) - 1 : data_type(-1),
+			static_cast<sdata_type>(rd->getValueOffset())
+		});
+		values += rd->getBlockSize();
+	}
+	auto rows = range.getSize();
+	auto parts = static_cast<size_t>(std::clamp<size_type>((rows + MinimumRowsPerThread - 1) / MinimumRowsPerThread, 1, workers.getThreads()));
+	std::vector<std::string> texts(parts);
+	auto separator = _options.separator;
+	// Formats the rows of a part into its own text.
+	std::function<void(size_t)> format = [&](size_t part)
+	{
+		auto first = rows * part / parts;
+		auto last = rows * (part + 1) / parts;
+		auto& text(texts[part]);
+		// Rough estimate of the size of a row.
+		text.reserve((last - first) * (values + 1) * 8);
+		char buf[24];
+		for (auto r = first; r < last; r++)
+		{
+			auto res = std::to_chars(buf, buf + sizeof(buf), range.getStart() + r);
+			text.append(buf, res.ptr);
+			for (auto& col: columns)
+			{
+				auto p = col.data + r * col.blockBytes;
+				switch (col.type)
+				{
+					case rtInt8:
+						appendValues(text, separator, reinterpret_cast<const uint8_t*>(p), col);
+						break;
+
+					case rtInt16:
+						appendValues(text, separator, reinterpret_cast<const uint16_t*>(p), col);
+						break;
+
+					case rtInt32:
+						appendValues(text, separator, reinterpret_cast<const uint32_t*>(p), col);
+						break;
+
+					case rtInt64:
+						appendValues(text, separator, reinterpret_cast<const uint64_t*>(p), col);
+						break;
+
+					default:
+						break;
+				}
+			}
+			text += '\n';
+		}
+	};
+	workers.run(parts, format);
+	// Write in order of the rows.
+	for (auto& text: texts)
+	{
+		os.write(text.data(), static_cast<std::streamsize>(text.size()));
+	}
+}
+
+}
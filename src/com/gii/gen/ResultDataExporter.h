@@ -0,0 +1,257 @@
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include <misc/gen/Range.h>
+#include "ResultData.h"
+
+namespace sf
+{
+
+/**
+ * @brief Exports a range of blocks of one or more results to a stream or file.
+ *
+ * The range is read in chunks of at most a segment so memory stays bounded independent of the size of the range.
+ * For the CSV format the rows of a chunk are formatted by a set of threads started once per export before being written in order.
+ * Each row starts with the block index followed by the values of each result.
+ * Raw format writes the blocks of each result per index concatenated as stored without any header.
+ * The columnar format is self-describing and consists of a header followed by batches of rows.
+ * <ul>
+ *   <li>Header: magic, version, column count, range start and stop followed per column by the length and text of the setup string.</li>
+ *   <li>Batch: start index and block count followed by the blocks of each column contiguously.</li>
+ * </ul>
+ * All binary values are 64-bit unsigned integers in native byte order except the column data itself.
+ */
+class _GII_CLASS ResultDataExporter :public ResultDataTypes
+{
+	public:
+		/**
+		 * @brief Format written by #write().
+		 */
+		enum EFormat :int
+		{
+			/** Text with a row per block index.*/
+			efCsv,
+			/** Blocks as stored without any header.*/
+			efRaw,
+			/** Self-describing binary with the data stored per column.*/
+			efColumnar,
+		};
+
+		/**
+		 * @brief Magic of the columnar format 'SFRDXCOL'.
+		 */
+		static constexpr uint64_t ColumnarMagic = 0x4C4F435844524653;
+		/**
+		 * @brief Version of the columnar format.
+		 */
+		static constexpr uint64_t ColumnarVersion = 1;
+
+		/**
+		 * @brief Options for exporting.
+		 */
+		struct Options
+		{
+			/**
+			 * @brief Format of the output.
+			 */
+			EFormat format{efCsv};
+			/**
+			 * @brief Separator between CSV fields.
+			 */
+			char separator{','};
+			/**
+			 * @brief When true a CSV header line with the names of the results is written.
+			 */
+			bool header{true};
+			/**
+			 * @brief Amount of formatting threads where zero means the amount of hardware threads.
+			 */
+			unsigned threads{0};
+			/**
+			 * @brief Amount of blocks read at once where zero means the smallest segment size.
+			 */
+			size_type chunkSize{0};
+			/**
+			 * @brief When true the validity of the data is not checked.
+			 */
+			bool force{false};
+		};
+
+		/**
+		 * @brief Statistics of the last export.
+		 */
+		struct Statistics
+		{
+			/**
+			 * @brief Amount of block indices exported.
+			 */
+			size_type blocks{0};
+			/**
+			 * @brief Bytes read from the results.
+			 */
+			uint64_t readBytes{0};
+			/**
+			 * @brief Bytes written to the output.
+			 */
+			uint64_t writtenBytes{0};
+			/**
+			 * @brief Duration of the export in seconds.
+			 */
+			double seconds{0};
+
+			/**
+			 * @brief Gets the output rate in MB/s.
+			 */
+			[[nodiscard]] double getWriteRate() const
+			{
+				return seconds > 0 ? double(writtenBytes) / seconds / 1e6 : 0;
+			}
+
+			/**
+			 * @brief Gets the input rate in MB/s.
+			 */
+			[[nodiscard]] double getReadRate() const
+			{
+				return seconds > 0 ? double(readBytes) / seconds / 1e6 : 0;
+			}
+		};
+
+		/**
+		 * @brief Default constructor.
+		 */
+		ResultDataExporter() = default;
+
+		/**
+		 * @brief Constructor setting the options.
+		 */
+		explicit ResultDataExporter(const Options& options);
+
+		/**
+		 * @brief Sets the options.
+		 */
+		void setOptions(const Options& options);
+
+		/**
+		 * @brief Gets the options.
+		 */
+		[[nodiscard]] const Options& getOptions() const;
+
+		/**
+		 * @brief Adds a result to export as the next column.
+		 *
+		 * @param id Id of an existing result.
+		 * @return True when the result exists.
+		 */
+		bool add(id_type id);
+
+		/**
+		 * @brief Removes all results.
+		 */
+		void clear();
+
+		/**
+		 * @brief Gets the amount of results added.
+		 */
+		[[nodiscard]] size_t getCount() const;
+
+		/**
+		 * @brief Writes the range of blocks of all results to a stream.
+		 *
+		 * @param os Stream written to which should be opened in binary mode.
+		 * @param range Range of block indices to export.
+		 * @return True on success otherwise #getError() returns the reason.
+		 */
+		bool write(std::ostream& os, const Range& range);
+
+		/**
+		 * @brief Writes the range of blocks of all results to a file.
+		 *
+		 * @param filename File which is created or truncated.
+		 * @param range Range of block indices to export.
+		 * @return True on success otherwise #getError() returns the reason.
+		 */
+		bool write(const std::string& filename, const Range& range);
+
+		/**
+		 * @brief Gets the statistics of the last export.
+		 */
+		[[nodiscard]] const Statistics& getStatistics() const;
+
+		/**
+		 * @brief Gets the reason of the last failure.
+		 */
+		[[nodiscard]] const std::string& getError() const;
+
+	private:
+		/**
+		 * @brief Threads formatting the CSV chunks.
+		 */
+		class Workers;
+
+		/**
+		 * @brief Sets the error and returns false.
+		 */
+		bool fail(const std::string& error);
+
+		/**
+		 * @brief Writes the header of the format.
+		 */
+		void writeHeader(std::ostream& os, const Range& range);
+
+		/**
+		 * @brief Formats the CSV rows of a chunk in parallel on the workers and writes them.
+		 */
+		void writeCsv(std::ostream& os, const Range& range, const std::vector<const uint8_t*>& data, Workers& workers);
+
+		/**
+		 * @brief Options of the export.
+		 */
+		Options _options;
+		/**
+		 * @brief Results in column order.
+		 */
+		std::vector<std::unique_ptr<ResultData>> _results;
+		/**
+		 * @brief Statistics of the last export.
+		 */
+		Statistics _statistics;
+		/**
+		 * @brief Reason of the last failure.
+		 */
+		std::string _error;
+};
+
+inline ResultDataExporter::ResultDataExporter(const Options& options)
+	:_options(options)
+{
+}
+
+inline void ResultDataExporter::setOptions(const Options& options)
+{
+	_options = options;
+}
+
+inline const ResultDataExporter::Options& ResultDataExporter::getOptions() const
+{
+	return _options;
+}
+
+inline size_t ResultDataExporter::getCount() const
+{
+	return _results.size();
+}
+
+inline const ResultDataExporter::Statistics& ResultDataExporter::getStatistics() const
+{
+	return _statistics;
+}
+
+inline const std::string& ResultDataExporter::getError() const
+{
+	return _error;
+}
+
+}
@@ -0,0 +1,85 @@
+#include <misc/gen/dbgutils.h>
+#include "ResultDataGovernor.h"
+
+namespace sf
+{
+
+ResultDataGovernor::ResultDataGovernor()
+	:_variableHandler(this, &ResultDataGovernor::variableEventHandler)
+	 , _sustain(this, &ResultDataGovernor::sustain, _sustain.spTimer)
+{
+	// Usage is only shown so once a second is enough.
+	_sustain.setInterval({1, 0});
+}
+
+ResultDataGovernor::~ResultDataGovernor()
+{
+	flush();
+}
+
+void ResultDataGovernor::setup(id_type id, const std::string& prefix)
+{
+	flush();
+	if (!id)
+	{
+		return;
+	}
+	auto name = prefix.c_str();
+	_vBudget.setup(stringf("0x%llX,%s|Budget,B,S,Storage budget of all results where zero is unlimited.,INTEGER,,1,0,0,0", id++, name));
+	_vUsed.setup(stringf("0x%llX,%s|Used,B,RS,Storage used by all results.,INTEGER,,1,0,0,0", id++, name));
+	_vPeak.setup(stringf("0x%llX,%s|Peak,B,RS,Highest storage used by all results.,INTEGER,,1,0,0,0", id++, name));
+	_vLimited.setup(stringf("0x%llX,%s|Limited,,RS,Results converted to ring mode by the budget.,INTEGER,,1,0,0,0", id++, name));
+	_vEvicted.setup(stringf("0x%llX,%s|Evicted,B,RS,Storage evicted to stay within the budget.,INTEGER,,1,0,0,0", id++, name));
+	_vReserved.setup(stringf("0x%llX,%s|Reserved,B,RS,Storage reserved by all results.,INTEGER,,1,0,0,0", id, name));
+	// Reflect the current budget before hooking the handler.
+	_vBudget.setCur(Value(static_cast<Value::int_type>(ResultData::getStorageBudget())));
+	_vBudget.setHandler(&_variableHandler);
+	update();
+}
+
+void ResultDataGovernor::flush()
+{
+	_vBudget.setHandler(nullptr);
+	_vBudget.setup(0);
+	_vUsed.setup(0);
+	_vPeak.setup(0);
+	_vLimited.setup(0);
+	_vEvicted.setup(0);
+	_vReserved.setup(0);
+}
+
+void ResultDataGovernor::update()
+{
+	// Skip when not setup.
+	if (!_vUsed.getId())
+	{
+		return;
+	}
+	auto usage = ResultData::getStorageUsage();
+	_vUsed.setCur(Value(static_cast<Value::int_type>(usage.used)));
+	_vPeak.setCur(Value(static_cast<Value::int_type>(usage.peak)));
+	_vLimited.setCur(Value(static_cast<Value::int_type>(usage.limited)));
+	_vEvicted.setCur(Value(static_cast<Value::int_type>(usage.evicted)));
+	_vReserved.setCur(Value(static_cast<Value::int_type>(ResultData::getTotalReservedSize())));
+}
+
+void ResultDataGovernor::variableEventHandler(Variable::EEvent event, const Variable& caller, Variable& link, bool same_inst)
+{
+	(void) caller;
+	(void) same_inst;
+	if (&link == &_vBudget && event == Variable::veValueChange)
+	{
+		auto budget = link.getCur().getInteger();
+		ResultData::setStorageBudget(budget > 0 ? static_cast<ResultData::size_type>(budget) : 0);
+		update();
+	}
+}
+
+bool ResultDataGovernor::sustain(const timespec& t)
+{
+	(void) t;
+	update();
+	return true;
+}
+
+}
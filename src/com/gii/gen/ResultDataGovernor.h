@@ -0,0 +1,100 @@
+#pragma once
+
+#include <misc/gen/Sustain.h>
+#include "Variable.h"
+#include "VariableHandler.h"
+#include "ResultData.h"
+#include "../global.h"
+
+namespace sf
+{
+
+/**
+ * @brief Exposes the global storage budget and usage of the result data through variables.
+ *
+ * The budget variable sets #sf::ResultData::setStorageBudget() and the read-only variables
+ * are updated periodically from #sf::ResultData::getStorageUsage().
+ * Variables are created using consecutive ids in the order: budget, used, peak, limited, evicted and reserved.
+ */
+class _GII_CLASS ResultDataGovernor :public InformationTypes
+{
+	public:
+		/**
+		 * @brief Default constructor.
+		 */
+		ResultDataGovernor();
+
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~ResultDataGovernor();
+
+		/**
+		 * @brief Copying this class is not possible.
+		 */
+		ResultDataGovernor(const ResultDataGovernor&) = delete;
+
+		/**
+		 * @brief Creates the variables.
+		 *
+		 * @param id Id of the first variable which is the budget.
+		 * @param prefix Name prefix of the variables.
+		 */
+		void setup(id_type id, const std::string& prefix = "Storage");
+
+		/**
+		 * @brief Removes the variables.
+		 */
+		void flush();
+
+		/**
+		 * @brief Updates the usage variables which is also done periodically.
+		 */
+		void update();
+
+	private:
+		/**
+		 * @brief Event handler for the budget variable.
+		 */
+		void variableEventHandler(Variable::EEvent event, const Variable& caller, Variable& link, bool same_inst);
+
+		/**
+		 * @brief Called from sustain interface.
+		 */
+		bool sustain(const timespec& t);
+
+		/**
+		 * @brief Hook to variable events.
+		 */
+		TVariableHandler<ResultDataGovernor> _variableHandler;
+		/**
+		 * @brief Hook to sustain interface.
+		 */
+		TSustain<ResultDataGovernor> _sustain;
+		/**
+		 * @brief Storage budget in bytes.
+		 */
+		Variable _vBudget;
+		/**
+		 * @brief Bytes used by all storage segments.
+		 */
+		Variable _vUsed;
+		/**
+		 * @brief Highest amount of bytes used.
+		 */
+		Variable _vPeak;
+		/**
+		 * @brief Amount of results converted to ring mode.
+		 */
+		Variable _vLimited;
+		/**
+		 * @brief Bytes evicted to stay within the budget.
+		 */
+		Variable _vEvicted;
+		/**
+		 * @brief Bytes reserved by all results.
+		 */
+		Variable _vReserved;
+};
+
+}
@@ -1,13 +1,304 @@
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <misc/gen/Sustain.h>
 #include "ResultDataHandler.h"
 #include "ResultData.h"
 
 namespace sf
 {
 
+struct ResultDataHandler::Queue
+{
+	/**
+	 * @brief Pending event.
+	 */
+	struct Entry
+	{
+		EEvent event;
+		const ResultData* caller;
+		ResultData* link;
+		Range range;
+	};
+
+	Queue(ResultDataHandler* handler, SustainGroup* group, size_t capacity)
+		:_handler(handler)
+		, _group(group)
+		, _capacity(capacity)
+		, _sustain(new TSustain<Queue>(this, &Queue::sustain, SustainBase::spDefault, group))
+	{
+		// Only called after being notified of a new event.
+		_sustain->setEventDriven(true);
+	}
+
+	/**
+	 * @brief Sustain function delivering the pending events.
+	 */
+	bool sustain(const timespec&)
+	{
+		deliver();
+		return true;
+	}
+
+	size_t deliver()
+	{
+		// Held during the handler call so purging waits for an entry being delivered.
+		std::lock_guard dlock(_deliverMutex);
+		size_t rv = 0;
+		// Only the events pending now so a fast writer cannot keep this loop going.
+		size_t count;
+		{
+			std::lock_guard lock(_mutex);
+			count = _entries.size();
+		}
+		while (rv < count && _handler)
+		{
+			Entry entry{};
+			{
+				std::lock_guard lock(_mutex);
+				if (_entries.empty())
+				{
+					break;
+				}
+				entry = _entries.front();
+				_entries.pop_front();
+				_counters.delivered++;
+			}
+			_handler->resultDataEventHandler(entry.event, *entry.caller, *entry.link, entry.range, entry.caller == entry.link);
+			rv++;
+		}
+		return rv;
+	}
+
+	void purge(const ResultData* rd, bool link_only)
+	{
+		std::lock_guard dlock(_deliverMutex);
+		std::lock_guard lock(_mutex);
+		auto sz = _entries.size();
+		std::erase_if(_entries, [rd, link_only](const Entry& entry)
+		{
+			return entry.link == rd || (!link_only && entry.caller == rd);
+		});
+		_counters.dropped += sz - _entries.size();
+	}
+
+	/**
+	 * @brief Guards the registry.
+	 */
+	static std::mutex& registryMutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	/**
+	 * @brief Registry of the queues for purging instances being destroyed.
+	 */
+	static std::vector<std::shared_ptr<Queue>>& registry()
+	{
+		static std::vector<std::shared_ptr<Queue>> list;
+		return list;
+	}
+
+	/**
+	 * @brief Handler the events are delivered to.
+	 */
+	ResultDataHandler* _handler;
+	/**
+	 * @brief Group calling the delivery.
+	 */
+	SustainGroup* _group;
+	/**
+	 * @brief Maximum amount of pending events.
+	 */
+	size_t _capacity;
+	/**
+	 * @brief Guards the pending events and counters.
+	 */
+	mutable std::mutex _mutex;
+	/**
+	 * @brief Held while delivering.
+	 */
+	std::recursive_mutex _deliverMutex;
+	/**
+	 * @brief Pending events.
+	 */
+	std::deque<Entry> _entries;
+	/**
+	 * @brief Counters of the queued delivery.
+	 */
+	Counters _counters;
+	/**
+	 * @brief Event driven sustain entry in the delivery group.
+	 */
+	std::unique_ptr<TSustain<Queue>> _sustain;
+};
+
 ResultDataHandler::~ResultDataHandler()
 {
+	setDeliveryGroup(nullptr);
 	ResultData::removeHandler(this);
 }
 
+void ResultDataHandler::setDeliveryGroup(SustainGroup* group, size_t capacity)
+{
+	if (_queue)
+	{
+		// Same group only changes the capacity.
+		if (_queue->_group == group && group)
+		{
+			std::lock_guard lock(_queue->_mutex);
+			_queue->_capacity = capacity;
+			return;
+		}
+		// Detaching the sustain entry waits for a delivery in progress.
+		_queue->_sustain.reset();
+		{
+			std::lock_guard dlock(_queue->_deliverMutex);
+			_queue->_handler = nullptr;
+		}
+		{
+			std::lock_guard lock(Queue::registryMutex());
+			std::erase(Queue::registry(), _queue);
+		}
+		{
+			std::lock_guard lock(_queue->_mutex);
+			_queue->_counters.dropped += _queue->_entries.size();
+			_queue->_entries.clear();
+		}
+		_queue.reset();
+	}
+	if (group)
+	{
+		_queue = std::make_shared<Queue>(this, group, capacity);
+		std::lock_guard lock(Queue::registryMutex());
+		Queue::registry().push_back(_queue);
+	}
+}
+
+SustainGroup* ResultDataHandler::getDeliveryGroup() const
+{
+	return _queue ? _queue->_group : nullptr;
+}
+
+size_t ResultDataHandler::deliver()
+{
+	return _queue ? _queue->deliver() : 0;
+}
+
+size_t ResultDataHandler::getPending() const
+{
+	if (!_queue)
+	{
+		return 0;
+	}
+	std::lock_guard lock(_queue->_mutex);
+	return _queue->_entries.size();
 }
 
+ResultDataHandler::Counters ResultDataHandler::getCounters() const
+{
+	if (!_queue)
+	{
+		return {};
+	}
+	std::lock_guard lock(_queue->_mutex);
+	return _queue->_counters;
+}
+
+bool ResultDataHandler::isQueueable(EEvent event)
+{
+	switch (event)
+	{
+		// Clearing and invalidating need the handler to respond before it happens.
+		case reInvalid:
+		case reClear:
+			return false;
+
+		default:
+			// Only local events since the private ones are part of the request protocol.
+			return event > reFirstLocal && event < reFirstPrivate;
+	}
+}
+
+bool ResultDataHandler::queueEvent(EEvent event, const ResultData& caller, ResultData& link, const Range& range)
+{
+	if (!_queue)
+	{
+		return false;
+	}
+	if (!isQueueable(event))
+	{
+		switch (event)
+		{
+			// Pending events of the link are obsolete after these events.
+			case reInvalid:
+			case reClear:
+			case reSetup:
+			case reIdChanged:
+			case reRemove:
+			case reUnlinked:
+				purge(&link);
+				break;
+
+			default:
+				break;
+		}
+		return false;
+	}
+	{
+		std::lock_guard lock(_queue->_mutex);
+		auto& entries(_queue->_entries);
+		// Merge with a pending event of the same kind looking back as long as events can be merged.
+		if (event == reAccessChange || event == reCommitted)
+		{
+			for (auto it = entries.rbegin(); it != entries.rend() && (it->event == reAccessChange || it->event == reCommitted); ++it)
+			{
+				if (it->event == event && it->link == &link && it->caller == &caller)
+				{
+					// These events carry the complete managed range so the latest one covers the previous.
+					it->range = range;
+					_queue->_counters.merged++;
+					return true;
+				}
+			}
+		}
+		if (entries.size() >= _queue->_capacity)
+		{
+			_queue->_counters.dropped++;
+			return true;
+		}
+		entries.push_back({event, &caller, &link, range});
+		_queue->_counters.queued++;
+	}
+	_queue->_sustain->notify();
+	return true;
+}
+
+void ResultDataHandler::purge(const ResultData* link)
+{
+	if (_queue)
+	{
+		_queue->purge(link, true);
+	}
+}
+
+void ResultDataHandler::purgeAll(const ResultData* rd)
+{
+	// Copy the list so no lock is held while waiting for a delivery in progress.
+	std::vector<std::shared_ptr<Queue>> list;
+	{
+		std::lock_guard lock(Queue::registryMutex());
+		if (Queue::registry().empty())
+		{
+			return;
+		}
+		list = Queue::registry();
+	}
+	for (auto& queue: list)
+	{
+		queue->purge(rd, false);
+	}
+}
+
+}
@@ -2,16 +2,46 @@
 
 #include "ResultDataTypes.h"
 #include <misc/gen/Range.h>
+#include <memory>
 
 namespace sf
 {
 
+class SustainGroup;
+
 /**
  * @brief Class used to give a ResultData instance access to virtual method of a derived class.
+ *
+ * By default events are delivered directly on the thread emitting them.
+ * When a delivery group is set using #setDeliveryGroup() the queueable events are put in a queue of this handler
+ * and delivered from the thread calling the group so a slow handler does not throttle the writer.
  */
 class _GII_CLASS ResultDataHandler :public ResultDataTypes
 {
 	public:
+		/**
+		 * @brief Counters of the queued event delivery.
+		 */
+		struct Counters
+		{
+			/**
+			 * @brief Amount of events put in the queue.
+			 */
+			uint64_t queued{0};
+			/**
+			 * @brief Amount of events merged with a pending event of the same kind.
+			 */
+			uint64_t merged{0};
+			/**
+			 * @brief Amount of events dropped because the queue was full or they became obsolete.
+			 */
+			uint64_t dropped{0};
+			/**
+			 * @brief Amount of queued events delivered.
+			 */
+			uint64_t delivered{0};
+		};
+
 		/**
 		 * @brief Pure virtual function which must be overloaded in a derived class.
 		 */
@@ -31,6 +61,74 @@ class _GII_CLASS ResultDataHandler :public ResultDataTypes
 		 */
 		virtual ~ResultDataHandler();
 
+		/**
+		 * @brief Delivers the queueable events from the thread calling the passed group.
+		 *
+		 * Pending #reAccessChange and #reCommitted events of the same instance are merged into one carrying the latest range.
+		 * Events needing an immediate response are still delivered directly.
+		 * Passing nullptr restores direct delivery and drops the pending events.
+		 * A derived class delivering from another thread must do this in its destructor.
+		 * @param group Sustain group calling the delivery like the default one of the main thread.
+		 * @param capacity Maximum amount of pending events after which new events are dropped.
+		 */
+		void setDeliveryGroup(SustainGroup* group, size_t capacity = 1024);
+
+		/**
+		 * @brief Gets the delivery group set with #setDeliveryGroup().
+		 */
+		[[nodiscard]] SustainGroup* getDeliveryGroup() const;
+
+		/**
+		 * @brief Delivers the pending events from the calling thread.
+		 *
+		 * Called from the delivery group but can be called directly.
+		 * @return Amount of events delivered.
+		 */
+		size_t deliver();
+
+		/**
+		 * @brief Gets the amount of pending events.
+		 */
+		[[nodiscard]] size_t getPending() const;
+
+		/**
+		 * @brief Gets the counters of the queued event delivery.
+		 */
+		[[nodiscard]] Counters getCounters() const;
+
+		/**
+		 * @brief Checks if the passed event is put in the queue when a delivery group is set.
+		 */
+		static bool isQueueable(EEvent event);
+
+	private:
+		/**
+		 * @brief Holds the queue and the sustain entry delivering it.
+		 */
+		struct Queue;
+
+		/**
+		 * @brief Puts the event in the queue when delivery is queued.
+		 *
+		 * @return True when queued, merged or dropped and false when it must be delivered directly.
+		 */
+		bool queueEvent(EEvent event, const ResultData& caller, ResultData& link, const Range& range);
+
+		/**
+		 * @brief Removes the pending events of the passed link from this handler.
+		 */
+		void purge(const ResultData* link);
+
+		/**
+		 * @brief Removes the pending events referring to the passed instance from all handlers.
+		 */
+		static void purgeAll(const ResultData* rd);
+
+		/**
+		 * @brief Queue when delivery is queued.
+		 */
+		std::shared_ptr<Queue> _queue;
+
 		friend class ResultDataTypes;
 
 		friend class ResultData;
@@ -61,6 +159,14 @@ class TResultDataHandler :public ResultDataHandler
 		TResultDataHandler(T* _this, TPmf pmf)
 			:_self(_this), _pmf(pmf) {}
 
+		/**
+		 * @brief Destructor stopping queued delivery before the members of the owner are gone.
+		 */
+		~TResultDataHandler() override
+		{
+			setDeliveryGroup(nullptr);
+		}
+
 		/**
 		 * @brief Prevent copying.
 		 */
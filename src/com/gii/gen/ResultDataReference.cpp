@@ -89,6 +89,7 @@ ResultDataReference::~ResultDataReference()
 	delete _rangeManager;
 	// Delete the allocated data storage container.
 	delete _data;
+	delete _times;
 }
 
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include "ResultDataTypes.h"
 #include "misc/gen/RangeManager.h"
 
@@ -52,8 +55,10 @@ struct ResultDataReference :ResultDataTypes
 	flags_type _flags{0};
 	/**
 	 * @brief Member that contains the current flags of the setup.
+	 *
+	 * Atomic since the storage governor sets #flgRecycle from the thread of another result.
 	 */
-	flags_type _curFlags{rtInvalid};
+	std::atomic<flags_type> _curFlags{rtInvalid};
 	/**
 	 * @brief Contains the name string of the result data.
 	 */
@@ -66,10 +71,36 @@ struct ResultDataReference :ResultDataTypes
 	 * @brief Flag for debugging output.
 	 */
 	bool _debug{false};
+	/**
+	 * @brief Priority for dividing the storage budget.
+	 */
+	int _priority{0};
+	/**
+	 * @brief Set when the storage governor limited the storage and the flag change is not signaled yet.
+	 */
+	std::atomic<bool> _storageLimited{false};
 	/**
 	 * @brief Container for segments of data.
 	 */
 	FileMappedStorage* _data{nullptr};
+	/**
+	 * @brief Optional container for the timestamp deltas of the blocks when flag #flgTimestamp is set.
+	 *
+	 * Each block holds a 32-bit nanosecond delta relative to the base in #_timeBases which applies to it.
+	 */
+	FileMappedStorage* _times{nullptr};
+	/**
+	 * @brief Block index and base timestamp pairs sorted on block index where a base never spans a segment.
+	 */
+	std::vector<std::pair<size_type, timestamp_type>> _timeBases;
+	/**
+	 * @brief Span of blocks written with a timestamp.
+	 */
+	Range _timeRange;
+	/**
+	 * @brief Guards the timestamp bases and span.
+	 */
+	std::mutex _timeMutex;
 	/**
 	 * @brief Range manager for accessible entries.
 	 */
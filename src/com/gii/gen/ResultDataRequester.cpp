@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <misc/gen/dbgutils.h>
 #include "ResultData.h"
 #include "ResultDataHandler.h"
@@ -7,17 +8,18 @@ namespace sf
 {
 
 ResultDataRequester::ResultDataRequester()
-	:_sustain(this, &ResultDataRequester::sustain, _sustain.spTimer)
+	:_sustain(this, &ResultDataRequester::sustain)
+	 , _timeoutSustain(this, &ResultDataRequester::sustain, _timeoutSustain.spTimer)
 	 , _handlerData(this, &ResultDataRequester::resultCallback)
-// Default time for state machine to wait for a state change.
-	 , _timeoutTimer({1, 0})
 	 , _handler(nullptr)
-	 , _rdIndex(nullptr)
-	// Is used for debugging timing of the state machine.
+	// Is used for debugging timing of the requests.
 	 , _byPass(false)
 {
-	// Timer is just needed for testing the timeout.
-	_sustain.setInterval({1, 0});
+	// Only called when a result event notified it.
+	_sustain.setEventDriven(true);
+	// Timer is just needed for timing out requests and enabled when requests are in flight.
+	_timeoutSustain.setInterval({1, 0});
+	_timeoutSustain.disable();
 }
 
 ResultDataRequester::~ResultDataRequester()
@@ -27,21 +29,33 @@ ResultDataRequester::~ResultDataRequester()
 
 void ResultDataRequester::reset()
 {
-	// Set the state of the machine.
-	setState(drsReady);
-	// Terminate the current work.
-	_work.clear();
-	// Disable the timer.
-	_timeoutTimer.disable();
-	//
-	_rdIndex->clearRequests();
-	//
+	// Terminate all requests in flight.
+	_requests.flush();
+	_prefetched.flush();
+	_state = drsReady;
+	_timeoutSustain.disable();
+	// Flush the requests placed on the results.
+	if (_rdIndex)
+	{
+		_rdIndex->clearRequests();
+	}
 	for (unsigned i = 0; i < _rdDataList.count(); i++)
 	{
 		_rdDataList[i]->clearRequests();
 	}
 }
 
+void ResultDataRequester::setMaxOutstanding(unsigned count)
+{
+	// At least a single request must be possible.
+	_maxOutstanding = std::max(1u, count);
+}
+
+void ResultDataRequester::resetMetrics()
+{
+	_metrics = {};
+}
+
 void ResultDataRequester::setHandler(ResultDataHandler* handler)
 {
 	_handler = handler;
@@ -163,56 +177,13 @@ void ResultDataRequester::resultCallback
 			}
 
 			case ResultData::reAccessChange:
-				if (&link != _rdIndex)
-				{
-					if (!_work._dataAccess.Bits || !link.getId())
-					{
-						break;
-					}
-					// Check if this result has to catch up.
-					if (_work._dataAccess.Has(link.getData<int>()))
-					{
-						// Check if the result has caught up with the working range of the index.
-						if (rng.isWithinSelf(_work._range))
-						{
-							_work._dataAccess.Unset(link.getData<int>());
-						}
-						// Speed up thing by calling process when waiting is over.
-						if (!_work._dataAccess.Bits)
-						{
-							process();
-						}
-					}
-				}
-				break;
-
 			case ResultData::reGotRange:
-				if (&link == _rdIndex)
+				// Requests in flight check the validity of their ranges themselves on the next sustain tick.
+				if (!_requests.isEmpty())
 				{
-					if (!_work._indexRequest)
-					{
-						setError("Index GotRange event not expected");
-					}
-					// Reset the flag.
-					_work._indexRequest = false;
-					// Speed up thing by calling process.
-					process();
-				}
-				else
-				{
-					if (!_work._dataRequest.Has(link.getData<int>()))
-					{
-						setError("Data GotRange event not expected");
-					}
-					// Clear the bit of the request placed.
-					_work._dataRequest.Unset(link.getData<int>());
-					// Speed up thing by calling process wen waiting is over.
-					if (!_work._dataRequest.Bits)
-					{
-						process();
-					}
-					break;
+					_sustain.notify();
 				}
+				break;
 		}
 	}
 	// Emit the event.
@@ -222,16 +193,18 @@ void ResultDataRequester::resultCallback
 	}
 }
 
-void ResultDataRequester::passIndexEvent(ResultDataRequester::EReqEvent event)
+void ResultDataRequester::passIndexEvent(ResultDataRequester::EReqEvent event, const Request& req)
 {
-	if (_handler)
+	// The index result is the caller unless only data results are attached.
+	auto rd = _rdIndex ? _rdIndex : (_rdDataList.count() ? _rdDataList[0] : nullptr);
+	if (_handler && rd)
 	{
 		_handler->resultDataEventHandler
 			(
 				(ResultData::EEvent) event,
-				*_rdIndex,
-				*_rdIndex,
-				_rdIndex->getId() ? _work._index : _work._range,
+				*rd,
+				*rd,
+				req._index.isEmpty() ? req._range : req._index,
 				true
 			);
 	}
@@ -239,8 +212,8 @@ void ResultDataRequester::passIndexEvent(ResultDataRequester::EReqEvent event)
 
 bool ResultDataRequester::sustain(const timespec&)
 {
-	// Processes the current state when not waiting for an event.
-	if (_state != drsReady)
+	// Processes the requests when notified and for timing them out.
+	if (!_requests.isEmpty())
 	{
 		process();
 	}
@@ -277,325 +250,440 @@ const char* ResultDataRequester::getStateName(int state)
 	}
 }
 
-bool ResultDataRequester::setState(ResultDataRequester::EState state)
+void ResultDataRequester::updateLatest(const Request& req, EState state)
+{
+	_state = state;
+	_index = req._index;
+	_range = req._range;
+}
+
+bool ResultDataRequester::addRequest(const Range& index, const Range& range, bool prefetch)
 {
-	if (_state == drsError)
+	if (!prefetch)
+	{
+		// Cancel the older user requests since their result is not of interest anymore.
+		if (_cancelStale)
+		{
+			for (unsigned i = 0; i < _requests.count();)
+			{
+				if (_requests[i]._prefetch)
+				{
+					i++;
+				}
+				else
+				{
+					cancelRequest(_requests[i]);
+					_requests.detachAt(i);
+					_metrics.cancelled++;
+				}
+			}
+		}
+		if (!index.isEmpty())
+		{
+			// Take over a prefetch in flight of the same range.
+			for (auto& req: _requests)
+			{
+				if (req._prefetch && req._index == index)
+				{
+					req._prefetch = false;
+					req._start = getTime();
+					req._sequence = ++_sequence;
+					_latest = req._sequence;
+					_metrics.prefetchHits++;
+					updateLatest(req, req._state);
+					return true;
+				}
+			}
+			// Count a hit on a finished prefetch.
+			auto idx = _prefetched.find(index);
+			if (idx != InformationTypes::npos)
+			{
+				_prefetched.detachAt(idx);
+				_metrics.prefetchHits++;
+			}
+		}
+		// Make room by dropping the oldest prefetch.
+		if (_requests.count() >= _maxOutstanding)
+		{
+			for (unsigned i = 0; i < _requests.count(); i++)
+			{
+				if (_requests[i]._prefetch)
+				{
+					cancelRequest(_requests[i]);
+					_requests.detachAt(i);
+					break;
+				}
+			}
+		}
+	}
+	// Cannot accept new request when the maximum is reached.
+	if (_requests.count() >= _maxOutstanding)
 	{
 		return false;
 	}
-	// Only change the previous state when the state is not psWAIT.
-	if (_state != drsWait)
+	Request req;
+	req._index = index;
+	req._range = range;
+	req._prefetch = prefetch;
+	// Skip getting the index result for a direct data request.
+	req._state = index.isEmpty() ? drsTryData : drsGetIndex;
+	req._start = getTime();
+	req._sequence = ++_sequence;
+	if (prefetch)
 	{
-		_statePrevious = _state;
+		_metrics.prefetched++;
 	}
-	// Assign the new state value.
-	_state = state;
-	// No waiting when state was set with this function.
-	_stateWait = drsReady;
-	// Signal success.
+	else
+	{
+		_latest = req._sequence;
+		updateLatest(req, req._state);
+	}
+	_requests.add(std::move(req));
 	return true;
 }
 
-bool ResultDataRequester::setError(const std::string& text)
-{
-	auto old_prev = _statePrevious;
-	// Update the previous state.
-	if (_state != drsWait)
-	{
-		_statePrevious = _state;
-	}
-	// Assign the new state first so that msg boxes can appear.
-	_state = drsError;
-	// Do some debug printing in case of an error.
-	SF_RTTI_NOTIFY(DO_DEFAULT, "State Machine ran into an error '"
-		<< text << "'. SetState(" << getStateName(old_prev) << "=>"
-		<< getStateName(_statePrevious) << "=>" << getStateName(_state) << ")" << _work._index << _work._range)
-	//
-	SF_RTTI_NOTIFY(DO_DEFAULT, "Resetting the state machine.")
-	// Reset the state machine after each error.
-	reset();
-	// Always return false for being able to use it as a return value.
-	return false;
-}
-
-bool ResultDataRequester::waitForState(ResultDataRequester::EState state)
+void ResultDataRequester::prefetch(const Range& index, bool forward)
 {
-	SF_RTTI_NOTIFY(DO_CLOG, "WaitForState(" << getStateName(state) << ")" << _work._index << _work._range);
-	_stateWait = state;
-	_state = drsWait;
-	// Reset the timer to generate an error when waiting takes too long.
-	_timeoutTimer.reset();
-	// Always return true for being able to use it as a return value.
-	return true;
+	auto access = _rdIndex->getAccessRange();
+	auto size = index.getSize();
+	Range next(index);
+	for (unsigned i = 0; i < _readahead; i++)
+	{
+		if (forward)
+		{
+			next.assign(next.getStop(), next.getStop() + size);
+		}
+		else
+		{
+			if (next.getStart() < size)
+			{
+				break;
+			}
+			next.assign(next.getStart() - size, next.getStart());
+		}
+		// Stop at the edge of the accessible range.
+		next &= access;
+		if (next.isEmpty())
+		{
+			break;
+		}
+		// Skip ranges already in flight or prefetched.
+		if (_prefetched.find(next) != InformationTypes::npos ||
+			std::any_of(_requests.begin(), _requests.end(), [&next](const Request& req) {return req._index == next;}))
+		{
+			continue;
+		}
+		if (!addRequest(next, Range(), true))
+		{
+			break;
+		}
+	}
 }
 
 bool ResultDataRequester::requestIndex(const Range& range)
 {
-	// Cannot accept new request when not ready.
-	if (_state != drsReady || range.isEmpty())
+	if (!_rdIndex || range.isEmpty())
 	{
 		return false;
 	}
-	// SetError("Not ready to accept another request");
 	// Check if the requested range is in the accessible range.
 	if (!_rdIndex->getAccessRange().isWithinSelf(range))
 	{
-		return setError("Index request was invalid");
+		SF_RTTI_NOTIFY(DO_DEFAULT, "Index request " << range << " was invalid")
+		return false;
 	}
-	// Set the new range to work on.
-	_work._index = range;
-	// Trigger the state machine to go to work.
-	if (setState(drsGetIndex))
+	// Determine the direction of movement from the previous request.
+	auto previous = _index;
+	if (!addRequest(range, Range(), false))
 	{
-		// This could speed up things.
-		process();
-		return true;
+		return false;
+	}
+	// Prefetch adjacent ranges only when moving.
+	if (!previous.isEmpty() && previous != range)
+	{
+		prefetch(range, range.getStart() >= previous.getStart());
 	}
-	return false;
+	// This could speed up things.
+	process();
+	return true;
 }
 
 bool ResultDataRequester::requestData(const Range& range)
 {
-	// Cannot accept new request when not ready and the range is empty.
-	if (_state != drsReady || range.isEmpty())
+	// Cannot accept an empty range.
+	if (range.isEmpty())
 	{
 		return false;
 	}
-	// Set the index value to an impossible value.
-	_work._index.clear();
-	// Set the work range.
-	_work._range = range;
-	// Trigger the state machine to go to work on the data and skip
-	// getting the index result.
-	if (setState(drsTryData))
-	{ // This could speed up things.
-		process();
-		return true;
+	// Set the index range empty to skip getting the index result.
+	if (!addRequest(Range(), range, false))
+	{
+		return false;
 	}
-	return false;
+	// This could speed up things.
+	process();
+	return true;
 }
 
-bool ResultDataRequester::process() // NOLINT(misc-no-recursion)
+void ResultDataRequester::cancelRequest(const Request& req)
 {
-	//
-	switch (_state)
+	// Fulfilled requests were removed by the results already.
+	if (req._indexRequest && !_rdIndex->isIndexRangeValid(req._index))
 	{
-		case drsError:
-			return false;
+		_rdIndex->cancelIndexRange(req._index);
+	}
+	for (int i = 0; i < _rdDataList.count(); i++)
+	{
+		if (req._dataRequest.Has(i) && !_rdDataList[i]->isRangeValid(req._range))
+		{
+			_rdDataList[i]->cancelRange(req._range);
+		}
+	}
+}
 
-		case drsReady:
-			return true;
+bool ResultDataRequester::advance(Request& req)
+{
+	req._waiting = false;
+	switch (req._state)
+	{
+		default:
+			return false;
 
 		case drsGetIndex:
-			// Check if the range is valid if not request it.
-			if (!_rdIndex->isIndexRangeValid(_work._index))
+			// Check if the range is valid if not request it once.
+			if (!_rdIndex->isIndexRangeValid(req._index) && !req._indexRequest)
 			{
-				// Set the work this index result for when a request
-				// is handled immediately and will reenter during the request call.
-				_work._indexRequest = true;
-				// Request the needed range and check for an error.
-				if (!_rdIndex->requestIndexRange(_work._index))
+				req._indexRequest = true;
+				// Request the needed range which could be answered during the call.
+				if (!_rdIndex->requestIndexRange(req._index) && !_rdIndex->isIndexRangeValid(req._index))
 				{
-					_work._indexRequest = false;
-					return setError("Index request failed");
+					SF_COND_RTTI_NOTIFY(!req._prefetch, DO_DEFAULT, "Index request " << req._index << " failed!")
+					return false;
 				}
 			}
-			// When requests were made and thus the data was not valid yet we must wait.
-			if (_work._indexRequest)
-			{
-				// Make the state machine wait for the request events.
-				return waitForState(drsReadIndex);
-			}
+			req._state = drsReadIndex;
+			[[fallthrough]];
 
 		case drsReadIndex:
+			// Wait for the index range to become valid.
+			if (!_rdIndex->isIndexRangeValid(req._index))
+			{
+				req._waiting = true;
+				return true;
+			}
 			// Data was valid so read the index data into the data range.
-			if (!_rdIndex->readIndexRange(_work._index, _work._range))
+			if (!_rdIndex->readIndexRange(req._index, req._range))
 			{
-				return setError("Index read failed");
+				SF_COND_RTTI_NOTIFY(!req._prefetch, DO_DEFAULT, "Index read " << req._index << " failed!")
+				return false;
 			}
-			//SF_RTTI_NOTIFY(DO_CLOG, "Index read: Work" << _work._index << _work._range)
-			// When the data was available waiting is not needed.
+			req._state = drsTryData;
+			[[fallthrough]];
 
 		case drsTryData:
 			// Check data pointed to by the retrieved range is accessible at the moment.
+			req._dataAccess.Bits = 0;
 			for (int i = 0; i < _rdDataList.count(); i++)
 			{
 				// Results which are not linked are ignored.
-				if (_rdDataList[i]->getId())
-				{
-					if (!_rdDataList[i]->getAccessRange().isWithinSelf(_work._range))
-					{
-						_work._dataAccess.Set(i);
-					}
-				}
-				else
+				if (_rdDataList[i]->getId() && !_rdDataList[i]->getAccessRange().isWithinSelf(req._range))
 				{
-					_work._dataAccess.Unset(i);
+					req._dataAccess.Set(i);
 				}
 			}
 			// If all needed data was not accessible it must be waited for.
-			if (_work._dataAccess.Bits)
+			if (req._dataAccess.Bits)
 			{
-				// If not wait for it.
-				return waitForState(drsGetData);
+				// A prefetch is dropped instead of waiting.
+				if (req._prefetch)
+				{
+					return false;
+				}
+				req._waiting = true;
+				return true;
 			}
+			req._state = drsGetData;
+			[[fallthrough]];
 
 		case drsGetData:
 			for (int i = 0; i < _rdDataList.count(); i++)
 			{
-				// Results which are not linked are ignored.
-				if (_rdDataList[i]->getId())
+				// Results which are not linked or valid are ignored.
+				if (!_rdDataList[i]->getId() || _rdDataList[i]->isRangeValid(req._range))
 				{
-					// Check if the range is valid if not request it.
-					if (!_rdDataList[i]->isRangeValid(_work._range))
+					continue;
+				}
+				// Request the needed range once which could be answered during the call.
+				if (!req._dataRequest.Has(i))
+				{
+					req._dataRequest.Set(i);
+					if (!_rdDataList[i]->requestRange(req._range) && !_rdDataList[i]->isRangeValid(req._range))
 					{
-						// Set the work on bit for this data result for when a request
-						// is handled immediately and will reenter during the request call.
-						_work._dataRequest.Set(i);
-						// Request the needed range and check for an error.
-						if (!_rdDataList[i]->requestRange(_work._range))
-						{
-							_work._dataRequest.Unset(i);
-							return setError("Data '" + _rdDataList[i]->getName() + "' request failed");
-						}
+						SF_COND_RTTI_NOTIFY(!req._prefetch, DO_DEFAULT, "Data '" << _rdDataList[i]->getName() << "' request " << req._range << " failed!")
+						return false;
 					}
 				}
-				else
+				// Wait for the range to become valid.
+				if (!_rdDataList[i]->isRangeValid(req._range))
 				{
-					_work._dataRequest.Unset(i);
+					req._waiting = true;
 				}
 			}
-			// When requests were made and thus the data was not valid yet we
-			// must wait for it to get valid.
-			if (_work._dataRequest.Bits)
+			if (req._waiting)
 			{
-				// Make the state machine wait for the request events.
-				return waitForState(drsApply);
+				return true;
 			}
+			req._state = drsApply;
+			[[fallthrough]];
 
 		case drsApply:
-			// Allow a new request to be placed again.
-			if (!setState(drsReady))
-			{
-				return false;
-			}
-			else
+			break;
+	}
+	return true;
+}
+
+void ResultDataRequester::process()
+{
+	// Results answering a request immediately reenter here.
+	if (_processing)
+	{
+		_reprocess = true;
+		return;
+	}
+	_processing = true;
+	// Requests which completed, failed having the error state or timed out.
+	Request::Vector done;
+	TimeSpec now(getTime());
+	do
+	{
+		_reprocess = false;
+		// Iterate using the sequence numbers since event handlers are able to modify the list.
+		TVector<unsigned> sequences;
+		for (auto& req: _requests)
+		{
+			sequences.add(req._sequence);
+		}
+		for (auto seq: sequences)
+		{
+			auto find = [this, seq]()
 			{
-				bool ok = true;
-				// Check if the index range is valid.
-				if (!_work._index.isEmpty())
-				{
-					ok &= _rdIndex->isRangeValid(_work._index);
-				}
-				// Iterate through all attached synchronous data instances to check if the range is valid.
-				for (unsigned i = 0; i < _rdDataList.count(); i++)
+				for (size_t i = 0; i < _requests.count(); i++)
 				{
-					// Results which are not linked are ignored.
-					if (_rdDataList[i]->getId())
+					if (_requests[i]._sequence == seq)
 					{
-						ok &= _rdDataList[i]->isRangeValid(_work._range);
+						return i;
 					}
 				}
+				return _requests.count();
+			};
+			auto idx = find();
+			if (idx == _requests.count())
+			{
+				continue;
+			}
+			// Work on a copy since the list could be reset during the requests.
+			auto req = _requests[idx];
+			bool ok = advance(req);
+			idx = find();
+			if (idx == _requests.count())
+			{
+				continue;
+			}
+			bool timeout = ok && req._state != drsApply && !_timeout.isZero() && now - req._start >= _timeout;
+			if (!ok || timeout || req._state == drsApply)
+			{
 				if (!ok)
 				{
-					setError("Design flaw");
+					req._state = drsError;
+				}
+				// Failed and timed out requests leave no requests behind.
+				if (req._state != drsApply)
+				{
+					cancelRequest(req);
 				}
-				// Signal that the requested data is valid.
-				passIndexEvent(reDataValid);
+				_requests.detachAt(idx);
+				done.add(req);
 			}
-			break;
-
-		case drsWait:
-		{
-			// When the wait timer timed out generate an error.
-			if (_timeoutTimer)
+			else
 			{
-				// Disable timer to prevent reentry.
-				_timeoutTimer.disable();
-				// Check which result caused the timeout.
-				for (int i = 0; i < _rdDataList.count(); i++)
+				_requests[idx] = req;
+				if (seq == _latest)
 				{
-					if (_work._dataRequest.Has(i))
-					{
-						SF_RTTI_NOTIFY(DO_DEFAULT, "Data Req " << _work._range << " of result '" << _rdDataList[i]->getName(2) << "' " << _rdDataList[i]->getBlockCount())
-					}
-					if (_work._dataAccess.Has(i))
-					{
-						SF_RTTI_NOTIFY(DO_DEFAULT,
-							"Data Access " << _work._range << " of result '" << _rdDataList[i]->getName(2) << "' " << _rdDataList[i]->getBlockCount())
-					}
+					updateLatest(req, req._waiting ? drsWait : req._state);
 				}
-				// Set error state.
-				return setError("Wait timer timed out");
 			}
-			//
-			switch (_stateWait)
+		}
+	}
+	while (_reprocess);
+	_processing = false;
+	// The timer is only needed for timing out the requests in flight.
+	if (_requests.isEmpty())
+	{
+		_timeoutSustain.disable();
+	}
+	else if (!_timeoutSustain.isEnabled())
+	{
+		_timeoutSustain.enable();
+	}
+	// Handle the finished requests outside the loop since the handler is able to place new requests.
+	for (auto& req: done)
+	{
+		if (req._prefetch)
+		{
+			// Remember the finished prefetches for counting hits.
+			if (req._state == drsApply)
 			{
-				case drsApply:
-					// If requests are still out continue waiting.
-					if (_work._dataRequest.Bits)
-					{
-						break;
-					}
-					// Enter the next state.
-					if (setState(_stateWait))
-					{
-						return process();
-					}
-					else
-					{
-						return false;
-					}
-
-				case drsReadIndex:
-					// If request is still out, continue waiting.
-					if (_work._indexRequest)
-					{
-						break;
-					}
-					// Enter the next state.
-					if (setState(_stateWait))
-					{
-						return process();
-					}
-					else
-					{
-						return false;
-					}
-
-				case drsGetData:
-					// Continue as long as the bits of the request are not
-					// zeroed by the result event handler.
-					if (_work._dataAccess.Bits)
-					{
-						break;
-					}
-					// Enter the next state.
-					if (setState(_stateWait))
-					{
-						return process();
-					}
-					else
-					{
-						return false;
-					}
-
-				default:
-					// Cannot wait for any other state.
-					return setError("Impossible state to wait for");
+				_prefetched.add(req._index);
+				while (_prefetched.count() > _maxOutstanding + _readahead)
+				{
+					_prefetched.detachAt(0);
+				}
 			}
+			continue;
+		}
+		if (req._sequence == _latest)
+		{
+			updateLatest(req, req._state == drsError ? drsError : drsReady);
+		}
+		if (req._state == drsApply)
+		{
+			auto latency = (TimeSpec(getTime()) - req._start).toDouble();
+			_metrics.completed++;
+			_metrics.latencyLast = latency;
+			_metrics.latencyMin = _metrics.completed == 1 ? latency : std::min(_metrics.latencyMin, latency);
+			_metrics.latencyMax = std::max(_metrics.latencyMax, latency);
+			_metrics.latencyMean += (latency - _metrics.latencyMean) / static_cast<double>(_metrics.completed);
+			// Signal that the requested data is valid.
+			passIndexEvent(reDataValid, req);
+		}
+		else if (req._state != drsError)
+		{
+			SF_RTTI_NOTIFY(DO_DEFAULT, "Request timed out in state '" << getStateName(req._state) << "' " << req._index << req._range)
+			_metrics.timedOut++;
+			passIndexEvent(reTimedOut, req);
+		}
+		else
+		{
+			_metrics.failed++;
 		}
-			break;
 	}
-	return true;
 }
 
 std::ostream& ResultDataRequester::getStatus(std::ostream& os)
 {
-	os << "State (prev > cur): " << getStateName(_statePrevious) << " > " << getStateName(_state) << std::endl
-		<< "Work Index: " << _work._index << std::endl
-		<< "Work Range: " << _work._range << std::endl;
+	os << "State: " << getStateName() << std::endl
+		<< "Index: " << _index << std::endl
+		<< "Range: " << _range << std::endl;
+	for (auto& req: _requests)
+	{
+		os << "Request #" << req._sequence << (req._prefetch ? " (prefetch)" : "") << ": "
+			<< getStateName(req._state) << (req._waiting ? " (waiting)" : "") << req._index << req._range << std::endl;
+	}
+	os << "Completed: " << _metrics.completed << ", Cancelled: " << _metrics.cancelled << ", Timed out: " << _metrics.timedOut
+		<< ", Failed: " << _metrics.failed << ", Prefetched: " << _metrics.prefetched << ", Hits: " << _metrics.prefetchHits << std::endl
+		<< "Latency (last/min/mean/max): " << _metrics.latencyLast << '/' << _metrics.latencyMin << '/'
+		<< _metrics.latencyMean << '/' << _metrics.latencyMax << 's' << std::endl;
 	return os;
 }
 
-}
\ No newline at end of file
+}
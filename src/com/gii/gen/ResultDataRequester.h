@@ -1,6 +1,6 @@
 #pragma once
 
-#include <misc/gen/ElapseTimer.h>
+#include <misc/gen/TimeSpec.h>
 #include <misc/gen/Sustain.h>
 #include <misc/gen/TBitSet.h>
 #include "ResultData.h"
@@ -13,6 +13,11 @@ namespace sf
  *
  * #sf::ResultData instances can be attached to this type of instance to handle
  * request on multiple results for when all data must be available at a time for processing.
+ *
+ * Multiple requests are kept in flight at a time where each one runs through the states
+ * #drsGetIndex, #drsReadIndex, #drsTryData, #drsGetData and #drsApply independently.
+ * Subsequent index requests make the requester prefetch adjacent ranges in the direction of movement
+ * and by default a new request cancels the older ones not finished yet.
  */
 class _GII_CLASS ResultDataRequester :public ResultDataTypes
 {
@@ -28,7 +33,7 @@ class _GII_CLASS ResultDataRequester :public ResultDataTypes
 			 */
 			reDataValid = reUserLocal,
 			/**
-			 * State machine timed out on getting data.
+			 * A request timed out on getting data.
 			 * The passed range contains the requested index range.
 			 */
 			reTimedOut = reUserLocal + 1,
@@ -75,6 +80,8 @@ class _GII_CLASS ResultDataRequester :public ResultDataTypes
 
 		/**
 		 * @brief Requests a range of the data using multiple index ranges.
+		 *
+		 * Fails when the maximum of outstanding requests has been reached.
 		 * @param range
 		 * @return True on success.
 		 */
@@ -88,11 +95,35 @@ class _GII_CLASS ResultDataRequester :public ResultDataTypes
 		bool requestData(const Range& range);
 
 		/**
-		 * @brief Sets the time-out in ms in which a request is allowed too take before it is timed out.
+		 * @brief Sets the time-out in which a request is allowed too take before it is timed out.
 		 * A value of zero. makes it wait indefinitely.
 		 */
 		inline void setTimeout(const TimeSpec& timeout);
 
+		/**
+		 * @brief Sets the maximum amount of requests in flight including prefetches which defaults to 4.
+		 */
+		void setMaxOutstanding(unsigned count);
+
+		/**
+		 * @brief Sets the amount of adjacent index ranges prefetched in the direction of movement which defaults to 2.
+		 *
+		 * A value of zero disables prefetching.
+		 */
+		inline void setReadahead(unsigned count);
+
+		/**
+		 * @brief Sets whether a new request cancels the older pending requests which is the default.
+		 *
+		 * Cancelled requests do not emit any event.
+		 */
+		inline void setCancelStale(bool yn);
+
+		/**
+		 * @brief Gets the amount of requests in flight including prefetches.
+		 */
+		[[nodiscard]] inline unsigned getOutstanding() const;
+
 		/**
 		 * @brief Called when results are attached or detached and when a time-out occurred.
 		 * Sets all members to their initial state.
@@ -100,12 +131,12 @@ class _GII_CLASS ResultDataRequester :public ResultDataTypes
 		void reset();
 
 		/**
-		 * @brief Gets the index range the requester is working on or has done.
+		 * @brief Gets the index range of the latest request.
 		 */
 		[[nodiscard]] inline const Range& getIndexRange() const;
 
 		/**
-		 * @brief Gets the data range the requester is working on or has done.
+		 * @brief Gets the data range of the latest request.
 		 */
 		[[nodiscard]] inline const Range& getDataRange() const;
 
@@ -153,10 +184,47 @@ class _GII_CLASS ResultDataRequester :public ResultDataTypes
 		const char* getStateName(int state = -2);
 
 		/**
-		 * Gets the current state from the requester.
+		 * Gets the state of the latest request.
 		 */
 		[[nodiscard]] inline EState getState() const;
 
+		/**
+		 * @brief Request counters and latencies accumulated since construction or #resetMetrics().
+		 */
+		struct Metrics
+		{
+			/** Amount of requests which emitted a #reDataValid event.*/
+			unsigned long long completed{0};
+			/** Amount of requests cancelled by a newer request.*/
+			unsigned long long cancelled{0};
+			/** Amount of requests which emitted a #reTimedOut event.*/
+			unsigned long long timedOut{0};
+			/** Amount of requests which failed.*/
+			unsigned long long failed{0};
+			/** Amount of prefetches placed.*/
+			unsigned long long prefetched{0};
+			/** Amount of requests served by a prefetch.*/
+			unsigned long long prefetchHits{0};
+			/** Latency of the last completed request in seconds.*/
+			double latencyLast{0};
+			/** Minimum latency of completed requests in seconds.*/
+			double latencyMin{0};
+			/** Maximum latency of completed requests in seconds.*/
+			double latencyMax{0};
+			/** Mean latency of completed requests in seconds.*/
+			double latencyMean{0};
+		};
+
+		/**
+		 * @brief Gets the request counters and latencies.
+		 */
+		[[nodiscard]] inline const Metrics& getMetrics() const;
+
+		/**
+		 * @brief Clears the request counters and latencies.
+		 */
+		void resetMetrics();
+
 		/**
 		 * @brief For debugging purposes only it writes the status to the output stream.
 		 */
@@ -164,12 +232,17 @@ class _GII_CLASS ResultDataRequester :public ResultDataTypes
 
 	private:
 		/**
-		 * @brief Hook to sustain interface.
+		 * @brief Event driven hook to the sustain interface notified by the result events.
 		 */
 		TSustain<ResultDataRequester> _sustain;
 
 		/**
-		 * @brief Called from sustain interface.
+		 * @brief Timer hook to the sustain interface only enabled while requests are in flight for timing them out.
+		 */
+		TSustain<ResultDataRequester> _timeoutSustain;
+
+		/**
+		 * @brief Called from both sustain hooks.
 		 */
 		bool sustain(const timespec& t);
 
@@ -191,107 +264,150 @@ class _GII_CLASS ResultDataRequester :public ResultDataTypes
 		 * @brief Data results linked.
 		 */
 		PtrVector _rdDataList;
+
 		/**
-		 * @brief Timer implementation for timing out a request.
+		 * @brief Structure holding a request in flight.
 		 */
-		ElapseTimer _timeoutTimer;
+		struct Request
+		{
+			/**
+			 * @brief Data range of a request.
+			 */
+			Range _range;
+			/**
+			 * @brief Index range of a request which is empty for a direct data request.
+			 */
+			Range _index;
+			/**
+			 * @brief State the request is in.
+			 */
+			EState _state{drsReady};
+			/**
+			 * @brief True when the request is a prefetch which emits no events.
+			 */
+			bool _prefetch{false};
+			/**
+			 * @brief True when waiting for events of the results.
+			 */
+			bool _waiting{false};
+			/**
+			 * @brief True when a request index was made.
+			 */
+			bool _indexRequest{false};
+			/**
+			 * @brief Bits of the data results a request was made on.
+			 */
+			TSet<int> _dataRequest;
+			/**
+			 * @brief Bits of the data results which must catch up with the index result.
+			 */
+			TSet<int> _dataAccess;
+			/**
+			 * @brief Time the request was placed.
+			 */
+			TimeSpec _start;
+			/**
+			 * @brief Sequence number of the request.
+			 */
+			unsigned _sequence{0};
+
+			typedef TVector<Request> Vector;
+		};
 
 		/**
-		 * @brief Processes
+		 * @brief Requests in flight.
 		 */
-		bool process();
-
+		Request::Vector _requests;
+		/**
+		 * @brief Index ranges of finished prefetches for counting hits.
+		 */
+		Range::Vector _prefetched;
 		/**
-		 * @brief Holds the current state.
+		 * @brief Sequence counter for requests.
+		 */
+		unsigned _sequence{0};
+		/**
+		 * @brief Sequence number of the latest user request.
+		 */
+		unsigned _latest{0};
+		/**
+		 * @brief Maximum amount of requests in flight.
+		 */
+		unsigned _maxOutstanding{4};
+		/**
+		 * @brief Amount of adjacent ranges to prefetch.
+		 */
+		unsigned _readahead{2};
+		/**
+		 * @brief When true a new request cancels older pending ones.
+		 */
+		bool _cancelStale{true};
+		/**
+		 * @brief Time a request is allowed to take.
+		 */
+		TimeSpec _timeout{1, 0};
+		/**
+		 * @brief Holds the state of the latest user request.
 		 */
 		EState _state{drsReady};
 		/**
-		 * @brief Holds the previous state.
+		 * @brief Index range of the latest user request.
 		 */
-		EState _statePrevious{drsReady};
+		Range _index;
 		/**
-		 * @brief State which the sustain will move to requests are met.
+		 * @brief Data range of the latest user request.
 		 */
-		EState _stateWait{drsReady};
-
+		Range _range;
+		/**
+		 * @brief Counters and latencies.
+		 */
+		Metrics _metrics;
+		/**
+		 * @brief Prevents reentering the process loop when results answer a request immediately.
+		 */
+		bool _processing{false};
 		/**
-		 * @brief Sets the new state and acts on it.
+		 * @brief Set when an event arrived while processing.
 		 */
-		bool setState(EState state);
+		bool _reprocess{false};
 
 		/**
-		 * @brief Sets the error state.
-		 * @param text Error text.
-		 * @return Always false for ease in functions.
+		 * @brief Adds a request to the list of requests in flight.
+		 * @return True on success.
 		 */
-		bool setError(const std::string& text);
+		bool addRequest(const Range& index, const Range& range, bool prefetch);
 
 		/**
-		 * @brief Sets the wait state member to the passed value and the state machine
-		 * waits for some conditions before continuing by setting the passed state.
-		 * When conditions are not met in time an error is generated.
-		 * When reset is true the timer is reset.
+		 * @brief Adds prefetches of ranges adjacent to the passed index range.
 		 */
-		bool waitForState(EState state);
+		void prefetch(const Range& index, bool forward);
 
 		/**
-		 * @brief Calls event handler passing own local events.
-		 * @param event
+		 * @brief Processes all requests in flight and emits the events of the finished ones.
 		 */
-		void passIndexEvent(EReqEvent event);
+		void process();
 
 		/**
-		 * @brief Structure holding data to work on.
+		 * @brief Moves the passed request through its states as far as the results allow.
+		 * @return False when the request failed.
 		 */
-		struct WorkData
-		{
-			/**
-			 * @brief Default constructor.
-			 */
-			WorkData()
-			{
-				clear();
-			}
+		bool advance(Request& req);
 
-			/**
-			 * @brief Clears all dat members to their initial state.
-			 */
-			void clear()
-			{
-				_indexRequest = false;
-				_dataRequest.Bits = 0;
-				_range.clear();
-				_index.clear();
-				_dataRequest.Bits = 0;
-				_dataAccess.Bits = 0;
-			}
+		/**
+		 * @brief Cancels the outstanding requests made on the results for the passed request.
+		 */
+		void cancelRequest(const Request& req);
 
-			/**
-			 * @brief Data range of a request.
-			 */
-			Range _range;
-			/**
-			 * @brief Index range of a request.
-			 */
-			Range _index;
-			/**
-			 * @brief True when a request index was made.
-			 */
-			bool _indexRequest{};
-			/**
-			 * @brief True when a request data was made and it must be waited for.
-			 */
-			TSet<int> _dataRequest;
-			/**
-			 * @brief True when it must wait for results to catch up with the index result.
-			 */
-			TSet<int> _dataAccess;
-		};
+		/**
+		 * @brief Updates the state of the latest request from the passed request.
+		 */
+		void updateLatest(const Request& req, EState state);
 
 		/**
-		 * @brief Holds request working/status information.
+		 * @brief Calls event handler passing own local events.
 		 */
-		WorkData _work;
+		void passIndexEvent(EReqEvent event, const Request& req);
+
 		/**
 		 * @brief Pointer to ResultDataEventHandler function.
 		 */
@@ -311,7 +427,31 @@ ResultDataRequester::EState ResultDataRequester::getState() const
 inline
 void ResultDataRequester::setTimeout(const TimeSpec& timeout)
 {
-	_timeoutTimer.set(timeout);
+	_timeout = timeout;
+}
+
+inline
+void ResultDataRequester::setReadahead(unsigned count)
+{
+	_readahead = count;
+}
+
+inline
+void ResultDataRequester::setCancelStale(bool yn)
+{
+	_cancelStale = yn;
+}
+
+inline
+unsigned ResultDataRequester::getOutstanding() const
+{
+	return _requests.count();
+}
+
+inline
+const ResultDataRequester::Metrics& ResultDataRequester::getMetrics() const
+{
+	return _metrics;
 }
 
 inline
@@ -329,13 +469,13 @@ const ResultDataHandler* ResultDataRequester::getHandler() const
 inline
 const Range& ResultDataRequester::getIndexRange() const
 {
-	return _work._index;
+	return _index;
 }
 
 inline
 const Range& ResultDataRequester::getDataRange() const
 {
-	return _work._range;
+	return _range;
 }
 
 }
@@ -19,6 +19,15 @@ SF_REG_CLASS
 #define SID_DATA         6
 #define SID_BLOCKCOUNT   7
 #define SID_REQUEST      8
+#define SID_SUM          9
+#define SID_MIN         10
+#define SID_MININDEX    11
+#define SID_MAX         12
+#define SID_MAXINDEX    13
+#define SID_MEAN        14
+#define SID_RMS         15
+#define SID_COUNTABOVE  16
+#define SID_HISTOGRAM   17
 // Events
 #define SID_ON_ID       50
 #define SID_ON_ACCESS   51
@@ -35,6 +44,15 @@ ScriptObject::IdInfo ResultDataScriptObject::_info[] =
 		{SID_DATA, ScriptObject::idFunction, "Data", 1, nullptr},
 		{SID_REQUEST, ScriptObject::idFunction, "Request", 2, nullptr},
 		{SID_BLOCKCOUNT, ScriptObject::idVariable, "BlockCount", 0, nullptr},
+		{SID_SUM, ScriptObject::idFunction, "Sum", 2, nullptr},
+		{SID_MIN, ScriptObject::idFunction, "Min", 2, nullptr},
+		{SID_MININDEX, ScriptObject::idFunction, "MinIndex", 2, nullptr},
+		{SID_MAX, ScriptObject::idFunction, "Max", 2, nullptr},
+		{SID_MAXINDEX, ScriptObject::idFunction, "MaxIndex", 2, nullptr},
+		{SID_MEAN, ScriptObject::idFunction, "Mean", 2, nullptr},
+		{SID_RMS, ScriptObject::idFunction, "Rms", 2, nullptr},
+		{SID_COUNTABOVE, ScriptObject::idFunction, "CountAbove", 3, nullptr},
+		{SID_HISTOGRAM, ScriptObject::idFunction, "Histogram", 5, nullptr},
 		{SID_ON_ID, ScriptObject::idVariable, "OnId", 0, nullptr},
 		{SID_ON_ACCESS, ScriptObject::idVariable, "OnAccess", 0, nullptr},
 		{SID_ON_CLEAR, ScriptObject::idVariable, "OnClear", 0, nullptr},
@@ -168,6 +186,69 @@ bool ResultDataScriptObject::getSetValue(const ScriptObject::IdInfo* info, Value
 			break;
 		}
 
+		case SID_SUM:
+		case SID_MIN:
+		case SID_MININDEX:
+		case SID_MAX:
+		case SID_MAXINDEX:
+		case SID_MEAN:
+		case SID_RMS:
+		case SID_COUNTABOVE:
+		{
+			auto threshold = (info->_index == SID_COUNTABOVE) ? (*params)[2].getInteger() : 0;
+			auto stats = getStatistics(getParamRange(*params), threshold);
+			switch (info->_index)
+			{
+				case SID_SUM:
+					value->set((Value::int_type) stats.sum);
+					break;
+				case SID_MIN:
+					value->set((Value::int_type) stats.minimum);
+					break;
+				case SID_MININDEX:
+					value->set((Value::int_type) stats.minimumIndex);
+					break;
+				case SID_MAX:
+					value->set((Value::int_type) stats.maximum);
+					break;
+				case SID_MAXINDEX:
+					value->set((Value::int_type) stats.maximumIndex);
+					break;
+				case SID_MEAN:
+					value->set((Value::flt_type) stats.getMean());
+					break;
+				case SID_RMS:
+					value->set((Value::flt_type) stats.getRms());
+					break;
+				default:
+					value->set((Value::int_type) stats.above);
+					break;
+			}
+			break;
+		}
+
+		case SID_HISTOGRAM:
+		{
+			// Script values have no array type so the bins are returned as a comma separated string.
+			std::string rv;
+			auto count = (*params)[4].getInteger();
+			if (count > 0)
+			{
+				TVector<size_type> bins(count);
+				getHistogram(getParamRange(*params), (*params)[2].getInteger(), (*params)[3].getInteger(), bins);
+				for (auto bin: bins)
+				{
+					if (!rv.empty())
+					{
+						rv += ',';
+					}
+					rv += std::to_string(bin);
+				}
+			}
+			value->set(rv);
+			break;
+		}
+
 		case SID_FLAGS:
 		{
 			if (!flag_set)
@@ -235,8 +316,45 @@ bool ResultDataScriptObject::getSetValue(const ScriptObject::IdInfo* info, Value
 	return true;
 }
 
+Range ResultDataScriptObject::getParamRange(const Value::vector_type& params) const
+{
+	auto count = static_cast<Value::int_type>(getBlockCount());
+	auto ofs = params[0].getInteger();
+	auto sz = params[1].getInteger();
+	// When the offset is negative it is relative to the end.
+	if (ofs < 0)
+	{
+		ofs += count;
+	}
+	// When the size is negative the data till the end is used.
+	if (sz < 0)
+	{
+		sz = count - ofs;
+	}
+	if (ofs < 0 || sz <= 0)
+	{
+		return {};
+	}
+	return {static_cast<Range::size_type>(ofs), static_cast<Range::size_type>(ofs + sz)};
+}
+
+const ResultData::Statistics& ResultDataScriptObject::getStatistics(const Range& range, sdata_type threshold)
+{
+	// Scripts retrieving multiple statistics of the same range only cause a single pass.
+	if (!_statsValid || _statsRange != range || _statsThreshold != threshold)
+	{
+		_statsRange = range;
+		_statsThreshold = threshold;
+		_statsValid = true;
+		ResultData::getStatistics(range, _stats, threshold);
+	}
+	return _stats;
+}
+
 void ResultDataScriptObject::resultDataEventHandler(ResultDataTypes::EEvent event, const ResultData& data, ResultData& resultData, const Range& range, bool b)
 {
+	// Any event could mean different data.
+	_statsValid = false;
 	auto si = dynamic_cast<ScriptInterpreter*>(getParent());
 	if (event < ResultData::reFirstLocal)
 	{
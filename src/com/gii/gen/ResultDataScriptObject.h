@@ -31,6 +31,12 @@ class ResultDataScriptObject :public ScriptObject, public ResultData, private Re
 	private:
 		void resultDataEventHandler(EEvent event, const ResultData& data, ResultData& resultData, const Range& range, bool b) override;
 
+		// Gets the block range from the offset and size parameters where negative values are relative to the end.
+		[[nodiscard]] Range getParamRange(const Value::vector_type& params) const;
+
+		// Gets the statistics of the range reusing those of the previous call when possible.
+		const Statistics& getStatistics(const Range& range, sdata_type threshold);
+
 		// Instruction pointer to jump to on a change of ID. 0 means disabled.
 		ip_type OnId{0};
 		// Instruction pointer to jump to on a change of access range. 0 means disabled.
@@ -39,6 +45,14 @@ class ResultDataScriptObject :public ScriptObject, public ResultData, private Re
 		ip_type OnClear{0};
 		// Instruction pointer to jump to on a got data event. 0 means disabled.
 		ip_type OnGotRange{0};
+		// Statistics of the last reduced range.
+		Statistics _stats;
+		// Range of the cached statistics.
+		Range _statsRange;
+		// Threshold of the cached statistics.
+		sdata_type _statsThreshold{0};
+		// True when the cached statistics are valid.
+		bool _statsValid{false};
 
 		static ScriptObject::IdInfo _info[];
 };
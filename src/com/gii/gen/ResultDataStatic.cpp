@@ -16,6 +16,16 @@ ResultDataTypes::size_type ResultDataStatic::_debugSegmentSize{0};
 
 ResultDataTypes::size_type ResultDataStatic::_recycleSize{2};
 
+ResultDataTypes::size_type ResultDataStatic::_segmentSizeLimit{10L * 1024L * 1024L};
+
+ResultDataTypes::size_type ResultDataStatic::_storageBudget{0};
+
+ResultDataTypes::size_type ResultDataStatic::_storagePeak{0};
+
+ResultDataTypes::size_type ResultDataStatic::_storageLimited{0};
+
+ResultDataTypes::size_type ResultDataStatic::_storageEvicted{0};
+
 /**
  * Array used for conversion.
  * Follows enumerate EType
@@ -35,7 +45,8 @@ ResultDataStatic::FlagLetters ResultDataStatic::_flagLetters[] =
 		{'A', flgArchive},
 		{'S', flgShare},
 		{'H', flgHidden},
-		{'R', flgRecycle}
+		{'R', flgRecycle},
+		{'T', flgTimestamp}
 	};
 
 int ResultDataStatic::_globalActive = 0;
@@ -79,6 +79,26 @@ class _GII_CLASS ResultDataStatic :public ResultDataTypes
 		 * @brief Debugging value for the segment size.
 		 */
 		static size_type _debugSegmentSize;
+		/**
+		 * @brief Maximum size of a storage segment in bytes.
+		 */
+		static size_type _segmentSizeLimit;
+		/**
+		 * @brief Global storage budget in bytes where zero is unlimited.
+		 */
+		static size_type _storageBudget;
+		/**
+		 * @brief Highest amount of storage bytes seen.
+		 */
+		static size_type _storagePeak;
+		/**
+		 * @brief Amount of results converted to ring mode by the budget.
+		 */
+		static size_type _storageLimited;
+		/**
+		 * @brief Bytes evicted to stay within the budget.
+		 */
+		static size_type _storageEvicted;
 
 		/**
 		 * @brief Lookup list for flags.
@@ -40,6 +40,11 @@ class _GII_CLASS ResultDataTypes :public InformationTypes
 		 */
 		typedef TVector<ResultDataReference*> ReferenceVector;
 
+		/**
+		 * @brief Type for block timestamps in nanoseconds of the steady clock.
+		 */
+		typedef int64_t timestamp_type;
+
 		/**
 		 * @brief Event enumerate values used in broadcasting where global events have a negative value.
 		 */
@@ -148,7 +153,9 @@ class _GII_CLASS ResultDataTypes :public InformationTypes
 			/** Represented by character 'S' this data may be used by clients*/
 			flgShare = 1 << 2,
 			/** Represented by character 'H' for selection of client only when listing.*/
-			flgHidden = 1 << 3
+			flgHidden = 1 << 3,
+			/** Represented by character 'T' a timestamp is stored for each written block.*/
+			flgTimestamp = 1 << 4
 		};
 		/**
 		 * @brief Enumerate for range information bit values
@@ -215,6 +222,34 @@ class _GII_CLASS ResultDataTypes :public InformationTypes
 			 * Needed to produce an element value to calculate with.
 			 */
 			size_type _offset{0};
+
+			/**
+			 * @brief Compares the fields with those of the passed definition.
+			 *
+			 * @param def Definition to compare with.
+			 * @return Bit mask of the differing #EField fields.
+			 */
+			[[nodiscard]] unsigned compare(const Definition& def) const
+			{
+				unsigned rv = 0;
+				auto differ = [&rv](bool differs, EField field)
+				{
+					if (differs)
+					{
+						rv |= 1u << field;
+					}
+				};
+				differ(_id != def._id, rfId);
+				differ(_name != def._name, rfName);
+				differ(_flags != def._flags, rfFlags);
+				differ(_description != def._description, rfDescription);
+				differ(_type != def._type, rfType);
+				differ(_blockSize != def._blockSize, rfBlockSize);
+				differ(_segmentSize != def._segmentSize, rfSegmentSize);
+				differ(_significantBits != def._significantBits, rfSigBits);
+				differ(_offset != def._offset, rfOffset);
+				return rv;
+			}
 		};
 };
 
@@ -0,0 +1,468 @@
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <misc/gen/dbgutils.h>
+#include <misc/gen/gen_utils.h>
+#include <misc/gen/target.h>
+#include <misc/gen/TimeSpec.h>
+#include "SharedResultData.h"
+
+#if !IS_WIN
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace sf
+{
+
+namespace
+{
+
+/**
+ * @brief Starts an update of the control block making the sequence odd.
+ */
+inline void beginUpdate(SharedResultData::ControlBlock* block)
+{
+	std::atomic_ref<uint64_t>(block->sequence).fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief Ends an update of the control block making the sequence even.
+ */
+inline void endUpdate(SharedResultData::ControlBlock* block)
+{
+	std::atomic_ref<uint64_t>(block->sequence).fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Calls the passed function until it ran without the control block being updated.
+ *
+ * @return The sequence the function ran on.
+ */
+template<typename Func>
+uint64_t readConsistent(SharedResultData::ControlBlock* block, Func&& func)
+{
+	std::atomic_ref<uint64_t> sequence(block->sequence);
+	for (;;)
+	{
+		auto seq = sequence.load(std::memory_order_acquire);
+		// Odd means an update is in progress.
+		if (seq & 1)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		func();
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence.load(std::memory_order_relaxed) == seq)
+		{
+			return seq;
+		}
+	}
+}
+
+}
+
+SharedResultData::SharedResultData()
+	:_handler(this, &SharedResultData::resultDataEventHandler)
+{
+	_result.setHandler(&_handler);
+}
+
+SharedResultData::~SharedResultData()
+{
+	close();
+	_result.setHandler(nullptr);
+}
+
+std::string SharedResultData::getDefaultName(id_type id)
+{
+#if IS_WIN
+	return stringf("sf-rd-0x%llX", id);
+#else
+	return stringf("/sf-rd-%d-0x%llX", ::getpid(), id);
+#endif
+}
+
+bool SharedResultData::open(id_type id, const std::string& name, size_type segments, size_type ranges)
+{
+	close();
+	if (!id || !segments)
+	{
+		return false;
+	}
+#if IS_WIN
+	(void) name;
+	(void) ranges;
+	SF_RTTI_NOTIFY(DO_DEFAULT, "Sharing results is not available on this platform!")
+	return false;
+#else
+	_name = name.empty() ? getDefaultName(id) : name;
+	auto fd = ::shm_open(_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+	if (fd == -1)
+	{
+		SF_RTTI_NOTIFY(DO_DEFAULT, "shm_open(" << _name << ") failed: " << strerror(errno))
+		_name.clear();
+		return false;
+	}
+	_size = ControlBlock::getSize(segments, ranges);
+	void* ptr = MAP_FAILED;
+	if (::ftruncate(fd, static_cast<off_t>(_size)) == 0)
+	{
+		ptr = ::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	// The mapping keeps the shared memory alive.
+	::close(fd);
+	if (ptr == MAP_FAILED)
+	{
+		SF_RTTI_NOTIFY(DO_DEFAULT, "Mapping shared memory '" << _name << "' failed: " << strerror(errno))
+		::shm_unlink(_name.c_str());
+		_name.clear();
+		_size = 0;
+		return false;
+	}
+	// The truncated memory is zeroed already.
+	_block = static_cast<ControlBlock*>(ptr);
+	_block->magic = ControlBlock::Magic;
+	_block->version = ControlBlock::Version;
+	_block->pid = ::getpid();
+	_block->id = id;
+	_block->offsetCapacity = segments;
+	_block->rangeCapacity = ranges;
+	_cursor = 0;
+	// Wait for the id to appear when it does not exist yet.
+	_result.setup(id, true);
+	publish();
+	return true;
+#endif
+}
+
+void SharedResultData::close()
+{
+	if (!_block)
+	{
+		return;
+	}
+	beginUpdate(_block);
+	_block->flags |= ControlBlock::flgClosed;
+	endUpdate(_block);
+#if !IS_WIN
+	::munmap(_block, _size);
+	// Readers having it mapped keep it until they unmap it.
+	::shm_unlink(_name.c_str());
+#endif
+	_block = nullptr;
+	_size = 0;
+	_name.clear();
+	_result.setup(0);
+}
+
+bool SharedResultData::isOpen() const
+{
+	return _block != nullptr;
+}
+
+const std::string& SharedResultData::getName() const
+{
+	return _name;
+}
+
+uint64_t SharedResultData::getSequence() const
+{
+	return _block ? std::atomic_ref<uint64_t>(_block->sequence).load(std::memory_order_acquire) : 0;
+}
+
+void SharedResultData::publish()
+{
+	if (!_block)
+	{
+		return;
+	}
+	auto& store(_result.getDataStore());
+	auto count = _result.getId() ? store.getSegmentCount() : 0;
+	// Determine the first segment having data.
+	size_type first = store.getEvictedCount();
+	if (store.getRecycleCount() && count > store.getRecycleCount())
+	{
+		first = std::max<size_type>(first, count - store.getRecycleCount());
+	}
+	if (count > _block->offsetCapacity)
+	{
+		first = std::max<size_type>(first, count - _block->offsetCapacity);
+	}
+	// Path of the file holding the segments.
+	auto path = _result.getId() ? store.getSharedPath() : std::string();
+	if (_result.getId() && path.empty())
+	{
+		SF_RTTI_NOTIFY(DO_DEFAULT, "Result '" << _result.getName() << "' does not use an arena backed storage!")
+	}
+	beginUpdate(_block);
+	std::strncpy(_block->path, path.c_str(), sizeof(_block->path) - 1);
+	std::strncpy(_block->definition, _result.getId() ? _result.getSetupString().c_str() : "", sizeof(_block->definition) - 1);
+	_block->blockSize = store.getBlockSize();
+	_block->segmentSize = store.getSegmentSize();
+	// Only segments not published before need their offset set.
+	auto offsets = _block->getOffsets();
+	for (auto seg = std::max<size_type>(first, _block->segmentCount); seg < count; seg++)
+	{
+		offsets[seg % _block->offsetCapacity] = store.getSegmentOffset(seg);
+	}
+	_block->segmentCount = count;
+	_block->firstSegment = std::min(first, count);
+	_block->accessStart = _result.getAccessRange().getStart();
+	_block->accessStop = _result.getAccessRange().getStop();
+	_block->cursor = _cursor;
+	// Validated ranges exceeding the capacity are dropped.
+	auto& validated(_result.getValidatedList());
+	auto ranges = _block->getRanges();
+	_block->rangeCount = std::min<uint64_t>(validated.size(), _block->rangeCapacity);
+	for (size_t i = 0; i < _block->rangeCount; i++)
+	{
+		ranges[i * 2] = validated[i].getStart();
+		ranges[i * 2 + 1] = validated[i].getStop();
+	}
+	endUpdate(_block);
+}
+
+void SharedResultData::resultDataEventHandler(EEvent event, const ResultData& caller, ResultData& link, const Range& range, bool same_inst)
+{
+	(void) link;
+	(void) range;
+	(void) same_inst;
+	switch (event)
+	{
+		default:
+			break;
+
+		case reCommitted:
+			// Move the cursor to the end of the committed ranges.
+			for (auto& rng: caller.getCommitList())
+			{
+				_cursor = std::max(_cursor, rng.getStop());
+			}
+			publish();
+			break;
+
+		case reClear:
+		case reInvalid:
+			_cursor = 0;
+			// Segments are no longer valid.
+			if (_block)
+			{
+				beginUpdate(_block);
+				_block->segmentCount = _block->firstSegment = 0;
+				_block->rangeCount = 0;
+				_block->cursor = 0;
+				endUpdate(_block);
+			}
+			break;
+
+		case reIdChanged:
+		case reReserve:
+		case reAccessChange:
+		case reFlagsChange:
+			publish();
+			break;
+	}
+}
+
+SharedResultDataReader::SharedResultDataReader() = default;
+
+SharedResultDataReader::~SharedResultDataReader()
+{
+	close();
+}
+
+bool SharedResultDataReader::open(const std::string& name)
+{
+	close();
+#if IS_WIN
+	(void) name;
+	SF_RTTI_NOTIFY(DO_DEFAULT, "Sharing results is not available on this platform!")
+	return false;
+#else
+	auto fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd == -1)
+	{
+		SF_RTTI_NOTIFY(DO_DEFAULT, "shm_open(" << name << ") failed: " << strerror(errno))
+		return false;
+	}
+	struct stat st{};
+	void* ptr = MAP_FAILED;
+	if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SharedResultData::ControlBlock))
+	{
+		_size = st.st_size;
+		ptr = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+	::close(fd);
+	if (ptr == MAP_FAILED)
+	{
+		SF_RTTI_NOTIFY(DO_DEFAULT, "Mapping shared memory '" << name << "' failed!")
+		_size = 0;
+		return false;
+	}
+	_block = static_cast<SharedResultData::ControlBlock*>(ptr);
+	if (_block->magic != SharedResultData::ControlBlock::Magic || _block->version != SharedResultData::ControlBlock::Version
+		|| SharedResultData::ControlBlock::getSize(_block->offsetCapacity, _block->rangeCapacity) > _size)
+	{
+		SF_RTTI_NOTIFY(DO_DEFAULT, "Shared memory '" << name << "' has an incompatible layout!")
+		close();
+		return false;
+	}
+	std::string path;
+	readConsistent(_block, [&]()
+	{
+		path.assign(_block->path, strnlen(_block->path, sizeof(_block->path)));
+		_segmentBytes = _block->segmentSize * _block->blockSize;
+	});
+	_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (_descriptor == -1)
+	{
+		SF_RTTI_NOTIFY(DO_DEFAULT, "Opening segment file '" << path << "' failed: " << strerror(errno))
+		close();
+		return false;
+	}
+	return true;
+#endif
+}
+
+void SharedResultDataReader::close()
+{
+#if !IS_WIN
+	for (auto& view: _views)
+	{
+		::munmap(const_cast<void*>(view.second), _segmentBytes);
+	}
+	if (_descriptor != -1)
+	{
+		::close(_descriptor);
+	}
+	if (_block)
+	{
+		::munmap(_block, _size);
+	}
+#endif
+	_views.clear();
+	_descriptor = -1;
+	_block = nullptr;
+	_size = 0;
+}
+
+bool SharedResultDataReader::isOpen() const
+{
+	return _block != nullptr;
+}
+
+uint64_t SharedResultDataReader::getSequence() const
+{
+	return _block ? std::atomic_ref<uint64_t>(_block->sequence).load(std::memory_order_acquire) : 0;
+}
+
+bool SharedResultDataReader::getState(State& state) const
+{
+	if (!_block)
+	{
+		return false;
+	}
+	state.sequence = readConsistent(_block, [&]()
+	{
+		state.id = _block->id;
+		state.closed = _block->flags & SharedResultData::ControlBlock::flgClosed;
+		state.blockSize = _block->blockSize;
+		state.segmentSize = _block->segmentSize;
+		state.segmentCount = _block->segmentCount;
+		state.firstSegment = _block->firstSegment;
+		state.access.assign(_block->accessStart, _block->accessStop);
+		state.cursor = _block->cursor;
+		state.validated.clear();
+		auto ranges = _block->getRanges();
+		for (size_t i = 0; i < std::min(_block->rangeCount, _block->rangeCapacity); i++)
+		{
+			state.validated.add(Range(ranges[i * 2], ranges[i * 2 + 1]));
+		}
+		state.definition.assign(_block->definition, strnlen(_block->definition, sizeof(_block->definition)));
+	});
+	return true;
+}
+
+bool SharedResultDataReader::waitForChange(uint64_t sequence, const timespec& timeout) const
+{
+	if (!_block)
+	{
+		return false;
+	}
+	TimeSpec deadline(getTime());
+	deadline += timeout;
+	while (getSequence() == sequence)
+	{
+		if (deadline < getTime())
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+	}
+	return true;
+}
+
+const void* SharedResultDataReader::getBlocks(Range::size_type ofs, Range::size_type& sz)
+{
+	if (!_block || !_segmentBytes)
+	{
+		return nullptr;
+	}
+	uint64_t offset = 0, block_size = 0, segment_size = 0;
+	bool available = false;
+	readConsistent(_block, [&]()
+	{
+		block_size = _block->blockSize;
+		segment_size = _block->segmentSize;
+		auto seg = segment_size ? ofs / segment_size : 0;
+		available = segment_size && seg >= _block->firstSegment && seg < _block->segmentCount;
+		if (available)
+		{
+			offset = _block->getOffsets()[seg % _block->offsetCapacity];
+		}
+	});
+	if (!available || offset == FileMappedStorage::npos)
+	{
+		return nullptr;
+	}
+	auto it = _views.find(offset);
+	if (it == _views.end())
+	{
+#if IS_WIN
+		return nullptr;
+#else
+		auto ptr = ::mmap(nullptr, _segmentBytes, PROT_READ, MAP_SHARED, _descriptor, static_cast<off_t>(offset));
+		if (ptr == MAP_FAILED)
+		{
+			SF_RTTI_NOTIFY(DO_DEFAULT, "Mapping segment at " << offset << " failed: " << strerror(errno))
+			return nullptr;
+		}
+		it = _views.emplace(offset, ptr).first;
+#endif
+	}
+	auto blk = ofs % segment_size;
+	sz = std::min<Range::size_type>(sz, segment_size - blk);
+	return static_cast<const char*>(it->second) + blk * block_size;
+}
+
+bool SharedResultDataReader::isAvailable(Range::size_type ofs) const
+{
+	if (!_block)
+	{
+		return false;
+	}
+	bool rv = false;
+	readConsistent(_block, [&]()
+	{
+		auto seg = _block->segmentSize ? ofs / _block->segmentSize : 0;
+		rv = _block->segmentSize && seg >= _block->firstSegment && seg < _block->segmentCount;
+	});
+	return rv;
+}
+
+}
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <map>
+#include <misc/gen/Range.h>
+#include "ResultData.h"
+#include "ResultDataHandler.h"
+
+namespace sf
+{
+
+/**
+ * @brief Publishes the storage layout of a result in shared memory for reading it from another process.
+ *
+ * The segments of the result are not copied since the reading process maps the file of the storage arena read-only.
+ * The control block in shared memory holds the segment offsets, validated ranges, access range and write cursor.
+ * Updates of the control block are guarded by a sequence counter which is odd during an update.
+ * Only results using an arena backed storage can be shared.
+ * @see sf::SharedResultDataReader
+ * @see sf::FileMappedStorage::Options
+ */
+class _GII_CLASS SharedResultData :public ResultDataTypes
+{
+	public:
+		/**
+		 * @brief Layout of the shared memory which is followed by the offset table and the ranges.
+		 */
+		struct ControlBlock
+		{
+			/**
+			 * @brief Value of #magic identifying the shared memory.
+			 */
+			static constexpr uint32_t Magic = 0x44524653;
+			/**
+			 * @brief Current version of the layout.
+			 */
+			static constexpr uint32_t Version = 1;
+			/**
+			 * @brief Flag indicating the publisher closed the control block.
+			 */
+			static constexpr uint64_t flgClosed = 1 << 0;
+			/**
+			 * @brief Identifies the shared memory.
+			 */
+			uint32_t magic;
+			/**
+			 * @brief Version of the layout.
+			 */
+			uint32_t version;
+			/**
+			 * @brief Incremented before and after each update so it is odd during an update.
+			 */
+			uint64_t sequence;
+			/**
+			 * @brief Process id of the publisher.
+			 */
+			uint64_t pid;
+			/**
+			 * @brief Id of the result.
+			 */
+			uint64_t id;
+			/**
+			 * @brief Flags like #flgClosed.
+			 */
+			uint64_t flags;
+			/**
+			 * @brief Size of a block in bytes.
+			 */
+			uint64_t blockSize;
+			/**
+			 * @brief Size of a segment in blocks.
+			 */
+			uint64_t segmentSize;
+			/**
+			 * @brief Amount of segments reserved.
+			 */
+			uint64_t segmentCount;
+			/**
+			 * @brief First segment having data which is non-zero when evicted or recycled.
+			 */
+			uint64_t firstSegment;
+			/**
+			 * @brief Start of the access range.
+			 */
+			uint64_t accessStart;
+			/**
+			 * @brief Stop of the access range.
+			 */
+			uint64_t accessStop;
+			/**
+			 * @brief Stop of the last committed range.
+			 */
+			uint64_t cursor;
+			/**
+			 * @brief Amount of entries in the offset table indexed by segment modulo the capacity.
+			 */
+			uint64_t offsetCapacity;
+			/**
+			 * @brief Maximum amount of validated ranges.
+			 */
+			uint64_t rangeCapacity;
+			/**
+			 * @brief Amount of validated ranges.
+			 */
+			uint64_t rangeCount;
+			/**
+			 * @brief Path to open the file of the storage arena.
+			 */
+			char path[128];
+			/**
+			 * @brief Setup string of the result.
+			 */
+			char definition[512];
+
+			/**
+			 * @brief Gets the offset table following the control block.
+			 */
+			inline uint64_t* getOffsets();
+
+			/**
+			 * @brief Gets the start and stop pairs of the validated ranges following the offset table.
+			 */
+			inline uint64_t* getRanges();
+
+			/**
+			 * @brief Gets the size in bytes needed for the passed capacities.
+			 */
+			static inline size_t getSize(size_t offsets, size_t ranges);
+		};
+
+		/**
+		 * @brief Default constructor.
+		 */
+		SharedResultData();
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~SharedResultData();
+
+		/**
+		 * @brief Starts sharing the result having the passed id.
+		 *
+		 * @param id Id of the result.
+		 * @param name Name of the shared memory where empty uses #getDefaultName().
+		 * @param segments Amount of newest segments the reader is able to locate.
+		 * @param ranges Maximum amount of validated ranges published.
+		 * @return True on success.
+		 */
+		bool open(id_type id, const std::string& name = {}, size_type segments = 1024, size_type ranges = 256);
+
+		/**
+		 * @brief Stops sharing and removes the shared memory name.
+		 */
+		void close();
+
+		/**
+		 * @brief Gets whether the result is shared.
+		 */
+		[[nodiscard]] bool isOpen() const;
+
+		/**
+		 * @brief Gets the name of the shared memory.
+		 */
+		[[nodiscard]] const std::string& getName() const;
+
+		/**
+		 * @brief Gets the default name of the shared memory of a result id published by this process.
+		 */
+		static std::string getDefaultName(id_type id);
+
+		/**
+		 * @brief Updates the control block from the result which is also done on events of the result.
+		 */
+		void publish();
+
+		/**
+		 * @brief Gets the current sequence counter.
+		 */
+		[[nodiscard]] uint64_t getSequence() const;
+
+	private:
+		/**
+		 * @brief Handles the events of the shared result.
+		 */
+		void resultDataEventHandler(EEvent event, const ResultData& caller, ResultData& link, const Range& range, bool same_inst);
+
+		/**
+		 * @brief Hook to result events.
+		 */
+		TResultDataHandler<SharedResultData> _handler;
+		/**
+		 * @brief Instance attached to the shared result.
+		 */
+		ResultData _result;
+		/**
+		 * @brief Name of the shared memory.
+		 */
+		std::string _name;
+		/**
+		 * @brief Mapped control block.
+		 */
+		ControlBlock* _block{nullptr};
+		/**
+		 * @brief Size of the mapped control block.
+		 */
+		size_t _size{0};
+		/**
+		 * @brief Stop of the last committed range.
+		 */
+		Range::size_type _cursor{0};
+};
+
+/**
+ * @brief Reads a result shared by #sf::SharedResultData in another process.
+ *
+ * Blocks are accessed directly in the read-only mapped segments without copying.
+ * Since segments are reused when recycled or evicted, data read must be checked afterwards using #isAvailable().
+ * @code
+ * SharedResultDataReader reader;
+ * reader.open(name);
+ * SharedResultDataReader::State state;
+ * if (reader.getState(state))
+ * {
+ * 	Range::size_type sz = 10;
+ * 	if (auto p = reader.getBlocks(state.cursor - sz, sz))
+ * 	{
+ * 		// Process 'sz' blocks at 'p' and drop the outcome when the data was overwritten in the meantime.
+ * 		if (!reader.isAvailable(state.cursor - 10)) {}
+ * 	}
+ * }
+ * @endcode
+ */
+class _GII_CLASS SharedResultDataReader :public ResultDataTypes
+{
+	public:
+		/**
+		 * @brief Consistent copy of the control block.
+		 */
+		struct State
+		{
+			/**
+			 * @brief Sequence counter of the copy.
+			 */
+			uint64_t sequence{0};
+			/**
+			 * @brief Id of the result.
+			 */
+			id_type id{0};
+			/**
+			 * @brief True when the publisher closed the control block.
+			 */
+			bool closed{false};
+			/**
+			 * @brief Size of a block in bytes.
+			 */
+			size_type blockSize{0};
+			/**
+			 * @brief Size of a segment in blocks.
+			 */
+			size_type segmentSize{0};
+			/**
+			 * @brief Amount of segments reserved.
+			 */
+			size_type segmentCount{0};
+			/**
+			 * @brief First segment having data.
+			 */
+			size_type firstSegment{0};
+			/**
+			 * @brief Access range of the result.
+			 */
+			Range access;
+			/**
+			 * @brief Stop of the last committed range.
+			 */
+			Range::size_type cursor{0};
+			/**
+			 * @brief Validated ranges.
+			 */
+			Range::Vector validated;
+			/**
+			 * @brief Setup string of the result.
+			 */
+			std::string definition;
+		};
+
+		/**
+		 * @brief Default constructor.
+		 */
+		SharedResultDataReader();
+
+		/**
+		 * @brief Virtual destructor.
+		 */
+		virtual ~SharedResultDataReader();
+
+		/**
+		 * @brief Opens the shared memory by name and the file holding the segments.
+		 *
+		 * @return True on success.
+		 */
+		bool open(const std::string& name);
+
+		/**
+		 * @brief Unmaps all segments and the control block.
+		 */
+		void close();
+
+		/**
+		 * @brief Gets whether the shared memory is opened.
+		 */
+		[[nodiscard]] bool isOpen() const;
+
+		/**
+		 * @brief Gets the current sequence counter.
+		 */
+		[[nodiscard]] uint64_t getSequence() const;
+
+		/**
+		 * @brief Gets a consistent copy of the control block.
+		 *
+		 * @return False when not open.
+		 */
+		bool getState(State& state) const;
+
+		/**
+		 * @brief Waits for the sequence counter to differ from the passed one by polling.
+		 *
+		 * @param sequence Sequence of the last state.
+		 * @param timeout Maximum time to wait.
+		 * @return True when changed.
+		 */
+		bool waitForChange(uint64_t sequence, const timespec& timeout) const;
+
+		/**
+		 * @brief Gets a pointer to blocks in the mapped segment.
+		 *
+		 * @param ofs Offset of the first block.
+		 * @param sz Amount of blocks wanted which is reduced to the amount available in the segment.
+		 * @return Nullptr when not available.
+		 */
+		const void* getBlocks(Range::size_type ofs, Range::size_type& sz);
+
+		/**
+		 * @brief Checks whether the segment of the passed block offset still holds its data.
+		 */
+		[[nodiscard]] bool isAvailable(Range::size_type ofs) const;
+
+	private:
+		/**
+		 * @brief Mapped control block.
+		 */
+		SharedResultData::ControlBlock* _block{nullptr};
+		/**
+		 * @brief Size of the mapped control block.
+		 */
+		size_t _size{0};
+		/**
+		 * @brief Descriptor of the file holding the segments.
+		 */
+		int _descriptor{-1};
+		/**
+		 * @brief Mapped segments by file offset.
+		 */
+		std::map<uint64_t, const void*> _views;
+		/**
+		 * @brief Size of a segment in bytes.
+		 */
+		size_t _segmentBytes{0};
+};
+
+inline uint64_t* SharedResultData::ControlBlock::getOffsets()
+{
+	return reinterpret_cast<uint64_t*>(this + 1);
+}
+
+inline uint64_t* SharedResultData::ControlBlock::getRanges()
+{
+	return getOffsets() + offsetCapacity;
+}
+
+inline size_t SharedResultData::ControlBlock::getSize(size_t offsets, size_t ranges)
+{
+	return sizeof(ControlBlock) + (offsets + ranges * 2) * sizeof(uint64_t);
+}
+
+}
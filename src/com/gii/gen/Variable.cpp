@@ -1,5 +1,7 @@
 #include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <unordered_map>
 #include <misc/gen/dbgutils.h>
 #include <misc/gen/gen_utils.h>
 #include <misc/gen/Value.h>
@@ -938,6 +940,17 @@ bool Variable::setCur(const Value& value, bool skip_self)
 	return updateValue(_converted ? convert(value, true) : value, skip_self);
 }
 
+bool Variable::setCur(Value&& value, bool skip_self)
+{
+	// When the temporary value is used skip updating the real value.
+	if (_temporary)
+	{
+		return updateTempValue(value, skip_self);
+	}
+	// If this instance uses the converted value it must be converted first to the real value.
+	return updateValue(_converted ? convert(value, true) : std::move(value), skip_self);
+}
+
 bool Variable::isReadOnly() const
 {
 	// If it is the owner it is not readonly by default.
@@ -985,7 +998,7 @@ bool Variable::loadCur(const Value& value) const
 				new_val = (new_val < _reference->_minValue) ? _reference->_minValue : new_val;
 			}
 			// Signal when changed and do not skip the event for this instance.
-			return const_cast<Variable*>(this)->updateValue(new_val, false);
+			return const_cast<Variable*>(this)->updateValue(std::move(new_val), false);
 		}
 	}
 	else
@@ -997,6 +1010,28 @@ bool Variable::loadCur(const Value& value) const
 }
 
 bool Variable::updateValue(const Value& value, bool skip_self)
+{
+	return updateValue(Value(value), skip_self);
+}
+
+bool Variable::updateValue(Value&& value, bool skip_self)
+{
+	// Check if there was a change of the current value.
+	if (assignValue(std::move(value)))
+	{
+		// Notify all variables referencing this variable that the current value has changed.
+		emitLocalEvent(veValueChange, skip_self);
+		return true;
+	}
+	return false;
+}
+
+bool Variable::assignValue(const Value& value)
+{
+	return assignValue(Value(value));
+}
+
+bool Variable::assignValue(Value&& value)
 {
 	// Check if this instance can change its value.
 	if (isReadOnly())
@@ -1011,9 +1046,8 @@ bool Variable::updateValue(const Value& value, bool skip_self)
 		case Value::vitInteger:
 		case Value::vitFloat:
 		{
-			// If the new value is numerical adjust type to _curValue type
-			// create non const Value type
-			Value new_val = value;
+			// If the new value is numerical adjust type to _curValue type.
+			Value new_val(std::move(value));
 			// Adjust the new_val type
 			if (!new_val.setType(getType()))
 			{
@@ -1035,7 +1069,7 @@ bool Variable::updateValue(const Value& value, bool skip_self)
 			}
 			// Set local 'changed ' to trigger event.
 			changed = _reference->_curValue != new_val;
-			_reference->_curValue = new_val;
+			_reference->_curValue = std::move(new_val);
 			break;
 		}
 
@@ -1097,15 +1131,14 @@ bool Variable::updateValue(const Value& value, bool skip_self)
 			// Set local 'changed ' to trigger event
 			changed = _reference->_curValue != v;
 			// assign the value
-			_reference->_curValue = v;
+			_reference->_curValue = std::move(v);
 			break;
 		}
 
 		case Value::vitBinary:
 		case Value::vitCustom:
 		{
-			// create non const Value type
-			Value new_val = value;
+			Value new_val(std::move(value));
 			// adjust the new_val type
 			if (!new_val.setType(getType()))
 			{
@@ -1115,7 +1148,7 @@ bool Variable::updateValue(const Value& value, bool skip_self)
 			// check for change of value
 			if (_reference->_curValue != new_val)
 			{
-				_reference->_curValue = value;
+				_reference->_curValue = std::move(new_val);
 				// Set changed local variable to trigger event
 				changed = true;
 			}
@@ -1130,8 +1163,6 @@ bool Variable::updateValue(const Value& value, bool skip_self)
 	{
 		// Update the converted value
 		_reference->_convertCurValue = convert(_reference->_curValue, false);
-		// Notify all variables referencing this variable that the current value has changed.
-		emitLocalEvent(veValueChange, skip_self);
 	}
 	return changed;
 }
@@ -1244,7 +1275,7 @@ bool Variable::readUpdate(std::istream& is, bool skip_self, PtrVector& list)
 	if (!is.fail() && !is.bad() && value.isValid())
 	{ // GetReferenceById get reference to owner to be able to update readonly vars
 		auto& var(not_ref_null(list) ? getInstanceById(id, list) : const_cast<Variable&>(getInstanceById(id)));
-		var.updateValue(value, skip_self);
+		var.updateValue(std::move(value), skip_self);
 		var.updateFlags(toFlags(flags), skip_self);
 		return true;
 	}
@@ -1269,12 +1300,174 @@ bool Variable::read(std::istream& is, bool skip_self, PtrVector& list)
 	{
 		// Check list for a NULL_REF and use
 		auto& var(not_ref_null(list) ? getInstanceById(id, list) : const_cast<Variable&>(getInstanceById(id)));
-		var.updateValue(value, skip_self);
+		var.updateValue(std::move(value), skip_self);
 		return true;
 	}
 	return false;
 }
 
+namespace
+{
+
+/**
+ * @brief Header of the binary snapshot stream.
+ */
+struct SnapshotHeader
+{
+	char _magic[4];
+	uint32_t _version;
+	uint64_t _count;
+};
+
+/**
+ * @brief Header of a single variable entry in the binary snapshot stream which is followed by the raw value data.
+ */
+struct SnapshotEntry
+{
+	uint64_t _id;
+	int32_t _type;
+	int32_t _flags;
+	uint32_t _size;
+	uint32_t _reserved;
+};
+
+constexpr char SnapshotMagic[4] = {'S', 'F', 'V', 'S'};
+
+}
+
+bool Variable::writeSnapshot(std::ostream& os)
+{
+	// Collect the global references excluding the zero variable.
+	ReferenceVector refs;
+	refs.reserve(VariableStatic::_references->size());
+	for (auto ref: *VariableStatic::_references)
+	{
+		if (ref->_global && ref->_id && ref != VariableStatic::zero()._reference)
+		{
+			refs.add(ref);
+		}
+	}
+	SnapshotHeader hdr{{}, SnapshotVersion, refs.size()};
+	memcpy(hdr._magic, SnapshotMagic, sizeof(hdr._magic));
+	os.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+	for (auto ref: refs)
+	{
+		auto& value(ref->_curValue);
+		SnapshotEntry entry{ref->_id, value.getType(), ref->_curFlags, static_cast<uint32_t>(value.getSize()), 0};
+		os.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+		if (entry._size)
+		{
+			os.write(static_cast<const char*>(value.getBinary()), entry._size);
+		}
+	}
+	// Check if out stream is valid.
+	return !os.fail() && !os.bad();
+}
+
+bool Variable::readSnapshot(std::istream& is, bool skip_self, size_type* count)
+{
+	if (count)
+	{
+		*count = 0;
+	}
+	SnapshotHeader hdr{};
+	if (!is.read(reinterpret_cast<char*>(&hdr), sizeof(hdr))
+		|| memcmp(hdr._magic, SnapshotMagic, sizeof(hdr._magic)) != 0)
+	{
+		SF_NORM_NOTIFY(DO_DEFAULT, "Variable: Snapshot stream format corrupt!")
+		return false;
+	}
+	if (hdr._version > SnapshotVersion)
+	{
+		SF_NORM_NOTIFY(DO_DEFAULT, "Variable: Snapshot version (" << hdr._version << ") not supported!")
+		return false;
+	}
+	// Build a lookup table once instead of a linear search for each entry.
+	std::unordered_map<id_type, VariableReference*> lookup;
+	lookup.reserve(VariableStatic::_references->size());
+	for (auto ref: *VariableStatic::_references)
+	{
+		if (ref->_global && ref->_id && ref != VariableStatic::zero()._reference)
+		{
+			lookup.emplace(ref->_id, ref);
+		}
+	}
+	// Owners of which the value or flags changed and need an event.
+	PtrVector value_changed;
+	PtrVector flags_changed;
+	// Buffer reused for reading the raw value data.
+	std::string buf;
+	bool rv = true;
+	for (uint64_t i = 0; i < hdr._count; i++)
+	{
+		SnapshotEntry entry{};
+		if (!is.read(reinterpret_cast<char*>(&entry), sizeof(entry)) || entry._size > Value::maxBinary + 1)
+		{
+			rv = false;
+			break;
+		}
+		buf.resize(entry._size);
+		if (entry._size && !is.read(buf.data(), entry._size))
+		{
+			rv = false;
+			break;
+		}
+		auto it = lookup.find(entry._id);
+		// Skip unknown identifiers and entries of which the type does not match.
+		if (it == lookup.end() || it->second->_type != entry._type || it->second->_list.empty())
+		{
+			continue;
+		}
+		// The owner is able to update readonly variables.
+		auto owner = it->second->_list[0];
+		if (owner->assignValue(Value(static_cast<Value::EType>(entry._type), buf.data(), entry._size)))
+		{
+			value_changed.add(owner);
+		}
+		if (owner->_reference->_curFlags != entry._flags)
+		{
+			owner->_reference->_curFlags = entry._flags;
+			flags_changed.add(owner);
+		}
+		if (count)
+		{
+			(*count)++;
+		}
+	}
+	SF_COND_NORM_NOTIFY(!rv, DO_DEFAULT, "Variable: Snapshot stream truncated or corrupt!")
+	// Disable deletion of instances while emitting.
+	VariableStatic::_globalActive++;
+	// Generate the list of instances, events and callers before calling any handler
+	// so any changes made by event handlers that could affect the lists is avoided.
+	struct EventEntry
+	{
+		Variable* _var;
+		EEvent _event;
+		Variable* _caller;
+	};
+	std::vector<EventEntry> ev_list;
+	for (auto [changed, event]: {std::pair{&value_changed, veValueChange}, std::pair{&flags_changed, veFlagsChange}})
+	{
+		for (auto owner: *changed)
+		{
+			for (auto var: owner->_reference->_list)
+			{
+				if (var && (!skip_self || var != owner))
+				{
+					ev_list.push_back({var, event, owner});
+				}
+			}
+		}
+	}
+	for (auto& entry: ev_list)
+	{
+		entry._var->emitEvent(entry._event, *entry._caller);
+	}
+	// Enable deletion of instances.
+	VariableStatic::_globalActive--;
+	return rv;
+}
+
 bool Variable::create(std::istream& is, Variable::PtrVector& list, bool global, int& err_line)
 {
 	bool ret_val = true;
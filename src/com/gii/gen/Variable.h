@@ -313,6 +313,15 @@ class _GII_CLASS Variable
 		 */
 		bool setCur(const Value& value, bool skip_self = false);
 
+		/**
+		 * @brief Same as #setCur() but moves the passed value into the variable when possible.
+		 *
+		 * @param value Sets a new current value.
+		 * @param skip_self When 'true' this instance is skipped in emission of events.
+		 * @return True when the value was actually changed.
+		 */
+		bool setCur(Value&& value, bool skip_self = false);
+
 		/**
 		 * @brief Same as #setCur() but for const instances objects of this instance.
 		 *
@@ -322,6 +331,15 @@ class _GII_CLASS Variable
 		 */
 		[[nodiscard]] inline bool setCur(const Value& value, bool skip_self = false) const;
 
+		/**
+		 * @brief Same as #setCur() but for const instances objects of this instance.
+		 *
+		 * @param value Sets a new current value.
+		 * @param skip_self When 'true' this instance is skipped in emission of events.
+		 * @return True when the value was actually changed.
+		 */
+		[[nodiscard]] inline bool setCur(Value&& value, bool skip_self = false) const;
+
 		/**
 		 * @brief Used in settings loading routines which use the owner to Set a new value.
 		 *
@@ -822,6 +840,33 @@ class _GII_CLASS Variable
 		 */
 		static bool read(std::istream& is, bool skip_self = false, PtrVector& list = null_ref<PtrVector>());
 
+		/**
+		 * @brief Current version of the binary snapshot format written by #writeSnapshot().
+		 */
+		static constexpr uint32_t SnapshotVersion = 1;
+
+		/**
+		 * @brief Writes the id, type, current value and current flags of all global variables in a binary form.
+		 *
+		 * The snapshot is versioned and intended for fast saving and restoring of large sets of variables.
+		 * It uses the native byte order so it is not meant to be exchanged between different platforms.
+		 * @param os Output stream which should be opened in binary mode.
+		 * @return True on success.
+		 */
+		static bool writeSnapshot(std::ostream& os);
+
+		/**
+		 * @brief Restores the current values and flags of global variables from a snapshot written by #writeSnapshot().
+		 *
+		 * All values and flags are applied first and the #veValueChange and #veFlagsChange events are emitted
+		 * afterwards in a single batch. Entries of which the id does not exist or the type differs are skipped.
+		 * @param is Input stream which should be opened in binary mode.
+		 * @param skip_self When 'true' the owning instances are skipped in emission of events.
+		 * @param count When not null it receives the amount of variables that were restored.
+		 * @return False when the stream is corrupt or has an incompatible version.
+		 */
+		static bool readSnapshot(std::istream& is, bool skip_self = false, size_type* count = nullptr);
+
 		/**
 		 * Reads multiple variable setup strings from stream separated by newline characters.
 		 * Returns true when no error occurred during the process.
@@ -882,6 +927,31 @@ class _GII_CLASS Variable
 		 */
 		bool updateValue(const Value& value, bool skip_self);
 
+		/**
+		 * @brief Same as #updateValue() but moves the passed value.
+		 *
+		 * @param value
+		 * @param skip_self When 'true' this instance is skipped in emission of events.
+		 * @return True when changed.
+		 */
+		bool updateValue(Value&& value, bool skip_self);
+
+		/**
+		 * @brief Assigns the original non-converted value of this instance without emitting an event.
+		 *
+		 * @param value New current value.
+		 * @return True when changed.
+		 */
+		bool assignValue(const Value& value);
+
+		/**
+		 * @brief Same as #assignValue() but moves the passed value.
+		 *
+		 * @param value New current value.
+		 * @return True when changed.
+		 */
+		bool assignValue(Value&& value);
+
 		/**
 		 * @brief Updates the temporary value of this instance.
 		 * @return True when changed.
@@ -1040,6 +1110,12 @@ inline bool Variable::setCur(const Value& value, bool skip_self) const
 	return const_cast<Variable*>(this)->setCur(value, skip_self);
 }
 
+inline bool Variable::setCur(Value&& value, bool skip_self) const
+{
+	// Cast this pointer to non-const class.
+	return const_cast<Variable*>(this)->setCur(std::move(value), skip_self);
+}
+
 inline bool Variable::isGlobal() const
 {
 	return _global;
@@ -303,7 +303,7 @@ class VariableTypes :public InformationTypes
 			/**
 			 * @brief Internal type of the instance.
 			 */
-			Value::EType _type;
+			Value::EType _type{Value::vitUndefined};
 			/**
 			 * @brief Rounding value. The value is a multiple of this value.
 			 */
@@ -325,6 +325,42 @@ class VariableTypes :public InformationTypes
 			 * @brief A vector of VariableTypes::State` instances.
 			 */
 			State::Vector _states;
+
+			/**
+			 * @brief Compares the fields with those of the passed definition.
+			 *
+			 * @param def Definition to compare with.
+			 * @return Bit mask of the differing #EField fields where the states together are represented by #vfFirstState.
+			 */
+			[[nodiscard]] unsigned compare(const Definition& def) const
+			{
+				unsigned rv = 0;
+				auto differ = [&rv](bool differs, EField field)
+				{
+					if (differs)
+					{
+						rv |= 1u << field;
+					}
+				};
+				differ(_id != def._id, vfId);
+				differ(_name != def._name, vfName);
+				differ(_unit != def._unit, vfUnit);
+				differ(_flags != def._flags, vfFlags);
+				differ(_description != def._description, vfDescription);
+				differ(_type != def._type, vfType);
+				differ(_convertOption != def._convertOption, vfConversionType);
+				differ(_roundValue != def._roundValue, vfRound);
+				differ(_defaultValue != def._defaultValue, vfDefault);
+				differ(_minValue != def._minValue, vfMinimum);
+				differ(_maxValue != def._maxValue, vfMaximum);
+				bool states = _states.size() != def._states.size();
+				for (size_t i = 0; !states && i < _states.size(); i++)
+				{
+					states = _states[i] != def._states[i];
+				}
+				differ(states, vfFirstState);
+				return rv;
+			}
 		};
 };
 
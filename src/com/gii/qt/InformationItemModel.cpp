@@ -3,6 +3,8 @@
 #include "../gen/ResultData.h"
 #include <misc/qt/qt_utils.h>
 #include <misc/qt/Resource.h>
+#include <QTimer>
+#include <unordered_map>
 #include <utility>
 
 namespace sf
@@ -20,6 +22,17 @@ InformationItemModel::TreeItem::TreeItem(InformationItemModel::TreeItem* parent,
 
 InformationItemModel::TreeItem::~TreeItem()
 {
+	// Prevent events from the instances while deleting them.
+	if (_variable)
+	{
+		_variable->setHandler(nullptr);
+		delete _variable;
+	}
+	if (_resultData)
+	{
+		_resultData->setHandler(nullptr);
+		delete _resultData;
+	}
 	qDeleteAll(_childItems);
 }
 
@@ -35,6 +48,54 @@ QStringList InformationItemModel::TreeItem::getNamePath() const
 	return sl;
 }
 
+bool InformationItemModel::TreeItem::lessThan(const TreeItem* i1, const TreeItem* i2)
+{
+	if (i1->_name != i2->_name)
+	{
+		return i1->_name < i2->_name;
+	}
+	// Folders go before other items having the same name.
+	if ((i1->_type == dtFolder) != (i2->_type == dtFolder))
+	{
+		return i1->_type == dtFolder;
+	}
+	return i1->_id < i2->_id;
+}
+
+int InformationItemModel::TreeItem::findRow(const TreeItem* item) const
+{
+	return static_cast<int>(std::lower_bound(_childItems.begin(), _childItems.end(), item, &TreeItem::lessThan) - _childItems.begin());
+}
+
+int InformationItemModel::TreeItem::getRow() const
+{
+	return _parentItem ? _parentItem->findRow(this) : 0;
+}
+
+InformationItemModel::TreeItem* InformationItemModel::TreeItem::findFolder(const QString& name) const
+{
+	// Only the name and type are used by the compare function.
+	TreeItem key(nullptr, name);
+	auto row = findRow(&key);
+	if (row < _childItems.count() && _childItems.at(row)->_type == dtFolder && _childItems.at(row)->_name == name)
+	{
+		return _childItems.at(row);
+	}
+	return nullptr;
+}
+
+void InformationItemModel::TreeItem::sortChildren()
+{
+	std::sort(_childItems.begin(), _childItems.end(), &TreeItem::lessThan);
+	for (auto child: _childItems)
+	{
+		if (child->_type == dtFolder)
+		{
+			child->sortChildren();
+		}
+	}
+}
+
 namespace
 {
 enum
@@ -67,6 +128,8 @@ InformationItemModel::InformationItemModel(Gii::SelectionMode mode, Gii::TypeId
 	 , _rootItem(new TreeItem(nullptr, "Root"))
 	 , _mode(mode)
 	 , _idType(idType)
+	 , _variableHandler(this, &InformationItemModel::variableEventHandler)
+	 , _resultDataHandler(this, &InformationItemModel::resultDataEventHandler)
 {
 	_icons[TreeItem::dtFolder] = Resource::getSvgIcon(Resource::getSvgIconResource(Resource::Icon::Folder), QPalette::ColorRole::Mid);
 	_icons[TreeItem::dtVariable] = Resource::getSvgIcon(":icon/svg/variable", QPalette::ColorRole::Mid);
@@ -75,6 +138,17 @@ InformationItemModel::InformationItemModel(Gii::SelectionMode mode, Gii::TypeId
 
 InformationItemModel::~InformationItemModel()
 {
+	// Prevent events from the listening instances while deleting them.
+	if (_variable)
+	{
+		_variable->setHandler(nullptr);
+	}
+	if (_resultData)
+	{
+		_resultData->setHandler(nullptr);
+	}
+	delete _variable;
+	delete _resultData;
 	delete _rootItem;
 }
 
@@ -104,8 +178,7 @@ QModelIndex InformationItemModel::parent(const QModelIndex& child) const
 	{
 		return {};
 	}
-	auto row = childItem->_parentItem->_parentItem->_childItems.indexOf(childItem->_parentItem);
-	return createIndex((int)row, 0, parentItem);
+	return createIndex(parentItem->getRow(), 0, parentItem);
 }
 
 QVariant InformationItemModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -365,95 +438,309 @@ void InformationItemModel::refresh()
 }
 */
 
-InformationItemModel::TreeItem* InformationItemModel::createPath(const QStringList& namePath)
+QModelIndex InformationItemModel::getIndex(TreeItem* item) const
 {
-	// When not empty.
-	if (!namePath.empty())
+	if (!item || item == _rootItem)
 	{
-		auto cur = _rootItem;
-		// Iterate through the name path names.
-		for (auto it = namePath.begin(); it != namePath.end(); it++)
+		return {};
+	}
+	return createIndex(item->getRow(), 0, item);
+}
+
+InformationItemModel::TreeItem* InformationItemModel::insertItem(const std::string& name, Gii::IdType id, int type, bool notify)
+{
+	QStringList namePath;
+	strings sl;
+	for (auto& s: sl.split(name, '|'))
+	{
+		namePath.append(QString::fromStdString(s));
+	}
+	// Splitting an empty name could result in an empty list.
+	if (namePath.isEmpty())
+	{
+		namePath.append(QString());
+	}
+	auto cur = _rootItem;
+	// Find the existing folders.
+	auto it = namePath.cbegin();
+	for (; it + 1 != namePath.cend(); it++)
+	{
+		auto folder = cur->findFolder(*it);
+		if (!folder)
 		{
-			// Find the name in the child list.
-			auto found = std::find_if(cur->_childItems.begin(), cur->_childItems.end(), [&](const TreeItem* i) -> bool
-			{
-				return *it == i->_name && (it + 1) != namePath.end() && i->_type == TreeItem::dtFolder;
-			});
-			// When found.
-			if (found != cur->_childItems.end())
+			break;
+		}
+		cur = folder;
+	}
+	// Create the top item detached to determine its row.
+	auto top = new TreeItem(nullptr, *it);
+	if (it + 1 == namePath.cend())
+	{
+		top->_type = static_cast<TreeItem::DataType>(type);
+		top->_id = id;
+	}
+	auto row = cur->findRow(top);
+	if (notify)
+	{
+		beginInsertRows(getIndex(cur), row, row);
+	}
+	top->_parentItem = cur;
+	cur->_childItems.insert(row, top);
+	// Create new items for the last part of the name list which only have a single child.
+	auto item = top;
+	while (++it != namePath.cend())
+	{
+		item = new TreeItem(item, *it);
+	}
+	item->_type = static_cast<TreeItem::DataType>(type);
+	item->_id = id;
+	_items.insert(id, item);
+	if (notify)
+	{
+		endInsertRows();
+		// The id column of a folder shows the amount of children.
+		if (cur != _rootItem)
+		{
+			auto index = getIndex(cur).siblingAtColumn(vcId);
+			Q_EMIT dataChanged(index, index, {Qt::DisplayRole});
+		}
+	}
+	return item;
+}
+
+void InformationItemModel::addItem(const Variable& var, bool notify)
+{
+	// Do not add ids twice.
+	if (!var.getId() || _items.contains(var.getId()))
+	{
+		return;
+	}
+	auto item = insertItem(var.getName(), var.getId(), TreeItem::dtVariable, notify);
+	// Create a non owner instance to be notified of its removal.
+	item->_variable = new Variable(var);
+	item->_variable->setData<Gii::IdType>(var.getId());
+	item->_variable->setHandler(&_variableHandler);
+}
+
+void InformationItemModel::addItem(const ResultData& rd, bool notify)
+{
+	// Do not add ids twice.
+	if (!rd.getId() || _items.contains(rd.getId()))
+	{
+		return;
+	}
+	auto item = insertItem(rd.getName(), rd.getId(), TreeItem::dtResultData, notify);
+	// Create a non owner instance to be notified of its removal.
+	item->_resultData = new ResultData(rd);
+	item->_resultData->setData<Gii::IdType>(rd.getId());
+	item->_resultData->setHandler(&_resultDataHandler);
+}
+
+void InformationItemModel::unregisterItem(TreeItem* item)
+{
+	if (item->_type == TreeItem::dtFolder)
+	{
+		for (auto child: item->_childItems)
+		{
+			unregisterItem(child);
+		}
+	}
+	else
+	{
+		_items.remove(item->_id);
+		_selected.removeAll(item);
+	}
+}
+
+void InformationItemModel::removeItem(TreeItem* item)
+{
+	// Remove the folders becoming empty as well.
+	while (item->_parentItem != _rootItem && item->_parentItem->_childItems.count() == 1)
+	{
+		item = item->_parentItem;
+	}
+	auto parent = item->_parentItem;
+	auto row = item->getRow();
+	beginRemoveRows(getIndex(parent), row, row);
+	parent->_childItems.removeAt(row);
+	unregisterItem(item);
+	endRemoveRows();
+	delete item;
+	if (parent != _rootItem)
+	{
+		auto index = getIndex(parent).siblingAtColumn(vcId);
+		Q_EMIT dataChanged(index, index, {Qt::DisplayRole});
+	}
+}
+
+void InformationItemModel::setPending(Gii::IdType id)
+{
+	// Schedule only once for the changes collected.
+	if (_pending.isEmpty())
+	{
+		QTimer::singleShot(0, this, &InformationItemModel::applyPending);
+	}
+	_pending.insert(id);
+}
+
+void InformationItemModel::applyPending()
+{
+	// Rebuilding is faster for large amounts of changes.
+	if (_pending.count() > PendingRebuildCount)
+	{
+		updateList();
+		return;
+	}
+	auto pending = std::move(_pending);
+	_pending.clear();
+	for (auto id: pending)
+	{
+		auto item = _items.value(id);
+		if (_idType == Gii::Variable)
+		{
+			auto& var(Variable::getInstanceById(id));
+			// Remove when gone or renamed.
+			if (item && (!var.getId() || item->getNamePath().mid(1).join('|') != QString::fromStdString(var.getName())))
 			{
-				// Restart the loop using the found item when not at the end.
-				if (it + 1 != namePath.end())
-				{
-					cur = *found;
-					continue;
-				}
-				else
-				{
-					// When at the end of the list return the found item.
-					return *found;
-				}
+				removeItem(item);
 			}
-			else
+			addItem(var, true);
+		}
+		else if (_idType == Gii::ResultData)
+		{
+			auto& rd(ResultData::getInstanceById(id));
+			// Remove when gone or renamed.
+			if (item && (!rd.getId() || item->getNamePath().mid(1).join('|') != QString::fromStdString(rd.getName())))
 			{
-				// Create new items for the last part of the name list.
-				for (auto itn = it; itn != namePath.end(); itn++)
-				{
-					cur = new TreeItem(cur, *itn);
-				}
-				return cur;
+				removeItem(item);
 			}
+			addItem(rd, true);
 		}
 	}
-	return nullptr;
+}
+
+void InformationItemModel::variableEventHandler(VariableTypes::EEvent event, const Variable& caller, Variable& link, bool same_inst)
+{
+	(void) same_inst;
+	switch (event)
+	{
+		default:
+			break;
+
+		// Global event for a new ID.
+		case Variable::veNewId:
+			setPending(caller.getId());
+			break;
+
+		// Reference of an item instance was removed or redefined.
+		case Variable::veIdChanged:
+		case Variable::veRemove:
+			if (&link != _variable)
+			{
+				setPending(link.getData<Gii::IdType>());
+			}
+			break;
+	}
+}
+
+void InformationItemModel::resultDataEventHandler(ResultDataTypes::EEvent event, const ResultData& caller, ResultData& link, const Range& range, bool same_inst)
+{
+	(void) range;
+	(void) same_inst;
+	switch (event)
+	{
+		default:
+			break;
+
+		// Global event for a new ID.
+		case ResultData::reNewId:
+			setPending(caller.getId());
+			break;
+
+		// Reference of an item instance was removed or redefined.
+		case ResultData::reIdChanged:
+		case ResultData::reRemove:
+			if (&link != _resultData)
+			{
+				setPending(link.getData<Gii::IdType>());
+			}
+			break;
+	}
 }
 
 void InformationItemModel::updateList()
 {
-	if (_idType == Gii::Variable)
+	beginResetModel();
+	// Clear the current tree.
+	qDeleteAll(_rootItem->_childItems);
+	_rootItem->_childItems.clear();
+	_items.clear();
+	_selected.clear();
+	_pending.clear();
+	// Create the listening instance once.
+	if (_idType == Gii::Variable && !_variable)
 	{
-		auto vl = Variable::getList();
-		std::sort(vl.begin(), vl.end(), [](const Variable* v1, const Variable* v2) -> bool
-		{
-			return v1->getName() < v2->getName();
-		});
-		for (auto v: vl)
+		_variable = new Variable();
+		_variable->setHandler(&_variableHandler);
+	}
+	else if (_idType == Gii::ResultData && !_resultData)
+	{
+		_resultData = new ResultData();
+		_resultData->setHandler(&_resultDataHandler);
+	}
+	// Items are appended and all sorted at once afterward which is faster than inserting sorted.
+	std::unordered_map<std::string, TreeItem*> folders;
+	auto add = [&](const std::string& name, Gii::IdType id, TreeItem::DataType type) -> TreeItem*
+	{
+		auto cur = _rootItem;
+		std::string::size_type start = 0, pos;
+		// Find or create the folders using the name up to the separator as key.
+		while ((pos = name.find('|', start)) != std::string::npos)
 		{
-			QStringList namePath;
-			strings sl;
-			for (auto& s: sl.split(v->getName(), '|'))
+			auto& folder(folders[name.substr(0, pos)]);
+			if (!folder)
 			{
-				namePath.append(QString::fromStdString(s));
+				folder = new TreeItem(cur, QString::fromStdString(name.substr(start, pos - start)));
 			}
-			if (auto item = createPath(namePath))
+			cur = folder;
+			start = pos + 1;
+		}
+		auto item = new TreeItem(cur, QString::fromStdString(name.substr(start)));
+		item->_type = type;
+		item->_id = id;
+		_items.insert(id, item);
+		return item;
+	};
+	if (_idType == Gii::Variable)
+	{
+		for (auto v: Variable::getList())
+		{
+			if (!_items.contains(v->getId()))
 			{
-				item->_type = TreeItem::dtVariable;
-				item->_id = v->getId();
+				auto item = add(v->getName(), v->getId(), TreeItem::dtVariable);
+				// Create a non owner instance to be notified of its removal.
+				item->_variable = new Variable(*v);
+				item->_variable->setData<Gii::IdType>(v->getId());
+				item->_variable->setHandler(&_variableHandler);
 			}
 		}
 	}
 	else if (_idType == Gii::ResultData)
 	{
-		auto rl = ResultData::getList();
-		std::sort(rl.begin(), rl.end(), [](const ResultData* r1, const ResultData* r2) -> bool
+		for (auto r: ResultData::getList())
 		{
-			return r1->getName() < r2->getName();
-		});
-		for (auto r: rl)
-		{
-			QStringList namePath;
-			strings sl;
-			for (auto& s: sl.split(r->getName(), '|'))
+			if (!_items.contains(r->getId()))
 			{
-				namePath.append(QString::fromStdString(s));
-			}
-			if (auto item = createPath(namePath))
-			{
-				item->_type = TreeItem::dtResultData;
-				item->_id = r->getId();
+				auto item = add(r->getName(), r->getId(), TreeItem::dtResultData);
+				// Create a non owner instance to be notified of its removal.
+				item->_resultData = new ResultData(*r);
+				item->_resultData->setData<Gii::IdType>(r->getId());
+				item->_resultData->setHandler(&_resultDataHandler);
 			}
 		}
 	}
+	_rootItem->sortChildren();
+	endResetModel();
 }
 
 void InformationItemModel::toggleSelection(const QModelIndex& index)
@@ -476,6 +763,29 @@ void InformationItemModel::toggleSelection(const QModelIndex& index)
 	dataChanged(index.siblingAtColumn(0), index.siblingAtColumn(0), {Qt::CheckStateRole});
 }
 
+void InformationItemModel::clearSelection()
+{
+	auto selected = std::move(_selected);
+	_selected.clear();
+	for (auto item: selected)
+	{
+		item->_selected = false;
+		// Check boxes are only in the first column.
+		auto index = getIndex(item);
+		Q_EMIT dataChanged(index, index, {Qt::CheckStateRole});
+	}
+}
+
+Gii::SelectionMode InformationItemModel::getSelectionMode() const
+{
+	return _mode;
+}
+
+Gii::TypeId InformationItemModel::getTypeId() const
+{
+	return _idType;
+}
+
 InformationTypes::IdVector InformationItemModel::getSelectedIds() const
 {
 	if (_mode == Gii::Multiple)
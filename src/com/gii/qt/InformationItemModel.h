@@ -2,8 +2,12 @@
 
 #include "../global.h"
 #include <gii/gen/InformationBase.h>
+#include <gii/gen/VariableHandler.h>
+#include <gii/gen/ResultDataHandler.h>
 #include "Namespace.h"
 #include <QIcon>
+#include <QHash>
+#include <QSet>
 #include <QAbstractItemModel>
 
 namespace sf
@@ -11,6 +15,9 @@ namespace sf
 
 /**
  * @brief Item model for viewing Variables in a tree view.
+ *
+ * The tree is kept sorted by name and is updated incrementally when ids are created or removed.
+ * Changes are collected from the events and applied in the event loop using row insert and remove notifications.
  */
 class _GII_CLASS InformationItemModel :public QAbstractItemModel
 {
@@ -80,7 +87,24 @@ class _GII_CLASS InformationItemModel :public QAbstractItemModel
 		[[nodiscard]] InformationTypes::IdVector getSelectedIds() const;
 
 		/**
-		 * @brief Updates the list data.
+		 * @brief Clears the selection of all items.
+		 */
+		void clearSelection();
+
+		/**
+		 * @brief Gets the selection mode passed to the constructor.
+		 */
+		[[nodiscard]] Gii::SelectionMode getSelectionMode() const;
+
+		/**
+		 * @brief Gets the type of ids passed to the constructor.
+		 */
+		[[nodiscard]] Gii::TypeId getTypeId() const;
+
+		/**
+		 * @brief Rebuilds the complete tree which resets the model.
+		 *
+		 * Only needed once since the tree is updated incrementally from then on.
 		 */
 		void updateList();
 
@@ -123,19 +147,106 @@ class _GII_CLASS InformationItemModel :public QAbstractItemModel
 			 */
 			TreeItem* _parentItem{nullptr};
 			/**
-			 * @brief Holds the child elements.
+			 * @brief Holds the child elements sorted using #lessThan().
 			 */
 			QList<TreeItem*> _childItems;
+			/**
+			 * @brief Holds the instance attached to the variable for receiving its events.
+			 */
+			Variable* _variable{nullptr};
+			/**
+			 * @brief Holds the instance attached to the result for receiving its events.
+			 */
+			ResultData* _resultData{nullptr};
 			/**
 			 * @brief Gets the name path of the current item.
 			 */
 			[[nodiscard]] QStringList getNamePath() const;
+			/**
+			 * @brief Gets the row of this item in the parent's child list using a binary search.
+			 */
+			[[nodiscard]] int getRow() const;
+			/**
+			 * @brief Finds the insert position of the passed item in the child list.
+			 */
+			[[nodiscard]] int findRow(const TreeItem* item) const;
+			/**
+			 * @brief Finds the child folder having the passed name.
+			 *
+			 * @return Nullptr when not found.
+			 */
+			[[nodiscard]] TreeItem* findFolder(const QString& name) const;
+			/**
+			 * @brief Sorts the child list of this and all underlying items.
+			 */
+			void sortChildren();
+			/**
+			 * @brief Sort order of items being folders before other items of the same name and then by id.
+			 */
+			static bool lessThan(const TreeItem* i1, const TreeItem* i2);
 		};
 
 		/**
-		 * @brief Creates the needed folder parents and
+		 * @brief Gets the model index of the passed item.
+		 */
+		[[nodiscard]] QModelIndex getIndex(TreeItem* item) const;
+
+		/**
+		 * @brief Creates a leaf item for the passed variable including the missing folders.
+		 *
+		 * @param notify When true the rows inserted are signalled.
+		 */
+		void addItem(const Variable& var, bool notify);
+
+		/**
+		 * @brief Creates a leaf item for the passed result including the missing folders.
+		 *
+		 * @param notify When true the rows inserted are signalled.
+		 */
+		void addItem(const ResultData& rd, bool notify);
+
+		/**
+		 * @brief Creates a leaf item using the '|' separated name including the missing folders.
+		 *
+		 * @param notify When true the rows inserted are signalled.
+		 * @return Created item.
+		 */
+		TreeItem* insertItem(const std::string& name, Gii::IdType id, int type, bool notify);
+
+		/**
+		 * @brief Removes the passed leaf item including folders becoming empty.
+		 */
+		void removeItem(TreeItem* item);
+
+		/**
+		 * @brief Removes the passed item and its children from the id hash and selection.
+		 */
+		void unregisterItem(TreeItem* item);
+
+		/**
+		 * @brief Collects the id for applying changes and schedules #applyPending().
+		 */
+		void setPending(Gii::IdType id);
+
+		/**
+		 * @brief Applies the changes of the collected ids.
+		 */
+		void applyPending();
+
+		/**
+		 * @brief Handles the events of the listening variable and the variable instances of the items.
+		 */
+		void variableEventHandler(VariableTypes::EEvent event, const Variable& caller, Variable& link, bool same_inst);
+
+		/**
+		 * @brief Handles the events of the listening result and the result instances of the items.
+		 */
+		void resultDataEventHandler(ResultDataTypes::EEvent event, const ResultData& caller, ResultData& link, const Range& range, bool same_inst);
+
+		/**
+		 * @brief Amount of pending changes above which the complete tree is rebuilt.
 		 */
-		TreeItem* createPath(const QStringList& namePath);
+		static constexpr qsizetype PendingRebuildCount = 1000;
 		/**
 		 * @brief Determines the multiple or single selection mode.
 		 */
@@ -148,8 +259,34 @@ class _GII_CLASS InformationItemModel :public QAbstractItemModel
 		 * @brief Holds the root item
 		 */
 		TreeItem* _rootItem;
-
+		/**
+		 * @brief Holds the leaf items by id.
+		 */
+		QHash<Gii::IdType, TreeItem*> _items;
+		/**
+		 * @brief Holds the ids having changed since the last #applyPending().
+		 */
+		QSet<Gii::IdType> _pending;
+		/**
+		 * @brief Holds the selected items.
+		 */
 		QList<TreeItem*> _selected;
+		/**
+		 * @brief Hook to variable events.
+		 */
+		TVariableHandler<InformationItemModel> _variableHandler;
+		/**
+		 * @brief Hook to result data events.
+		 */
+		TResultDataHandler<InformationItemModel> _resultDataHandler;
+		/**
+		 * @brief Listening instance for receiving new variable ids.
+		 */
+		Variable* _variable{nullptr};
+		/**
+		 * @brief Listening instance for receiving new result ids.
+		 */
+		ResultData* _resultData{nullptr};
 
 		QIcon _icons[3];
 };
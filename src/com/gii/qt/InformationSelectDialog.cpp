@@ -147,14 +147,22 @@ InformationTypes::IdVector InformationSelectDialog::execute(Gii::SelectionMode m
 {
 	_settings = settings ? settings : getGlobalSettings();
 	_mode = mode;
-	// Delete previous model when it exists.
-	delete_null(_itemModel);
-	// Create a new model for the given type and selection mode.
-	_itemModel = new InformationItemModel(mode, idType, this);
-	// Fill the model.
-	_itemModel->updateList();
-	// Assign the model.
-	_proxyModel->setSourceModel(_itemModel);
+	// The model keeps itself up to date so reuse it when the type and selection mode are the same.
+	if (_itemModel && _itemModel->getSelectionMode() == mode && _itemModel->getTypeId() == idType)
+	{
+		_itemModel->clearSelection();
+	}
+	else
+	{
+		// Delete previous model when it exists.
+		delete_null(_itemModel);
+		// Create a new model for the given type and selection mode.
+		_itemModel = new InformationItemModel(mode, idType, this);
+		// Fill the model.
+		_itemModel->updateList();
+		// Assign the model.
+		_proxyModel->setSourceModel(_itemModel);
+	}
 	// Resize the columns.
 	resizeColumnsToContents(ui->treeView);
 	// Restore the settings for this instance.
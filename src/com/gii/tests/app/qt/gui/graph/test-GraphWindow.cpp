@@ -10,6 +10,7 @@
 GraphWindow::GraphWindow(QWidget* parent)
 	:QDialog(parent)
 	 , ui(new Ui::GraphWindow)
+	 , _graph(palette())
 {
 	ui->setupUi(this);
 	// Set an icon on the window.
@@ -24,6 +25,21 @@ GraphWindow::GraphWindow(QWidget* parent)
 	{
 		ui->drawWidget->update();
 	});
+	connect(&_timer, &QTimer::timeout, [&]()
+	{
+		ui->drawWidget->update();
+	});
+	connect(ui->cbAnimate, &QCheckBox::toggled, [&](bool checked)
+	{
+		checked ? _timer.start(0) : _timer.stop();
+	});
+	connect(ui->cbCache, &QCheckBox::toggled, [&](bool checked)
+	{
+		_graph.setCaching(checked);
+		// Restart the measurement.
+		_paintTime = _paintCount = 0;
+		ui->drawWidget->update();
+	});
 	for (auto i: {ui->cbDebug, ui->cbLeft, ui->cbRight, ui->cbTop, ui->cbBottom})
 	{
 		connect(i, &QCheckBox::clicked, [&]()
@@ -40,32 +56,20 @@ void GraphWindow::onSlider(int pos)
 
 void GraphWindow::onPaint(QPaintEvent* event)
 {
-	sf::Graph graph(palette());
+	// Kept between paints so its cached layer is reused when nothing changed.
+	auto& graph(_graph);
 	graph._debug = ui->cbDebug->isChecked();
-	//
-	if (ui->cbLeft->isChecked())
-	{
-		graph.setRuler(sf::Draw::roLeft, 0, 10, 2, "V");
-		//graph.setRuler(sf::Draw::roLeft, 0, 10, 2, "Y1");
-	}
-	if (ui->cbRight->isChecked())
-	{
-		graph.setRuler(sf::Draw::roRight, 0, 10, 2, "Y2");
-		//graph.setRuler(sf::Draw::roRight, 10e-2, -20e-2, 3, "sec");
-	}
-	if (ui->cbTop->isChecked())
-	{
-		graph.setRuler(sf::Draw::roTop, 0, 10, 2, "X1");
-		//graph.setRuler(sf::Draw::roTop, -5e03, 10e03, 2, "m/s");
-	}
+	// A ruler having zero digits is disabled.
+	graph.setRuler(sf::Draw::roLeft, 0, 10, ui->cbLeft->isChecked() ? 2 : 0, "V");
+	//graph.setRuler(sf::Draw::roLeft, 0, 10, 2, "Y1");
+	graph.setRuler(sf::Draw::roRight, 0, 10, ui->cbRight->isChecked() ? 2 : 0, "Y2");
+	//graph.setRuler(sf::Draw::roRight, 10e-2, -20e-2, 3, "sec");
+	graph.setRuler(sf::Draw::roTop, 0, 10, ui->cbTop->isChecked() ? 2 : 0, "X1");
+	//graph.setRuler(sf::Draw::roTop, -5e03, 10e03, 2, "m/s");
 	auto start = ui->leValueStart->text().toDouble();
 	auto stop = ui->leValueStop->text().toDouble();
-
-	if (ui->cbBottom->isChecked())
-	{
-		graph.setRuler(sf::Draw::roBottom, start, stop, 3, "s");
-		//graph.setRuler(sf::Draw::roBottom, 0, 10, 2, "X2");
-	}
+	graph.setRuler(sf::Draw::roBottom, start, stop, ui->cbBottom->isChecked() ? 3 : 0, "s");
+	//graph.setRuler(sf::Draw::roBottom, 0, 10, 2, "X2");
 	//
 	graph.setGrid(sf::Draw::goHorizontal, sf::Draw::roLeft);
 	graph.setGrid(sf::Draw::goVertical, sf::Draw::roBottom);
@@ -78,5 +82,14 @@ void GraphWindow::onPaint(QPaintEvent* event)
 	int ofs = ui->slider->value();
 	rc.adjust(ofs, ofs, ofs * -2, ofs * -2);
 
+	QElapsedTimer timer;
+	timer.start();
 	graph.paint(painter, rc, event->region());
+	_paintTime += timer.nsecsElapsed();
+	// Show the average over a number of paints.
+	if (++_paintCount >= 100 || !_timer.isActive())
+	{
+		ui->lblPaintTime->setText(QString("%1 us").arg(double(_paintTime) / _paintCount / 1000.0, 0, 'f', 1));
+		_paintTime = _paintCount = 0;
+	}
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <QDialog>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <misc/qt/Graph.h>
 
 namespace Ui {class GraphWindow;}
 
@@ -18,6 +21,14 @@ class GraphWindow :public QDialog
 	private:
 		// Pointer to the main window.
 		Ui::GraphWindow* ui;
+		// Graph kept between paints to use its cached layer.
+		sf::Graph _graph;
+		// Timer repainting continuously like a graph receiving data.
+		QTimer _timer;
+		// Accumulated paint time in nanoseconds.
+		qint64 _paintTime{0};
+		// Amount of paints accumulated.
+		int _paintCount{0};
 
 		void onSlider(int pos);
 };
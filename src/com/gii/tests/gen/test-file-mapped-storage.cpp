@@ -2,9 +2,33 @@
 #include <string>
 #include <iostream>
 #include <utility>
+#include <chrono>
+#include <iomanip>
+#include <filesystem>
+#include <thread>
 #include <misc/gen/TVector.h>
 #include <gii/gen/FileMappedStorage.h>
 
+namespace
+{
+
+/**
+ * @brief Gets the amount of open file descriptors of this process.
+ */
+size_t getDescriptorCount()
+{
+	size_t rv = 0;
+#if !IS_WIN
+	for ([[maybe_unused]] auto& entry: std::filesystem::directory_iterator("/proc/self/fd"))
+	{
+		rv++;
+	}
+#endif
+	return rv;
+}
+
+}
+
 TEST_CASE("sf::FileMappedStorage", "[result]")
 {
 	SECTION("Storage:Creation")
@@ -76,5 +100,179 @@ Block Count: 1000
 		std::clog << "Client: " << handler_client << std::endl;
 */
 	}
+
+	SECTION("Storage:Arena")
+	{
+		typedef int32_t block_type;
+		size_t blocks_per_seg = 1000;
+		for (auto backing: {sf::FileMappedStorage::bkArenaFile, sf::FileMappedStorage::bkArenaMemory})
+		{
+			sf::FileMappedStorage::Options options;
+			options.backing = backing;
+			options.shared = true;
+			auto fd_count = getDescriptorCount();
+			auto ds1 = new sf::FileMappedStorage(blocks_per_seg, sizeof(block_type), 0, options);
+			auto ds2 = new sf::FileMappedStorage(blocks_per_seg, sizeof(block_type), 0, options);
+#if !IS_WIN
+			// Storages having the same options share the arena.
+			REQUIRE(ds1->getArena());
+			REQUIRE(ds1->getArena() == ds2->getArena());
+#endif
+			REQUIRE(ds1->reserve(blocks_per_seg * 20));
+			REQUIRE(ds2->reserve(blocks_per_seg * 20));
+			// A single descriptor is used for all segments of both storages.
+			CHECK(getDescriptorCount() <= fd_count + 1);
+			sf::TVector<block_type> buffer_write(blocks_per_seg * 3);
+			for (size_t i = 0; i < buffer_write.size(); i++)
+			{
+				buffer_write[i] = static_cast<block_type>(i);
+			}
+			sf::TVector<block_type> buffer_read(buffer_write.size());
+			// Write across segment boundaries in both storages.
+			REQUIRE(ds1->blockWrite(blocks_per_seg / 2, buffer_write.size(), buffer_write.data()));
+			REQUIRE(ds2->blockWrite(blocks_per_seg * 5, buffer_write.size(), buffer_write.data()));
+			REQUIRE(ds1->blockRead(blocks_per_seg / 2, buffer_read.size(), buffer_read.data()));
+			REQUIRE(buffer_write == buffer_read);
+			REQUIRE(ds2->blockRead(blocks_per_seg * 5, buffer_read.size(), buffer_read.data()));
+			REQUIRE(buffer_write == buffer_read);
+#if !IS_WIN
+			auto arena = ds1->getArena();
+			CHECK(arena->getAllocated() == arena->getFileSize());
+			// Released ranges are reused.
+			delete ds1;
+			CHECK(arena->getAllocated() < arena->getFileSize());
+			ds1 = new sf::FileMappedStorage(blocks_per_seg, sizeof(block_type), 0, options);
+			REQUIRE(ds1->reserve(blocks_per_seg * 20));
+			CHECK(arena->getAllocated() == arena->getFileSize());
+#endif
+			delete ds1;
+			delete ds2;
+		}
+	}
+	SECTION("Storage:Preallocate")
+	{
+		typedef int32_t block_type;
+		size_t blocks_per_seg = 1000;
+		// Waits for the background thread to have the expected spare count.
+		auto wait_spares = [](const sf::FileMappedStorage& ds, sf::FileMappedStorage::size_type count)
+		{
+			for (int i = 0; i < 500 && ds.getSpareCount() != count; i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+			return ds.getSpareCount() == count;
+		};
+		sf::FileMappedStorage::Options options;
+		options.preallocate = 4;
+		options.watermark = 2;
+		sf::FileMappedStorage ds(blocks_per_seg, sizeof(block_type), 0, options);
+		// Spare segments are created on construction.
+		REQUIRE(wait_spares(ds, 4));
+		// Taking one is above the watermark and does not refill.
+		REQUIRE(ds.reserve(blocks_per_seg));
+		REQUIRE(ds.getSpareCount() == 3);
+		// Dropping to the watermark fills up again.
+		REQUIRE(ds.reserve(blocks_per_seg * 2));
+		REQUIRE(wait_spares(ds, 4));
+		REQUIRE(ds.reserve(blocks_per_seg * 4));
+		REQUIRE(wait_spares(ds, 4));
+		CHECK(ds.getSpareMisses() == 0);
+		// Taking more than available creates the rest directly.
+		REQUIRE(ds.reserve(blocks_per_seg * 10));
+		CHECK(ds.getSpareMisses() == 2);
+		REQUIRE(wait_spares(ds, 4));
+		// Data written to the pre-allocated segments reads back.
+		sf::TVector<block_type> buffer_write(blocks_per_seg * 3);
+		for (size_t i = 0; i < buffer_write.size(); i++)
+		{
+			buffer_write[i] = static_cast<block_type>(i);
+		}
+		sf::TVector<block_type> buffer_read(buffer_write.size());
+		REQUIRE(ds.blockWrite(blocks_per_seg / 2, buffer_write.size(), buffer_write.data()));
+		REQUIRE(ds.blockRead(blocks_per_seg / 2, buffer_read.size(), buffer_read.data()));
+		REQUIRE(buffer_write == buffer_read);
+		// Recycling limits the spare segments to the ones still to be used.
+		sf::FileMappedStorage ds_recycle(blocks_per_seg, sizeof(block_type), 3, options);
+		REQUIRE(wait_spares(ds_recycle, 3));
+		REQUIRE(ds_recycle.reserve(blocks_per_seg * 10));
+		CHECK(ds_recycle.getSpareCount() == 0);
+		CHECK(ds_recycle.getSpareMisses() == 0);
+		CHECK(ds_recycle.getSize() == blocks_per_seg * sizeof(block_type) * 3);
+	}
+	SECTION("Storage:Limit")
+	{
+		typedef int32_t block_type;
+		size_t blocks_per_seg = 100;
+		auto total = sf::FileMappedStorage::getTotalSize();
+		sf::FileMappedStorage ds(blocks_per_seg, sizeof(block_type));
+		REQUIRE(ds.reserve(blocks_per_seg * 5));
+		CHECK(sf::FileMappedStorage::getTotalSize() == total + blocks_per_seg * sizeof(block_type) * 5);
+		sf::TVector<block_type> buffer_write(blocks_per_seg * 5);
+		for (size_t i = 0; i < buffer_write.size(); i++)
+		{
+			buffer_write[i] = static_cast<block_type>(i);
+		}
+		REQUIRE(ds.blockWrite(0, buffer_write.size(), buffer_write.data()));
+		// Keeping the 2 newest segments evicts the 3 oldest.
+		REQUIRE(ds.limitSegments(2));
+		CHECK_FALSE(ds.limitSegments(1));
+		CHECK(ds.getEvictedCount() == 3);
+		CHECK(ds.getSize() == blocks_per_seg * sizeof(block_type) * 2);
+		CHECK(sf::FileMappedStorage::getTotalSize() == total + blocks_per_seg * sizeof(block_type) * 2);
+		sf::TVector<block_type> buffer_read(blocks_per_seg);
+		CHECK_FALSE(ds.blockRead(0, 1, buffer_read.data()));
+		REQUIRE(ds.blockRead(blocks_per_seg * 4, blocks_per_seg, buffer_read.data()));
+		CHECK(buffer_read[0] == static_cast<block_type>(blocks_per_seg * 4));
+		// Growing reuses the oldest kept segment.
+		REQUIRE(ds.reserve(blocks_per_seg * 6));
+		CHECK(ds.getSegmentCount() == 6);
+		CHECK(ds.getSize() == blocks_per_seg * sizeof(block_type) * 2);
+		REQUIRE(ds.blockRead(blocks_per_seg * 5, 1, buffer_read.data()));
+		CHECK(buffer_read[0] == static_cast<block_type>(blocks_per_seg * 3));
+		// A copy shares the ring of the reference.
+		sf::FileMappedStorage copy(ds);
+		CHECK(copy.getRecycleCount() == 2);
+		CHECK(copy.getEvictedCount() == 3);
+		CHECK(copy.getSize() == ds.getSize());
+		CHECK_FALSE(copy.blockRead(0, 1, buffer_read.data()));
+		REQUIRE(copy.blockRead(blocks_per_seg * 5, 1, buffer_read.data()));
+		CHECK(buffer_read[0] == static_cast<block_type>(blocks_per_seg * 3));
+	}
 }
 
+TEST_CASE("sf::FileMappedStorage-Benchmark", "[.][result][benchmark]")
+{
+	typedef int32_t block_type;
+	// Segments of 1 MiB and a total of 512 MiB.
+	const size_t blocks_per_seg = 1024 * 1024 / sizeof(block_type);
+	const size_t seg_count = 512;
+	sf::TVector<block_type> buffer(blocks_per_seg / 4);
+	for (size_t i = 0; i < buffer.size(); i++)
+	{
+		buffer[i] = static_cast<block_type>(i);
+	}
+	std::clog << "Backing             Reserve(ms)  Write(MiB/s)  Descriptors" << std::endl;
+	for (auto backing: {sf::FileMappedStorage::bkTemporaryFiles, sf::FileMappedStorage::bkArenaFile, sf::FileMappedStorage::bkArenaMemory})
+	{
+		sf::FileMappedStorage::Options options;
+		options.backing = backing;
+		auto fd_count = getDescriptorCount();
+		sf::FileMappedStorage ds(blocks_per_seg, sizeof(block_type), 0, options);
+		auto t0 = std::chrono::steady_clock::now();
+		REQUIRE(ds.reserve(blocks_per_seg * seg_count));
+		auto t1 = std::chrono::steady_clock::now();
+		auto fds = getDescriptorCount() - fd_count;
+		for (size_t ofs = 0; ofs < blocks_per_seg * seg_count; ofs += buffer.size())
+		{
+			REQUIRE(ds.blockWrite(ofs, buffer.size(), buffer.data()));
+		}
+		auto t2 = std::chrono::steady_clock::now();
+		auto reserve_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+		auto write_s = std::chrono::duration<double>(t2 - t1).count();
+		std::clog
+			<< std::left << std::setw(20) << (backing == sf::FileMappedStorage::bkTemporaryFiles ? "TemporaryFiles" : backing == sf::FileMappedStorage::bkArenaFile ? "ArenaFile" : "ArenaMemory")
+			<< std::right << std::setw(11) << std::fixed << std::setprecision(1) << reserve_ms
+			<< std::setw(14) << (double(seg_count) / write_s)
+			<< std::setw(13) << fds << std::endl;
+	}
+}
@@ -0,0 +1,88 @@
+#include <test/catch.h>
+
+#include <vector>
+#include <gii/gen/ResultDataColorizer.h>
+
+extern int debug_level;
+
+TEST_CASE("sf::ResultDataColorizer", "[result]")
+{
+	using Colorizer = sf::ResultDataColorizer;
+	Colorizer colorizer;
+	// Palette of 4 colors to easily tell the index.
+	const std::vector<Colorizer::color_type> palette{0xFF000000, 0xFF000001, 0xFF000002, 0xFF000003};
+	CHECK_FALSE(colorizer.isValid());
+
+	SECTION("Int8")
+	{
+		// Signed data with an offset of 127.
+		REQUIRE(colorizer.setFormat(sf::ResultData::rtInt8, 8, 127));
+		colorizer.setPalette(palette);
+		REQUIRE(colorizer.isValid());
+		CHECK(colorizer.getWindowLow() == -127);
+		CHECK(colorizer.getWindowHigh() == 128);
+		const uint8_t src[] = {0, 63, 64, 127, 128, 191, 192, 255};
+		Colorizer::color_type dest[8];
+		REQUIRE(colorizer.colorize(src, 8, dest));
+		CHECK(std::vector<Colorizer::color_type>(dest, dest + 8) == std::vector<Colorizer::color_type>{
+			palette[0], palette[0], palette[1], palette[1], palette[2], palette[2], palette[3], palette[3]});
+		// Narrow window clips the values outside it.
+		colorizer.setWindowLevel(0, 4);
+		CHECK(colorizer.getWindowLow() == -2);
+		CHECK(colorizer.getWindowHigh() == 1);
+		const uint8_t win[] = {0, 125, 126, 127, 128, 129, 255};
+		REQUIRE(colorizer.colorize(win, 7, dest));
+		CHECK(std::vector<Colorizer::color_type>(dest, dest + 7) == std::vector<Colorizer::color_type>{
+			palette[0], palette[0], palette[1], palette[2], palette[3], palette[3], palette[3]});
+	}
+
+	SECTION("Int16")
+	{
+		// Bits beyond the 12 significant ones are masked.
+		REQUIRE(colorizer.setFormat(sf::ResultData::rtInt16, 12, 0));
+		colorizer.setPalette(Colorizer::grayscale(4096));
+		const uint16_t src[] = {0, 0xF000, 0x0FFF, 0x0800};
+		Colorizer::color_type dest[4];
+		REQUIRE(colorizer.colorize(src, 4, dest));
+		CHECK(dest[0] == 0xFF000000);
+		CHECK(dest[1] == 0xFF000000);
+		CHECK(dest[2] == 0xFFFFFFFF);
+		CHECK(dest[3] == 0xFF7F7F7F);
+	}
+
+	SECTION("Int32")
+	{
+		REQUIRE(colorizer.setFormat(sf::ResultData::rtInt32, 24, 1024));
+		colorizer.setPalette(palette);
+		colorizer.setWindow(1000, 0);
+		CHECK(colorizer.getWindowLow() == 0);
+		const uint32_t src[] = {0, 1024, 1024 + 249, 1024 + 251, 1024 + 751, 1024 + 5000, 0xFF000000};
+		Colorizer::color_type dest[7];
+		REQUIRE(colorizer.colorize(src, 7, dest));
+		CHECK(std::vector<Colorizer::color_type>(dest, dest + 7) == std::vector<Colorizer::color_type>{
+			palette[0], palette[0], palette[0], palette[1], palette[3], palette[3], palette[0]});
+	}
+
+	SECTION("Rows")
+	{
+		REQUIRE(colorizer.setFormat(sf::ResultData::rtInt64, 64, 0));
+		colorizer.setPalette(palette);
+		colorizer.setWindow(0, 3);
+		// Rows of 3 values in a destination having a stride of 4 pixels.
+		const uint64_t src[] = {0, 1, 2, 3, 2, 1};
+		std::vector<Colorizer::color_type> dest(8, 0);
+		REQUIRE(colorizer.colorize(src, 3, 2, dest.data(), 4 * sizeof(Colorizer::color_type)));
+		CHECK(dest == std::vector<Colorizer::color_type>{palette[0], palette[1], palette[2], 0, palette[3], palette[2], palette[1], 0});
+		CHECK(colorizer.getStatistics().pixels == 6);
+		colorizer.resetStatistics();
+		CHECK(colorizer.getStatistics().pixels == 0);
+	}
+
+	SECTION("Invalid")
+	{
+		CHECK_FALSE(colorizer.setFormat(sf::ResultData::rtString, 8, 0));
+		colorizer.setPalette(palette);
+		Colorizer::color_type dest;
+		CHECK_FALSE(colorizer.colorize("", 1, &dest));
+	}
+}
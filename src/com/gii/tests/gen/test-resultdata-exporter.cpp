@@ -0,0 +1,133 @@
+#include <test/catch.h>
+
+#include <cstring>
+#include <sstream>
+#include <gii/gen/ResultDataExporter.h>
+
+extern int debug_level;
+
+TEST_CASE("sf::ResultDataExporter", "[result]")
+{
+	sf::ResultData::initialize();
+	{
+		// Offset of 100 and significant bits of 8 to check the value conversion.
+		sf::ResultData rd1(std::string("0x30,Export|One,S,Exported one.,INT16,1,8,8,100"));
+		sf::ResultData rd2(std::string("0x31,Export|Two,S,Exported two.,INT32,2,4,32,0"));
+		REQUIRE(rd1.setAccessRange({0, 12}, false));
+		REQUIRE(rd2.setAccessRange({0, 12}, false));
+		for (sf::Range::size_type i = 0; i < 12; i++)
+		{
+			// Bits above the significant ones are masked.
+			uint16_t v1 = 0xF00 | static_cast<uint16_t>(i * 10);
+			int32_t v2[2] = {static_cast<int32_t>(i), static_cast<int32_t>(i * 1000)};
+			REQUIRE(rd1.blockWrite(i, 1, &v1));
+			REQUIRE(rd2.blockWrite(i, 1, v2));
+		}
+		rd1.commitValidations();
+		rd2.commitValidations();
+
+		sf::ResultDataExporter exporter;
+		REQUIRE(exporter.add(0x30));
+		REQUIRE(exporter.add(0x31));
+		CHECK_FALSE(exporter.add(0x3F));
+		CHECK(exporter.getCount() == 2);
+
+		SECTION("CSV")
+		{
+			sf::ResultDataExporter::Options options;
+			// Small chunks and multiple threads to exercise the ordering.
+			options.chunkSize = 5;
+			options.threads = 4;
+			exporter.setOptions(options);
+			std::ostringstream os;
+			REQUIRE(exporter.write(os, {2, 9}));
+			std::string expected = "Index,Export|One,Export|Two[0],Export|Two[1]\n";
+			for (int i = 2; i < 9; i++)
+			{
+				expected += std::to_string(i) + ',' + std::to_string(i * 10 - 100) + ',' + std::to_string(i) + ',' + std::to_string(i * 1000) + '\n';
+			}
+			CHECK(os.str() == expected);
+			CHECK(exporter.getStatistics().blocks == 7);
+			CHECK(exporter.getStatistics().readBytes == 7 * (2 + 8));
+			CHECK(exporter.getStatistics().writtenBytes == expected.size());
+		}
+
+		SECTION("Raw")
+		{
+			sf::ResultDataExporter::Options options;
+			options.format = sf::ResultDataExporter::efRaw;
+			exporter.setOptions(options);
+			std::ostringstream os;
+			REQUIRE(exporter.write(os, {0, 12}));
+			auto text = os.str();
+			REQUIRE(text.size() == 12 * (2 + 8));
+			// Blocks of each index are concatenated.
+			uint16_t v1;
+			int32_t v2[2];
+			std::memcpy(&v1, text.data() + 3 * 10, sizeof(v1));
+			std::memcpy(v2, text.data() + 3 * 10 + 2, sizeof(v2));
+			CHECK(v1 == (0xF00 | 30));
+			CHECK(v2[0] == 3);
+			CHECK(v2[1] == 3000);
+		}
+
+		SECTION("Columnar")
+		{
+			sf::ResultDataExporter::Options options;
+			options.format = sf::ResultDataExporter::efColumnar;
+			options.chunkSize = 8;
+			exporter.setOptions(options);
+			std::ostringstream os;
+			REQUIRE(exporter.write(os, {0, 12}));
+			std::istringstream is(os.str());
+			auto read = [&]()
+			{
+				uint64_t value = 0;
+				is.read(reinterpret_cast<char*>(&value), sizeof(value));
+				return value;
+			};
+			CHECK(read() == sf::ResultDataExporter::ColumnarMagic);
+			CHECK(read() == sf::ResultDataExporter::ColumnarVersion);
+			REQUIRE(read() == 2);
+			CHECK(read() == 0);
+			CHECK(read() == 12);
+			for (auto rd: {&rd1, &rd2})
+			{
+				std::string setup(read(), '\0');
+				is.read(setup.data(), static_cast<std::streamsize>(setup.size()));
+				CHECK(setup == rd->getSetupString());
+			}
+			// Two batches of 8 and 4 blocks.
+			CHECK(read() == 0);
+			CHECK(read() == 8);
+			is.ignore(8 * 2);
+			int32_t v2[16];
+			is.read(reinterpret_cast<char*>(v2), sizeof(v2));
+			CHECK(v2[14] == 7);
+			CHECK(v2[15] == 7000);
+			CHECK(read() == 8);
+			CHECK(read() == 4);
+			is.ignore(4 * (2 + 8));
+			CHECK(is.good());
+			CHECK(is.peek() == std::char_traits<char>::eof());
+		}
+
+		SECTION("Invalid")
+		{
+			std::ostringstream os;
+			// Not validated beyond the written range.
+			REQUIRE(rd1.setAccessRange({0, 20}, false));
+			CHECK_FALSE(exporter.write(os, {10, 14}));
+			CHECK_FALSE(exporter.getError().empty());
+			sf::ResultDataExporter::Options options;
+			options.force = true;
+			exporter.setOptions(options);
+			exporter.clear();
+			CHECK_FALSE(exporter.write(os, {0, 2}));
+			REQUIRE(exporter.add(0x30));
+			CHECK(exporter.write(os, {10, 14}));
+			CHECK(exporter.getStatistics().blocks == 4);
+		}
+	}
+	sf::ResultData::uninitialize();
+}
@@ -0,0 +1,62 @@
+#include <test/catch.h>
+
+#include <gii/gen/ResultDataGovernor.h>
+
+TEST_CASE("sf::ResultDataGovernor", "[gii][resultdata]")
+{
+	sf::Variable::initialize();
+	sf::ResultData::initialize();
+	// Scoped so all instances are gone before uninitializing.
+	{
+		sf::ResultDataGovernor governor;
+		governor.setup(0x7000, "Governor");
+		// Client instances of the budget, used, peak, limited, evicted and reserved variables.
+		sf::Variable v_budget, v_used, v_peak, v_limited, v_evicted, v_reserved;
+		REQUIRE(v_budget.setup(0x7000));
+		REQUIRE(v_used.setup(0x7001));
+		REQUIRE(v_peak.setup(0x7002));
+		REQUIRE(v_limited.setup(0x7003));
+		REQUIRE(v_evicted.setup(0x7004));
+		REQUIRE(v_reserved.setup(0x7005));
+		CHECK(v_budget.getName() == "Governor|Budget");
+		CHECK(v_budget.getCur().getInteger() == 0);
+		CHECK(v_used.isReadOnly());
+
+		SECTION("Budget")
+		{
+			REQUIRE(v_budget.setCur(sf::Value(1000)));
+			CHECK(sf::ResultData::getStorageBudget() == 1000);
+			// Negative values mean unlimited.
+			REQUIRE(v_budget.setCur(sf::Value(-1)));
+			CHECK(sf::ResultData::getStorageBudget() == 0);
+		}
+
+		SECTION("Usage")
+		{
+			auto usage = sf::ResultData::getStorageUsage();
+			CHECK(v_used.getCur().getInteger() == static_cast<sf::Value::int_type>(usage.used));
+			// Each result has 5 segments of 20 blocks of 4 bytes.
+			sf::ResultData r_low(std::string("0x7100,Low,S,Low priority data.,INT32,1,20,24,1024"));
+			sf::ResultData r_high(std::string("0x7101,High,S,High priority data.,INT32,1,20,24,1024"));
+			REQUIRE(r_high.setPriority(1));
+			REQUIRE(v_budget.setCur(sf::Value(static_cast<sf::Value::int_type>(usage.used + 600))));
+			REQUIRE(r_low.setAccessRange({0, 100}, false));
+			governor.update();
+			// The usage follows the storage growing.
+			CHECK(v_used.getCur().getInteger() == static_cast<sf::Value::int_type>(usage.used + 400));
+			CHECK(v_peak.getCur().getInteger() >= v_used.getCur().getInteger());
+			CHECK(v_reserved.getCur().getInteger() == static_cast<sf::Value::int_type>(sf::ResultData::getTotalReservedSize()));
+			CHECK(v_limited.getCur().getInteger() == static_cast<sf::Value::int_type>(usage.limited));
+			// Exceeding the budget limits the low priority result which shows up in the variables.
+			REQUIRE(r_high.setAccessRange({0, 100}, false));
+			governor.update();
+			CHECK(v_limited.getCur().getInteger() == static_cast<sf::Value::int_type>(usage.limited + 1));
+			CHECK(v_evicted.getCur().getInteger() > static_cast<sf::Value::int_type>(usage.evicted));
+			CHECK(v_used.getCur().getInteger() <= static_cast<sf::Value::int_type>(usage.used + 600));
+		}
+	}
+	// Leave the budget unlimited for other tests.
+	sf::ResultData::setStorageBudget(0);
+	sf::ResultData::uninitialize();
+	sf::Variable::uninitialize();
+}
@@ -0,0 +1,185 @@
+#include <test/catch.h>
+
+#include <iostream>
+#include <gii/gen/ResultData.h>
+#include <gii/gen/ResultDataRequester.h>
+#include <misc/gen/Sustain.h>
+
+extern int debug_level;
+
+namespace
+{
+
+/**
+ * Server answering the requests of the index and data results when told to.
+ */
+struct Server :sf::ResultDataHandler
+{
+	// Each index block holds the stop of the data range of 4 blocks.
+	static constexpr sf::Range::size_type DataPerIndex = 4;
+
+	Server()
+		:_index(std::string("0x10,Index,S,Requester index.,INT64,1,100,64,0"))
+		 , _data(std::string("0x11,Data,S,Requester data.,INT32,1,100,32,0"))
+	{
+		_index.setHandler(this);
+		_data.setHandler(this);
+	}
+
+	~Server() override
+	{
+		_index.setHandler(nullptr);
+		_data.setHandler(nullptr);
+	}
+
+	void resultDataEventHandler(EEvent event, const sf::ResultData& call_res, sf::ResultData& link_res, const sf::Range& range, bool same_inst) override
+	{
+		if (event == reGetRange)
+		{
+			_pending.add({&link_res, range});
+		}
+	}
+
+	// Answers the requests pending at the time of the call and returns the amount answered.
+	size_t answer()
+	{
+		size_t rv = 0;
+		for (auto count = _pending.count(); count; count--)
+		{
+			auto req = _pending.first();
+			_pending.detachAt(0);
+			sf::TVector<int64_t> buf(req.second.getSize());
+			for (sf::Range::size_type i = 0; i < req.second.getSize(); i++)
+			{
+				buf[i] = static_cast<int64_t>((req.second.getStart() + i + 1) * (req.first == &_index ? DataPerIndex : 1));
+			}
+			if (req.first == &_data)
+			{
+				// Data blocks are 32 bits so pack the values.
+				auto p = reinterpret_cast<int32_t*>(buf.data());
+				for (sf::Range::size_type i = 0; i < req.second.getSize(); i++)
+				{
+					p[i] = static_cast<int32_t>(buf[i]);
+				}
+			}
+			CHECK(req.first->blockWrite(req.second, buf.data()));
+			req.first->commitValidations();
+			rv++;
+		}
+		// The requester handles the result events on the next sustain tick.
+		sf::SustainBase::callSustain();
+		return rv;
+	}
+
+	sf::ResultData _index;
+	sf::ResultData _data;
+	sf::TVector<std::pair<sf::ResultData*, sf::Range>> _pending;
+};
+
+/**
+ * Client collecting the events of the requester.
+ */
+struct Client :sf::ResultDataHandler
+{
+	void resultDataEventHandler(EEvent event, const sf::ResultData& call_res, sf::ResultData& link_res, const sf::Range& range, bool same_inst) override
+	{
+		if (event == (EEvent) sf::ResultDataRequester::reDataValid)
+		{
+			_valid.add(range);
+		}
+	}
+
+	sf::Range::Vector _valid;
+};
+
+}
+
+TEST_CASE("sf::ResultDataRequester", "[result]")
+{
+	sf::ResultData::initialize();
+	{
+		Server server;
+		Client client;
+		sf::ResultData r_index, r_data;
+		r_index.setup(0x10, true);
+		r_data.setup(0x11, true);
+		REQUIRE(r_index.getId() == 0x10);
+		REQUIRE(r_data.getId() == 0x11);
+		REQUIRE(server._index.setAccessRange({0, 100}, false));
+		REQUIRE(server._data.setAccessRange({0, 100 * Server::DataPerIndex}, false));
+		sf::ResultDataRequester requester;
+		requester.setHandler(&client);
+		requester.attachIndex(&r_index);
+		requester.attachData(&r_data);
+
+		SECTION("Single")
+		{
+			REQUIRE(requester.requestIndex(10));
+			CHECK(requester.getState() == sf::ResultDataRequester::drsWait);
+			CHECK(client._valid.isEmpty());
+			// Index first and then the data.
+			CHECK(server.answer() == 1);
+			CHECK(requester.getDataRange() == sf::Range(40, 44));
+			CHECK(server.answer() == 1);
+			REQUIRE(client._valid.count() == 1);
+			CHECK(client._valid[0] == sf::Range(10, 11));
+			CHECK(requester.getState() == sf::ResultDataRequester::drsReady);
+			CHECK(requester.getOutstanding() == 0);
+			CHECK(requester.getMetrics().completed == 1);
+			// Valid data is served immediately.
+			REQUIRE(requester.requestIndex(10));
+			CHECK(client._valid.count() == 2);
+			CHECK(server._pending.isEmpty());
+		}
+
+		SECTION("Pipelined")
+		{
+			requester.setCancelStale(false);
+			requester.setReadahead(0);
+			requester.setMaxOutstanding(2);
+			REQUIRE(requester.requestIndex(20));
+			REQUIRE(requester.requestIndex(30));
+			// Maximum amount in flight is reached.
+			CHECK_FALSE(requester.requestIndex(40));
+			CHECK(requester.getOutstanding() == 2);
+			// Both index requests are out at the same time.
+			CHECK(server.answer() == 2);
+			CHECK(server.answer() == 2);
+			REQUIRE(client._valid.count() == 2);
+			CHECK(client._valid[0] == sf::Range(20, 21));
+			CHECK(client._valid[1] == sf::Range(30, 31));
+			CHECK(requester.getMetrics().completed == 2);
+		}
+
+		SECTION("Cancel and prefetch")
+		{
+			REQUIRE(requester.requestIndex(50));
+			// Moving forward cancels the previous request and prefetches the next ranges.
+			REQUIRE(requester.requestIndex(51));
+			CHECK(requester.getMetrics().cancelled == 1);
+			CHECK(requester.getMetrics().prefetched == 2);
+			CHECK(requester.getOutstanding() == 3);
+			// The index request of the cancelled one was withdrawn from the result.
+			CHECK_FALSE(r_index.cancelIndexRange(sf::Range(50, 51)));
+			while (server.answer())
+			{
+			}
+			// Only the latest request emits an event.
+			REQUIRE(client._valid.count() == 1);
+			CHECK(client._valid[0] == sf::Range(51, 52));
+			CHECK(requester.getOutstanding() == 0);
+			// Next step is served by the prefetch.
+			REQUIRE(requester.requestIndex(52));
+			CHECK(requester.getMetrics().prefetchHits == 1);
+			REQUIRE(client._valid.count() == 2);
+			CHECK(client._valid[1] == sf::Range(52, 53));
+			if (debug_level)
+			{
+				requester.getStatus(std::clog);
+			}
+		}
+
+		requester.release();
+	}
+	sf::ResultData::uninitialize();
+}
@@ -4,6 +4,11 @@
 #include <string>
 #include <iostream>
 #include <utility>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <misc/gen/Sustain.h>
 #include <gii/gen/ResultData.h>
 
 extern int debug_level;
@@ -412,7 +417,223 @@ TEST_CASE("sf::ResultData", "[result]")
 		});
 	}
 
+	SECTION("Storage:Budget")
+	{
+		// Each result has 5 segments of 20 blocks of 4 bytes.
+		sf::ResultData r_low(std::string("0x2,Low,S,Low priority data.,INT32,1,20,24,1024"));
+		sf::ResultData r_high(std::string("0x3,High,S,High priority data.,INT32,1,20,24,1024"));
+		REQUIRE(r_high.setPriority(1));
+		CHECK(r_high.getPriority() == 1);
+		ResHandler handler_low;
+		r_low.setHandler(&handler_low);
+		auto usage = sf::ResultData::getStorageUsage();
+		// Budget of 1.5 results divides in quotas of a third and two thirds.
+		sf::ResultData::setStorageBudget(600);
+		CHECK(sf::ResultData::getStorageBudget() == 600);
+		REQUIRE(r_low.setAccessRange({0, 100}, false));
+		CHECK(r_low.getSegmentCount() == 5);
+		CHECK_FALSE(r_low.isFlag(sf::ResultData::flgRecycle));
+		// Exceeding the budget converts the low priority result to ring mode.
+		REQUIRE(r_high.setAccessRange({0, 100}, false));
+		CHECK(r_low.getStorageQuota() == 200);
+		CHECK(r_high.getStorageQuota() == 400);
+		CHECK(r_low.isFlag(sf::ResultData::flgRecycle));
+		CHECK_FALSE(r_high.isFlag(sf::ResultData::flgRecycle));
+		CHECK(sf::ResultData::getStorageUsage().limited == usage.limited + 1);
+		CHECK(sf::ResultData::getStorageUsage().evicted == usage.evicted + 240);
+		CHECK(sf::ResultData::getStorageUsage().used <= 600);
+		// Oldest blocks of the limited result are no longer readable even when forced.
+		int32_t value;
+		CHECK_FALSE(r_low.blockRead(0, 1, &value, true));
+		CHECK(r_low.blockRead(99, 1, &value, true));
+		// The flag change is signaled when the owner writes next.
+		auto flag_events = [&]() {
+			return std::count_if(handler_low._events.begin(), handler_low._events.end(), [](const ResEvent& ev) {
+				return ev._event == sf::ResultData::reFlagsChange;
+			});
+		};
+		CHECK(flag_events() == 0);
+		REQUIRE(r_low.blockWrite(99, 1, &value));
+		CHECK(flag_events() == 1);
+		REQUIRE(r_low.blockWrite(99, 1, &value));
+		CHECK(flag_events() == 1);
+		sf::ResultData::setStorageBudget(0);
+	}
+
+	SECTION("Data:Statistics")
+	{
+		// Blocks of 2 values having an offset of 100.
+		sf::ResultData rd(std::string("0x4,Stats,S,Statistics data.,INT16,2,16,16,100"));
+		REQUIRE(rd.setAccessRange({0, 40}, false));
+		// Values repeat 0 to 9 except for a single high and low value.
+		sf::TVector<uint16_t> buf(80);
+		for (size_t i = 0; i < buf.count(); i++)
+		{
+			buf[i] = 100 + i % 10;
+		}
+		buf[25] = 100 + 50;
+		buf[61] = 100 - 20;
+		REQUIRE(rd.blockWrite({0, 40}, buf.data()));
+		rd.commitValidations();
+		sf::ResultData::Statistics stats;
+		REQUIRE(rd.getStatistics({0, 40}, stats, 9));
+		CHECK(stats.count == 80);
+		CHECK(stats.sum == 384);
+		CHECK(stats.minimum == -20);
+		CHECK(stats.minimumIndex == 61);
+		CHECK(stats.maximum == 50);
+		CHECK(stats.maximumIndex == 25);
+		CHECK(stats.above == 9);
+		CHECK(stats.getMean() == Approx(4.8));
+		CHECK(stats.getRms() == Approx(std::sqrt(5154.0 / 80)));
+		// Indices are absolute element indices.
+		REQUIRE(rd.getStatistics({10, 20}, stats));
+		CHECK(stats.count == 20);
+		CHECK(stats.sum == 135);
+		CHECK(stats.minimumIndex == 20);
+		CHECK(stats.maximumIndex == 25);
+		// Values outside the limits are not counted.
+		sf::TVector<sf::ResultData::size_type> bins(5);
+		REQUIRE(rd.getHistogram({0, 40}, 0, 10, bins));
+		CHECK(bins == sf::TVector<sf::ResultData::size_type>{15, 16, 15, 16, 16});
+		// Ranges not validated fail.
+		CHECK_FALSE(rd.getStatistics({30, 45}, stats));
+		CHECK(stats.count == 0);
+	}
+
+	SECTION("Events:Queued")
+	{
+		// Group not started so delivery only happens when called.
+		sf::SustainGroup group;
+		ResHandler handler_client;
+		sf::ResultData r_server(std::string("0x5,Queued,S,Queued events.,INT32,1,20,24,1024"));
+		sf::ResultData r_client;
+		r_client.setHandler(&handler_client);
+		REQUIRE(r_client.setup(0x5, true));
+		handler_client._events.clear();
+		handler_client.setDeliveryGroup(&group);
+		CHECK(handler_client.getDeliveryGroup() == &group);
+		sf::TVector<int32_t> buf(15);
+		REQUIRE(r_server.blockWrite(0, 10, buf.data(), true));
+		r_server.commitValidations(false);
+		REQUIRE(r_server.blockWrite(10, 5, buf.data(), true));
+		r_server.commitValidations(false);
+		// Nothing delivered yet and the second access and commit events are merged.
+		CHECK(handler_client._events.empty());
+		CHECK(handler_client.getPending() == 3);
+		auto counters = handler_client.getCounters();
+		CHECK(counters.queued == 3);
+		CHECK(counters.merged == 2);
+		CHECK(counters.dropped == 0);
+		group.call();
+		CHECK(handler_client.getCounters().delivered == 3);
+		REQUIRE(handler_client._events == ResEvent::Vector{
+			{
+				{sf::ResultData::reReserve, &r_server, &r_client, false, 0x5, "(0,20,0)"},
+				{sf::ResultData::reAccessChange, &r_server, &r_client, false, 0x5, "(0,15,5)"},
+				{sf::ResultData::reCommitted, &r_server, &r_client, false, 0x5, "(0,15,5)"},
+			}
+		});
+		handler_client._events.clear();
+		// Events exceeding the capacity are dropped.
+		handler_client.setDeliveryGroup(&group, 1);
+		r_server.setFlag(sf::ResultData::flgArchive, false);
+		REQUIRE(r_server.blockWrite(15, 1, buf.data(), true));
+		r_server.commitValidations(false);
+		CHECK(handler_client.getPending() == 1);
+		CHECK(handler_client.getCounters().dropped == 2);
+		// Clearing is delivered directly and makes the pending events obsolete.
+		r_server.clearValidations(false);
+		CHECK(handler_client.getPending() == 1);
+		CHECK(handler_client.getCounters().dropped == 3);
+		REQUIRE(handler_client._events.count() == 1);
+		CHECK(handler_client._events[0]._event == sf::ResultData::reClear);
+		// Delivered from the thread of the group.
+		std::atomic<std::thread::id> thread_id;
+		handler_client._callback.assign([&thread_id](sf::ResultData::EEvent, const sf::ResultData&, sf::ResultData&, const sf::Range&, bool)
+		{
+			thread_id = std::this_thread::get_id();
+		});
+		REQUIRE(group.start(sf::TimeSpec(0.01)));
+		auto limit = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (handler_client.getPending() && std::chrono::steady_clock::now() < limit)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		group.stop();
+		CHECK(handler_client.getPending() == 0);
+		CHECK(thread_id.load() != std::this_thread::get_id());
+		handler_client.setDeliveryGroup(nullptr);
+	}
+
+	SECTION("Data:Timestamps")
+	{
+		sf::ResultData r_plain(std::string("0x6,Plain,S,Without timestamps.,INT32,1,8,32,0"));
+		CHECK_FALSE(r_plain.hasTimestamps());
+		CHECK(r_plain.findBlock(0) == sf::ResultData::npos);
+		// Segments of 8 blocks.
+		sf::ResultData rd(std::string("0x7,Stamped,ST,With timestamps.,INT32,1,8,32,0"));
+		REQUIRE(rd.hasTimestamps());
+		CHECK(rd.getFlagsString().find('T') != std::string::npos);
+		REQUIRE(rd.setAccessRange({0, 40}, false));
+		sf::TVector<int32_t> buf(16);
+		// Far from zero so deltas are relative to a base.
+		const sf::ResultData::timestamp_type t0 = 5'000'000'000'000;
+		auto stamp = [&](sf::Range::size_type i)
+		{
+			// Jumps beyond the 32-bit delta range within the third segment.
+			return t0 + static_cast<sf::ResultData::timestamp_type>(i) * 1000 + (i >= 20 ? 10'000'000'000 : 0);
+		};
+		for (sf::Range::size_type i = 0; i < 24; i++)
+		{
+			REQUIRE(rd.blockWrite(i, 1, buf.data(), false, stamp(i)));
+		}
+		rd.commitValidations();
+		sf::ResultData::timestamp_type ts;
+		for (sf::Range::size_type i = 0; i < 24; i++)
+		{
+			REQUIRE(rd.getBlockTime(i, ts));
+			CHECK(ts == stamp(i));
+		}
+		CHECK_FALSE(rd.getBlockTime(24, ts));
+		CHECK(rd.findBlock(t0 - 1) == sf::ResultData::npos);
+		CHECK(rd.findBlock(t0) == 0);
+		CHECK(rd.findBlock(stamp(13)) == 13);
+		CHECK(rd.findBlock(stamp(13) + 999) == 13);
+		CHECK(rd.findBlock(stamp(19) + 1'000'000) == 19);
+		CHECK(rd.findBlock(stamp(21)) == 21);
+		CHECK(rd.findBlock(stamp(23) * 2) == 23);
+		// Rewriting the first block of a segment earlier keeps the time of the following ones.
+		REQUIRE(rd.blockWrite(16, 1, buf.data(), false, stamp(16) - 500));
+		REQUIRE(rd.getBlockTime(16, ts));
+		CHECK(ts == stamp(16) - 500);
+		REQUIRE(rd.getBlockTime(17, ts));
+		CHECK(ts == stamp(17));
+		REQUIRE(rd.getBlockTime(21, ts));
+		CHECK(ts == stamp(21));
+		// Blocks of a single write spanning segments share the timestamp.
+		auto t1 = stamp(30);
+		REQUIRE(rd.blockWrite(24, 12, buf.data(), false, t1));
+		rd.commitValidations();
+		REQUIRE(rd.getBlockTime(24, ts));
+		CHECK(ts == t1);
+		REQUIRE(rd.getBlockTime(35, ts));
+		CHECK(ts == t1);
+		CHECK(rd.findBlock(t1) == 35);
+		CHECK(rd.findBlock(t1 - 1) == 23);
+		// Without a timestamp the current time is used.
+		auto before = sf::ResultData::getTimestamp();
+		REQUIRE(rd.blockWrite(36, 1, buf.data()));
+		auto after = sf::ResultData::getTimestamp();
+		REQUIRE(rd.getBlockTime(36, ts));
+		CHECK(ts >= before);
+		CHECK(ts <= after);
+		// Timestamps are cleared with the data.
+		rd.clearValidations(false);
+		CHECK_FALSE(rd.getBlockTime(0, ts));
+		CHECK(rd.findBlock(t1) == sf::ResultData::npos);
+	}
+
 	sf::ResultData::uninitialize();
 
 }
-
@@ -0,0 +1,90 @@
+#include <test/catch.h>
+
+#include <iostream>
+#include <misc/gen/target.h>
+#include <gii/gen/SharedResultData.h>
+
+extern int debug_level;
+
+// Sharing results is not available on Windows.
+#if !IS_WIN
+
+TEST_CASE("sf::SharedResultData", "[result]")
+{
+	sf::ResultData::initialize();
+	{
+		// Sharing needs the segments to be allocated from an arena.
+		sf::FileMappedStorage::Options options;
+		options.backing = sf::FileMappedStorage::bkArenaMemory;
+		auto default_options = sf::FileMappedStorage::getDefaultOptions();
+		sf::FileMappedStorage::setDefaultOptions(options);
+		sf::ResultData rd(std::string("0x20,Shared,S,Shared data.,INT32,1,20,24,0"));
+		sf::FileMappedStorage::setDefaultOptions(default_options);
+		// Writes the block offset as value.
+		auto write = [&](sf::Range::size_type start, sf::Range::size_type stop)
+		{
+			sf::TVector<int32_t> buf(stop - start);
+			for (auto i = start; i < stop; i++)
+			{
+				buf[i - start] = static_cast<int32_t>(i);
+			}
+			REQUIRE(rd.blockWrite({start, stop}, buf.data()));
+			rd.commitValidations();
+		};
+		REQUIRE(rd.setAccessRange({0, 40}, false));
+		sf::SharedResultData shared;
+		REQUIRE(shared.open(0x20));
+		write(0, 30);
+
+		sf::SharedResultDataReader reader;
+		REQUIRE(reader.open(shared.getName()));
+		sf::SharedResultDataReader::State state;
+		REQUIRE(reader.getState(state));
+		CHECK(state.id == 0x20);
+		CHECK_FALSE(state.closed);
+		CHECK(state.blockSize == sizeof(int32_t));
+		CHECK(state.segmentSize == 20);
+		CHECK(state.segmentCount == 2);
+		CHECK(state.firstSegment == 0);
+		CHECK(state.access == sf::Range(0, 40));
+		CHECK(state.cursor == 30);
+		REQUIRE(state.validated.count() == 1);
+		CHECK(state.validated[0] == sf::Range(0, 30));
+		CHECK(state.definition == rd.getSetupString());
+		if (debug_level)
+		{
+			std::clog << "Shared memory: " << shared.getName() << '\n' << state.definition << std::endl;
+		}
+
+		// Blocks are limited to the segment they start in.
+		sf::Range::size_type sz = 10;
+		auto p = static_cast<const int32_t*>(reader.getBlocks(15, sz));
+		REQUIRE(p);
+		CHECK(sz == 5);
+		CHECK(p[0] == 15);
+		CHECK(p[4] == 19);
+		sz = 10;
+		p = static_cast<const int32_t*>(reader.getBlocks(25, sz));
+		REQUIRE(p);
+		CHECK(sz == 10);
+		CHECK(p[0] == 25);
+		CHECK(reader.isAvailable(25));
+		CHECK_FALSE(reader.isAvailable(45));
+
+		// Following the tail sees the new data in the same mapping.
+		auto sequence = state.sequence;
+		write(30, 40);
+		CHECK(reader.waitForChange(sequence, {0, 1000000}));
+		REQUIRE(reader.getState(state));
+		CHECK(state.cursor == 40);
+		CHECK(p[9] == 34);
+
+		// Closing is seen by the reader.
+		shared.close();
+		REQUIRE(reader.getState(state));
+		CHECK(state.closed);
+	}
+	sf::ResultData::uninitialize();
+}
+
+#endif
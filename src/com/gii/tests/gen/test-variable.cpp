@@ -2,6 +2,7 @@
 
 #include <string>
 #include <iostream>
+#include <sstream>
 #include <utility>
 #include <gii/gen/Variable.h>
 #include <gii/gen/UnitConversionServer.h>
@@ -317,6 +318,10 @@ TEST_CASE("sf::Variable", "[variable]")
 		sf::Variable v_server(definition);
 		REQUIRE(v_server.isValid());
 		REQUIRE(v_server.getSetupString() == def_str);
+		// Comparing definitions returns the differing fields.
+		CHECK(definition.compare(sf::Variable::getDefinition(def_str)) == 0);
+		auto other = sf::Variable::getDefinition("0x1000,High Speed,km/h,A,High speed velocity setting,FLOAT,DOUBLE,0.1,10,0,30,Stop=0");
+		CHECK(definition.compare(other) == ((1u << sf::Variable::vfUnit) | (1u << sf::Variable::vfMaximum) | (1u << sf::Variable::vfFirstState)));
 	}
 
 	SECTION("Local Instance")
@@ -543,6 +548,90 @@ TEST_CASE("sf::Variable", "[variable]")
 		var.setCur(sf::Value(sf::unescape(R"(D:\\Data\\files)")));
 	}
 
+	SECTION("SetCur Move")
+	{
+		sf::Variable v_num;
+		v_num.setup(sf::Variable::getDefinition("0x1000,High Speed,m/s,A,High speed velocity setting,FLOAT,FLOAT,0.1,10,0,20"), 0x400000);
+		sf::Variable v_str;
+		v_str.setup(sf::Variable::getDefinition("0x1001,Label,,A,Label of the session,STRING,,8,Session,,"), 0x400000);
+		// Passing an lvalue leaves it untouched.
+		sf::Value value(1.23);
+		REQUIRE(v_num.setCur(value));
+		CHECK(value == sf::Value(1.23));
+		CHECK(v_num.getCur() == sf::Value(1.2));
+		// Moved values are rounded the same.
+		REQUIRE(v_num.setCur(sf::Value(4.56)));
+		CHECK(v_num.getCur() == sf::Value(4.6));
+		// Moved strings are truncated to the maximum length.
+		sf::Value moved(std::string("Measurement"));
+		REQUIRE(v_str.setCur(std::move(moved)));
+		CHECK(v_str.getCur().getString() == "Measurem");
+		CHECK_FALSE(v_str.setCur(sf::Value("Measurement")));
+	}
+
 	sf::Variable::uninitialize();
 
 }
+
+TEST_CASE("sf::Variable-Snapshot", "[variable][snapshot]")
+{
+	sf::Variable::initialize();
+
+	SECTION("Save/Restore")
+	{
+		VarHandler handler_server;
+		VarHandler handler_client;
+
+		sf::Variable v_flt("0x1000,High Speed,m/s,A,High speed velocity setting,FLOAT,FLOAT,0.1,10,0,20", 0x400000);
+		sf::Variable v_int("0x1001,Mode,,A,Mode of operation,INTEGER,,1,0,0,3", 0x400000);
+		sf::Variable v_str("0x1002,Label,,A,Label of the session,STRING,,0,Session,,", 0x400000);
+		v_flt.setHandler(&handler_server);
+		sf::Variable v_client(0x401000, true);
+		v_client.setHandler(&handler_client);
+
+		REQUIRE(v_flt.setCur(sf::Value(12.3)));
+		REQUIRE(v_int.setCur(sf::Value(2)));
+		REQUIRE(v_str.setCur(sf::Value("Snapshot")));
+		REQUIRE(v_flt.setFlag(sf::Variable::flgParameter));
+
+		std::stringstream ss(std::ios::in | std::ios::out | std::ios::binary);
+		REQUIRE(sf::Variable::writeSnapshot(ss));
+
+		// Change all values and flags before restoring them.
+		REQUIRE(v_flt.setCur(sf::Value(1.0)));
+		REQUIRE(v_int.setCur(sf::Value(0)));
+		REQUIRE(v_str.setCur(sf::Value("Changed")));
+		REQUIRE(v_flt.unsetFlag(sf::Variable::flgParameter));
+		handler_client._events.clear();
+		handler_server._events.clear();
+
+		sf::Variable::size_type count{0};
+		REQUIRE(sf::Variable::readSnapshot(ss, false, &count));
+		CHECK(count == 3);
+		CHECK(v_flt.getCur().getFloat() == 12.3);
+		CHECK(v_int.getCur().getInteger() == 2);
+		CHECK(v_str.getCur().getString() == "Snapshot");
+		CHECK(v_flt.isFlag(sf::Variable::flgParameter));
+		// Events are emitted after all values were applied.
+		CHECK(handler_client._events == VarEvent::Vector{
+			{
+				{sf::Variable::veValueChange, &v_flt, &v_client, false, 0x401000, "12.3"},
+				{sf::Variable::veFlagsChange, &v_flt, &v_client, false, 0x401000, "AP"},
+			}
+		});
+		// Restoring again does not cause any changes.
+		ss.clear();
+		ss.seekg(0);
+		handler_client._events.clear();
+		REQUIRE(sf::Variable::readSnapshot(ss));
+		CHECK(handler_client._events.empty());
+	}
+
+	SECTION("Corrupt")
+	{
+		std::stringstream ss(std::string("Not a snapshot stream"), std::ios::in | std::ios::binary);
+		REQUIRE_FALSE(sf::Variable::readSnapshot(ss));
+	}
+
+	sf::Variable::uninitialize();
+}
@@ -0,0 +1,79 @@
+#include <test/catch.h>
+
+#include <QCoreApplication>
+#include <QSignalSpy>
+#include <gii/gen/Variable.h>
+#include <gii/qt/InformationItemModel.h>
+#include <misc/qt/qt_utils.h>
+
+extern int debug_level;
+
+namespace
+{
+
+// Finds the index having the passed name below the parent.
+QModelIndex find(const QAbstractItemModel& model, const QString& name, const QModelIndex& parent = {})
+{
+	for (int row = 0; row < model.rowCount(parent); row++)
+	{
+		auto index = model.index(row, 0, parent);
+		if (model.data(index, Qt::DisplayRole).toString() == name)
+		{
+			return index;
+		}
+	}
+	return {};
+}
+
+}
+
+TEST_CASE("sf::InformationItemModel", "[gui][qt]")
+{
+	// When not GUI application has been started skip this test.
+	if (!sf::isGuiApplication())
+	{
+		SKIP("QApplication is not running.");
+	}
+
+	sf::Variable::initialize();
+	{
+		sf::Variable v1(std::string("0x1,Model|Folder|First,,S,First variable.,INTEGER,,1,0,0,0"));
+		sf::Variable v2(std::string("0x2,Model|Folder|Second,,S,Second variable.,INTEGER,,1,0,0,0"));
+		sf::InformationItemModel model(sf::Gii::Multiple, sf::Gii::Variable, nullptr);
+		model.updateList();
+		auto folder = find(model, "Folder", find(model, "Model"));
+		REQUIRE(folder.isValid());
+		CHECK(model.rowCount(folder) == 2);
+
+		SECTION("Insert")
+		{
+			QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+			QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+			sf::Variable v3(std::string("0x3,Model|Folder|Between,,S,Sorted between.,INTEGER,,1,0,0,0"));
+			QCoreApplication::processEvents();
+			CHECK(inserted.count() == 1);
+			CHECK(reset.count() == 0);
+			REQUIRE(model.rowCount(folder) == 3);
+			// Items are sorted by name.
+			CHECK(model.data(model.index(0, 0, folder), Qt::DisplayRole).toString() == "Between");
+			CHECK(model.getId(model.index(0, 0, folder)) == 0x3);
+			CHECK(model.parent(model.index(2, 0, folder)) == folder);
+		}
+
+		SECTION("Remove")
+		{
+			QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+			{
+				sf::Variable v3(std::string("0x3,Other|Third,,S,Removed again.,INTEGER,,1,0,0,0"));
+				QCoreApplication::processEvents();
+				CHECK(find(model, "Other").isValid());
+			}
+			QCoreApplication::processEvents();
+			// The folder becoming empty is removed as well.
+			CHECK(removed.count() == 1);
+			CHECK_FALSE(find(model, "Other").isValid());
+			CHECK(model.rowCount(folder) == 2);
+		}
+	}
+	sf::Variable::uninitialize();
+}
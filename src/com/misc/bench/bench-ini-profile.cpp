@@ -0,0 +1,74 @@
+#include <misc/gen/IniProfile.h>
+#include <sstream>
+#include <test/benchmark.h>
+
+namespace
+{
+
+/**
+ * @brief Creates the content of a profile sized like an application settings file.
+ */
+std::string makeProfile(int sections, int keys)
+{
+	std::ostringstream os;
+	for (int s = 0; s < sections; s++)
+	{
+		os << "[Section-" << s << "]\n";
+		for (int k = 0; k < keys; k++)
+		{
+			os << "Key-" << k << "=Value of key " << k << " in section " << s << "\n";
+		}
+		os << "\n";
+	}
+	return os.str();
+}
+
+}// namespace
+
+SF_BENCHMARK("misc/IniProfile/parse")
+{
+	auto content = makeProfile(200, 20);
+	state.setBytes(content.size());
+	state.run(20, [&]() {
+		std::istringstream is(content);
+		sf::IniProfile profile(is);
+		sf::bench::keep(profile);
+	});
+}
+
+SF_BENCHMARK("misc/IniProfile/get-string")
+{
+	std::istringstream is(makeProfile(200, 20));
+	sf::IniProfile profile(is);
+	int n = 0;
+	state.setItems(1);
+	state.run(100000, [&]() {
+		n = (n * 7 + 13) % 4000;
+		profile.setSection("Section-" + std::to_string(n / 20), false);
+		sf::bench::keep(profile.getString("Key-" + std::to_string(n % 20)));
+	});
+}
+
+SF_BENCHMARK("misc/IniProfile/set-string")
+{
+	std::istringstream is(makeProfile(200, 20));
+	sf::IniProfile profile(is);
+	int n = 0;
+	state.setItems(1);
+	state.run(100000, [&]() {
+		n = (n * 7 + 13) % 4000;
+		profile.setSection("Section-" + std::to_string(n / 20));
+		profile.setString("Key-" + std::to_string(n % 20), "Changed value " + std::to_string(n));
+	});
+}
+
+SF_BENCHMARK("misc/IniProfile/write")
+{
+	std::istringstream is(makeProfile(200, 20));
+	sf::IniProfile profile(is);
+	state.run(20, [&]() {
+		std::ostringstream os;
+		profile.write(os);
+		sf::bench::keep(os);
+	});
+}
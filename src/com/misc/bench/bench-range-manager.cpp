@@ -0,0 +1,50 @@
+#include <misc/gen/RangeManager.h>
+#include <test/benchmark.h>
+
+SF_BENCHMARK("misc/RangeManager/request-fulfill")
+{
+	// Clients requesting ranges scattered over a session of a million blocks like a scrolling view.
+	sf::Range::Vector results, fulfilled;
+	sf::RangeManager rm;
+	rm.setManaged({0, 1000000});
+	sf::Range::size_type pos = 0;
+	size_t count = 0;
+	state.setItems(1);
+	state.run(10000, [&]() {
+		sf::Range::id_type id = count % 8 + 1;
+		pos = (pos * 1103515245 + 12345) % (1000000 - 2000);
+		if (rm.request({pos, pos + 2000, id}, results) == sf::RangeManager::rmInaccessible)
+		{
+			// The server makes the missing ranges accessible in parts.
+			for (auto& r: results)
+			{
+				rm.setAccessible(sf::Range(r.getStart(), r.getStop()), fulfilled);
+			}
+		}
+		// Forget the accessible ranges every so often like a flush after recording.
+		if (++count % 500 == 0)
+		{
+			rm.flush();
+			rm.setManaged({0, 1000000});
+		}
+		sf::bench::keep(results);
+	});
+}
+
+SF_BENCHMARK("misc/RangeManager/pending-requests")
+{
+	// Many outstanding requests from several clients before the server replies.
+	sf::Range::Vector results, fulfilled;
+	sf::RangeManager rm;
+	state.setItems(200);
+	state.run(100, [&]() {
+		rm.flush();
+		rm.setManaged({0, 1000000});
+		for (sf::Range::size_type i = 0; i < 200; i++)
+		{
+			rm.request({i * 4000, i * 4000 + 3000, static_cast<sf::Range::id_type>(i % 8 + 1)}, results);
+		}
+		rm.setAccessible(sf::Range(0, 1000000), fulfilled);
+		sf::bench::keep(fulfilled);
+	});
+}
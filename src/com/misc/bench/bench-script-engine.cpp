@@ -0,0 +1,36 @@
+#include <misc/gen/ScriptEngine.h>
+#include <test/benchmark.h>
+
+SF_BENCHMARK("misc/ScriptEngine/calculate-expression")
+{
+	// Expression like the ones used for unit conversions and parameter limits.
+	const std::string script("pow(sin(PI/4), 2.0) * 1000 + 23 % 5.5 - 11 / 2");
+	sf::ScriptEngine engine;
+	sf::Value result;
+	state.run(10000, [&]() {
+		engine.calculate(script, result);
+		sf::bench::keep(result);
+	});
+}
+
+SF_BENCHMARK("misc/ScriptEngine/calculate-string")
+{
+	const std::string script("\"Channel-\" + 12 + \" Gate-\" + 3");
+	sf::ScriptEngine engine;
+	sf::Value result;
+	state.run(10000, [&]() {
+		engine.calculate(script, result);
+		sf::bench::keep(result);
+	});
+}
+
+SF_BENCHMARK("misc/ScriptEngine/calculator-xyz")
+{
+	// Creates an engine for each call.
+	const std::string script("x * 1e6 + y * 2 - z");
+	double x = 0;
+	state.run(10000, [&]() {
+		x += 1e-6;
+		sf::bench::keep(sf::calculator(script, 0.0, x, 2.0, 3.0));
+	});
+}
@@ -0,0 +1,77 @@
+#include <misc/gen/Value.h>
+#include <test/benchmark.h>
+
+SF_BENCHMARK("misc/Value/add-float")
+{
+	sf::Value a(1.5), b(2.25);
+	state.run(1000000, [&]() {
+		sf::bench::keep(a + b);
+	});
+}
+
+SF_BENCHMARK("misc/Value/add-integer")
+{
+	sf::Value a(15), b(225);
+	state.run(1000000, [&]() {
+		sf::bench::keep(a + b);
+	});
+}
+
+SF_BENCHMARK("misc/Value/accumulate-mixed")
+{
+	// Integer and floating point mixed as in script calculations.
+	sf::Value sum(0), step(0.5), factor(3);
+	state.run(1000000, [&]() {
+		sum += step;
+		sum *= factor;
+		sum /= factor;
+		sf::bench::keep(sum);
+	});
+}
+
+SF_BENCHMARK("misc/Value/copy-string")
+{
+	sf::Value a("A string value which is long enough to be allocated.");
+	state.run(1000000, [&]() {
+		sf::Value b(a);
+		sf::bench::keep(b);
+	});
+}
+
+SF_BENCHMARK("misc/Value/to-string")
+{
+	sf::Value a(12345.6789);
+	state.run(100000, [&]() {
+		sf::bench::keep(a.getString());
+	});
+}
+
+SF_BENCHMARK("misc/Value/from-string")
+{
+	const std::string s("12345.6789");
+	state.run(100000, [&]() {
+		sf::Value a(sf::Value::vitFloat);
+		a.assign(sf::Value(s));
+		sf::bench::keep(a);
+	});
+}
+
+SF_BENCHMARK("misc/Value/assign-short-string")
+{
+	// Short strings like units, state names and identifiers.
+	sf::Value a("mm/s"), b(sf::Value::vitString);
+	state.run(1000000, [&]() {
+		b = a;
+		sf::bench::keep(b);
+	});
+}
+
+SF_BENCHMARK("misc/Value/concatenate-short-string")
+{
+	sf::Value a("Gate-"), b(3);
+	state.run(100000, [&]() {
+		sf::Value c(a);
+		c += b;
+		sf::bench::keep(c);
+	});
+}
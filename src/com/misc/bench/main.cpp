@@ -0,0 +1,7 @@
+#define SF_BENCHMARK_MAIN
+#include <test/benchmark.h>
+
+int main(int argc, char* argv[])
+{
+	return sf::bench::main(argc, argv);
+}
@@ -1,55 +1,71 @@
 #include <algorithm>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <sys/stat.h>
 
 #include "DynamicLibraryInfo.h"
+#include "IniProfile.h"
 #include "TDynamicBuffer.h"
 #include "gen_utils.h"
 
+#if !IS_WIN
+	#include <elf.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+
 namespace sf
 {
 
-DynamicLibraryInfo::DynamicLibraryInfo(const DynamicLibraryInfo& dld) = default;
+namespace
+{
 
-void DynamicLibraryInfo::clear()
+/**
+ * @brief Holds the cache and the mutex protecting it.
+ */
+struct
 {
-	directory.clear();
-	filename.clear();
-	name.clear();
-	description.clear();
-}
+		std::mutex mutex;
+		std::unique_ptr<IniProfile> profile;
+} Cache;
 
-std::string DynamicLibraryInfo::path() const
+/**
+ * @brief Splits the block between the markers into name and description.
+ */
+bool splitInformation(const char* data, size_t size, std::string& name, std::string& description, std::string& options)
 {
-	std::string::value_type dir_sep;
-#if IS_WIN
-	dir_sep = '\\';
-#else
-	dir_sep = '/';
-#endif
-	return directory + dir_sep + filename;
+	std::string block(data, size);
+	auto pos = block.find(SF_DL_NAME_SEPARATOR);
+	if (pos == std::string::npos)
+	{
+		return false;
+	}
+	name = block.substr(0, pos);
+	description = block.substr(pos + strlen(SF_DL_NAME_SEPARATOR));
+	// Libraries built before the options were introduced lack the separator.
+	pos = description.rfind(SF_DL_OPTION_SEPARATOR);
+	if (pos != std::string::npos)
+	{
+		options = description.substr(pos + strlen(SF_DL_OPTION_SEPARATOR));
+		description.resize(pos);
+	}
+	return true;
 }
 
-bool DynamicLibraryInfo::read(const std::string& dir, const std::string& fn)
-{
-	std::string::value_type dir_sep;
 #if IS_WIN
-	dir_sep = '\\';
-#else
-	dir_sep = '/';
-#endif
-	std::string filepath = dir + dir_sep + fn;
-	// clear the structure members.
-	clear();
+
+/**
+ * @brief Scans the file in chunks for the markers and returns the block in between.
+ */
+bool scanFile(const std::string& filepath, std::string& name, std::string& description, std::string& options)
+{
 	// Get the markers to look for.
 	const uint64_t mark_beg = *((uint64_t*) (SF_DL_MARKER_BEGIN));
 	const uint64_t mark_end = *((uint64_t*) (SF_DL_MARKER_END));
 	// Set to 1 when the begin marker has been found and to 2 when both are found.
 	int flag = 0;
-	// Sanity check.
-	if (!fileExists(filepath))
-	{
-		return false;
-	}
 	// Create a 16 KByte buffer.
 	DynamicBuffer buf(16 * 1024);
 	// Create the stream.
@@ -125,38 +141,267 @@ bool DynamicLibraryInfo::read(const std::string& dir, const std::string& fn)
 	{
 		// Set get index on the stream.
 		is.seekg(beg_idx, std::ifstream::beg);
-		// Resize the buffer to accommodate the size between the markers and the needed terminating zero.
+		// Resize the buffer to accommodate the size between the markers.
 		buf.resize(end_idx - beg_idx);
 		// Read the data between the markers into the buffer.
 		is.read(buf.c_str(), buf.size());
 		//
 		if (is.good())
 		{
-			// Terminate the character string.
-			buf[buf.size()] = '\0';
-			//
-			char* sep = strstr(buf.c_str(), SF_DL_NAME_SEPARATOR);
-			if (sep != nullptr)
+			return splitInformation(buf.c_str(), buf.size(), name, description, options);
+		}
+	}
+	return false;
+}
+
+#else
+
+/**
+ * @brief Finds the block between the markers in the passed memory range.
+ */
+bool findInformation(const char* data, size_t size, std::string& name, std::string& description, std::string& options)
+{
+	const auto marker_len = strlen(SF_DL_MARKER_BEGIN);
+	auto beg = static_cast<const char*>(::memmem(data, size, SF_DL_MARKER_BEGIN, marker_len));
+	if (beg)
+	{
+		beg += marker_len;
+		auto end = static_cast<const char*>(::memmem(beg, size - (beg - data), SF_DL_MARKER_END, marker_len));
+		if (end)
+		{
+			return splitInformation(beg, end - beg, name, description, options);
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Locates the information section using the ELF section headers.
+ *
+ * @return True when the section was found and the offset and size are set.
+ */
+template<typename Ehdr, typename Shdr>
+bool findElfSection(const char* data, size_t size, size_t& offset, size_t& length)
+{
+	if (size < sizeof(Ehdr))
+	{
+		return false;
+	}
+	auto ehdr = reinterpret_cast<const Ehdr*>(data);
+	// Sanity check the section header table and the section name string table.
+	if (!ehdr->e_shoff || ehdr->e_shentsize != sizeof(Shdr) || ehdr->e_shstrndx >= ehdr->e_shnum
+		|| ehdr->e_shoff + ehdr->e_shnum * sizeof(Shdr) > size)
+	{
+		return false;
+	}
+	auto shdr = reinterpret_cast<const Shdr*>(data + ehdr->e_shoff);
+	auto& strtab(shdr[ehdr->e_shstrndx]);
+	if (strtab.sh_offset + strtab.sh_size > size)
+	{
+		return false;
+	}
+	auto names = data + strtab.sh_offset;
+	for (size_t i = 0; i < ehdr->e_shnum; i++)
+	{
+		if (shdr[i].sh_name < strtab.sh_size && !strncmp(names + shdr[i].sh_name, SF_DL_SECTION_NAME, strtab.sh_size - shdr[i].sh_name))
+		{
+			if (shdr[i].sh_type == SHT_NOBITS || shdr[i].sh_offset + shdr[i].sh_size > size)
 			{
-				// Terminate the name.
-				*sep = '\0';
-				// Move the pointer to the start of the description.
-				sep += strlen(SF_DL_NAME_SEPARATOR);
-				// Assign the name part.
-				name = buf.c_str();
-				// Assign the description part.
-				description = sep;
-				// Assign the directory.
-				directory = dir;
-				// Assign the name.
-				filename = fn;
+				return false;
 			}
+			offset = shdr[i].sh_offset;
+			length = shdr[i].sh_size;
+			return true;
 		}
 	}
-	// Close the file stream.
-	is.close();
-	// Signal failure.
 	return false;
 }
 
+/**
+ * @brief Maps the file and reads the information from the ELF section or else by scanning for the markers.
+ */
+bool scanFile(const std::string& filepath, std::string& name, std::string& description, std::string& options)
+{
+	auto fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	{
+		return false;
+	}
+	bool rv = false;
+	struct stat st{};
+	if (!::fstat(fd, &st) && st.st_size > EI_NIDENT)
+	{
+		auto size = static_cast<size_t>(st.st_size);
+		auto ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr != MAP_FAILED)
+		{
+			auto data = static_cast<const char*>(ptr);
+			size_t offset = 0, length = 0;
+			bool found = false;
+			// Only ELF files of the native byte order have section headers which are usable.
+			if (!memcmp(data, ELFMAG, SELFMAG) && data[EI_DATA] == (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ ? ELFDATA2LSB : ELFDATA2MSB))
+			{
+				if (data[EI_CLASS] == ELFCLASS64)
+				{
+					found = findElfSection<Elf64_Ehdr, Elf64_Shdr>(data, size, offset, length);
+				}
+				else if (data[EI_CLASS] == ELFCLASS32)
+				{
+					found = findElfSection<Elf32_Ehdr, Elf32_Shdr>(data, size, offset, length);
+				}
+			}
+			// Only the section is searched when it was found otherwise the whole file.
+			rv = found ? findInformation(data + offset, length, name, description, options) : findInformation(data, size, name, description, options);
+			::munmap(ptr, size);
+		}
+	}
+	::close(fd);
+	return rv;
+}
+
+#endif
+
+}// namespace
+
+DynamicLibraryInfo::DynamicLibraryInfo(const DynamicLibraryInfo& dld) = default;
+
+void DynamicLibraryInfo::clear()
+{
+	directory.clear();
+	filename.clear();
+	name.clear();
+	description.clear();
+	lazy = false;
+	dependencies.clear();
+	provides.clear();
+}
+
+void DynamicLibraryInfo::setOptions(const std::string& options)
+{
+	lazy = false;
+	dependencies.clear();
+	provides.clear();
+	// Appends the comma separated list following the option name.
+	auto append = [](const std::string& list, std::vector<std::string>& dest)
+	{
+		strings names;
+		for (auto& name: names.explode(list, ","))
+		{
+			name = trim(name);
+			if (!name.empty())
+			{
+				dest.push_back(name);
+			}
+		}
+	};
+	strings opts;
+	for (auto& opt: opts.explode(options, ";"))
+	{
+		opt = trim(opt);
+		if (opt == "lazy")
+		{
+			lazy = true;
+		}
+		else if (opt.find("depends=") == 0)
+		{
+			append(opt.substr(strlen("depends=")), dependencies);
+		}
+		else if (opt.find("provides=") == 0)
+		{
+			append(opt.substr(strlen("provides=")), provides);
+		}
+	}
+}
+
+std::string DynamicLibraryInfo::path() const
+{
+	std::string::value_type dir_sep;
+#if IS_WIN
+	dir_sep = '\\';
+#else
+	dir_sep = '/';
+#endif
+	return directory + dir_sep + filename;
+}
+
+void DynamicLibraryInfo::setCacheFile(const std::string& filepath)
+{
+	std::lock_guard lock(Cache.mutex);
+	// Only when it changes.
+	if (Cache.profile && Cache.profile->getFilepath() == filepath)
+	{
+		return;
+	}
+	// Destruction writes pending changes.
+	Cache.profile.reset(filepath.empty() ? nullptr : new IniProfile(filepath));
+}
+
+bool DynamicLibraryInfo::syncCache()
+{
+	std::lock_guard lock(Cache.mutex);
+	return !Cache.profile || Cache.profile->sync();
+}
+
+bool DynamicLibraryInfo::read(const std::string& dir, const std::string& fn)
+{
+	std::string::value_type dir_sep;
+#if IS_WIN
+	dir_sep = '\\';
+#else
+	dir_sep = '/';
+#endif
+	std::string filepath = dir + dir_sep + fn;
+	// clear the structure members.
+	clear();
+	// Get the size and modification time of the file which also serves as a sanity check.
+	struct stat st{};
+	if (::stat(filepath.c_str(), &st))
+	{
+		return false;
+	}
+	auto size = std::to_string(st.st_size);
+	auto modified = std::to_string(st.st_mtime);
+	std::string options;
+	{
+		std::lock_guard lock(Cache.mutex);
+		// Check the cache for the file having the same size and modification time.
+		if (Cache.profile && Cache.profile->selectSection(filepath)
+			&& Cache.profile->getString("Size") == size && Cache.profile->getString("Modified") == modified)
+		{
+			name = unescape(Cache.profile->getString("Name"));
+			description = unescape(Cache.profile->getString("Description"));
+			options = unescape(Cache.profile->getString("Options"));
+		}
+		else
+		{
+			// Libraries without information are cached as well having an empty name.
+			if (!scanFile(filepath, name, description, options))
+			{
+				name.clear();
+				description.clear();
+				options.clear();
+			}
+			if (Cache.profile)
+			{
+				Cache.profile->setSection(filepath);
+				Cache.profile->setString("Size", size);
+				Cache.profile->setString("Modified", modified);
+				Cache.profile->setString("Name", escape(name));
+				Cache.profile->setString("Description", escape(description));
+				Cache.profile->setString("Options", escape(options));
+			}
+		}
+	}
+	if (name.empty())
+	{
+		return false;
+	}
+	setOptions(options);
+	// Assign the directory.
+	directory = dir;
+	// Assign the name.
+	filename = fn;
+	return true;
+}
+
 }// namespace sf
@@ -3,12 +3,18 @@
 #include "../global.h"
 #include <cstring>
 #include <string>
+#include <vector>
 
 /**
  * Separator between name and description.
  */
 #define SF_DL_NAME_SEPARATOR "\n\n"
 
+/**
+ * Separator between the description and the optional load options.
+ */
+#define SF_DL_OPTION_SEPARATOR "\n@@\n"
+
 /**
  * Defines marker string used to find the start of a naming and description block in a compiled binary
  */
@@ -18,6 +24,22 @@
  */
 #define SF_DL_MARKER_END "\n^*!$@#\n"
 
+/**
+ * Name of the ELF section the naming and description block is placed in so it can be located without scanning.
+ */
+#define SF_DL_SECTION_NAME ".sf_dl_info"
+
+/**
+ * Attribute placing the naming and description block in its own section.
+ */
+#if IS_GNU && !IS_WIN
+	#define SF_DL_SECTION_ATTR __attribute__((section(SF_DL_SECTION_NAME), used))
+#elif IS_GNU
+	#define SF_DL_SECTION_ATTR __attribute__((used))
+#else
+	#define SF_DL_SECTION_ATTR
+#endif
+
 namespace sf
 {
 
@@ -52,6 +74,18 @@ struct _MISC_CLASS DynamicLibraryInfo
 	 * @brief Description of the dynamic library.
 	 */
 		std::string description{};
+		/**
+	 * @brief When true the library is loaded only when first required.
+	 */
+		bool lazy{false};
+		/**
+	 * @brief Names of the dynamic libraries which need to be loaded before this one.
+	 */
+		std::vector<std::string> dependencies{};
+		/**
+	 * @brief Names looked up by the application which load this library when it is lazy.
+	 */
+		std::vector<std::string> provides{};
 
 		/**
 	 * @brief PAth to the library. Combines directory and filename.
@@ -61,12 +95,41 @@ struct _MISC_CLASS DynamicLibraryInfo
 		/**
 	 * @brief Reads the information from the file.
 	 *
+	 * On Linux the information is located using the ELF section headers and
+	 * falls back to scanning the memory mapped file for the markers.
+	 * When a cache file has been set using #setCacheFile() the information is taken from it
+	 * as long as the size and modification time of the file did not change.
 	 * @param dir Directory of the
 	 * @param filename Location of the dynamic library file relative to the directory.
 	 * @return  True on success.
 	 */
 		bool read(const std::string& dir, const std::string& filename);
 
+		/**
+	 * @brief Sets the file used to cache the information read from dynamic libraries.
+	 *
+	 * Passing an empty path disables the cache after writing pending changes.
+	 * @param filepath Path to the cache file.
+	 */
+		static void setCacheFile(const std::string& filepath);
+
+		/**
+	 * @brief Writes pending changes of the cache to file.
+	 *
+	 * @return True on success or when no cache file is set.
+	 */
+		static bool syncCache();
+
+		/**
+	 * @brief Parses the load options string into the #lazy, #dependencies and #provides members.
+	 *
+	 * Options are separated by a ';' character where 'lazy' sets the #lazy flag,
+	 * 'depends=<name>,<name>' adds dependencies by library name and
+	 * 'provides=<name>,<name>' adds the names of registered classes, widgets or file suffixes like '*.ext'.
+	 * @param options Options string.
+	 */
+		void setOptions(const std::string& options);
+
 		/**
 	 * @brief Clears all the members.
 	 */
@@ -6,6 +6,7 @@
 	#include <windows.h>
 #else
 	#include "lnx/FileMapper.h"
+	#include "lnx/FileMapperArena.h"
 #endif
 #if IS_QT
 	#include "qt/FileMapper.h"
@@ -32,4 +33,25 @@ IFileMapper* IFileMapper::instantiate(bool native)
 	}
 }
 
+std::shared_ptr<IFileMapper::Arena> IFileMapper::createArena(bool memory, bool huge_pages)
+{
+#if IS_WIN
+	(void) memory;
+	(void) huge_pages;
+	return {};
+#else
+	return std::make_shared<lnx::FileMapperArena>(memory, huge_pages);
+#endif
+}
+
+IFileMapper* IFileMapper::instantiate(const std::shared_ptr<Arena>& arena)
+{
+#if IS_WIN
+	(void) arena;
+	return new win::FileMapper;
+#else
+	return new lnx::ArenaFileMapper(std::dynamic_pointer_cast<lnx::FileMapperArena>(arena));
+#endif
+}
+
 }// namespace sf
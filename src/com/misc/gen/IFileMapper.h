@@ -2,6 +2,9 @@
 
 #include "../global.h"
 #include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
 
 namespace sf
 {
@@ -56,6 +59,16 @@ class _MISC_CLASS IFileMapper
 		 */
 		virtual void* getPtr() = 0;
 
+		/**
+		 * @brief Gets the offset of the view in the file of the arena it was allocated from.
+		 *
+		 * @return Maximum value when not allocated from an arena.
+		 */
+		[[nodiscard]] virtual size_t getOffset() const
+		{
+			return std::numeric_limits<size_t>::max();
+		}
+
 		/**
 		 * @brief Gets an instance of this interface using a native or non-native (Qt) implementation.
 		 *
@@ -64,6 +77,54 @@ class _MISC_CLASS IFileMapper
 		 * @return
 		 */
 		static IFileMapper* instantiate(bool native);
+
+		/**
+		 * @brief Single file or memory region from which multiple file mappers allocate their views.
+		 *
+		 * Saves a file descriptor and file per mapper when many mappers are needed.
+		 */
+		class _MISC_CLASS Arena
+		{
+			public:
+				/**
+				 * @brief Virtual destructor.
+				 */
+				virtual ~Arena() = default;
+
+				/**
+				 * @brief Gets the amount of bytes allocated by the mappers using this arena.
+				 */
+				[[nodiscard]] virtual size_t getAllocated() const = 0;
+
+				/**
+				 * @brief Gets the size of the underlying file including released ranges.
+				 */
+				[[nodiscard]] virtual size_t getFileSize() const = 0;
+
+				/**
+				 * @brief Gets the path through which another process is able to open the underlying file.
+				 *
+				 * The path is only valid for as long as the arena exists.
+				 */
+				[[nodiscard]] virtual std::string getSharedPath() const = 0;
+		};
+
+		/**
+		 * @brief Creates an arena for passing to #instantiate(const std::shared_ptr<Arena>&).
+		 *
+		 * @param memory True for an anonymous memory file and false for a temporary file on disk.
+		 * @param huge_pages Advises the use of transparent huge pages on the mapped views.
+		 * @return Null when not available on this platform.
+		 */
+		static std::shared_ptr<Arena> createArena(bool memory, bool huge_pages);
+
+		/**
+		 * @brief Gets an instance of this interface allocating its view from the passed arena.
+		 *
+		 * @param arena Arena created using #createArena().
+		 * @return Instance which must be deleted by the caller.
+		 */
+		static IFileMapper* instantiate(const std::shared_ptr<Arena>& arena);
 };
 
 }// namespace sf
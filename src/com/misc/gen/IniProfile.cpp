@@ -1,4 +1,5 @@
 #include <cstring>
+#include <sstream>
 #include <string>
 
 #include "IniProfile.h"
@@ -109,6 +110,8 @@ void IniProfile::flush()
 	}
 	// Flush the pointers in the list.
 	_sections.flush();
+	// Invalidate the section index.
+	_sectionMapValid = false;
 	// Reset the current index.
 	_sectionIndex = npos;
 }
@@ -159,6 +162,8 @@ bool IniProfile::read(std::istream& is)
 			delete_null(section);
 		}
 	}
+	// Sections were added so the index needs to be rebuilt.
+	_sectionMapValid = false;
 	// if eof flag was reason for stopping reading return true as well
 	return (is.good() || is.eof());
 }
@@ -250,6 +255,11 @@ bool IniProfile::setSection(const std::string& section, bool create)
 		s->_name = section;
 		// Add section to the list and make it the current one.
 		_sectionIndex = _sections.add(s);
+		// Add the section to the index when it is valid.
+		if (_sectionMapValid)
+		{
+			_sectionMap.emplace(section, _sectionIndex);
+		}
 		// Set dirty flag
 		_dirty = true;
 		// Tells that section dit not exist at the start of this function
@@ -297,7 +307,7 @@ bool IniProfile::getString(const std::string& key, std::string& value, const std
 		return false;
 	}
 	// Check for valid buffer
-	value = _sections[_sectionIndex]->_entries[p]->_value;
+	value = _sections[_sectionIndex]->entries()[p]->_value;
 	// Signal success.
 	return true;
 }
@@ -349,9 +359,9 @@ IniProfile::Entry* IniProfile::getEntry(IniProfile::size_type p)
 		// Get section pointer
 		Section* section = _sections[_sectionIndex];
 		// Check for valid index
-		if (p < section->_entries.count())
+		if (p < section->entries().count())
 		{// Return entry pointer
-			return section->_entries[p];
+			return section->entries()[p];
 		}
 	}
 	// return entry pointer NULL if not exist
@@ -377,18 +387,22 @@ IniProfile::size_type IniProfile::findSection(const std::string& section) const
 	{
 		return _sectionIndex;
 	}
-	// Loop through section list
-	for (IniProfile::size_type i = 0; i < _sections.count(); i++)
+	// Rebuild the section index when needed.
+	if (!_sectionMapValid)
 	{
-		// Section name is case insensitive compared
-		if (!::strcmp(_sections[i]->_name.c_str(), section.c_str()))
+		_sectionMap.clear();
+		_sectionMap.reserve(_sections.count());
+		for (IniProfile::size_type i = 0; i < _sections.count(); i++)
 		{
-			// Return position
-			return i;
+			// Only the first section having the name is found.
+			_sectionMap.emplace(_sections[i]->_name, i);
 		}
+		_sectionMapValid = true;
 	}
-	// Return UINT_MAX on not found
-	return npos;
+	// Section name is case-sensitive compared.
+	auto it = _sectionMap.find(section);
+	// Return npos on not found.
+	return it == _sectionMap.end() ? npos : it->second;
 }
 
 bool IniProfile::removeSection(IniProfile::size_type p)
@@ -400,6 +414,8 @@ bool IniProfile::removeSection(IniProfile::size_type p)
 		delete_null(_sections[p]);
 		// remove from list
 		_sections.detachAt(p);
+		// Positions have shifted so the index needs to be rebuilt.
+		_sectionMapValid = false;
 		// correct current section index pointer
 		if (p < _sectionIndex)
 		{
@@ -428,11 +444,7 @@ bool IniProfile::removeKeys(IniProfile::size_type section)
 	if (section < _sections.count())
 	{
 		// delete instance
-		for (auto e: _sections[section]->_entries)
-		{
-			delete e;
-		}
-		_sections[section]->_entries.clear();
+		_sections[section]->removeEntries();
 		// Set dirty flag
 		_dirty = true;
 		// Signal success.
@@ -443,6 +455,7 @@ bool IniProfile::removeKeys(IniProfile::size_type section)
 
 IniProfile::Section::~Section()
 {
+	// Content which was not parsed has no entries.
 	EntryVector::iter_type i(_entries);
 	while (i)
 	{
@@ -466,23 +479,16 @@ bool IniProfile::Section::read(std::istream& is)
 			read_to_delim(_name, is, ']');
 			// skip to end of this line
 			skip_to_nextline(is);
-			// check for section start character
+			// Keep the content up to the next section start character for parsing it on first access.
+			std::string line;
 			while (is.good() && is.peek() != '[')
 			{
-				// create empty entry
-				auto entry = new Entry();
-				// read entry from if stream has no errors and entry
-				if (entry->read(is) && entry->isValid())
-				{
-					_entries.add(entry);
-				}
-				else
-				{
-					delete_null(entry);
-				}
+				getline(is, line);
+				_content.append(line).append(1, '\n');
 				// skip empty lines
 				skip_empty_lines(is);
 			}
+			_parsed = _content.empty();
 			// Read of Section succeeded.
 			return true;
 		}
@@ -491,6 +497,52 @@ bool IniProfile::Section::read(std::istream& is)
 	return false;
 }
 
+void IniProfile::Section::parse()
+{
+	std::istringstream is(_content);
+	// Mark parsed before anything else.
+	_parsed = true;
+	while (is.good())
+	{
+		// create empty entry
+		auto entry = new Entry();
+		// read entry from if stream has no errors and entry
+		if (entry->read(is) && entry->isValid())
+		{
+			_entries.add(entry);
+		}
+		else
+		{
+			delete_null(entry);
+		}
+		// skip empty lines
+		skip_empty_lines(is);
+	}
+	// Free the content since it is not needed anymore.
+	std::string().swap(_content);
+	_indexed = false;
+}
+
+IniProfile::EntryVector& IniProfile::Section::entries()
+{
+	if (!_parsed)
+	{
+		parse();
+	}
+	return _entries;
+}
+
+void IniProfile::Section::removeEntries()
+{
+	for (auto e: entries())
+	{
+		delete e;
+	}
+	_entries.clear();
+	_index.clear();
+	_indexed = true;
+}
+
 std::ostream& IniProfile::Section::write(std::ostream& os)// NOLINT(readability-make-member-function-const)
 {
 	// Check stream for errors
@@ -498,7 +550,7 @@ std::ostream& IniProfile::Section::write(std::ostream& os)// NOLINT(readability-
 	{
 		// Write section head
 		os << '[' << _name << ']' << '\n';
-		EntryVector::iter_type i(_entries);
+		EntryVector::iter_type i(entries());
 		// write all entries to the stream
 		while (i)
 		{
@@ -542,8 +594,8 @@ int IniProfile::Section::setEntry(const std::string& key, const std::string& val
 		// if not found
 		else
 		{
-			// Add entry at the end of the section list
-			_entries.add(new Entry(key, value));
+			// Add entry at the end of the section list and to the index.
+			_index.emplace(key, _entries.add(new Entry(key, value)));
 			// Signal change.
 			return 1;
 		}
@@ -564,9 +616,12 @@ bool IniProfile::Section::insertComment(const std::string& key, const std::strin
 		// When found
 		if (p != npos)
 		{
+			// Positions after the inserted one shift so the index needs to be rebuilt.
+			_indexed = false;
 			// Add entry at found location
 			return _entries.addAt(entry, p);
 		}
+		delete entry;
 	}
 	// Comment was not inserted
 	return false;
@@ -577,17 +632,29 @@ IniProfile::EntryVector::size_type IniProfile::Section::findEntry(const std::str
 	// Check if key is valid.
 	if (!key.empty())
 	{
-		EntryVector::size_type idx = 0;
-		// Loop through entry list
-		for (auto e: _entries)
+		// Rebuild the index when needed which also parses the content.
+		if (!_parsed || !_indexed)
 		{
-			// Section name is case-sensitive compared.
-			if (e->_key == key)
+			_index.clear();
+			_index.reserve(entries().count());
+			EntryVector::size_type idx = 0;
+			for (auto e: _entries)
 			{
-				// Return index in list
-				return idx;
+				// Comments have no key and only the first key is found.
+				if (!e->_cmtFlag)
+				{
+					_index.emplace(e->_key, idx);
+				}
+				idx++;
 			}
-			idx++;
+			_indexed = true;
+		}
+		// Key is case-sensitive compared.
+		auto it = _index.find(key);
+		if (it != _index.end())
+		{
+			// Return index in list
+			return it->second;
 		}
 	}
 	// Signal not found.
@@ -596,12 +663,14 @@ IniProfile::EntryVector::size_type IniProfile::Section::findEntry(const std::str
 
 bool IniProfile::Section::removeEntry(EntryVector::size_type index)
 {// check for valid parameters
-	if (index != npos && index < _entries.count())
+	if (index != npos && index < entries().count())
 	{
 		// delete entry instance
 		delete_null(_entries[index]);
 		// remove from list
 		_entries.detachAt(index);
+		// Positions have shifted so the index needs to be rebuilt.
+		_indexed = false;
 		// return true on success
 		return true;
 	}
@@ -666,7 +735,7 @@ bool IniProfile::Entry::read(std::istream& is)
 
 IniProfile::size_type IniProfile::getEntryCount() const
 {
-	return _sections.count() ? _sections[_sectionIndex]->_entries.count() : 0;
+	return _sections.count() ? _sections[_sectionIndex]->entries().count() : 0;
 }
 
 std::string IniProfile::getEntryKey(IniProfile::size_type p)
@@ -688,7 +757,7 @@ strings IniProfile::getKeys(size_type section) const
 	if (section < _sections.count())
 	{
 		// Iterate through the sections entries.
-		for (auto e: _sections.at(_sectionIndex)->_entries)
+		for (auto e: _sections.at(_sectionIndex)->entries())
 		{
 			// Ignore comment lines.
 			if (!e->_cmtFlag)
@@ -763,7 +832,7 @@ IniProfile::KeyValueMap IniProfile::getMap(IniProfile::size_type section) const
 	if (section < _sections.count())
 	{
 		// Iterate through the sections entries.
-		for (auto e: _sections.at(section)->_entries)
+		for (auto e: _sections.at(section)->entries())
 		{
 			// Ignore comment lines.
 			if (!e->_cmtFlag)
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include "../global.h"
 #include "TVector.h"
@@ -347,6 +348,9 @@ class _MISC_CLASS IniProfile
 
 		/**
 		 * @brief Internal storage class for sections.
+		 *
+		 * The entries of a section read from a stream are parsed on first access.
+		 * Keys are looked up through a hash index while the ordered entry vector is kept for writing.
 		 */
 		class _MISC_CLASS Section
 		{
@@ -397,6 +401,11 @@ class _MISC_CLASS IniProfile
 				 */
 				bool removeEntry(EntryVector::size_type index);
 
+				/**
+				 * @brief Removes all entries.
+				 */
+				void removeEntries();
+
 				/**
 				 * @brief Adds comment to before entry specified by the key.
 				 *
@@ -417,20 +426,50 @@ class _MISC_CLASS IniProfile
 				/**
 				 * @brief Read section from an input stream.
 				 *
+				 * Only the name is parsed and the content is kept until the entries are accessed.
 				 * @param is Input stream.
 				 * @return True on success.
 				 */
 				bool read(std::istream& is);
 
+				/**
+				 * @brief Gets the entries and parses the content read from the stream when not done yet.
+				 *
+				 * @return Vector of entries.
+				 */
+				EntryVector& entries();
+
 				/**
 				 * @brief Holds the name of the section
 				 */
 				std::string _name;
 
+			private:
+				/**
+				 * @brief Parses the entries from the content read by #read().
+				 */
+				void parse();
+
 				/**
 				 * @brief Holds the key value pairs.
 				 */
 				EntryVector _entries;
+				/**
+				 * @brief Holds the unparsed content of the section.
+				 */
+				std::string _content;
+				/**
+				 * @brief Set when the content has been parsed into entries.
+				 */
+				bool _parsed{true};
+				/**
+				 * @brief Hash index of the keys to their position in the entries vector.
+				 */
+				std::unordered_map<std::string, EntryVector::size_type> _index;
+				/**
+				 * @brief Set when the index reflects the entries vector.
+				 */
+				bool _indexed{false};
 		};
 
 		/**
@@ -447,6 +486,14 @@ class _MISC_CLASS IniProfile
 		 * Vector holding all sections.
 		 */
 		SectionVector _sections;
+		/**
+		 * Hash index of the section names to their position in the sections vector.
+		 */
+		mutable std::unordered_map<std::string, SectionVector::size_type> _sectionMap;
+		/**
+		 * Set when the section index reflects the sections vector.
+		 */
+		mutable bool _sectionMapValid{false};
 		/**
 		 * current index to section.
 		 */
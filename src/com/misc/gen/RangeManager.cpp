@@ -61,6 +61,20 @@ void RangeManager::flushRequests(Range::id_type id)
 	}
 }
 
+bool RangeManager::flushRequest(const Range& r)
+{
+	for (auto count = _requests.count(); count;)
+	{
+		auto& i = _requests[--count];
+		if (i.getId() == r.getId() && i.getStart() == r.getStart() && i.getStop() == r.getStop())
+		{
+			_requests.detachAt(count);
+			return true;
+		}
+	}
+	return false;
+}
+
 RangeManager::EResult RangeManager::request(const Range& r, Range::Vector& rrl)
 {
 	// Check if the requested range is within the managed range first.
@@ -136,6 +136,13 @@ class _MISC_CLASS RangeManager
 		 */
 		void flushRequests(Range::id_type id);
 
+		/**
+		 * @brief Flushes a single request having the same start, stop and identifier as the passed one.
+		 * @param r Range as passed to #request.
+		 * @return True when the request was found.
+		 */
+		bool flushRequest(const Range& r);
+
 		/**
 		 * @brief Determines if the managed range is automatically determined and set when #setAccessible is called.
 		 * Making a call to #setManaged unnecessary when set to true.
@@ -5,6 +5,7 @@
 #include <cstring>
 
 #include "ScriptEngine.h"
+#include "ScriptTokenizer.h"
 #include "Value.h"
 #include "dbgutils.h"
 #include "gen_utils.h"
@@ -577,7 +578,8 @@ bool ScriptEngine::getName(std::string& name)
 
 bool ScriptEngine::isAlpha(char ch)
 {
-	return isalpha(ch) || (strchr("_", ch) && ch);
+	// Same rule as used for highlighting.
+	return ScriptTokenizer::isNameStart(static_cast<unsigned char>(ch));
 }
 
 void ScriptEngine::eatWhite()
@@ -968,7 +970,7 @@ bool ScriptEngine::arith(Value& result, DataCode& left)// NOLINT(misc-no-recursi
 								{
 									return false;
 								}
-								params.add(loc_res);
+								params.add(std::move(loc_res));
 							} while (_cmd[_pos] != ')');
 						}
 						else
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include "TVector.h"
+
+namespace sf
+{
+
+/**
+ * @brief Splits a line of script text into tokens in a single pass.
+ *
+ * Uses the same character rules as the script engine and interpreter for names, numbers, strings and comments.
+ * A state is passed from line to line to continue block comments which makes it suitable for highlighting
+ * the blocks of a text document individually.
+ * Whitespace does not produce tokens.
+ */
+class ScriptTokenizer
+{
+	public:
+		/**
+		 * @brief Type of token.
+		 */
+		enum EToken :int
+		{
+			/** Identifier starting with an alpha or underscore character.*/
+			tkName,
+			/** Decimal, floating point or hexadecimal number.*/
+			tkNumber,
+			/** Quoted string including the quotes.*/
+			tkString,
+			/** Single line or block comment.*/
+			tkComment,
+			/** Sequence of operator characters.*/
+			tkOperator,
+			/** Single punctuation character.*/
+			tkPunctuator,
+			/** Any other character.*/
+			tkOther,
+		};
+
+		/**
+		 * @brief State passed from one line to the next.
+		 */
+		enum EState :int
+		{
+			/** Line starts in code.*/
+			tsCode = 0,
+			/** Line starts inside a block comment.*/
+			tsComment = 1,
+		};
+
+		/**
+		 * @brief Token position and length in characters.
+		 */
+		struct Token
+		{
+			/**
+			 * @brief Type of the token.
+			 */
+			EToken type;
+			/**
+			 * @brief Start position in the line.
+			 */
+			size_t start;
+			/**
+			 * @brief Length of the token.
+			 */
+			size_t length;
+
+			/**
+			 * @brief Gets the position after the token.
+			 */
+			[[nodiscard]] size_t end() const
+			{
+				return start + length;
+			}
+		};
+
+		/**
+		 * @brief Type for holding the tokens of a line.
+		 */
+		typedef TVector<Token> Vector;
+
+		/**
+		 * @brief Constructor.
+		 *
+		 * @param quotes Characters starting and ending a string.
+		 */
+		explicit ScriptTokenizer(const char* quotes = "\"")
+			:_quotes(quotes) {}
+
+		/**
+		 * @brief Checks if the character starts a name.
+		 */
+		static bool isNameStart(unsigned ch)
+		{
+			return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+		}
+
+		/**
+		 * @brief Checks if the character continues a name.
+		 */
+		static bool isNameChar(unsigned ch)
+		{
+			return isNameStart(ch) || isDigit(ch);
+		}
+
+		/**
+		 * @brief Checks if the character is a decimal digit.
+		 */
+		static bool isDigit(unsigned ch)
+		{
+			return ch >= '0' && ch <= '9';
+		}
+
+		/**
+		 * @brief Checks if the character is a hexadecimal digit.
+		 */
+		static bool isHexDigit(unsigned ch)
+		{
+			return isDigit(ch) || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+		}
+
+		/**
+		 * @brief Checks if the character is one of the passed ASCII characters.
+		 */
+		static bool isOneOf(unsigned ch, const char* chars)
+		{
+			return ch && ch < 0x80 && std::strchr(chars, static_cast<int>(ch));
+		}
+
+		/**
+		 * @brief Tokenizes a line of text.
+		 *
+		 * @tparam C Character type like 'char' or a 16-bit unicode character.
+		 * @param text Pointer to the characters.
+		 * @param length Amount of characters.
+		 * @param state State returned from the previous line.
+		 * @param tokens Receives the tokens which is cleared first.
+		 * @return State for the next line.
+		 */
+		template<typename C>
+		EState tokenize(const C* text, size_t length, EState state, Vector& tokens) const;
+
+	private:
+		/**
+		 * @brief Characters starting and ending a string.
+		 */
+		const char* _quotes;
+};
+
+template<typename C>
+ScriptTokenizer::EState ScriptTokenizer::tokenize(const C* text, size_t length, EState state, Vector& tokens) const
+{
+	tokens.flush();
+	// Get the character as unsigned and zero beyond the end.
+	auto at = [&](size_t i) -> unsigned
+	{
+		return i < length ? static_cast<std::make_unsigned_t<C>>(text[i]) : 0;
+	};
+	size_t i = 0;
+	// Continue a block comment of the previous line.
+	if (state == tsComment)
+	{
+		while (i < length && !(at(i) == '*' && at(i + 1) == '/'))
+		{
+			i++;
+		}
+		if (i >= length)
+		{
+			tokens.add({tkComment, 0, length});
+			return tsComment;
+		}
+		i += 2;
+		tokens.add({tkComment, 0, i});
+	}
+	while (i < length)
+	{
+		auto start = i;
+		auto ch = at(i);
+		// Skip whitespace.
+		if (isOneOf(ch, "\r\n\t "))
+		{
+			i++;
+			continue;
+		}
+		// Look for comment '//'.
+		if (ch == '/' && at(i + 1) == '/')
+		{
+			tokens.add({tkComment, start, length - start});
+			break;
+		}
+		// Look for comment '/*' end '*/'.
+		if (ch == '/' && at(i + 1) == '*')
+		{
+			i += 2;
+			while (i < length && !(at(i) == '*' && at(i + 1) == '/'))
+			{
+				i++;
+			}
+			if (i >= length)
+			{
+				tokens.add({tkComment, start, length - start});
+				return tsComment;
+			}
+			i += 2;
+			tokens.add({tkComment, start, i - start});
+			continue;
+		}
+		// Quoted string where the quote is escaped using a backslash and ends at the end of the line.
+		if (isOneOf(ch, _quotes))
+		{
+			i++;
+			while (i < length && at(i) != ch)
+			{
+				i += (at(i) == '\\') ? 2 : 1;
+			}
+			i = std::min(i + 1, length);
+			tokens.add({tkString, start, i - start});
+			continue;
+		}
+		// Number like the engine converts it.
+		if (isDigit(ch) || (ch == '.' && isDigit(at(i + 1))))
+		{
+			if (ch == '0' && (at(i + 1) == 'x' || at(i + 1) == 'X') && isHexDigit(at(i + 2)))
+			{
+				i += 2;
+				while (isHexDigit(at(i)))
+				{
+					i++;
+				}
+			}
+			else
+			{
+				while (isDigit(at(i)))
+				{
+					i++;
+				}
+				if (at(i) == '.')
+				{
+					i++;
+					while (isDigit(at(i)))
+					{
+						i++;
+					}
+				}
+				// Exponent.
+				if (at(i) == 'e' || at(i) == 'E')
+				{
+					auto e = i + 1;
+					if (at(e) == '+' || at(e) == '-')
+					{
+						e++;
+					}
+					if (isDigit(at(e)))
+					{
+						i = e;
+						while (isDigit(at(i)))
+						{
+							i++;
+						}
+					}
+				}
+			}
+			tokens.add({tkNumber, start, i - start});
+			continue;
+		}
+		// Identifier.
+		if (isNameStart(ch))
+		{
+			while (isNameChar(at(i)))
+			{
+				i++;
+			}
+			tokens.add({tkName, start, i - start});
+			continue;
+		}
+		// Operators are grouped together.
+		if (isOneOf(ch, "=+-*/%^|&!<>~?"))
+		{
+			while (isOneOf(at(i), "=+-*/%^|&!<>~?") && !(at(i) == '/' && (at(i + 1) == '/' || at(i + 1) == '*')))
+			{
+				i++;
+			}
+			tokens.add({tkOperator, start, i - start});
+			continue;
+		}
+		tokens.add({isOneOf(ch, "[](){},:;.") ? tkPunctuator : tkOther, start, 1});
+		i++;
+	}
+	return tsCode;
+}
+
+}
@@ -1,6 +1,8 @@
 #include "Sustain.h"
 #include "gen_utils.h"
 #include "target.h"
+#include <algorithm>
+#include <chrono>
 #if IS_QT
 	#include <QTimer>
 #elif IS_WIN
@@ -13,109 +15,460 @@
 namespace sf
 {
 
-SustainBase::PtrVector* SustainBase::_defaultVector = nullptr;
+namespace
+{
 
-SustainBase::SustainBase(PtrVector* vector, int priority)
-	: _list(vector)
-	, _priority(priority)
-{// Check if the vector is a valid pointer.
-	if (!_list)
-	{// Check also if the default vector has been created.
-		if (!_defaultVector)
-		{// It has not so we create it.
-			_defaultVector = new PtrVector();
-		}
-		// Assign the vector data member with the static default vector pointer value.
-		_list = _defaultVector;
+/**
+ * @brief Gets the nanoseconds passed since the passed time point.
+ */
+inline uint64_t nanosecondsSince(const std::chrono::steady_clock::time_point& tp)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tp).count();
+}
+
+/**
+ * @brief Minimum time the group thread sleeps when an entry is due.
+ */
+const TimeSpec MinimumWait(0.001);
+
+}// namespace
+
+SustainGroup* SustainGroup::_defaultGroup = nullptr;
+
+SustainBase::SustainBase(SustainGroup* group, int priority)
+	: _priority(priority)
+	, _group(group)
+{// Check if the group is a valid pointer.
+	if (!_group)
+	{// Assign the default group which is created when needed.
+		_group = SustainGroup::getDefault();
 	}
 	// When the priority is not spTIMER enable it by default.
 	if (_priority != spTimer)
 	{
-		enable();
+		_timer.enable();
 	}
-	// Order on the priority of the entry priority 0 is the highest.
-	size_t i = _list->count();
-	// Find the insert position based on the entry priority.
-	while (i)
+	// Add this entry to the group.
+	_group.load()->attach(this);
+}
+
+SustainBase::~SustainBase()
+{// Check if the group still exists to detach from.
+	if (auto group = _group.load())
 	{
-		if (_priority > (*_list)[i - 1]->_priority)
+		group->detach(this);
+		// Cleanup the default group if it is empty and not hooked into a timer.
+		if (group == SustainGroup::_defaultGroup && !group->count() && !group->_wakeUp)
 		{
-			break;
+			delete_null(SustainGroup::_defaultGroup);
 		}
-		i--;
 	}
-	// Add this entry to the passed vector at position 'i'.
-	_list->addAt(this, i);
 }
 
-SustainBase::~SustainBase()
-{// Check if the vector still exists to detach from.
-	if (_list)
+void SustainBase::setInterval(const timespec& interval)
+{
+	_timer.set(interval);
+	if (auto group = _group.load())
+	{
+		group->schedule(this);
+	}
+}
+
+void SustainBase::enable()
+{
+	_timer.enable();
+	if (auto group = _group.load())
+	{
+		group->schedule(this);
+	}
+}
+
+void SustainBase::disable()
+{
+	_timer.disable();
+	if (auto group = _group.load())
+	{
+		group->schedule(this);
+	}
+}
+
+void SustainBase::setEventDriven(bool yn)
+{
+	// Timer entries are always driven by their timer.
+	if (_priority == spTimer || _eventDriven == yn)
+	{
+		return;
+	}
+	if (auto group = _group.load())
+	{
+		// Detaching and attaching again moves the entry into the correct list.
+		group->detach(this);
+		_eventDriven = yn;
+		group->attach(this);
+	}
+	else
+	{
+		_eventDriven = yn;
+	}
+}
+
+void SustainBase::notify()
+{
+	// Loaded once since the group can detach the entry from another thread.
+	auto group = _group.load();
+	// Only add the entry to the notified list once.
+	if (group && _eventDriven && !_notified.exchange(true))
+	{
+		group->notify(this);
+	}
+}
+
+void SustainBase::callSustain(SustainGroup* group)
+{
+	if (!group)
+	{
+		group = SustainGroup::_defaultGroup;
+	}
+	if (group)
+	{
+		group->call();
+	}
+}
+
+SustainGroup::~SustainGroup()
+{
+	stop();
+	flush();
+}
+
+SustainGroup* SustainGroup::getDefault()
+{
+	if (!_defaultGroup)
+	{
+		_defaultGroup = new SustainGroup();
+	}
+	return _defaultGroup;
+}
+
+void SustainGroup::attach(SustainBase* entry)
+{
+	std::lock_guard lock(_mutex);
+	entry->_group = this;
+	_entries.add(entry);
+	// Timer and event driven entries are not polled.
+	if (entry->_priority == SustainBase::spTimer)
+	{
+		schedule(entry);
+	}
+	else if (!entry->_eventDriven)
 	{
-		_list->detach(this);
-		// Cleanup the default vector if the vector is empty.
-		if (_list == _defaultVector)
+		// Order on the priority of the entry priority 0 is the highest.
+		auto i = _polled.count();
+		// Find the insert position based on the entry priority.
+		while (i)
 		{
-			size_t count = _defaultVector->count();
-			if (!count)
+			if (entry->_priority > _polled[i - 1]->_priority)
 			{
-				delete_null(_defaultVector);
+				break;
 			}
+			i--;
 		}
-		_list = nullptr;
+		// Add this entry at position 'i'.
+		_polled.addAt(entry, i);
+	}
+	else if (entry->_notified)
+	{
+		std::lock_guard nlock(_notifyMutex);
+		_notified.add(entry);
 	}
 }
 
-void SustainBase::flushVector(PtrVector* vector)
+void SustainGroup::detach(SustainBase* entry)
 {
-	if (vector)
+	std::lock_guard lock(_mutex);
+	_entries.detach(entry);
+	_polled.detach(entry);
+	_due.detach(entry);
+	if (entry->_queued)
 	{
-		PtrVector::iter_type i(*vector);
-		while (i)
+		_timers.erase(entry->_slot);
+		entry->_queued = false;
+	}
+	{
+		// Cleared while holding the notify lock so a concurrent notification cannot add the entry again.
+		std::lock_guard nlock(_notifyMutex);
+		_notified.detach(entry);
+		entry->_group = nullptr;
+	}
+	// Tells the tick calling the entry that it must not be touched anymore.
+	if (_calling == entry)
+	{
+		_calling = nullptr;
+	}
+}
+
+void SustainGroup::schedule(SustainBase* entry)
+{
+	if (entry->_priority != SustainBase::spTimer)
+	{
+		return;
+	}
+	std::lock_guard lock(_mutex);
+	if (entry->_queued)
+	{
+		_timers.erase(entry->_slot);
+		entry->_queued = false;
+	}
+	// Disabled entries are not queued until enabled again.
+	if (entry->_timer.isEnabled())
+	{
+		entry->_slot = _timers.emplace(entry->_timer.getTarget(), entry);
+		entry->_queued = true;
+		// Wake up the thread when the entry became the first to be due and is scheduled from another thread.
+		if (entry->_slot == _timers.begin() && _thread.joinable() && _thread.get_id() != std::this_thread::get_id())
 		{
-			(i++)->_list = nullptr;
+			{
+				std::lock_guard nlock(_notifyMutex);
+				_wake = true;
+			}
+			_condition.notify_one();
 		}
-		vector->flush();
 	}
 }
 
-void SustainBase::callSustain(SustainBase::PtrVector* vector)
+void SustainGroup::notify(SustainBase* entry)
 {
-	if (!vector)
+	TClosure<void> wake_up;
+	{
+		std::lock_guard lock(_notifyMutex);
+		// Detached in the meantime by another thread.
+		if (entry->_group != this)
+		{
+			entry->_notified = false;
+			return;
+		}
+		// Only the first notification needs to wake up the owning thread.
+		if (!_notified.count())
+		{
+			wake_up = _wakeUp;
+		}
+		_notified.add(entry);
+	}
+	_condition.notify_one();
+	if (wake_up)
+	{
+		wake_up();
+	}
+}
+
+bool SustainGroup::callEntry(SustainBase* entry, const timespec& time)
+{
+	// Restored afterwards for when a sustain function calls the group itself.
+	auto calling = _calling;
+	_calling = entry;
+	// Only measured when entry metrics are enabled.
+	auto metrics = _entryMetrics;
+	auto tp = metrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	bool rv = entry->call(time);
+	auto ns = metrics ? nanosecondsSince(tp) : 0;
+	// Detaching during the call could have deleted the entry.
+	bool attached = _calling == entry;
+	_calling = calling;
+	_metrics.calls++;
+	if (!attached)
+	{
+		return false;
+	}
+	if (metrics)
+	{
+		entry->_metrics.calls++;
+		entry->_metrics.total += ns;
+		entry->_metrics.maximum = std::max(entry->_metrics.maximum, ns);
+	}
+	// If the hooked function returns false disable this entry.
+	if (!rv)
 	{
-		vector = _defaultVector;
+		entry->disable();
 	}
-	if (vector)
-	{// Get the clock for all sustain functions.
-		auto time = getTime(false);
-		// Do not use iterator because sustain could affect the vector itself.
-		unsigned i = 0;
-		while (i < vector->count())
+	return true;
+}
+
+void SustainGroup::call()
+{
+	std::lock_guard lock(_mutex);
+	auto tp = std::chrono::steady_clock::now();
+	// Get the clock for all sustain functions.
+	auto time = getTime(false);
+	// Do not use iterator because sustain could affect the vector itself.
+	SustainBase::PtrVector::size_type i = 0;
+	while (i < _polled.count())
+	{
+		auto entry = _polled[i++];
+		// Check if entry was disabled. This may look strange but the timers
+		// enable disable is also used for non timer entries.
+		if (entry->_timer.isEnabled())
+		{
+			callEntry(entry, time);
+		}
+	}
+	// Only the entries notified before this point are called so an entry notifying itself is called on the next tick.
+	size_t count;
+	{
+		std::lock_guard nlock(_notifyMutex);
+		count = _notified.count();
+	}
+	while (count--)
+	{
+		SustainBase* entry;
 		{
-			SustainBase* entry((*vector)[i++]);
-			// Check if the sustain function is on a timer by checking
-			// if the priority has the lowest priority which is spTIMER.
-			//
-			if (entry->_priority == spTimer)
+			std::lock_guard nlock(_notifyMutex);
+			if (!_notified.count())
 			{
-				if (!entry->_timer(time))
-				{
-					continue;
-				}
+				break;
 			}
-			// Check if entry was disabled. This may look strange but the timers
-			// enable disable is also used for non timer entries.
-			if (entry->_timer.isEnabled())
-			{// IF the hooked function returns false disable this entry.
-				if (!entry->call(time))
+			entry = _notified[0];
+			_notified.detachAt(0);
+		}
+		entry->_notified = false;
+		if (entry->_timer.isEnabled())
+		{
+			callEntry(entry, time);
+		}
+	}
+	// Move the timer entries which are due from the queue into a separate list since entries can be detached during calls.
+	while (!_timers.empty() && _timers.begin()->first <= time)
+	{
+		auto entry = _timers.begin()->second;
+		_timers.erase(_timers.begin());
+		entry->_queued = false;
+		_due.add(entry);
+	}
+	while (_due.count())
+	{
+		auto entry = _due[0];
+		_due.detachAt(0);
+		// Sets the next target time and skips rescheduling when the entry was detached during the call.
+		if (!entry->_timer(time) || callEntry(entry, time))
+		{
+			schedule(entry);
+		}
+	}
+	_metrics.ticks++;
+	auto ns = nanosecondsSince(tp);
+	_metrics.total += ns;
+	_metrics.maximum = std::max(_metrics.maximum, ns);
+}
+
+void SustainGroup::run(TimeSpec poll)
+{
+	while (!_terminate)
+	{
+		call();
+		// Determine how long to sleep.
+		bool forever = true;
+		TimeSpec wait(poll);
+		{
+			std::lock_guard lock(_mutex);
+			if (_polled.count())
+			{
+				forever = false;
+			}
+			if (!_timers.empty())
+			{
+				auto left = _timers.begin()->first - getTime(false);
+				if (forever || left < wait)
 				{
-					entry->disable();
+					wait = left;
 				}
+				forever = false;
 			}
 		}
+		// Entries due again immediately like zero interval timers must not make the thread spin.
+		if (!forever && wait < MinimumWait)
+		{
+			wait = MinimumWait;
+		}
+		std::unique_lock lock(_notifyMutex);
+		auto pred = [&]() -> bool {return _terminate || _wake || _notified.count();};
+		if (forever)
+		{
+			_condition.wait(lock, pred);
+		}
+		else
+		{
+			_condition.wait_for(lock, std::chrono::seconds(wait.tv_sec) + std::chrono::nanoseconds(wait.tv_nsec), pred);
+		}
+		_wake = false;
 	}
 }
 
+bool SustainGroup::start(const TimeSpec& poll)
+{
+	if (_thread.joinable())
+	{
+		return false;
+	}
+	_terminate = false;
+	_thread = std::thread(&SustainGroup::run, this, poll);
+	return true;
+}
+
+void SustainGroup::stop()
+{
+	if (_thread.joinable())
+	{
+		{
+			std::lock_guard lock(_notifyMutex);
+			_terminate = true;
+		}
+		_condition.notify_all();
+		_thread.join();
+	}
+}
+
+void SustainGroup::flush()
+{
+	std::lock_guard lock(_mutex);
+	while (_entries.count())
+	{
+		detach(_entries[_entries.count() - 1]);
+	}
+}
+
+size_t SustainGroup::count() const
+{
+	std::lock_guard lock(_mutex);
+	return _entries.count();
+}
+
+void SustainGroup::setMetrics(bool yn)
+{
+	std::lock_guard lock(_mutex);
+	_entryMetrics = yn;
+}
+
+SustainGroup::Metrics SustainGroup::getMetrics() const
+{
+	std::lock_guard lock(_mutex);
+	return _metrics;
+}
+
+void SustainGroup::resetMetrics()
+{
+	std::lock_guard lock(_mutex);
+	_metrics = {};
+	for (auto entry: _entries)
+	{
+		entry->_metrics = {};
+	}
+}
+
+void SustainGroup::setWakeUp(const TClosure<void>& wakeUp)
+{
+	std::lock_guard lock(_notifyMutex);
+	_wakeUp = wakeUp;
+}
+
 #if IS_QT
 
 class SustainQtTimer
@@ -124,24 +477,38 @@ class SustainQtTimer
 		SustainQtTimer()
 		{
 			QObject::connect(&_timer, &QTimer::timeout, [&]() {
-				static int sentry = 0;
-				// Place sentry for this part of the code
-				if (sentry < MAX_TIMER_REENTRIES)
-				{
-					// Set sentry
-					sentry++;
-					// Iterate through all functions in the table.
-					SustainBase::callSustain();
-					// Make entry of the function possible.
-					sentry--;
-					// Prevent clang warning.
-					(void) sentry;
-				}
-				else
-				{
-					SF_NORM_NOTIFY(DO_DEFAULT, "Skipped: Maximum re-entries reached!")
-				}
+				tick();
 			});
+			// Notified entries are called from the event loop without waiting for the timer.
+			SustainGroup::getDefault()->setWakeUp(TClosure<void>([&]() {
+				QMetaObject::invokeMethod(&_timer, [&]() {tick();}, Qt::QueuedConnection);
+			}));
+		}
+
+		~SustainQtTimer()
+		{
+			SustainGroup::getDefault()->setWakeUp(TClosure<void>());
+		}
+
+		void tick()
+		{
+			static int sentry = 0;
+			// Place sentry for this part of the code
+			if (sentry < MAX_TIMER_REENTRIES)
+			{
+				// Set sentry
+				sentry++;
+				// Iterate through all functions in the table.
+				SustainBase::callSustain();
+				// Make entry of the function possible.
+				sentry--;
+				// Prevent clang warning.
+				(void) sentry;
+			}
+			else
+			{
+				SF_NORM_NOTIFY(DO_DEFAULT, "Skipped: Maximum re-entries reached!")
+			}
 		}
 
 		QTimer _timer;
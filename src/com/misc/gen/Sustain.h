@@ -2,12 +2,20 @@
 
 #include "../global.h"
 #include "IntervalTimer.h"
+#include "TClosure.h"
 #include "TVector.h"
 #include "target.h"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
 
 namespace sf
 {
 
+class SustainGroup;
+
 /*
  * @brief Base class for template `TSustain` which enables repetitive calls from the main thread with a set frequency.
  *
@@ -28,6 +36,10 @@ namespace sf
  *   // To set the freq of the timer, use
  *   Entry.setInterval(const timespec& interval);
  *
+ *   // Event driven entries are only called after a notification which can be done from any thread.
+ *   Entry.setEventDriven(true);
+ *   Entry.notify();
+ *
  *   // To enable all this, do once, at program startup...
  *   // (this timer determines the maximum freq of sustained functions
  *   setSustainTimer(unsigned int ms);
@@ -36,6 +48,26 @@ class _MISC_CLASS SustainBase
 {
 	public:
 		typedef TVector<SustainBase*> PtrVector;
+		/**
+		 * @brief Cost of the calls made to a single entry.
+		 *
+		 * Only gathered when enabled on the group using SustainGroup::setMetrics().
+		 */
+		struct Metrics
+		{
+			/**
+			 * @brief Amount of calls made.
+			 */
+			uint64_t calls{0};
+			/**
+			 * @brief Total time spent in the calls in nanoseconds.
+			 */
+			uint64_t total{0};
+			/**
+			 * @brief Longest call in nanoseconds.
+			 */
+			uint64_t maximum{0};
+		};
 		/**
 		 * @brief Do not use an iterator because the sustain function could affect the vector itself.
 		 */
@@ -59,13 +91,13 @@ class _MISC_CLASS SustainBase
 
 	protected:
 		/**
-		 * @brief Default Constructor adding itself to the passed vector.
+		 * @brief Default Constructor adding itself to the passed group.
 		 *
-		 * If the passed vector is NULL the default vector is selected.
-		 * @param vector
+		 * If the passed group is NULL the default group is selected.
+		 * @param group
 		 * @param priority
 		 */
-		SustainBase(PtrVector* vector, int priority);
+		SustainBase(SustainGroup* group, int priority);
 
 		/**
 		 * @brief oes not have to be virtual because this base class is not used must always be derived.
@@ -84,10 +116,7 @@ class _MISC_CLASS SustainBase
 		 * This is only valid when the priority for this entry is #spTimer.
 		 * @param interval In milliseconds.
 		 */
-		void setInterval(const timespec& interval)
-		{
-			_timer.set(interval);
-		}
+		void setInterval(const timespec& interval);
 
 		/**
 		 * @brief Gets the interval at which the hooked function is called.
@@ -102,18 +131,12 @@ class _MISC_CLASS SustainBase
 		/**
 		 * @brief Enables this entry.
 		 */
-		void enable()
-		{
-			_timer.enable();
-		}
+		void enable();
 
 		/**
 		 * @brief Disables this entry.
 		 */
-		void disable()
-		{
-			_timer.disable();
-		}
+		void disable();
 
 		/**
 		 * @brief  Returns if the entry is enabled or not.
@@ -126,33 +149,63 @@ class _MISC_CLASS SustainBase
 		}
 
 		/**
-		 * @brief Must be overloaded to be able to call the sustain member function.
+		 * @brief Makes this entry event driven.
 		 *
-		 * @param time
-		 * @return
+		 * An event driven entry is not called on each tick but only once after each call to #notify().
+		 * Not valid for entries having priority #spTimer.
+		 * @param yn True for event driven.
 		 */
-		virtual inline bool call(const timespec& time)
+		void setEventDriven(bool yn);
+
+		/**
+		 * @brief Gets if this entry is event driven.
+		 */
+		[[nodiscard]] bool isEventDriven() const
 		{
-			return false;
+			return _eventDriven;
 		}
 
 		/**
-		 * @brief Flushes the vector and clears all Vector member of all entries first.
+		 * @brief Wakes up an event driven entry to be called on the next tick of its group.
+		 *
+		 * Can be called from any thread.
+		 */
+		void notify();
+
+		/**
+		 * @brief Gets the cost of the calls made to this entry.
+		 */
+		[[nodiscard]] const Metrics& getMetrics() const
+		{
+			return _metrics;
+		}
+
+		/**
+		 * @brief Gets the group this entry is part of.
 		 */
-		static void flushVector(PtrVector* vector);
+		[[nodiscard]] SustainGroup* getGroup() const
+		{
+			return _group;
+		}
 
 		/**
-		 * @brief Calls all sustain table entry functions in the passed vector.
+		 * @brief Must be overloaded to be able to call the sustain member function.
 		 *
-		 * The default is the static default vector.
-		 * @param vector
+		 * @param time
+		 * @return
 		 */
-		static void callSustain(PtrVector* vector = nullptr);
+		virtual inline bool call(const timespec& time)
+		{
+			return false;
+		}
 
 		/**
-		 * @brief Pointer to the default vector which is automatically created when
+		 * @brief Calls all sustain table entry functions in the passed group which are due.
+		 *
+		 * The default is the static default group.
+		 * @param group
 		 */
-		static PtrVector* _defaultVector;
+		static void callSustain(SustainGroup* group = nullptr);
 
 	protected:
 		/**
@@ -160,13 +213,249 @@ class _MISC_CLASS SustainBase
 		 */
 		int _priority;
 		/**
-		 * @brief Vector where this entry is part of.
+		 * @brief Group where this entry is part of which is atomic since notifying can happen from any thread.
 		 */
-		PtrVector* _list;
+		std::atomic<SustainGroup*> _group;
 		/**
 		 * @brief Timer for when priority #spTimer has been set.
 		 */
 		IntervalTimer _timer;
+
+	private:
+		/**
+		 * @brief Holds the event driven flag.
+		 */
+		bool _eventDriven{false};
+		/**
+		 * @brief Set when notified and cleared just before the call.
+		 */
+		std::atomic<bool> _notified{false};
+		/**
+		 * @brief Holds the position in the timer queue of the group.
+		 */
+		std::multimap<TimeSpec, SustainBase*>::iterator _slot;
+		/**
+		 * @brief True when #_slot is valid.
+		 */
+		bool _queued{false};
+		/**
+		 * @brief Holds the metrics of this entry.
+		 */
+		Metrics _metrics;
+
+		friend class SustainGroup;
+};
+
+/**
+ * @brief Group of sustain entries called from the same thread.
+ *
+ * Polled entries are called on each tick in order of priority, #SustainBase::spTimer entries
+ * are kept in a queue ordered by their target time so only due entries are visited and
+ * event driven entries are only called after being notified.<br>
+ * The default group is called from the main thread using #setSustainTimer().
+ * Other groups are called using #callSustain() or run on their own thread using #start().
+ */
+class _MISC_CLASS SustainGroup
+{
+	public:
+		/**
+		 * @brief Type for the ordered timer queue.
+		 */
+		typedef std::multimap<TimeSpec, SustainBase*> TimerQueue;
+
+		/**
+		 * @brief Metrics of the group ticks.
+		 */
+		struct Metrics
+		{
+			/**
+			 * @brief Amount of ticks.
+			 */
+			uint64_t ticks{0};
+			/**
+			 * @brief Amount of entry calls.
+			 */
+			uint64_t calls{0};
+			/**
+			 * @brief Total time spent in ticks in nanoseconds.
+			 */
+			uint64_t total{0};
+			/**
+			 * @brief Longest tick in nanoseconds.
+			 */
+			uint64_t maximum{0};
+		};
+
+		/**
+		 * @brief Default constructor.
+		 */
+		SustainGroup() = default;
+
+		/**
+		 * @brief Destructor stopping the thread and detaching all entries.
+		 */
+		~SustainGroup();
+
+		/**
+		 * @brief Prevent copying.
+		 */
+		SustainGroup(const SustainGroup&) = delete;
+
+		/**
+		 * @brief Prevent copying.
+		 */
+		SustainGroup& operator=(const SustainGroup&) = delete;
+
+		/**
+		 * @brief Calls the entries which are due.
+		 */
+		void call();
+
+		/**
+		 * @brief Starts a thread calling this group.
+		 *
+		 * The thread sleeps until a timer entry is due, an entry is notified or the poll interval passed.
+		 * @param poll Interval for calling the polled entries.
+		 * @return True when started and false when already running.
+		 */
+		bool start(const TimeSpec& poll);
+
+		/**
+		 * @brief Stops the thread started with #start() and waits for it to finish.
+		 */
+		void stop();
+
+		/**
+		 * @brief Detaches all entries from this group.
+		 */
+		void flush();
+
+		/**
+		 * @brief Gets the amount of entries in this group.
+		 */
+		[[nodiscard]] size_t count() const;
+
+		/**
+		 * @brief Enables gathering the metrics of each entry call.
+		 */
+		void setMetrics(bool yn);
+
+		/**
+		 * @brief Gets the metrics of the ticks.
+		 */
+		[[nodiscard]] Metrics getMetrics() const;
+
+		/**
+		 * @brief Resets the metrics of the group and its entries.
+		 */
+		void resetMetrics();
+
+		/**
+		 * @brief Sets the function called from the notifying thread when an entry is notified.
+		 *
+		 * Used to have the owning thread call #call() without waiting for the next tick.
+		 */
+		void setWakeUp(const TClosure<void>& wakeUp);
+
+		/**
+		 * @brief Gets the default group which is created when needed.
+		 */
+		static SustainGroup* getDefault();
+
+	private:
+		/**
+		 * @brief Attaches the entry.
+		 */
+		void attach(SustainBase* entry);
+		/**
+		 * @brief Detaches the entry.
+		 */
+		void detach(SustainBase* entry);
+		/**
+		 * @brief (Re)schedules the entry depending on its state.
+		 */
+		void schedule(SustainBase* entry);
+		/**
+		 * @brief Adds the entry to the notified list.
+		 */
+		void notify(SustainBase* entry);
+		/**
+		 * @brief Calls the passed entry.
+		 *
+		 * @return False when the entry was detached during the call and must not be touched anymore.
+		 */
+		bool callEntry(SustainBase* entry, const timespec& time);
+		/**
+		 * @brief Thread function.
+		 */
+		void run(TimeSpec poll);
+
+		/**
+		 * @brief Guards the entries and is held during a tick.
+		 */
+		mutable std::recursive_mutex _mutex;
+		/**
+		 * @brief Guards the notified list and wake-up of the thread.
+		 */
+		std::mutex _notifyMutex;
+		/**
+		 * @brief Used to wake up the thread.
+		 */
+		std::condition_variable _condition;
+		/**
+		 * @brief All attached entries.
+		 */
+		SustainBase::PtrVector _entries;
+		/**
+		 * @brief Polled entries ordered by priority.
+		 */
+		SustainBase::PtrVector _polled;
+		/**
+		 * @brief Timer entries ordered by target time.
+		 */
+		TimerQueue _timers;
+		/**
+		 * @brief Timer entries due in the current tick.
+		 */
+		SustainBase::PtrVector _due;
+		/**
+		 * @brief Notified event driven entries.
+		 */
+		SustainBase::PtrVector _notified;
+		/**
+		 * @brief Set to wake up the thread for recalculating the sleep time.
+		 */
+		bool _wake{false};
+		/**
+		 * @brief Called when an entry is notified.
+		 */
+		TClosure<void> _wakeUp;
+		/**
+		 * @brief Thread when started.
+		 */
+		std::thread _thread;
+		/**
+		 * @brief Flag for the thread to stop.
+		 */
+		std::atomic<bool> _terminate{false};
+		/**
+		 * @brief Entry being called which is cleared when detached during the call.
+		 */
+		SustainBase* _calling{nullptr};
+		/**
+		 * @brief Holds the flag for gathering entry metrics.
+		 */
+		bool _entryMetrics{false};
+		/**
+		 * @brief Holds the group metrics.
+		 */
+		Metrics _metrics;
+		/**
+		 * @brief Holds the default group.
+		 */
+		static SustainGroup* _defaultGroup;
+
+		friend class SustainBase;
 };
 
 /**
@@ -189,9 +478,9 @@ class TSustain : public SustainBase
 		 * @param self This pointer.
 		 * @param pmf Pointer to member function.
 		 * @param priority The priority.
-		 * @param vector Optional pointer to vector keeping the instance.
+		 * @param group Optional pointer to group keeping the instance.
 		 */
-		TSustain(T* self, Pmf pmf, int priority = spDefault, PtrVector* vector = nullptr);
+		TSustain(T* self, Pmf pmf, int priority = spDefault, SustainGroup* group = nullptr);
 
 		/**
 		 * @brief Prevent copying.
@@ -226,8 +515,8 @@ class TSustain : public SustainBase
 };
 
 template<class T>
-TSustain<T>::TSustain(T* self, Pmf pmf, int priority, PtrVector* vector)
-	: SustainBase(vector, priority)
+TSustain<T>::TSustain(T* self, Pmf pmf, int priority, SustainGroup* group)
+	: SustainBase(group, priority)
 	, _self(self)
 	, _pmf(pmf)
 {
@@ -249,10 +538,10 @@ class _MISC_CLASS StaticSustain : public SustainBase
 		 *
 		 * @param pf
 		 * @param priority
-		 * @param vector
+		 * @param group
 		 */
-		explicit StaticSustain(Pf pf, int priority = spDefault, PtrVector* vector = _defaultVector)
-			: SustainBase(vector, priority)
+		explicit StaticSustain(Pf pf, int priority = spDefault, SustainGroup* group = nullptr)
+			: SustainBase(group, priority)
 			, _pf(pf)
 		{}
 
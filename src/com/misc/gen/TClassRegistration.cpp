@@ -0,0 +1,30 @@
+#include "TClassRegistration.h"
+
+namespace sf
+{
+
+// Anonymous namespace.
+namespace
+{
+
+RequireClosure requireHandler;
+
+}
+
+std::mutex& getClassRegistrationMutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+void setRequireHandler(const RequireClosure& handler)
+{
+	requireHandler = handler;
+}
+
+bool requireProvider(const std::string& name)
+{
+	return requireHandler && requireHandler(name);
+}
+
+}
@@ -6,6 +6,7 @@
 #include "TClosure.h"
 #include "TVector.h"
 #include "dbgutils.h"
+#include <mutex>
 #include <vector>
 
 /**
@@ -24,15 +25,24 @@
 /**
  * Declaration of dynamically loadable library information and function for set/get the library filename.
  */
-#define SF_DL_INFORMATION(name, description)                           \
+#define SF_DL_INFORMATION(name, description) \
+	SF_DL_INFORMATION_EX(name, description, "")
+
+/**
+ * Same as SF_DL_INFORMATION but with load options like "lazy;depends=<name>,<name>;provides=<name>,<name>".
+ * See sf::DynamicLibraryInfo::setOptions() for the syntax.
+ */
+#define SF_DL_INFORMATION_EX(name, description, options)               \
 	namespace                                                            \
 	{                                                                    \
-	const char* _dl_ =                                                   \
+	SF_DL_SECTION_ATTR const char _dl_[] =                               \
 		SF_DL_MARKER_BEGIN                                                 \
 			name                                                             \
 				SF_DL_NAME_SEPARATOR                                           \
 					description                                                  \
-						SF_DL_MARKER_END;                                          \
+						SF_DL_OPTION_SEPARATOR                                     \
+							options                                                  \
+								SF_DL_MARKER_END;                                      \
                                                                        \
 	extern "C" TARGET_EXPORT const char* SF_DL_NAME_FUNC(const char* nm) \
 	{                                                                    \
@@ -65,6 +75,35 @@ inline std::string getLibraryName()
 	return SF_DL_NAME_FUNC(nullptr);
 }
 
+/**
+ * @brief Gets the process wide mutex serializing class registrations.
+ *
+ * Libraries loaded from different threads run their registrations concurrently.
+ */
+_MISC_FUNC std::mutex& getClassRegistrationMutex();
+
+/**
+ * @brief Type of the handler loading the lazy library providing a name.
+ */
+typedef TClosure<bool, const std::string&> RequireClosure;
+
+/**
+ * @brief Sets the handler called when a name is looked up which is not available yet.
+ *
+ * The application module configuration installs it to load lazy libraries on first use.
+ * @param handler Callback closure.
+ */
+_MISC_FUNC void setRequireHandler(const RequireClosure& handler = {});
+
+/**
+ * @brief Loads the lazy library providing the passed name using the installed handler.
+ *
+ * Called by #sf::TClassRegistration::create() for names not registered.
+ * @param name Registered class name, widget class name or file suffix like '*.ext'.
+ * @return True when a library was loaded.
+ */
+_MISC_FUNC bool requireProvider(const std::string& name);
+
 }// namespace sf
 
 /**
@@ -327,6 +366,7 @@ size_t TClassRegistration<T, P>::size() const
 template<typename T, typename P>
 size_t TClassRegistration<T, P>::registerClass(const char* name, const char* description, const typename TClassRegistration<T, P>::callback_t& callback)
 {
+	std::lock_guard lock(getClassRegistrationMutex());
 	// Sanity check on existing entry.
 	if (find(name))
 	{
@@ -390,6 +430,11 @@ template<typename T, typename P>
 T* TClassRegistration<T, P>::create(const std::string& name, const P& params) const
 {
 	auto entry = find(name);
+	// The class could be registered by a library not loaded yet.
+	if (entry == nullptr && requireProvider(name))
+	{
+		entry = find(name);
+	}
 	if (entry == nullptr)
 	{
 		return nullptr;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 namespace sf
 {
 
@@ -47,6 +49,11 @@ class TFifoClass
 		 */
 		bool push(const T& item);
 
+		/**
+		 * @brief Same as #push(const T&) but moving the item into the buffer.
+		 */
+		bool push(T&& item);
+
 		/**
 		 * @brief Push item of zero in fifo
 		 */
@@ -226,6 +233,18 @@ bool TFifoClass<T>::push(const T& item)
 	return true;
 }
 
+template<class T>
+bool TFifoClass<T>::push(T&& item)
+{
+	if ((((_tail + 1) % _bufSize)) == _head)
+	{
+		return false;
+	}
+	_buffer[_tail++] = std::move(item);
+	_tail %= _bufSize;
+	return true;
+}
+
 template<class T>
 bool TFifoClass<T>::push(const T* item, TFifoClass<T>::size_type count)
 {
@@ -271,7 +290,7 @@ T TFifoClass<T>::pop()
 	{
 		return _zero;
 	}
-	T tmp = _buffer[_head++];
+	T tmp = std::move(_buffer[_head++]);
 	_head %= _bufSize;
 	return tmp;
 }
@@ -284,7 +303,7 @@ bool TFifoClass<T>::pop(T& item)
 		item = _zero;
 		return false;
 	}
-	item = _buffer[_head++];
+	item = std::move(_buffer[_head++]);
 	_head %= _bufSize;
 	return true;
 }
@@ -12,8 +12,6 @@
 namespace sf
 {
 
-const size_t Value::_sizeExtra = 1;
-
 const char* Value::_invalidStr = "n/a";
 
 const char* Value::_typeNames[] =
@@ -29,6 +27,12 @@ const char* Value::_typeNames[] =
 
 Value& Value::operator=(Value&& v) noexcept
 {
+	if (&v == this)
+	{
+		return *this;
+	}
+	// Free the current content before taking over the passed one.
+	release();
 	_data = v._data;
 	_size = v._size;
 	_type = v._type;
@@ -137,19 +141,22 @@ Value::Value(const void* v, size_t size)
 Value::~Value()
 {
 	// Only delete memory of variable sized value types.
-	if (_type >= vitString && _data._ptr)
+	release();
+}
+
+char* Value::allocate()
+{
+	if (isInline())
 	{
-		free_null(_data._ptr);
+		return _data._inline;
 	}
+	return _data._ptr = static_cast<char*>(malloc(_size + _sizeExtra));
 }
 
 Value& Value::set(int type, const void* content, size_t size)
 {
 	// Free any memory for this item if any is allocated.
-	if (_type >= vitString && _data._ptr)
-	{
-		free_null(_data._ptr);
-	}
+	release();
 	_size = 0;
 	switch (type)
 	{
@@ -196,18 +203,18 @@ Value& Value::set(int type, const void* content, size_t size)
 				{
 					_size = maxString;
 				}
-				_data._ptr = (char*) malloc(_size + _sizeExtra);
+				auto ptr = allocate();
 #if IS_WIN
-				memcpy_s(_data._ptr, _size, content, _size);
+				memcpy_s(ptr, _size, content, _size);
 #else
-				memcpy(_data._ptr, content, _size);
+				memcpy(ptr, content, _size);
 #endif
-				_data._ptr[_size - 1] = '\0';
+				ptr[_size - 1] = '\0';
 			}
 			else
 			{
-				_data._ptr = (char*) malloc(_size + _sizeExtra);
-				memset(_data._ptr, 0, _size);
+				// Empty string having only the terminator.
+				memset(allocate(), 0, _size + _sizeExtra);
 			}
 			break;
 
@@ -217,18 +224,17 @@ Value& Value::set(int type, const void* content, size_t size)
 			{
 				_size = maxBinary;
 			}
-			_data._ptr = (char*) malloc(_size + _sizeExtra);
 			if (content)
 			{
 #if IS_WIN
-				memcpy_s(_data._ptr, _size, content, _size);
+				memcpy_s(allocate(), _size, content, _size);
 #else
-				memcpy(_data._ptr, content, _size);
+				memcpy(allocate(), content, _size);
 #endif
 			}
 			else
 			{
-				memset(_data._ptr, 0, _size);
+				memset(allocate(), 0, _size);
 			}
 			break;
 
@@ -238,18 +244,17 @@ Value& Value::set(int type, const void* content, size_t size)
 			{
 				_size = maxCustom;
 			}
-			_data._ptr = (char*) malloc(_size + _sizeExtra);
 			if (content)
 			{
 #if IS_WIN
-				memcpy_s(_data._ptr, _size, content, _size);
+				memcpy_s(allocate(), _size, content, _size);
 #else
-				memcpy(_data._ptr, content, _size);
+				memcpy(allocate(), content, _size);
 #endif
 			}
 			else
 			{
-				memset(_data._ptr, 0, _size);
+				memset(allocate(), 0, _size);
 			}
 			break;
 
@@ -287,6 +292,16 @@ Value& Value::assign(const Value& v)// NOLINT(misc-no-recursion)
 	return *this;
 }
 
+Value& Value::assign(Value&& v)// NOLINT(misc-no-recursion)
+{
+	// Taking over is only possible when the type is kept and no reference is involved.
+	if (_type != vitReference && v._type != vitReference && (_type == v._type || _type == vitUndefined || _type == vitInvalid))
+	{
+		return *this = std::move(v);
+	}
+	return assign(static_cast<const Value&>(v));
+}
+
 bool Value::isZero() const// NOLINT(misc-no-recursion)
 {
 	switch (_type)
@@ -301,7 +316,7 @@ bool Value::isZero() const// NOLINT(misc-no-recursion)
 			return _data._ref->isZero();
 
 		case vitString:
-			return !strlen(_data._ptr);
+			return !strlen(getPtr());
 
 		case vitBinary:
 		case vitCustom:
@@ -320,21 +335,17 @@ Value& Value::set(const Value& v)
 	if (&v != this)
 	{
 		// Delete the current allocated memory.
-		if (_type >= vitString && _data._ptr)
-		{
-			free_null(_data._ptr);
-		}
+		release();
 		// Assign the new type and size
 		_type = v._type;
 		_size = v._size;
 		// Check if memory needs to be copied and reserved.
 		if (_type >= vitString)
 		{
-			_data._ptr = (char*) malloc(_size + _sizeExtra);
 #if IS_WIN
-			memcpy_s(_data._ptr, _size, v._data._ptr, _size);
+			memcpy_s(allocate(), _size, v.getPtr(), _size);
 #else
-			memcpy(_data._ptr, v._data._ptr, _size);
+			memcpy(allocate(), v.getPtr(), _size);
 #endif
 		}
 		else
@@ -370,7 +381,7 @@ Value::int_type Value::getInteger(int* cnv_err) const// NOLINT(misc-no-recursion
 			return _data._ref->getInteger(nullptr);
 
 		case vitString:
-			rv = strtol(_data._ptr, &end_ptr, 0);
+			rv = strtol(getPtr(), &end_ptr, 0);
 			if (end_ptr && *end_ptr != '\0' && cnv_err)
 			{
 				(*cnv_err)++;
@@ -405,9 +416,9 @@ Value::flt_type Value::getFloat(int* cnv_err) const// NOLINT(misc-no-recursion)
 			return _data._ref->getFloat();
 
 		case vitString:
-			if (strlen(_data._ptr))
+			if (strlen(getPtr()))
 			{
-				rv = sf::stod(_data._ptr, &end_ptr);
+				rv = sf::stod(getPtr(), &end_ptr);
 			}
 			if (end_ptr && *end_ptr != '\0' && cnv_err)
 			{
@@ -459,11 +470,11 @@ std::string Value::getString(int precision) const// NOLINT(misc-no-recursion)
 			return _data._ref->getString();
 
 		case vitString:
-			return _data._ptr;
+			return getPtr();
 
 		case vitBinary:
 		case vitCustom:
-			return hexString(_data._ptr, _size);
+			return hexString(getPtr(), _size);
 	}
 	return _invalidStr;
 }
@@ -479,7 +490,7 @@ const void* Value::getBinary() const// NOLINT(misc-no-recursion)
 		case vitString:
 		case vitBinary:
 		case vitCustom:
-			return _data._ptr;
+			return getPtr();
 
 		case vitReference:
 			return _data._ref->getBinary();
@@ -497,7 +508,7 @@ const char* Value::getData() const// NOLINT(misc-no-recursion)
 	{
 		return _data._ref->getData();
 	}
-	return (_type >= vitString) ? _data._ptr : (char*) &_data;
+	return (_type >= vitString) ? getPtr() : (char*) &_data;
 }
 
 Value::EType Value::getType(const char* type)
@@ -523,10 +534,7 @@ const char* Value::getType(Value::EType type)
 void Value::makeInvalid()
 {
 	// When memory was allocated release it.
-	if (_type >= vitString)
-	{
-		free_null(_data._ptr);
-	}
+	release();
 	// Set the type to the invalid value.
 	_type = vitInvalid;
 }
@@ -559,10 +567,7 @@ bool Value::setType(EType type)// NOLINT(misc-no-recursion)
 			break;
 
 		case vitUndefined:
-			if (_type >= vitString)
-			{
-				free_null(_data._ptr);
-			}
+			release();
 			_type = vitUndefined;
 			break;
 
@@ -594,21 +599,17 @@ bool Value::setType(EType type)// NOLINT(misc-no-recursion)
 			{
 				// Copy std::string to temporary std::string buffer
 				std::string tmp = getString();
+				// Only delete when type has allocated memory which depends on the current size.
+				release();
 				// Calculate new size
 				_size = tmp.length() / 2;
-				// Only delete when type has allocated memory.
-				if (_type >= vitString)
-				{
-					// Delete previous content pointer
-					free_null(_data._ptr);
-				}
 				// Create new buffer
-				_data._ptr = (char*) malloc(_size + _sizeExtra);
+				auto ptr = allocate();
 				// Convert hex std::string to binary data
-				if (stringHex(tmp.c_str(), _data._ptr, _size) == size_t(-1))
+				if (stringHex(tmp.c_str(), ptr, _size) == size_t(-1))
 				{
 					// Clear all memory after conversion error
-					std::memset(_data._ptr, '\0', _size);
+					std::memset(ptr, '\0', _size);
 					cnv_err = -1;
 				}
 				// Assign the type member.
@@ -702,7 +703,7 @@ Value Value::add(const Value& v) const// NOLINT(misc-no-recursion)
 			return Value(_data._flt + v.getFloat(nullptr));
 
 		case vitString:
-			return Value(_data._ptr + v.getString());
+			return Value(getPtr() + v.getString());
 
 		case vitReference:
 			return _data._ref->add(v);
@@ -799,7 +800,7 @@ int Value::compare(const Value& v) const// NOLINT(misc-no-recursion)
 
 		case vitString: {
 			// Case sensitive compare
-			return std::basic_string_view(_data._ptr, _size - 1).compare(v.getString());
+			return std::basic_string_view(getPtr(), _size - 1).compare(v.getString());
 		}
 
 		case vitReference:
@@ -814,7 +815,7 @@ int Value::compare(const Value& v) const// NOLINT(misc-no-recursion)
 			// if the compared type isn't the same type it's not equal by default
 			if (v._type == vitBinary || v._type == vitCustom)
 			{
-				return memcmp(_data._ptr, v._data._ptr, _size);
+				return memcmp(getPtr(), v.getPtr(), _size);
 			}
 			else
 			{
@@ -5,6 +5,7 @@
 #if IS_QT
 	#include <QString>
 #endif
+#include <cstdlib>
 #include <limits>
 
 namespace sf
@@ -14,6 +15,7 @@ namespace sf
  * @brief Value container class able to performing arithmetic functions.
  *
  * Class designed to store settings and to manipulate them using overloaded basic arithmetic operators.
+ * Strings and binary data small enough are stored inside the instance without allocating memory.
  */
 class _MISC_CLASS Value
 {
@@ -42,9 +44,9 @@ class _MISC_CLASS Value
 			vitInteger,
 			/** Floating point value using no additional allocated memory.*/
 			vitFloat,
-			/** String value having additional allocated memory.*/
+			/** String value having additional allocated memory when not fitting inline.*/
 			vitString,
-			/** Binary untyped value having additional allocated memory.*/
+			/** Binary untyped value having additional allocated memory when not fitting inline.*/
 			vitBinary,
 			/** Custom value for now handled the same as a binary typed.*/
 			vitCustom,
@@ -56,7 +58,7 @@ class _MISC_CLASS Value
 		Value();
 
 		/**
-		 * @brief Move assignment operator is default.
+		 * @brief Move assignment operator taking over the content and type.
 		 */
 		Value& operator=(Value&&) noexcept;
 
@@ -314,6 +316,13 @@ class _MISC_CLASS Value
 		 */
 		Value& assign(const Value& v);
 
+		/**
+		 * @brief Same as #assign(const Value&) but taking over the content when the type is kept.
+		 * @param v The new value.
+		 * @return Itself
+		 */
+		Value& assign(Value&& v);
+
 		/**
 		 * @brief Assigns a boolean value but not changing the current type.
 		 *
@@ -683,6 +692,26 @@ class _MISC_CLASS Value
 		 */
 		void makeInvalid();
 
+		/**
+		 * Returns true when the content of a variable sized type is stored in the instance itself.
+		 */
+		[[nodiscard]] inline bool isInline() const;
+
+		/**
+		 * Returns the memory of the current size for a variable sized type allocating it when not inline.
+		 */
+		char* allocate();
+
+		/**
+		 * Frees the memory of a variable sized type when it was allocated.
+		 */
+		inline void release();
+
+		/**
+		 * Returns the content of a variable sized type.
+		 */
+		[[nodiscard]] inline char* getPtr() const;
+
 		/**
 		 * Type of the content stored.
 		 * Default type is vitUndefined.
@@ -715,13 +744,17 @@ class _MISC_CLASS Value
 			 * Reference pointer to other instance.
 			 */
 				Value* _ref;
+				/**
+			 * Content of variable sized types when it fits.
+			 */
+				char _inline[16];
 		} _data{nullptr};
 
 		/**
 		 * Additional size to allocate.
 		 * Minimal is 1 for terminating a string.
 		 */
-		static const size_t _sizeExtra;
+		static constexpr size_t _sizeExtra = 1;
 
 		/**
 		 * Holds all the type name strings from the EType enumerate.
@@ -753,6 +786,25 @@ class _MISC_CLASS Value
 		friend std::istream& operator>>(std::istream& is, Value& v);
 };
 
+inline bool Value::isInline() const
+{
+	return _size + _sizeExtra <= sizeof(_data._inline);
+}
+
+inline void Value::release()
+{
+	if (_type >= vitString && !isInline() && _data._ptr)
+	{
+		free(_data._ptr);
+		_data._ptr = nullptr;
+	}
+}
+
+inline char* Value::getPtr() const
+{
+	return isInline() ? const_cast<char*>(_data._inline) : _data._ptr;
+}
+
 inline Value& Value::set(bool v)
 {
 	return set(int_type(v));
@@ -0,0 +1,232 @@
+#include "FileMapperArena.h"
+#include "../gen/Exception.h"
+#include "../gen/gen_utils.h"
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace sf::lnx
+{
+
+namespace
+{
+
+/**
+ * @brief Size of a transparent huge page on x86_64 and aarch64 with 4K pages.
+ */
+constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+}// namespace
+
+FileMapperArena::FileMapperArena(bool memory, bool huge_pages)
+	: _hugePages(huge_pages)
+	, _alignment(huge_pages ? HugePageSize : ::getpagesize())
+{
+	if (memory)
+	{
+		_descriptor = ::memfd_create(std::string("fm-").append(getExecutableName()).c_str(), MFD_CLOEXEC);
+		if (_descriptor == -1)
+		{
+			throw ExceptionSystemCall("memfd_create", errno, typeid(*this).name(), __FUNCTION__);
+		}
+	}
+	else
+	{
+		// Open a file using a template
+		auto tpl = std::string("fm-").append(getExecutableName()).append("-{}.tmp");
+		_file.createTemporary(std::filesystem::temp_directory_path().append(tpl));
+		// Remove the directory entry since only the descriptor is used.
+		_file.unlink();
+		_descriptor = _file.getDescriptor();
+	}
+}
+
+FileMapperArena::~FileMapperArena()
+{
+	// The temporary file closes its own descriptor.
+	if (!_file.isOpen() && _descriptor != -1)
+	{
+		::close(_descriptor);
+	}
+}
+
+size_t FileMapperArena::align(size_t sz) const
+{
+	return (sz + _alignment - 1) & ~(_alignment - 1);
+}
+
+size_t FileMapperArena::allocate(size_t sz)
+{
+	// Allocating nothing is not allowed by posix_fallocate().
+	if (!sz)
+	{
+		return 0;
+	}
+	sz = align(sz);
+	std::lock_guard lock(_mutex);
+	size_t ofs;
+	// Reuse a released range of the same size.
+	auto it = _released.find(sz);
+	if (it != _released.end())
+	{
+		ofs = it->second;
+		_released.erase(it);
+	}
+	else
+	{
+		ofs = _end;
+		_end += sz;
+	}
+	// Allocate the disk space or memory up front to prevent a SIGBUS when writing to the mapped view.
+	if (auto err = ::posix_fallocate(_descriptor, static_cast<off_t>(ofs), static_cast<off_t>(sz)))
+	{
+		// Undo the allocation.
+		if (ofs + sz == _end)
+		{
+			_end = ofs;
+		}
+		else
+		{
+			_released.emplace(sz, ofs);
+		}
+		throw ExceptionSystemCall("posix_fallocate", err, typeid(*this).name(), __FUNCTION__);
+	}
+	_allocated += sz;
+	return ofs;
+}
+
+void FileMapperArena::release(size_t ofs, size_t sz)
+{
+	// Empty ranges were never allocated.
+	if (!sz)
+	{
+		return;
+	}
+	sz = align(sz);
+	std::lock_guard lock(_mutex);
+	// Give the space back to the system keeping the file sparse.
+	::fallocate(_descriptor, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(ofs), static_cast<off_t>(sz));
+	_released.emplace(sz, ofs);
+	_allocated -= sz;
+}
+
+int FileMapperArena::getDescriptor() const
+{
+	return _descriptor;
+}
+
+bool FileMapperArena::isHugePages() const
+{
+	return _hugePages;
+}
+
+size_t FileMapperArena::getAlignment() const
+{
+	return _alignment;
+}
+
+size_t FileMapperArena::getAllocated() const
+{
+	std::lock_guard lock(_mutex);
+	return _allocated;
+}
+
+size_t FileMapperArena::getFileSize() const
+{
+	std::lock_guard lock(_mutex);
+	return _end;
+}
+
+std::string FileMapperArena::getSharedPath() const
+{
+	return stringf("/proc/%d/fd/%d", ::getpid(), _descriptor);
+}
+
+ArenaFileMapper::ArenaFileMapper(std::shared_ptr<FileMapperArena> arena)
+	: IFileMapper()
+	, _arena(std::move(arena))
+{
+	if (!_arena)
+	{
+		throw Exception().Function(typeid(*this).name(), __FUNCTION__, "Arena is not allowed to be null!");
+	}
+}
+
+ArenaFileMapper::~ArenaFileMapper()
+{
+	reset();
+}
+
+void ArenaFileMapper::initialize()
+{
+	// Nothing to be done since the arena provides the file.
+}
+
+void ArenaFileMapper::reset()
+{
+	if (_ptr)
+	{
+		::munmap(_ptr, _size);
+		_ptr = nullptr;
+	}
+	_counter = 0;
+	if (_size)
+	{
+		_arena->release(_offset, _size);
+		_offset = _size = 0;
+	}
+}
+
+void ArenaFileMapper::createView(size_t sz)
+{
+	reset();
+	_offset = _arena->allocate(sz);
+	_size = sz;
+}
+
+bool ArenaFileMapper::mapView()
+{
+	// Check if already mapped.
+	if (!_counter++)
+	{
+		_ptr = static_cast<char*>(::mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _arena->getDescriptor(), static_cast<off_t>(_offset)));
+		// Check for failure.
+		if (_ptr == MAP_FAILED)
+		{
+			_ptr = nullptr;
+			_counter = 0;
+			throw ExceptionSystemCall("mmap", errno, typeid(*this).name(), __FUNCTION__);
+		}
+		// Only an advice so failure is not an error.
+		if (_arena->isHugePages())
+		{
+			::madvise(_ptr, _size, MADV_HUGEPAGE);
+		}
+	}
+	return _ptr != nullptr;
+}
+
+bool ArenaFileMapper::unmapView()
+{
+	// Decrement the counter and check for zero.
+	if (_counter && !--_counter)
+	{
+		if (::munmap(_ptr, _size) == -1)
+		{
+			throw ExceptionSystemCall("munmap", errno, typeid(*this).name(), __FUNCTION__);
+		}
+		_ptr = nullptr;
+	}
+	return true;
+}
+
+void* ArenaFileMapper::getPtr()
+{
+	return _ptr;
+}
+
+size_t ArenaFileMapper::getOffset() const
+{
+	return _size ? _offset : std::numeric_limits<size_t>::max();
+}
+
+}// namespace sf::lnx
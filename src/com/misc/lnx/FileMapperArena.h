@@ -0,0 +1,199 @@
+#pragma once
+
+#include "../gen/IFileMapper.h"
+#include "../global.h"
+#include "File.h"
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace sf::lnx
+{
+
+/**
+ * @brief Arena allocating page aligned ranges from a single anonymous memory file or unlinked temporary file.
+ *
+ * Released ranges are punched out of the file, keeping it sparse, and reused for new allocations of the same size.
+ */
+class _MISC_CLASS FileMapperArena : public IFileMapper::Arena
+{
+	public:
+		/**
+		 * @brief Initializing constructor.
+		 *
+		 * Throws an exception when the file could not be created.
+		 * @param memory True for using memfd_create() and false for a temporary file.
+		 * @param huge_pages Aligns ranges on huge page boundaries and advises transparent huge pages when mapped.
+		 */
+		FileMapperArena(bool memory, bool huge_pages);
+
+		/**
+		 * @brief Destructor closing the file.
+		 */
+		~FileMapperArena() override;
+
+		/**
+		 * @brief Allocates a range in the file.
+		 *
+		 * @param sz Size in bytes which is rounded up to the alignment.
+		 * @return Offset into the file which is zero for an empty range since nothing is allocated.
+		 */
+		size_t allocate(size_t sz);
+
+		/**
+		 * @brief Releases a range allocated with #allocate().
+		 *
+		 * @param ofs Offset into the file.
+		 * @param sz Size passed to #allocate().
+		 */
+		void release(size_t ofs, size_t sz);
+
+		/**
+		 * @brief Gets the file descriptor to map the ranges from.
+		 */
+		[[nodiscard]] int getDescriptor() const;
+
+		/**
+		 * @brief Gets the huge pages flag passed to the constructor.
+		 */
+		[[nodiscard]] bool isHugePages() const;
+
+		/**
+		 * @brief Gets the alignment of the ranges.
+		 */
+		[[nodiscard]] size_t getAlignment() const;
+
+		/**
+		 * @brief Overridden from base class.
+		 */
+		[[nodiscard]] size_t getAllocated() const override;
+
+		/**
+		 * @brief Overridden from base class.
+		 */
+		[[nodiscard]] size_t getFileSize() const override;
+
+		/**
+		 * @brief Overridden from base class.
+		 *
+		 * Returns the '/proc' path of the descriptor since the file has no directory entry.
+		 */
+		[[nodiscard]] std::string getSharedPath() const override;
+
+	private:
+		/**
+		 * @brief Rounds the size up to the alignment.
+		 */
+		[[nodiscard]] size_t align(size_t sz) const;
+
+		/**
+		 * @brief Guards the members when mappers in different threads allocate.
+		 */
+		mutable std::mutex _mutex;
+		/**
+		 * @brief Holds the temporary file when not using memory.
+		 */
+		File _file;
+		/**
+		 * @brief Holds the descriptor of the memory file.
+		 */
+		int _descriptor{-1};
+		/**
+		 * @brief Holds the huge pages flag.
+		 */
+		bool _hugePages;
+		/**
+		 * @brief Holds the range alignment.
+		 */
+		size_t _alignment;
+		/**
+		 * @brief Holds the end of the last range.
+		 */
+		size_t _end{0};
+		/**
+		 * @brief Holds the allocated amount of bytes.
+		 */
+		size_t _allocated{0};
+		/**
+		 * @brief Released ranges mapped by size to offset.
+		 */
+		std::multimap<size_t, size_t> _released;
+};
+
+/**
+ * @brief File mapper for mapping a view allocated from a #sf::lnx::FileMapperArena.
+ */
+class _MISC_CLASS ArenaFileMapper : public IFileMapper
+{
+	public:
+		/**
+		 * @brief Initializing constructor.
+		 *
+		 * @param arena Arena to allocate the view from.
+		 */
+		explicit ArenaFileMapper(std::shared_ptr<FileMapperArena> arena);
+
+		/**
+		 * @brief Destructor releasing the view.
+		 */
+		~ArenaFileMapper() override;
+
+		/**
+		 * @brief Overridden from base class and does nothing.
+		 */
+		void initialize() override;
+
+		/**
+		 * @brief Overridden from base class allocating the range from the arena.
+		 */
+		void createView(size_t sz) override;
+
+		/**
+		 * @brief Overridden from base class.
+		 */
+		bool mapView() override;
+
+		/**
+		 * @brief Overridden from base class.
+		 */
+		bool unmapView() override;
+
+		/**
+		 * @brief Overridden from base class.
+		 */
+		void* getPtr() override;
+
+		/**
+		 * @brief Overridden from base class.
+		 */
+		[[nodiscard]] size_t getOffset() const override;
+
+	private:
+		/**
+		 * @brief Releases the view from the arena.
+		 */
+		void reset();
+
+		/**
+		 * @brief Holds the arena keeping it alive as long as this mapper exists.
+		 */
+		std::shared_ptr<FileMapperArena> _arena;
+		/**
+		 * @brief Holds the offset into the arena.
+		 */
+		size_t _offset{0};
+		/**
+		 * @brief Holds the size of the view.
+		 */
+		size_t _size{0};
+		/**
+		 * @brief Holds the pointer when mapped.
+		 */
+		char* _ptr{nullptr};
+		/**
+		 * @brief Holds the amount of times the view is mapped.
+		 */
+		int _counter{0};
+};
+
+}// namespace sf::lnx
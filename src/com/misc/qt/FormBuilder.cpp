@@ -1,3 +1,4 @@
+#include <cstring>
 #include <qmetaobject.h>
 #include <QFrame>
 #include <QBoxLayout>
@@ -11,6 +12,29 @@
 #include <QFormLayout>
 #include <QLabel>
 #include <QTabWidget>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDockWidget>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QHash>
+#include <QIcon>
+#include <QMainWindow>
+#include <QMdiArea>
+#include <QMenu>
+#include <QMenuBar>
+#include <QMutex>
+#include <QSaveFile>
+#include <QScrollArea>
+#include <QSharedPointer>
+#include <QStackedWidget>
+#include <QStatusBar>
+#include <QToolBar>
+#include <QToolBox>
+#include <QWizard>
+#include <QXmlStreamReader>
+#include "../gen/TClassRegistration.h"
 #include "ObjectExtension.h"
 #include "FormBuilder.h"
 
@@ -289,6 +313,844 @@ bool isDispensablePropertyByValue(QObject* obj, const QString& name, const QVari
 	return false;
 }
 
+struct FormBuilder::Scan
+{
+	/**
+	 * @brief Widget element.
+	 */
+	struct Widget
+	{
+		QString className;
+		// Name of the parent widget element.
+		QString parent;
+		// Name of the layout element when present.
+		QString layout;
+		// Property names with the text of their value element in the order of the XML.
+		QList<QPair<QString, QString>> properties;
+		// Child widget elements not part of the layout.
+		QStringList children;
+	};
+
+	/**
+	 * @brief Layout element.
+	 */
+	struct Layout
+	{
+		QString className;
+		QStringList properties;
+	};
+
+	// Name of the root widget.
+	QString root;
+	// Widget elements by name.
+	QHash<QString, Widget> widgets;
+	// Layout elements by name.
+	QHash<QString, Layout> layouts;
+	// Amount of spacer elements.
+	qsizetype spacers{0};
+	// Names of the widgets in tab order.
+	QStringList tabStops;
+	// True when the compiled layout is able to represent the XML.
+	bool compilable{true};
+};
+
+struct FormBuilder::Compiled
+{
+	/**
+	 * @brief Kinds of nodes.
+	 */
+	enum EKind :qint32
+	{
+		kWidget = 0,
+		kLayout,
+		kSpacer,
+	};
+
+	/**
+	 * @brief Placements of a node in its parent.
+	 */
+	enum EPlacement :qint32
+	{
+		/** Child widget not in a layout. */
+		plFree = 0,
+		/** Item of the parent layout. */
+		plLayout,
+		/** Page of a container widget. */
+		plPage,
+	};
+
+	/**
+	 * @brief Property name and resolved value.
+	 */
+	typedef QPair<QByteArray, QVariant> Property;
+
+	/**
+	 * @brief Widget, layout or spacer having its parent node before it.
+	 */
+	struct Node
+	{
+		qint32 kind{kWidget};
+		QString className;
+		QString name;
+		// Index of the parent node or -1 for the root.
+		qint32 parent{-1};
+		qint32 placement{plFree};
+		// Position in the parent layout where the column is the role for a form layout.
+		qint32 row{0};
+		qint32 column{0};
+		qint32 rowSpan{1};
+		qint32 columnSpan{1};
+		qint32 stretch{0};
+		qint32 alignment{0};
+		// Page attributes for container widgets.
+		QString title;
+		QIcon icon;
+		QString toolTip;
+		QString whatsThis;
+		// Properties in the order to apply.
+		QList<Property> properties;
+		// Name of the buddy of a label.
+		QString buddy;
+		// Layout margins and spacing.
+		QMargins margins;
+		qint32 spacing{-1};
+		qint32 horizontalSpacing{-1};
+		qint32 verticalSpacing{-1};
+		QList<qint32> rowStretch;
+		QList<qint32> rowMinimum;
+		QList<qint32> columnStretch;
+		QList<qint32> columnMinimum;
+		// Spacer size and policies.
+		QSize size;
+		qint32 horizontalPolicy{0};
+		qint32 verticalPolicy{0};
+
+		friend QDataStream& operator<<(QDataStream& ds, const Node& node)
+		{
+			return ds << node.kind << node.className << node.name << node.parent << node.placement
+				<< node.row << node.column << node.rowSpan << node.columnSpan << node.stretch << node.alignment
+				<< node.title << node.icon << node.toolTip << node.whatsThis << node.properties << node.buddy
+				<< node.margins << node.spacing << node.horizontalSpacing << node.verticalSpacing
+				<< node.rowStretch << node.rowMinimum << node.columnStretch << node.columnMinimum
+				<< node.size << node.horizontalPolicy << node.verticalPolicy;
+		}
+
+		friend QDataStream& operator>>(QDataStream& ds, Node& node)
+		{
+			return ds >> node.kind >> node.className >> node.name >> node.parent >> node.placement
+				>> node.row >> node.column >> node.rowSpan >> node.columnSpan >> node.stretch >> node.alignment
+				>> node.title >> node.icon >> node.toolTip >> node.whatsThis >> node.properties >> node.buddy
+				>> node.margins >> node.spacing >> node.horizontalSpacing >> node.verticalSpacing
+				>> node.rowStretch >> node.rowMinimum >> node.columnStretch >> node.columnMinimum
+				>> node.size >> node.horizontalPolicy >> node.verticalPolicy;
+		}
+	};
+
+	// Nodes in creation order.
+	QList<Node> nodes;
+	// Names of the widgets in tab order.
+	QStringList tabStops;
+	// Geometry of the root widget.
+	QRect geometry;
+};
+
+// Anonymous namespace.
+namespace
+{
+
+// Identifies the cache file format which is also bound to the Qt version for the streamed variants.
+constexpr quint32 CacheMagic = 0x53465543;
+constexpr quint32 CacheVersion = 1;
+
+// Guards the compiled layouts and load times.
+QMutex CacheMutex;
+bool CacheEnabled{true};
+QHash<QByteArray, QSharedPointer<const FormBuilder::Compiled>> CompiledCache;
+FormBuilder::LoadTime LoadTimes[FormBuilder::lpCount];
+
+QSharedPointer<const FormBuilder::Compiled> findCompiled(const QByteArray& key)
+{
+	QMutexLocker lock(&CacheMutex);
+	return CompiledCache.value(key);
+}
+
+void storeCompiled(const QByteArray& key, const QSharedPointer<const FormBuilder::Compiled>& compiled)
+{
+	QMutexLocker lock(&CacheMutex);
+	CompiledCache.insert(key, compiled);
+}
+
+void addLoadTime(FormBuilder::ELoadPath path, qint64 nsecs)
+{
+	QMutexLocker lock(&CacheMutex);
+	auto& lt = LoadTimes[path];
+	lt.count++;
+	lt.total += nsecs;
+	lt.maximum = std::max(lt.maximum, nsecs);
+}
+
+QSharedPointer<const FormBuilder::Compiled> readCacheFile(const QString& path, const QByteArray& key)
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		return {};
+	}
+	QDataStream ds(&file);
+	ds.setVersion(QDataStream::Qt_6_0);
+	quint32 magic{0}, version{0}, qt{0};
+	QByteArray k;
+	ds >> magic >> version >> qt >> k;
+	if (ds.status() != QDataStream::Ok || magic != CacheMagic || version != CacheVersion || qt != QT_VERSION || k != key)
+	{
+		return {};
+	}
+	auto rv = QSharedPointer<FormBuilder::Compiled>::create();
+	ds >> rv->nodes >> rv->tabStops >> rv->geometry;
+	// Variants of types not registered at this moment fail to read.
+	if (ds.status() != QDataStream::Ok)
+	{
+		return {};
+	}
+	return rv;
+}
+
+void writeCacheFile(const QString& path, const QByteArray& key, const FormBuilder::Compiled& compiled)
+{
+	// Failing to write for instance a read-only directory only means the next process compiles again.
+	QSaveFile file(path);
+	if (file.open(QIODevice::WriteOnly))
+	{
+		QDataStream ds(&file);
+		ds.setVersion(QDataStream::Qt_6_0);
+		ds << CacheMagic << CacheVersion << quint32(QT_VERSION) << key;
+		ds << compiled.nodes << compiled.tabStops << compiled.geometry;
+		if (ds.status() == QDataStream::Ok)
+		{
+			file.commit();
+		}
+	}
+}
+
+QString attribute(const QXmlStreamReader& xml, const char* name)
+{
+	return xml.attributes().value(QLatin1String(name)).toString();
+}
+
+QRect readRect(QXmlStreamReader& xml)
+{
+	int x = 0, y = 0, width = 0, height = 0;
+	while (xml.readNextStartElement())
+	{
+		auto tag = xml.name().toString();
+		auto value = xml.readElementText().toInt();
+		if (tag == QLatin1String("x"))
+		{
+			x = value;
+		}
+		else if (tag == QLatin1String("y"))
+		{
+			y = value;
+		}
+		else if (tag == QLatin1String("width"))
+		{
+			width = value;
+		}
+		else if (tag == QLatin1String("height"))
+		{
+			height = value;
+		}
+	}
+	return {x, y, width, height};
+}
+
+void scanLayout(QXmlStreamReader& xml, FormBuilder::Scan& scan, const QString& owner);
+
+QString scanWidget(QXmlStreamReader& xml, FormBuilder::Scan& scan, const QString& parent)
+{
+	auto name = attribute(xml, "name");
+	FormBuilder::Scan::Widget wgt;
+	wgt.className = attribute(xml, "class");
+	wgt.parent = parent;
+	if (parent.isEmpty())
+	{
+		scan.root = name;
+	}
+	while (xml.readNextStartElement())
+	{
+		auto tag = xml.name();
+		if (tag == QLatin1String("property"))
+		{
+			auto pnm = attribute(xml, "name");
+			QString text;
+			// Text of the value element like the DOM would return it.
+			if (xml.readNextStartElement())
+			{
+				text = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+				xml.skipCurrentElement();
+			}
+			wgt.properties.append({pnm, text});
+		}
+		else if (tag == QLatin1String("attribute"))
+		{
+			// Only the page attributes of the container widgets are compiled.
+			static const QStringList pageAttributes{"title", "icon", "label", "toolTip", "whatsThis"};
+			if (!pageAttributes.contains(attribute(xml, "name")))
+			{
+				scan.compilable = false;
+			}
+			xml.skipCurrentElement();
+		}
+		else if (tag == QLatin1String("widget"))
+		{
+			wgt.children.append(scanWidget(xml, scan, name));
+		}
+		else if (tag == QLatin1String("layout"))
+		{
+			wgt.layout = attribute(xml, "name");
+			scanLayout(xml, scan, name);
+		}
+		else
+		{
+			// Items, actions, table rows and columns are not compiled.
+			if (tag != QLatin1String("zorder"))
+			{
+				scan.compilable = false;
+			}
+			xml.skipCurrentElement();
+		}
+	}
+	// Unnamed and duplicate widgets cannot be matched with the loaded ones.
+	if (name.isEmpty() || scan.widgets.contains(name))
+	{
+		scan.compilable = false;
+	}
+	scan.widgets.insert(name, wgt);
+	return name;
+}
+
+void scanLayout(QXmlStreamReader& xml, FormBuilder::Scan& scan, const QString& owner)
+{
+	auto name = attribute(xml, "name");
+	FormBuilder::Scan::Layout lay;
+	lay.className = attribute(xml, "class");
+	while (xml.readNextStartElement())
+	{
+		if (xml.name() == QLatin1String("property"))
+		{
+			lay.properties.append(attribute(xml, "name"));
+			xml.skipCurrentElement();
+		}
+		else if (xml.name() == QLatin1String("item"))
+		{
+			while (xml.readNextStartElement())
+			{
+				if (xml.name() == QLatin1String("widget"))
+				{
+					// Widgets in a layout have the widget owning the layout as parent.
+					scanWidget(xml, scan, owner);
+				}
+				else if (xml.name() == QLatin1String("layout"))
+				{
+					scanLayout(xml, scan, owner);
+				}
+				else
+				{
+					if (xml.name() == QLatin1String("spacer"))
+					{
+						scan.spacers++;
+					}
+					else
+					{
+						scan.compilable = false;
+					}
+					xml.skipCurrentElement();
+				}
+			}
+		}
+		else
+		{
+			scan.compilable = false;
+			xml.skipCurrentElement();
+		}
+	}
+	if (name.isEmpty() || scan.layouts.contains(name))
+	{
+		scan.compilable = false;
+	}
+	scan.layouts.insert(name, lay);
+}
+
+void scanUi(const QByteArray& data, FormBuilder::Scan& scan)
+{
+	QXmlStreamReader xml(data);
+	if (xml.readNextStartElement() && xml.name() == QLatin1String("ui"))
+	{
+		while (xml.readNextStartElement())
+		{
+			if (xml.name() == QLatin1String("widget"))
+			{
+				scanWidget(xml, scan, {});
+			}
+			else if (xml.name() == QLatin1String("tabstops"))
+			{
+				while (xml.readNextStartElement())
+				{
+					scan.tabStops.append(xml.readElementText());
+				}
+			}
+			else if (xml.name() == QLatin1String("connections") || xml.name() == QLatin1String("buttongroups"))
+			{
+				// Designer writes these elements empty most of the time.
+				if (xml.readNextStartElement())
+				{
+					scan.compilable = false;
+					xml.skipCurrentElement();
+					xml.skipCurrentElement();
+				}
+			}
+			else
+			{
+				xml.skipCurrentElement();
+			}
+		}
+	}
+	if (xml.hasError() || scan.root.isEmpty())
+	{
+		scan.compilable = false;
+	}
+}
+
+/**
+ * @brief Compiles the widget tree after loading it from XML.
+ */
+struct Compiler
+{
+	typedef FormBuilder::Compiled Compiled;
+
+	const FormBuilder::Scan& scan;
+	Compiled& compiled;
+	qsizetype widgets{0};
+	qsizetype layouts{0};
+	qsizetype spacers{0};
+
+	bool property(QObject* obj, const QString& name, Compiled::Node& node)
+	{
+		auto key = name.toLatin1();
+		auto value = obj->property(key.constData());
+		if (!value.isValid())
+		{
+			return false;
+		}
+		auto idx = obj->metaObject()->indexOfProperty(key.constData());
+		// Enumerations and flags are stored as integers which the meta property converts back.
+		if (idx >= 0 && (obj->metaObject()->property(idx).isEnumType() || obj->metaObject()->property(idx).isFlagType()))
+		{
+			bool ok = false;
+			int v = value.toInt(&ok);
+			if (!ok)
+			{
+				if (value.metaType().sizeOf() != static_cast<qsizetype>(sizeof(int)))
+				{
+					return false;
+				}
+				std::memcpy(&v, value.constData(), sizeof(int));
+			}
+			value = QVariant(v);
+		}
+		if (!value.metaType().hasRegisteredDataStreamOperators())
+		{
+			return false;
+		}
+		node.properties.append({key, value});
+		return true;
+	}
+
+	bool widget(QWidget* w, const QString& name, Compiled::Node node)
+	{
+		auto it = scan.widgets.constFind(name);
+		if (it == scan.widgets.constEnd())
+		{
+			return false;
+		}
+		// Widgets having a structure not represented by the compiled layout.
+		if (qobject_cast<QMainWindow*>(w) || qobject_cast<QDockWidget*>(w) || qobject_cast<QMdiArea*>(w) || qobject_cast<QWizard*>(w) ||
+			qobject_cast<QToolBar*>(w) || qobject_cast<QMenuBar*>(w) || qobject_cast<QMenu*>(w) || qobject_cast<QStatusBar*>(w))
+		{
+			return false;
+		}
+		node.kind = Compiled::kWidget;
+		node.className = it->className;
+		node.name = name;
+		// A 'Line' widget is a frame having its orientation applied through the frame shape.
+		bool line = it->className == QLatin1String("Line");
+		for (auto& prop: it->properties)
+		{
+			// The buddy is resolved by name after all widgets have been created.
+			if ((prop.first == QLatin1String("buddy") && qobject_cast<QLabel*>(w)) || (line && prop.first == QLatin1String("orientation")))
+			{
+				continue;
+			}
+			if (!property(w, prop.first, node))
+			{
+				return false;
+			}
+		}
+		if (line && (!property(w, "frameShape", node) || !property(w, "frameShadow", node)))
+		{
+			return false;
+		}
+		// Dynamic properties set by the loading or the widget itself.
+		for (auto& dpn: w->dynamicPropertyNames())
+		{
+			if (dpn.startsWith("_q_") || std::any_of(node.properties.cbegin(), node.properties.cend(), [&dpn](const Compiled::Property& p) {
+				return p.first == dpn;
+			}))
+			{
+				continue;
+			}
+			if (!property(w, QString::fromLatin1(dpn), node))
+			{
+				return false;
+			}
+		}
+		if (auto lbl = qobject_cast<QLabel*>(w))
+		{
+			if (lbl->buddy())
+			{
+				node.buddy = lbl->buddy()->objectName();
+			}
+		}
+		auto index = static_cast<qint32>(compiled.nodes.size());
+		compiled.nodes.append(node);
+		widgets++;
+		// Child widgets are created before the layout like the form builder does.
+		for (auto& child: it->children)
+		{
+			auto cw = w->findChild<QWidget*>(child);
+			if (!cw)
+			{
+				return false;
+			}
+			Compiled::Node cn;
+			cn.parent = index;
+			cn.placement = Compiled::plPage;
+			if (auto tw = qobject_cast<QTabWidget*>(w))
+			{
+				auto i = tw->indexOf(cw);
+				if (i < 0)
+				{
+					return false;
+				}
+				cn.title = tw->tabText(i);
+				cn.icon = tw->tabIcon(i);
+				cn.toolTip = tw->tabToolTip(i);
+				cn.whatsThis = tw->tabWhatsThis(i);
+			}
+			else if (auto tb = qobject_cast<QToolBox*>(w))
+			{
+				auto i = tb->indexOf(cw);
+				if (i < 0)
+				{
+					return false;
+				}
+				cn.title = tb->itemText(i);
+				cn.icon = tb->itemIcon(i);
+				cn.toolTip = tb->itemToolTip(i);
+			}
+			else if (auto sw = qobject_cast<QStackedWidget*>(w))
+			{
+				if (sw->indexOf(cw) < 0)
+				{
+					return false;
+				}
+			}
+			else if (auto sp = qobject_cast<QSplitter*>(w))
+			{
+				if (sp->indexOf(cw) < 0)
+				{
+					return false;
+				}
+			}
+			else if (auto sa = qobject_cast<QScrollArea*>(w))
+			{
+				if (sa->widget() != cw)
+				{
+					return false;
+				}
+			}
+			else if (cw->parentWidget() == w)
+			{
+				cn.placement = Compiled::plFree;
+			}
+			else
+			{
+				return false;
+			}
+			if (!widget(cw, child, cn))
+			{
+				return false;
+			}
+		}
+		// Widgets creating their own layout are skipped when the XML has none.
+		if (!it->layout.isEmpty())
+		{
+			if (!w->layout() || w->layout()->objectName() != it->layout)
+			{
+				return false;
+			}
+			Compiled::Node ln;
+			ln.parent = index;
+			ln.placement = Compiled::plLayout;
+			if (!layout(w->layout(), ln))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool layout(QLayout* l, Compiled::Node node)
+	{
+		auto it = scan.layouts.constFind(l->objectName());
+		if (it == scan.layouts.constEnd())
+		{
+			return false;
+		}
+		node.kind = Compiled::kLayout;
+		node.className = it->className;
+		node.name = l->objectName();
+		// Margins and spacing are always stored.
+		static const QStringList handled{"leftMargin", "topMargin", "rightMargin", "bottomMargin", "spacing", "horizontalSpacing", "verticalSpacing"};
+		for (auto& pnm: it->properties)
+		{
+			if (!handled.contains(pnm) && !property(l, pnm, node))
+			{
+				return false;
+			}
+		}
+		node.margins = l->contentsMargins();
+		node.spacing = l->spacing();
+		auto grid = qobject_cast<QGridLayout*>(l);
+		auto form = qobject_cast<QFormLayout*>(l);
+		auto box = qobject_cast<QBoxLayout*>(l);
+		if (grid)
+		{
+			node.horizontalSpacing = grid->horizontalSpacing();
+			node.verticalSpacing = grid->verticalSpacing();
+			for (int r = 0; r < grid->rowCount(); r++)
+			{
+				node.rowStretch.append(grid->rowStretch(r));
+				node.rowMinimum.append(grid->rowMinimumHeight(r));
+			}
+			for (int c = 0; c < grid->columnCount(); c++)
+			{
+				node.columnStretch.append(grid->columnStretch(c));
+				node.columnMinimum.append(grid->columnMinimumWidth(c));
+			}
+		}
+		else if (form)
+		{
+			node.horizontalSpacing = form->horizontalSpacing();
+			node.verticalSpacing = form->verticalSpacing();
+		}
+		else if (!box)
+		{
+			return false;
+		}
+		auto index = static_cast<qint32>(compiled.nodes.size());
+		compiled.nodes.append(node);
+		layouts++;
+		for (int i = 0; i < l->count(); i++)
+		{
+			auto item = l->itemAt(i);
+			Compiled::Node cn;
+			cn.parent = index;
+			cn.placement = Compiled::plLayout;
+			cn.alignment = static_cast<qint32>(item->alignment());
+			if (grid)
+			{
+				grid->getItemPosition(i, &cn.row, &cn.column, &cn.rowSpan, &cn.columnSpan);
+			}
+			else if (form)
+			{
+				QFormLayout::ItemRole role;
+				form->getItemPosition(i, &cn.row, &role);
+				cn.column = role;
+			}
+			else
+			{
+				cn.stretch = box->stretch(i);
+			}
+			if (auto w = item->widget())
+			{
+				if (!widget(w, w->objectName(), cn))
+				{
+					return false;
+				}
+			}
+			else if (auto nl = item->layout())
+			{
+				if (!layout(nl, cn))
+				{
+					return false;
+				}
+			}
+			else if (auto spacer = item->spacerItem())
+			{
+				cn.kind = Compiled::kSpacer;
+				cn.size = spacer->sizeHint();
+				cn.horizontalPolicy = spacer->sizePolicy().horizontalPolicy();
+				cn.verticalPolicy = spacer->sizePolicy().verticalPolicy();
+				compiled.nodes.append(cn);
+				spacers++;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+void setNodeProperties(QObject* obj, const FormBuilder::Compiled::Node& node, QList<QPair<QObject*, const FormBuilder::Compiled::Property*>>& deferred)
+{
+	for (auto& prop: node.properties)
+	{
+		// The current index of containers is applied when the pages exist.
+		if (prop.first == "currentIndex")
+		{
+			deferred.append({obj, &prop});
+		}
+		else
+		{
+			obj->setProperty(prop.first.constData(), prop.second);
+		}
+	}
+}
+
+void setLayoutValues(QLayout* layout, const FormBuilder::Compiled::Node& node)
+{
+	layout->setContentsMargins(node.margins);
+	if (auto grid = qobject_cast<QGridLayout*>(layout))
+	{
+		grid->setHorizontalSpacing(node.horizontalSpacing);
+		grid->setVerticalSpacing(node.verticalSpacing);
+		for (int r = 0; r < node.rowStretch.size(); r++)
+		{
+			grid->setRowStretch(r, node.rowStretch.at(r));
+			grid->setRowMinimumHeight(r, node.rowMinimum.value(r));
+		}
+		for (int c = 0; c < node.columnStretch.size(); c++)
+		{
+			grid->setColumnStretch(c, node.columnStretch.at(c));
+			grid->setColumnMinimumWidth(c, node.columnMinimum.value(c));
+		}
+	}
+	else if (auto form = qobject_cast<QFormLayout*>(layout))
+	{
+		form->setHorizontalSpacing(node.horizontalSpacing);
+		form->setVerticalSpacing(node.verticalSpacing);
+	}
+	else
+	{
+		layout->setSpacing(node.spacing);
+	}
+}
+
+bool addToLayout(QLayout* layout, const FormBuilder::Compiled::Node& node, QWidget* wgt, QLayout* lay, QLayoutItem* item)
+{
+	auto alignment = static_cast<Qt::Alignment>(node.alignment);
+	if (auto box = qobject_cast<QBoxLayout*>(layout))
+	{
+		if (wgt)
+		{
+			box->addWidget(wgt, node.stretch, alignment);
+		}
+		else if (lay)
+		{
+			box->addLayout(lay, node.stretch);
+			lay->setAlignment(alignment);
+		}
+		else
+		{
+			box->addItem(item);
+			box->setStretch(box->count() - 1, node.stretch);
+		}
+	}
+	else if (auto grid = qobject_cast<QGridLayout*>(layout))
+	{
+		if (wgt)
+		{
+			grid->addWidget(wgt, node.row, node.column, node.rowSpan, node.columnSpan, alignment);
+		}
+		else if (lay)
+		{
+			grid->addLayout(lay, node.row, node.column, node.rowSpan, node.columnSpan, alignment);
+		}
+		else
+		{
+			grid->addItem(item, node.row, node.column, node.rowSpan, node.columnSpan, alignment);
+		}
+	}
+	else if (auto form = qobject_cast<QFormLayout*>(layout))
+	{
+		auto role = static_cast<QFormLayout::ItemRole>(node.column);
+		if (wgt)
+		{
+			form->setWidget(node.row, role, wgt);
+		}
+		else if (lay)
+		{
+			form->setLayout(node.row, role, lay);
+		}
+		else
+		{
+			form->setItem(node.row, role, item);
+		}
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+bool addPage(QWidget* container, const FormBuilder::Compiled::Node& node, QWidget* wgt)
+{
+	if (auto tw = qobject_cast<QTabWidget*>(container))
+	{
+		auto i = tw->addTab(wgt, node.icon, node.title);
+		tw->setTabToolTip(i, node.toolTip);
+		tw->setTabWhatsThis(i, node.whatsThis);
+	}
+	else if (auto tb = qobject_cast<QToolBox*>(container))
+	{
+		auto i = tb->addItem(wgt, node.icon, node.title);
+		tb->setItemToolTip(i, node.toolTip);
+	}
+	else if (auto sw = qobject_cast<QStackedWidget*>(container))
+	{
+		sw->addWidget(wgt);
+	}
+	else if (auto sp = qobject_cast<QSplitter*>(container))
+	{
+		sp->addWidget(wgt);
+	}
+	else if (auto sa = qobject_cast<QScrollArea*>(container))
+	{
+		sa->setWidget(wgt);
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+}
+
 QList<DomProperty*> FormBuilder::computeProperties(QObject* obj)
 {
 	auto list = QFormBuilder::computeProperties(obj);
@@ -358,31 +1220,93 @@ QList<DomProperty*> FormBuilder::computeProperties(QObject* obj)
 	return map.values();
 }
 
+QWidget* FormBuilder::createWidget(const QString& widgetName, QWidget* parentWidget, const QString& name)
+{
+	auto wgt = QFormBuilder::createWidget(widgetName, parentWidget, name);
+	if (!wgt && requireProvider(widgetName.toStdString()))
+	{
+		// Rescan the plugins for the custom widgets of the loaded library.
+		setPluginPath(pluginPaths());
+		wgt = QFormBuilder::createWidget(widgetName, parentWidget, name);
+	}
+	return wgt;
+}
+
 QWidget* FormBuilder::load(QIODevice* dev, QWidget* parentWidget)
 {
-	// Create a dom to hold the XML.
-	QDomDocument dom;
-	// Read the dom contents from the device.
-	dom.setContent(dev->readAll());
+	QElapsedTimer timer;
+	timer.start();
+	// Read the XML only once.
+	auto data = dev->readAll();
+	auto cached = isCacheEnabled();
+	// Key of the compiled layout.
+	QByteArray key;
+	// Cache file located next to the ui-file.
+	QString cacheFile;
+	if (cached)
+	{
+		key = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+		// Resources and other devices only use the cache in memory.
+		auto fd = qobject_cast<QFileDevice*>(dev);
+		if (fd && !fd->fileName().isEmpty() && !fd->fileName().startsWith(':'))
+		{
+			QFileInfo fi(fd->fileName());
+			cacheFile = fi.absoluteDir().filePath('.' + fi.fileName() + ".cache");
+		}
+		if (auto compiled = findCompiled(key))
+		{
+			if (auto widget = instantiate(*compiled, parentWidget))
+			{
+				addLoadTime(lpMemory, timer.nsecsElapsed());
+				return widget;
+			}
+		}
+		else if (!cacheFile.isEmpty())
+		{
+			if (auto compiled = readCacheFile(cacheFile, key))
+			{
+				storeCompiled(key, compiled);
+				if (auto widget = instantiate(*compiled, parentWidget))
+				{
+					addLoadTime(lpFile, timer.nsecsElapsed());
+					return widget;
+				}
+			}
+		}
+	}
+	// Gather the information not available from the loaded widgets.
+	Scan scan;
+	scanUi(data, scan);
 	// Root widget when loaded.
 	QWidget* widget;
 	// Make buffer go out of scope when done.
 	{
-		// Create an IO device for loading the form builder.
-		QBuffer buf;
-		// Open the buffer device.
-		buf.open(QIODevice::ReadWrite);
-		// Write the dom doc in the buffer.
-		buf.write(dom.toByteArray());
-		// Move pointer to start of the buffer for reading.
-		buf.seek(0);
+		// Create an IO device on the read data for loading the form builder.
+		QBuffer buf(&data);
+		buf.open(QIODevice::ReadOnly);
 		// Load the UI XML from the buffer.
 		widget = QFormBuilder::load(&buf, parentWidget);
 	}
 	// Check if the resulting widget is valid.
 	if (widget)
 	{
-		fixLoadingProperties(widget, dom);
+		fixLoadingProperties(widget, scan);
+	}
+	addLoadTime(lpXml, timer.nsecsElapsed());
+	// Compile the loaded layout for the next time.
+	if (widget && cached && scan.compilable)
+	{
+		timer.restart();
+		auto compiled = QSharedPointer<Compiled>::create();
+		if (compile(widget, scan, *compiled))
+		{
+			storeCompiled(key, compiled);
+			if (!cacheFile.isEmpty())
+			{
+				writeCacheFile(cacheFile, key, *compiled);
+			}
+		}
+		addLoadTime(lpCompile, timer.nsecsElapsed());
 	}
 	return widget;
 }
@@ -779,75 +1703,260 @@ void FormBuilder::fixSavingProperties(QWidget* widget, QDomDocument& dom)
 	}
 }
 
-void FormBuilder::fixLoadingProperties(QWidget* widget, QDomDocument& dom)
+void FormBuilder::fixLoadingProperties(QWidget* widget, const Scan& scan)
 {
 	// Create property name cache for each specific class.
 	QMap<QString, QStringList> cache;
-	// Get the root widget element.
-	auto root = dom.firstChildElement("ui").firstChildElement("widget");
 	// Fix QWidget or derived elements custom properties.
+	for (auto it = scan.widgets.constBegin(); it != scan.widgets.constEnd(); ++it)
 	{
-		// Iterate through all dom elements
-		iterateDomElements(dom, root, [widget, &cache](const QDomElement& elem)
+		// Get a child by name if it is not the root widget itself.
+		auto wgt = (it.key() == widget->objectName()) ? widget : widget->findChild<QWidget*>(it.key());
+		// Only widgets having dynamic properties need fixing.
+		if (!wgt || wgt->dynamicPropertyNames().isEmpty())
 		{
-			// Only check widget dom elements.
-			if (elem.nodeName() == "widget")
+			continue;
+		}
+		// Get the widgets meta-object.
+		auto mo = wgt->metaObject();
+		// When the cache entry does not exist for this class name yet created it.
+		if (!cache.contains(mo->className()))
+		{
+			// Easy access reference to the list.
+			QStringList& nms = cache[mo->className()];
+			// Iterate through its properties to collect names.
+			for (int idx = 0; idx < mo->propertyCount(); ++idx)
 			{
-				// Get the name attribute of the widget element.
-				auto attr = elem.attributes().namedItem("name");
-				// Check if the attribute is valid attribute and the name is not empty.
-				if (!attr.isNull() && !attr.nodeValue().isEmpty())
+				// Add each known property to the string list.
+				nms.append(mo->property(idx).name());
+			}
+		}
+		// Get all non-dynamic properties in a list for comparison.
+		QStringList& names = cache[mo->className()];
+		// Iterate through the properties of the widget element.
+		for (auto& prop: it->properties)
+		{
+			// Check if the name is not in the list of non-dynamic properties.
+			if (!prop.first.isEmpty() && !names.contains(prop.first))
+			{
+				wgt->setProperty(prop.first.toLocal8Bit(), prop.second);
+			}
+		}
+	}
+}
+
+bool FormBuilder::compile(QWidget* widget, const Scan& scan, Compiled& compiled)
+{
+	if (widget->objectName() != scan.root)
+	{
+		return false;
+	}
+	Compiler compiler{scan, compiled};
+	if (!compiler.widget(widget, scan.root, {}))
+	{
+		return false;
+	}
+	// Every element of the XML must have been compiled.
+	if (compiler.widgets != scan.widgets.size() || compiler.layouts != scan.layouts.size() || compiler.spacers != scan.spacers)
+	{
+		return false;
+	}
+	compiled.tabStops = scan.tabStops;
+	compiled.geometry = widget->geometry();
+	return true;
+}
+
+QWidget* FormBuilder::instantiate(const Compiled& compiled, QWidget* parentWidget)
+{
+	auto& nodes = compiled.nodes;
+	// Objects created for each node.
+	QList<QObject*> objects(nodes.size(), nullptr);
+	// Widget owning the created widget or layout of each node.
+	QList<QWidget*> owners(nodes.size(), nullptr);
+	// Properties applied after the children have been created.
+	QList<QPair<QObject*, const Compiled::Property*>> deferred;
+	QWidget* root{nullptr};
+	bool ok = !nodes.isEmpty();
+	for (qsizetype i = 0; ok && i < nodes.size(); i++)
+	{
+		auto& node = nodes.at(i);
+		auto parent = node.parent >= 0 ? objects.at(node.parent) : nullptr;
+		auto parentLayout = qobject_cast<QLayout*>(parent);
+		// Widget being the parent of the created widgets.
+		auto parentWgt = node.parent < 0 ? parentWidget : parentLayout ? owners.at(node.parent) : qobject_cast<QWidget*>(parent);
+		switch (node.kind)
+		{
+			case Compiled::kWidget:
+			{
+				auto wgt = createWidget(node.className, parentWgt, node.name);
+				if (!wgt)
 				{
-					auto wgt_name = attr.nodeValue();
-					// Get a child by name if it is not the root widget itself.
-					if (auto wgt = (wgt_name == widget->objectName()) ? widget : widget->findChild<QWidget*>(wgt_name))
+					ok = false;
+					break;
+				}
+				if (!root)
+				{
+					root = wgt;
+				}
+				objects[i] = wgt;
+				owners[i] = wgt;
+				setNodeProperties(wgt, node, deferred);
+				if (node.placement == Compiled::plLayout)
+				{
+					ok = addToLayout(parentLayout, node, wgt, nullptr, nullptr);
+				}
+				else if (node.placement == Compiled::plPage)
+				{
+					ok = addPage(qobject_cast<QWidget*>(parent), node, wgt);
+				}
+				break;
+			}
+
+			case Compiled::kLayout:
+			{
+				auto lay = createLayout(node.className, parentLayout ? static_cast<QObject*>(parentLayout) : parentWgt, node.name);
+				if (!lay)
+				{
+					ok = false;
+					break;
+				}
+				objects[i] = lay;
+				owners[i] = parentWgt;
+				setNodeProperties(lay, node, deferred);
+				setLayoutValues(lay, node);
+				if (parentLayout && !(ok = addToLayout(parentLayout, node, nullptr, lay, nullptr)))
+				{
+					delete lay;
+				}
+				break;
+			}
+
+			case Compiled::kSpacer:
+			{
+				auto spacer = new QSpacerItem(node.size.width(), node.size.height(),
+					static_cast<QSizePolicy::Policy>(node.horizontalPolicy), static_cast<QSizePolicy::Policy>(node.verticalPolicy));
+				if (!(ok = addToLayout(parentLayout, node, nullptr, nullptr, spacer)))
+				{
+					delete spacer;
+				}
+				break;
+			}
+
+			default:
+				ok = false;
+		}
+	}
+	if (!ok)
+	{
+		delete root;
+		return nullptr;
+	}
+	for (auto& entry: deferred)
+	{
+		entry.first->setProperty(entry.second->first.constData(), entry.second->second);
+	}
+	// Resolve the buddies now all widgets exist.
+	for (qsizetype i = 0; i < nodes.size(); i++)
+	{
+		if (!nodes.at(i).buddy.isEmpty())
+		{
+			if (auto lbl = qobject_cast<QLabel*>(objects.at(i)))
+			{
+				lbl->setBuddy(root->findChild<QWidget*>(nodes.at(i).buddy));
+			}
+		}
+	}
+	// Apply the tab order.
+	QWidget* previous{nullptr};
+	for (auto& name: compiled.tabStops)
+	{
+		auto wgt = (name == root->objectName()) ? root : root->findChild<QWidget*>(name);
+		if (wgt && previous)
+		{
+			QWidget::setTabOrder(previous, wgt);
+		}
+		previous = wgt;
+	}
+	return root;
+}
+
+void FormBuilder::setCacheEnabled(bool yn)
+{
+	QMutexLocker lock(&CacheMutex);
+	CacheEnabled = yn;
+}
+
+bool FormBuilder::isCacheEnabled()
+{
+	QMutexLocker lock(&CacheMutex);
+	return CacheEnabled;
+}
+
+void FormBuilder::clearCache()
+{
+	QMutexLocker lock(&CacheMutex);
+	CompiledCache.clear();
+}
+
+QRect FormBuilder::peekGeometry(QIODevice* dev)
+{
+	auto data = dev->readAll();
+	if (isCacheEnabled())
+	{
+		if (auto compiled = findCompiled(QCryptographicHash::hash(data, QCryptographicHash::Sha1)))
+		{
+			return compiled->geometry;
+		}
+	}
+	// Read the XML up to the geometry property of the root widget.
+	QXmlStreamReader xml(data);
+	if (xml.readNextStartElement() && xml.name() == QLatin1String("ui"))
+	{
+		while (xml.readNextStartElement())
+		{
+			if (xml.name() != QLatin1String("widget"))
+			{
+				xml.skipCurrentElement();
+				continue;
+			}
+			while (xml.readNextStartElement())
+			{
+				if (xml.name() == QLatin1String("property") && attribute(xml, "name") == QLatin1String("geometry"))
+				{
+					if (xml.readNextStartElement() && xml.name() == QLatin1String("rect"))
 					{
-						// Get the widgets meta-object.
-						auto mo = wgt->metaObject();
-						// When the cache entry does not exist for this class name yet created it.
-						if (!cache.contains(mo->className()))
-						{
-							// Easy access reference to the list.
-							QStringList& nms = cache[mo->className()];
-							// Iterate through its properties to collect names.
-							for (int idx = 0; idx < mo->propertyCount(); ++idx)
-							{
-								// Add each known property to the string list.
-								nms.append(mo->property(idx).name());
-							}
-						}
-						// Get all non-dynamic properties in a list for comparison.
-						QStringList& names = cache[mo->className()];
-						// Iterate through property elements in the dom.
-						for (auto& pnm: wgt->dynamicPropertyNames())
-						{
-							// Get the first property element.
-							auto pel = elem.firstChildElement("property");
-							while (!pel.isNull())
-							{
-								// Get the property name attribute of the property dom element.
-								auto pna = pel.attributes().namedItem("name");
-								// Check its validity.
-								if (!pna.isNull())
-								{
-									// Get the property's n ode attributes node value.
-									auto anv = pna.nodeValue();
-									// Check if the name is not in the list of non-dynamic properties.
-									if (!anv.isEmpty() && !names.contains(pna.nodeValue()))
-									{
-										auto pnv = pel.firstChildElement().text();
-										wgt->setProperty(anv.toLocal8Bit(), pnv);
-									}
-								}
-								// Go to the next property of this widget element.
-								pel = pel.nextSiblingElement("property");
-							}
-						}
+						return readRect(xml);
 					}
+					break;
 				}
+				xml.skipCurrentElement();
 			}
-		});
+			break;
+		}
 	}
+	return {};
+}
+
+FormBuilder::LoadTime FormBuilder::getLoadTime(ELoadPath path)
+{
+	QMutexLocker lock(&CacheMutex);
+	return (path >= 0 && path < lpCount) ? LoadTimes[path] : LoadTime{};
+}
+
+QString FormBuilder::getLoadReport()
+{
+	static const char* names[lpCount] = {"XML", "Compile", "Cache file", "Memory"};
+	QString rv("Layout load times:");
+	for (int i = 0; i < lpCount; i++)
+	{
+		auto lt = getLoadTime(static_cast<ELoadPath>(i));
+		rv += QString("\n  %1 %2 loads, average %3 ms, maximum %4 ms")
+			.arg(QString(names[i]) + ':', -12)
+			.arg(lt.count, 6)
+			.arg(lt.count ? static_cast<double>(lt.total) / static_cast<double>(lt.count) / 1e6 : 0.0, 9, 'f', 3)
+			.arg(static_cast<double>(lt.maximum) / 1e6, 9, 'f', 3);
+	}
+	return rv;
 }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QtDesigner/QFormBuilder>
+#include <QRect>
 
 #include "../global.h"
 
@@ -11,10 +12,51 @@ namespace sf
 {
 /**
  * @brief Derived class to be able to prevent some properties to be stored when written to file.
+ *
+ * Loaded layouts are compiled into a binary representation of the widget tree having the resolved property values.
+ * The compiled layout is cached in memory and in a hidden file next to the ui-file both keyed by the hash of the XML content.
+ * Loading a layout having a cached compiled version creates the widgets without parsing the XML.
+ * Layouts using features not represented by the compiled version like connections, actions or item lists are always loaded from XML.
  */
 class _MISC_CLASS FormBuilder :public ::QFormBuilder
 {
 	public:
+		/**
+		 * @brief Paths a layout can be loaded through.
+		 */
+		enum ELoadPath :int
+		{
+			/** Parsing the XML. */
+			lpXml = 0,
+			/** Compiling after parsing the XML including writing the cache file. */
+			lpCompile,
+			/** Instantiating from the compiled layout read from the cache file. */
+			lpFile,
+			/** Instantiating from the compiled layout in memory. */
+			lpMemory,
+			/** Amount of paths. */
+			lpCount
+		};
+
+		/**
+		 * @brief Timing of a load path.
+		 */
+		struct LoadTime
+		{
+			/**
+			 * @brief Amount of loads.
+			 */
+			qint64 count{0};
+			/**
+			 * @brief Accumulated time in nanoseconds.
+			 */
+			qint64 total{0};
+			/**
+			 * @brief Longest time in nanoseconds.
+			 */
+			qint64 maximum{0};
+		};
+
 		/**
 		 * @brief Overridden from QFormBuilder base class.
 		 */
@@ -25,22 +67,87 @@ class _MISC_CLASS FormBuilder :public ::QFormBuilder
 		 */
 		void save(QIODevice* dev, QWidget* widget) override;
 
+		/**
+		 * @brief Enables or disables the use of compiled layouts which is enabled by default.
+		 */
+		static void setCacheEnabled(bool yn);
+
+		/**
+		 * @brief Gets whether compiled layouts are used.
+		 */
+		static bool isCacheEnabled();
+
+		/**
+		 * @brief Clears the compiled layouts held in memory.
+		 */
+		static void clearCache();
+
+		/**
+		 * @brief Gets the geometry of the root widget without creating any widget.
+		 *
+		 * Uses the compiled layout when available and otherwise only reads the XML up to the geometry property.
+		 * @param dev Device to read the ui-file from.
+		 * @return Empty rectangle when not found.
+		 */
+		static QRect peekGeometry(QIODevice* dev);
+
+		/**
+		 * @brief Gets the timing of the passed load path.
+		 */
+		static LoadTime getLoadTime(ELoadPath path);
+
+		/**
+		 * @brief Gets a report comparing the timing of the load paths.
+		 */
+		static QString getLoadReport();
+
+		/**
+		 * @brief Holds the widget tree information read from the XML.
+		 */
+		struct Scan;
+
+		/**
+		 * @brief Compiled representation of a layout.
+		 */
+		struct Compiled;
+
 	protected:
 		/**
 		 * @brief Overridden from QFormBuilder base class.
 		 */
 		QList<DomProperty*> computeProperties(QObject* obj) override;
 
+		/**
+		 * @brief Overridden from QFormBuilder base class.
+		 *
+		 * Loads the pending library providing the widget class when it is not available.
+		 */
+		QWidget* createWidget(const QString& widgetName, QWidget* parentWidget, const QString& name) override;
+
 		/**
 		 * @brief Fixes the missing property dom elements when saving the dom.
 		 */
 		void fixSavingProperties(QWidget* widget, QDomDocument& dom);
 
 		/**
-		 * @brief Fixes the missing property dom elements when loading the dom.
+		 * @brief Fixes the missing dynamic properties after loading.
+		 */
+		void fixLoadingProperties(QWidget* widget, const Scan& scan);
+
+	private:
+		/**
+		 * @brief Compiles the loaded widget tree into the passed instance.
+		 *
+		 * @return False when the layout cannot be represented.
 		 */
-		void fixLoadingProperties(QWidget* widget, QDomDocument& dom);
+		bool compile(QWidget* widget, const Scan& scan, Compiled& compiled);
+
+		/**
+		 * @brief Creates the widgets from the compiled layout.
+		 *
+		 * @return Nullptr on failure.
+		 */
+		QWidget* instantiate(const Compiled& compiled, QWidget* parentWidget);
 };
 
 }
-
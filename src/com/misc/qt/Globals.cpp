@@ -85,6 +85,16 @@ void FormBuilderSave(QIODevice* io, QWidget* widget)
 	getGlobalFormBuilder()->save(io, widget);
 }
 
+QRect FormBuilderGeometry(QIODevice* io)
+{
+	return FormBuilder::peekGeometry(io);
+}
+
+QString FormBuilderLoadReport()
+{
+	return FormBuilder::getLoadReport();
+}
+
 void setPluginDir(QString dir)
 {
 	PluginDir = dir;
@@ -11,6 +11,8 @@ class QWidget;
 
 class QIODevice;
 
+class QRect;
+
 namespace sf
 {
 
@@ -83,4 +85,16 @@ _MISC_FUNC QWidget* FormBuilderLoad(QIODevice* io, QWidget* parent);
  */
 _MISC_FUNC void FormBuilderSave(QIODevice* io, QWidget* widget);
 
+/**
+ * @brief Gets the geometry of the root widget from the passed UI file without creating the widgets.
+ *
+ * Allows sizing containers before loading the form when it is needed.
+ */
+_MISC_FUNC QRect FormBuilderGeometry(QIODevice* io);
+
+/**
+ * @brief Gets the report comparing the timing of loading forms from XML and the compiled cache.
+ */
+_MISC_FUNC QString FormBuilderLoadReport();
+
 }
\ No newline at end of file
@@ -46,19 +46,30 @@ Graph::RulerInfo* Graph::getRulerInfo(Draw::ERulerOrientation ro)
 
 void Graph::setColor(Graph::EColor index, QColor color)
 {
-	_colors[index] = color;
+	if (_colors[index] != color)
+	{
+		_colors[index] = color;
+		_layerValid = false;
+	}
 }
 
 void Graph::setRuler(Draw::ERulerOrientation ro, double start, double stop, int digits, const QString& unit)
 {
 	auto ri = getRulerInfo(ro);
 	// Setting information enables the ruler too when the amount of digits is non-zero.
-	ri->enabled = digits > 0;
-	ri->start = start;
-	ri->stop = stop;
+	bool enabled = digits > 0;
 	// Do not allow
-	ri->digits = clip(digits, 1, 10);
-	ri->unit = unit;
+	digits = clip(digits, 1, 10);
+	// Only invalidate the cached layer when something changed.
+	if (ri->enabled != enabled || ri->start != start || ri->stop != stop || ri->digits != digits || ri->unit != unit)
+	{
+		ri->enabled = enabled;
+		ri->start = start;
+		ri->stop = stop;
+		ri->digits = digits;
+		ri->unit = unit;
+		_layerValid = false;
+	}
 }
 
 void Graph::setBounds(const QFontMetrics& fm, const QRect& bounds)
@@ -75,29 +86,35 @@ void Graph::setBounds(const QFontMetrics& fm, const QRect& bounds)
 		_bottom.enabled ? -_bottom.size : 0);
 }
 
-const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion& region)
+void Graph::invalidate()
 {
-	Draw draw;
-	// Get font sizes to calculate needed widths and heights.
-	setBounds(QFontMetrics(painter.font()), bounds);
-	// When the background is a valid color paint int.
-	if (_colors[cGraphBackground].isValid())
+	_layerValid = false;
+}
+
+void Graph::setCaching(bool enable)
+{
+	_caching = enable;
+	// Release the memory when not used.
+	if (!_caching)
 	{
-		painter.fillRect(_plotArea, _colors[cGraphBackground]);
+		_layer = {};
+		_layerValid = false;
 	}
+}
+
+bool Graph::isCaching() const
+{
+	return _caching;
+}
+
+void Graph::layoutRulers(const QRect& bounds)
+{
 	// When there is a left ruler.
 	if (_left.enabled)
 	{
 		_left.rect = bounds;
 		_left.rect.setWidth(_left.size);
 		_left.bounds = _left.rect;
-		// The area allowed painting in.
-		auto area = _left.bounds;
-		// Draw background of ruler area.
-		if (_colors[cRulerBackground].isValid() && !_debug)
-		{
-			painter.fillRect(_left.rect, _colors[cRulerBackground]);
-		}
 		// Correction when having a top ruler.
 		if (_top.enabled)
 		{
@@ -108,12 +125,6 @@ const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion&
 		{
 			_left.rect.setBottom(_left.rect.bottom() - _bottom.size);
 		}
-		// Draw the actual ruler elements.
-		if (!_debug)
-		{
-			draw.ruler(painter, Draw::roLeft, _colors[cRulerLine], _colors[cRulerText],
-				_left.rect, area, _left.start, _left.stop, _left.digits, _left.unit);
-		}
 	}
 	// When there is a right ruler.
 	if (_right.enabled)
@@ -122,13 +133,6 @@ const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion&
 		_right.rect.setWidth(_right.size);
 		_right.rect.moveTo(QPoint(bounds.width() - _right.size, 0) + bounds.topLeft());
 		_right.bounds = _right.rect;
-		// The area allowed painting in.
-		auto area = _right.bounds;
-		// Draw background of ruler area.
-		if (_colors[cRulerBackground].isValid() && !_debug)
-		{
-			painter.fillRect(_right.rect, _colors[cRulerBackground]);
-		}
 		// Correction when having a top ruler.
 		if (_top.enabled)
 		{
@@ -139,12 +143,6 @@ const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion&
 		{
 			_right.rect.setBottom(_right.rect.bottom() - _bottom.size);
 		}
-		// Draw the actual ruler elements.
-		if (!_debug)
-		{
-			draw.ruler(painter, Draw::roRight, _colors[cRulerLine], _colors[cRulerText],
-				_right.rect, area, _right.start, _right.stop, _right.digits, _right.unit);
-		}
 	}
 	// When there is a top ruler.
 	if (_top.enabled)
@@ -152,8 +150,6 @@ const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion&
 		_top.rect = bounds;
 		_top.rect.setHeight(_top.size);
 		_top.bounds = _top.rect;
-		// The area allowed painting in.
-		auto area = _top.bounds;
 		// Correction when having a left ruler.
 		if (_left.enabled)
 		{
@@ -164,17 +160,6 @@ const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion&
 		{
 			_top.rect.setRight(_top.rect.right() - _right.size);
 		}
-		// Draw background of area.
-		if (_colors[cRulerBackground].isValid() && !_debug)
-		{
-			painter.fillRect(_top.rect, _colors[cRulerBackground]);
-		}
-		// Draw the actual ruler elements.
-		if (!_debug)
-		{
-			draw.ruler(painter, Draw::roTop, _colors[cRulerLine], _colors[cRulerText],
-				_top.rect, area, _top.start, _top.stop, _top.digits, _top.unit);
-		}
 	}
 	// When there is a bottom ruler.
 	if (_bottom.enabled)
@@ -183,8 +168,6 @@ const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion&
 		_bottom.rect.moveTo(QPoint(0, _bottom.rect.height() - _bottom.size) + bounds.topLeft());
 		_bottom.rect.setHeight(_bottom.size);
 		_bottom.bounds = _bottom.rect;
-		// The area allowed painting in.
-		auto area = _bottom.bounds;
 		// Correction when having a left ruler.
 		if (_left.enabled)
 		{
@@ -195,30 +178,83 @@ const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion&
 		{
 			_bottom.rect.setRight(_bottom.rect.right() - _right.size);
 		}
-		// Draw background of area.
-		if (_colors[cRulerBackground].isValid() && !_debug)
-		{
-			painter.fillRect(_bottom.rect, _colors[cRulerBackground]);
-		}
-		// Draw the actual ruler elements.
-		if (!_debug)
+	}
+}
+
+void Graph::paintLayer(QPainter& painter)
+{
+	Draw draw;
+	// When the background is a valid color paint int.
+	if (_colors[cGraphBackground].isValid())
+	{
+		painter.fillRect(_plotArea, _colors[cGraphBackground]);
+	}
+	// Debugging only paints the contours on top of the layer.
+	if (_debug)
+	{
+		return;
+	}
+	for (auto ro: {Draw::roLeft, Draw::roRight, Draw::roTop, Draw::roBottom})
+	{
+		auto ri = getRulerInfo(ro);
+		if (ri->enabled)
 		{
-			draw.ruler(painter, Draw::roBottom, _colors[cRulerLine], _colors[cRulerText],
-				_bottom.rect, area, _bottom.start, _bottom.stop, _bottom.digits, _bottom.unit);
+			// Draw background of ruler area.
+			if (_colors[cRulerBackground].isValid())
+			{
+				// The vertical rulers fill the corners.
+				painter.fillRect((ro & (Draw::roLeft | Draw::roRight)) ? ri->bounds : ri->rect, _colors[cRulerBackground]);
+			}
+			// Draw the actual ruler elements in the area allowed painting in.
+			draw.ruler(painter, ro, _colors[cRulerLine], _colors[cRulerText], ri->rect, ri->bounds, ri->start, ri->stop, ri->digits, ri->unit);
 		}
 	}
 	// Check if horizontal grid is enabled.
-	if (_horizontal && !_debug)
+	if (_horizontal)
 	{
 		auto ri = getRulerInfo(_horizontal);
 		draw.gridLines(painter, Draw::goHorizontal, _colors[cGridLines], _plotArea, ri->start, ri->stop, ri->digits);
 	}
 	// Check if vertical grid is enabled.
-	if (_vertical && !_debug)
+	if (_vertical)
 	{
 		auto ri = getRulerInfo(_vertical);
 		draw.gridLines(painter, Draw::goVertical, _colors[cGridLines], _plotArea, ri->start, ri->stop, ri->digits);
 	}
+}
+
+const QRect& Graph::paint(QPainter& painter, const QRect& bounds, const QRegion& region)
+{
+	// Get font sizes to calculate needed widths and heights.
+	setBounds(QFontMetrics(painter.font()), bounds);
+	layoutRulers(bounds);
+	if (_caching && painter.device())
+	{
+		auto ratio = painter.device()->devicePixelRatioF();
+		// Render the layer again only when the geometry or appearance changed.
+		if (!_layerValid || _layerBounds != bounds || _layerRatio != ratio || _layerFont != painter.font() || _layerDebug != _debug)
+		{
+			_layerBounds = bounds;
+			_layerRatio = ratio;
+			_layerFont = painter.font();
+			_layerDebug = _debug;
+			_layer = QPixmap(bounds.size() * ratio);
+			_layer.setDevicePixelRatio(ratio);
+			_layer.fill(Qt::transparent);
+			QPainter lp(&_layer);
+			lp.setFont(_layerFont);
+			lp.setRenderHints(painter.renderHints());
+			// Use the same coordinates as the passed painter.
+			lp.translate(-bounds.topLeft());
+			paintLayer(lp);
+			_layerValid = true;
+		}
+		painter.drawPixmap(bounds.topLeft(), _layer);
+	}
+	else
+	{
+		paintLayer(painter);
+	}
 	if (_debug)
 	{
 		for (auto& i: {_left, _right, _top, _bottom})
@@ -246,13 +282,15 @@ void Graph::paintPlotCross(QPainter& painter, const QString& text)
 
 void Graph::setGrid(Draw::EGridOrientation go, Draw::ERulerOrientation ro)
 {
-	if (go == Draw::goHorizontal)
+	if (go == Draw::goHorizontal && _horizontal != ro)
 	{
 		_horizontal = ro;
+		_layerValid = false;
 	}
-	else if (go == Draw::goVertical)
+	else if (go == Draw::goVertical && _vertical != ro)
 	{
 		_vertical = ro;
+		_layerValid = false;
 	}
 }
 
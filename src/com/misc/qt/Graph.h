@@ -3,6 +3,7 @@
 #include "Draw.h"
 #include <QPainter>
 #include <QPalette>
+#include <QPixmap>
 #include "../gen/gen_utils.h"
 #include "../global.h"
 
@@ -16,6 +17,8 @@ namespace sf
  * @image html "doc/Graph.png"
  *
  * Use this class as a private class for a custom widget which produces a graph.
+ * The rulers, grid and backgrounds are rendered into a cached layer which is only rendered again when
+ * the bounds, ruler settings, colors or font changed so repainting at data rate only composites the layer.
  */
 class _MISC_CLASS Graph
 {
@@ -65,6 +68,23 @@ class _MISC_CLASS Graph
 		 */
 		const QRect& paint(QPainter& painter, const QRect& bounds, const QRegion& region = null_ref<QRegion>());
 
+		/**
+		 * @brief Enables or disables the cached layer for the rulers and grid which is enabled by default.
+		 *
+		 * @param enable When false the rulers and grid are drawn on each paint.
+		 */
+		void setCaching(bool enable);
+
+		/**
+		 * @brief Gets whether the rulers and grid are cached.
+		 */
+		[[nodiscard]] bool isCaching() const;
+
+		/**
+		 * @brief Forces the cached layer to be rendered again on the next paint.
+		 */
+		void invalidate();
+
 		/**
 		 * @brief Paints a cross with text in the plot area.
 		 * Used when a plot can not be painted.
@@ -180,6 +200,45 @@ class _MISC_CLASS Graph
 		 * @brief Holds the last calculated graph area rectangle.
 		 */
 		 QRect _plotArea;
+
+		/**
+		 * @brief Calculates the ruler rectangles for the passed bounds.
+		 */
+		void layoutRulers(const QRect& bounds);
+
+		/**
+		 * @brief Paints the backgrounds, rulers and grid of which the cached layer consists.
+		 */
+		void paintLayer(QPainter& painter);
+
+		/**
+		 * @brief Cached layer having the backgrounds, rulers and grid.
+		 */
+		QPixmap _layer;
+		/**
+		 * @brief Flag indicating the cached layer is up to date with the settings.
+		 */
+		bool _layerValid{false};
+		/**
+		 * @brief Bounds the cached layer was rendered for.
+		 */
+		QRect _layerBounds;
+		/**
+		 * @brief Font the cached layer was rendered with.
+		 */
+		QFont _layerFont;
+		/**
+		 * @brief Device pixel ratio the cached layer was rendered for.
+		 */
+		qreal _layerRatio{0};
+		/**
+		 * @brief Debug flag the cached layer was rendered with.
+		 */
+		bool _layerDebug{false};
+		/**
+		 * @brief Enables the cached layer.
+		 */
+		bool _caching{true};
 };
 
 }
@@ -1,6 +1,11 @@
 #include <QDir>
 #include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
 #include <QLibrary>
+#include <QThread>
+#include <algorithm>
+#include <thread>
 #include "../gen/TClassRegistration.h"
 #include "ModuleConfiguration.h"
 #include "ModuleConfigurationDialog.h"
@@ -24,10 +29,17 @@ ModuleConfiguration::ModuleConfiguration(QSettings* settings, QObject* parent)
 	 , _dialog(nullptr)
 	 , _settings(settings)
 {
+	if (_settings)
+	{
+		_parallel = _settings->value(QStringLiteral("AppModules/Parallel"), _parallel).toBool();
+	}
+	// Lookups of names not available yet load the pending library providing it.
+	setRequireHandler(RequireClosure().assign(this, &ModuleConfiguration::requireHandler, std::placeholders::_1));
 }
 
 ModuleConfiguration::~ModuleConfiguration()
 {
+	setRequireHandler();
 	delete _dialog;
 }
 
@@ -68,33 +80,214 @@ ModuleConfiguration::ModuleListType ModuleConfiguration::getList() const
 	return ml;
 }
 
-size_t ModuleConfiguration::load(bool startup)
+QString ModuleConfiguration::getCacheFile() const
+{
+	return QFileInfo(_settings->fileName()).absoluteDir().filePath("module-info.cache");
+}
+
+void ModuleConfiguration::setParallel(bool yn)
+{
+	_parallel = yn;
+}
+
+ModuleConfiguration::ModuleListType ModuleConfiguration::getPending() const
+{
+	return _pending;
+}
+
+const ModuleConfiguration::LoadTimeList& ModuleConfiguration::getLoadTimes() const
+{
+	return _loadTimes;
+}
+
+void ModuleConfiguration::loadLibrary(LoadTime& lt)
+{
+	QElapsedTimer timer;
+	timer.start();
+	QLibrary lib(QDir(getModuleDir()).filePath(lt.filename));
+	qInfo() << "Loading Module:" << lt.filename << lt.name;
+	lt.loaded = lib.load();
+	if (!lt.loaded)
+	{
+		qWarning() << lt.filename << lib.errorString();
+	}
+	// Cast the function to the correct type.
+	auto func = (SF_DL_NAME_FUNC_TYPE) lib.resolve(SF_DL_NAME_FUNC_NAME);
+	if (func)
+	{
+		func(lt.filename.toLocal8Bit());
+	}
+	lt.elapsed = timer.nsecsElapsed();
+}
+
+size_t ModuleConfiguration::loadPending(const QString& filename, LoadTimeList& ltl)
 {
-	// Return value initialization.
 	size_t rv = 0;
+	// Remove it first to prevent circular dependencies from recursing endlessly.
+	auto name = _pending.take(filename);
+	for (auto& dep: _dependencies.value(filename))
+	{
+		auto key = _pending.contains(dep) ? dep : _pending.key(dep);
+		if (!key.isEmpty())
+		{
+			rv += loadPending(key, ltl);
+		}
+	}
+	LoadTime lt{filename, name, 0, true};
+	loadLibrary(lt);
+	ltl.append(lt);
+	return rv + (lt.loaded ? 1 : 0);
+}
+
+bool ModuleConfiguration::require(const QString& name)
+{
+	// Find the filename when the module name or a provided name was passed.
+	auto key = _pending.contains(name) ? name : _pending.key(name);
+	if (key.isEmpty() && _pending.contains(_provides.value(name)))
+	{
+		key = _provides.value(name);
+	}
+	if (key.isEmpty())
+	{
+		return false;
+	}
+	LoadTimeList ltl;
+	auto count = loadPending(key, ltl);
+	_loadTimes.append(ltl);
+	// When a lib was loaded emit the signal for the instances to be created and initialized.
+	if (count)
+	{
+		Q_EMIT libraryLoaded(false);
+	}
+	return ltl.last().loaded;
+}
+
+bool ModuleConfiguration::requireHandler(const std::string& name)
+{
+	// Libraries are only loaded from the thread owning this instance.
+	return QThread::currentThread() == thread() && require(QString::fromStdString(name));
+}
+
+size_t ModuleConfiguration::load(bool startup)
+{
+	QElapsedTimer timer;
+	timer.start();
 	// Get the list of to be loaded modules.
 	auto list = getList();
-	// Load each dynamic library in the list when not loaded yet.
+	// Maps the module name to the library filename for resolving dependencies.
+	QMap<QString, QString> names;
+	// Libraries still to be loaded.
+	QStringList todo;
+	// Rebuilt from the current configuration.
+	_pending.clear();
+	_provides.clear();
+	// Read the load options of each library using the cache.
+	DynamicLibraryInfo::setCacheFile(getCacheFile().toStdString());
 	for (auto it = list.begin(); it != list.constEnd(); ++it)
 	{
-		auto name = QDir(getModuleDir()).filePath(it.key());
-		QLibrary lib(name);
-		// Only load when not loaded yet.
-		if (!lib.isLoaded())
+		// Only when not loaded yet.
+		if (QLibrary(QDir(getModuleDir()).filePath(it.key())).isLoaded())
+		{
+			continue;
+		}
+		DynamicLibraryInfo dli;
+		if (dli.read(QDir(getModuleDir()).absolutePath().toStdString(), it.key().toStdString()))
+		{
+			names[QString::fromStdString(dli.name)] = it.key();
+		}
+		names[it.value()] = it.key();
+		auto& deps = _dependencies[it.key()];
+		deps.clear();
+		for (auto& dep: dli.dependencies)
+		{
+			deps.append(QString::fromStdString(dep));
+		}
+		if (dli.lazy)
+		{
+			_pending[it.key()] = it.value();
+			for (auto& nm: dli.provides)
+			{
+				_provides[QString::fromStdString(nm)] = it.key();
+			}
+		}
+		else
+		{
+			todo.append(it.key());
+		}
+	}
+	DynamicLibraryInfo::syncCache();
+	// Lazy libraries needed by the others are loaded as well.
+	for (int i = 0; i < todo.count(); i++)
+	{
+		for (auto& dep: _dependencies.value(todo.at(i)))
+		{
+			auto key = names.value(dep);
+			if (_pending.contains(key))
+			{
+				_pending.remove(key);
+				todo.append(key);
+			}
+		}
+	}
+	LoadTimeList ltl;
+	// Load level by level where a level consists of libraries having their dependencies loaded.
+	while (!todo.isEmpty())
+	{
+		LoadTimeList level;
+		for (auto& key: todo)
+		{
+			auto& deps = _dependencies[key];
+			if (std::none_of(deps.begin(), deps.end(), [&](const QString& dep) {return todo.contains(names.value(dep));}))
+			{
+				level.append({key, list.value(key)});
+			}
+		}
+		// Break circular dependencies by loading the rest in one go.
+		if (level.isEmpty())
+		{
+			qWarning() << "Circular module dependencies:" << todo;
+			for (auto& key: todo)
+			{
+				level.append({key, list.value(key)});
+			}
+		}
+		for (auto& lt: level)
 		{
-			qInfo() << "Loading Module:" << it.key() << it.value();
-			if (!lib.load())
+			todo.removeOne(lt.filename);
+		}
+		if (_parallel && level.count() > 1)
+		{
+			// Each thread writes only its own entry.
+			std::vector<std::thread> threads;
+			for (auto& lt: level)
 			{
-				qWarning() << it.key() << lib.errorString();
+				threads.emplace_back([this, &lt]() {loadLibrary(lt);});
 			}
-			// Cast the function to the correct type.
-			auto func = (SF_DL_NAME_FUNC_TYPE) lib.resolve(SF_DL_NAME_FUNC_NAME);
-			if (func)
+			for (auto& t: threads)
+			{
+				t.join();
+			}
+		}
+		else
+		{
+			for (auto& lt: level)
 			{
-				func(it.key().toLocal8Bit());
+				loadLibrary(lt);
 			}
-			// Increment the return value.
-			rv++;
+		}
+		ltl.append(level);
+	}
+	// Return value is the amount of loaded libraries.
+	auto rv = (size_t) std::count_if(ltl.begin(), ltl.end(), [](const LoadTime& lt) {return lt.loaded;});
+	_loadTimes.append(ltl);
+	// Report the load times.
+	if (!ltl.isEmpty())
+	{
+		qInfo().noquote() << QString("Loaded %1 of %2 module(s) in %3 ms, %4 pending.")
+			.arg(rv).arg(ltl.count()).arg(double(timer.nsecsElapsed()) / 1e6, 0, 'f', 1).arg(_pending.count());
+		for (auto& lt: ltl)
+		{
+			qInfo().noquote() << QString("  %1 ms %2 (%3)").arg(double(lt.elapsed) / 1e6, 8, 'f', 1).arg(lt.filename, lt.name);
 		}
 	}
 	// When a lib was loaded emit the signal.
@@ -3,6 +3,7 @@
 #include <QWidget>
 #include <QDialog>
 #include <QSettings>
+#include <QStringList>
 
 #include "../global.h"
 
@@ -55,10 +56,81 @@ class _MISC_CLASS ModuleConfiguration :public QObject
 		/**
 		 * @brief Loads the module configuration from the settings.
 		 *
-		 * @return True when at least a library was loaded.
+		 * Libraries declaring themselves lazy are not loaded but kept pending until #require() is called.
+		 * The others are loaded in order of their dependencies.
+		 * When enabled using #setParallel() libraries of the same level are loaded in parallel.
+		 * @param startup True when called at application startup.
+		 * @return Amount of libraries loaded.
 		 */
 		size_t load(bool startup);
 
+		/**
+		 * @brief Loads a pending lazy library and the pending libraries it depends on.
+		 *
+		 * Called through #sf::requireProvider() when a layout, script or menu action looks up a name
+		 * provided by a pending library like a registered class, widget class or file suffix.
+		 * @param name Module name, library filename or a name provided by the library.
+		 * @return True when the library was loaded by this call.
+		 */
+		bool require(const QString& name);
+
+		/**
+		 * @brief Gets the pending lazy libraries.
+		 *
+		 * @return Mapped list like #getList().
+		 */
+		[[nodiscard]] ModuleListType getPending() const;
+
+		/**
+		 * @brief Sets if libraries of the same dependency level are loaded in parallel.
+		 *
+		 * Class registrations are serialized but other static initializers of the libraries must be thread safe as well.
+		 * Default is true or the 'Parallel' key in the 'AppModules' group of the settings.
+		 */
+		void setParallel(bool yn);
+
+		/**
+		 * @brief Holds the time it took to load a library.
+		 */
+		struct LoadTime
+		{
+			/**
+			 * @brief Library filename.
+			 */
+			QString filename;
+			/**
+			 * @brief Module name.
+			 */
+			QString name;
+			/**
+			 * @brief Time in nanoseconds the load took.
+			 */
+			qint64 elapsed{0};
+			/**
+			 * @brief True when loaded through #require().
+			 */
+			bool lazy{false};
+			/**
+			 * @brief True when loading succeeded.
+			 */
+			bool loaded{false};
+		};
+
+		/**
+		 * @brief List type for reporting load times.
+		 */
+		typedef QList<LoadTime> LoadTimeList;
+
+		/**
+		 * @brief Gets the load times of all libraries loaded so far.
+		 */
+		[[nodiscard]] const LoadTimeList& getLoadTimes() const;
+
+		/**
+		 * @brief Gets the file used to cache the dynamic library information.
+		 */
+		[[nodiscard]] QString getCacheFile() const;
+
 		/**
 		 * @brief Saves the module configuration to the settings.
 		 */
@@ -83,6 +155,38 @@ class _MISC_CLASS ModuleConfiguration :public QObject
 		 * @brief Holds the settings reference for the module config.
 		 */
 		QSettings* _settings;
+		/**
+		 * @brief Loads a single library and fills in the passed timing entry.
+		 */
+		void loadLibrary(LoadTime& lt);
+		/**
+		 * @brief Loads a pending library after its pending dependencies.
+		 */
+		size_t loadPending(const QString& filename, LoadTimeList& ltl);
+		/**
+		 * @brief Handler installed using #sf::setRequireHandler().
+		 */
+		bool requireHandler(const std::string& name);
+		/**
+		 * @brief Holds the lazy libraries not loaded yet.
+		 */
+		ModuleListType _pending;
+		/**
+		 * @brief Holds the library filename of the pending libraries by the names they provide.
+		 */
+		QMap<QString, QString> _provides;
+		/**
+		 * @brief Holds the dependency module names of each library.
+		 */
+		QMap<QString, QStringList> _dependencies;
+		/**
+		 * @brief Holds the load times of the loaded libraries.
+		 */
+		LoadTimeList _loadTimes;
+		/**
+		 * @brief Holds the flag for loading in parallel.
+		 */
+		bool _parallel{true};
 };
 
 inline
@@ -82,6 +82,8 @@ void AppModuleList::refresh()
 	}
 	// Get the current list of modules.
 	auto list = _config->getList();
+	// Use a cache next to the settings file so unchanged libraries are not scanned again.
+	DynamicLibraryInfo::setCacheFile(_config->getCacheFile().toStdString());
 	// Iterate through the list module file in the module directory.
 	QDirIterator it(_config->getModuleDir(), QDir::Filter::Files);
 	while (it.hasNext())
@@ -105,6 +107,8 @@ void AppModuleList::refresh()
 			}
 		}
 	}
+	// Write the newly scanned library information.
+	DynamicLibraryInfo::syncCache();
 	// For all entries which were not present add an entry.
 	for (auto i = list.begin(); i != list.constEnd(); ++i)
 	{
@@ -11,110 +11,50 @@ ScriptHighlighter::ScriptHighlighter(ScriptInterpreter* script, QTextDocument* d
 	auto dark_mode = pte ? pte->palette().color(QPalette::Base).lightness() < 127 : false;
 
 	_curLineColor = (dark_mode ? QColorConstants::DarkYellow.darker() : QColor(255, 250, 227));
-	//
-	// The order of appending rules is important otherwise functions in commented lines are highlighted too.
-	//
 	// Identifiers.
-	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Blue.lighter() : QColorConstants::DarkBlue);
-		rule.format.setFontWeight(QFont::Bold);
-		for (auto& id: script->getIdentifiers(ScriptObject::idKeyword))
-		{
-			rule.pattern = QRegularExpression(QString("\\b%1\\b").arg(id.c_str()));
-			_rules.append(rule);
-		}
-	}
+	_formats[fKeyword].setForeground(dark_mode ? QColorConstants::Blue.lighter() : QColorConstants::DarkBlue);
+	_formats[fKeyword].setFontWeight(QFont::Bold);
 	// Constants.
-	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Cyan : QColorConstants::DarkCyan);
-		rule.format.setFontWeight(QFont::Bold);
-		for (auto& id: script->getIdentifiers(ScriptObject::idConstant))
-		{
-			rule.pattern = QRegularExpression(QString("\\b%1\\b").arg(id.c_str()));
-			_rules.append(rule);
-		}
-	}
+	_formats[fConstant].setForeground(dark_mode ? QColorConstants::Cyan : QColorConstants::DarkCyan);
+	_formats[fConstant].setFontWeight(QFont::Bold);
 	// Punctuators.
-	{
-		HighlightingRule rule;
-		rule.format.setFontWeight(QFont::Bold);
-		rule.pattern = QRegularExpression(QStringLiteral("[\\[\\](){},:;]"));
-		_rules.append(rule);
-	}
+	_formats[fPunctuator].setFontWeight(QFont::Bold);
 	// Operators.
-	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Blue : QColorConstants::DarkBlue);
-		rule.format.setFontWeight(QFont::Bold);
-		rule.pattern = QRegularExpression(QStringLiteral("[=+-/|%^*]"));
-		_rules.append(rule);
-	}
+	_formats[fOperator].setForeground(dark_mode ? QColorConstants::Blue : QColorConstants::DarkBlue);
+	_formats[fOperator].setFontWeight(QFont::Bold);
 	// Number values.
-	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Red.lighter() : QColorConstants::DarkRed);
-		rule.pattern = QRegularExpression(QStringLiteral("[+-]?(?<![a-zA-Z_])([0-9]*[.])?[0-9]+([eE][+-]?[0-9]*)?"));
-		_rules.append(rule);
-	}
-	// Hexadecimal number values.
-	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Red.lighter() : QColorConstants::DarkRed);
-		rule.pattern = QRegularExpression(QStringLiteral("0[xX][0-9a-fA-F]+"));
-		_rules.append(rule);
-	}
+	_formats[fNumber].setForeground(dark_mode ? QColorConstants::Red.lighter() : QColorConstants::DarkRed);
 	// Type definitions.
-	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Blue.lighter() : QColorConstants::DarkBlue);
-		rule.format.setFontItalic(true);
-		for (auto& id: script->getIdentifiers(ScriptObject::idTypedef))
-		{
-			rule.pattern = QRegularExpression(QString("\\b%1\\b").arg(id.c_str()));
-			_rules.append(rule);
-		}
-	}
+	_formats[fTypedef].setForeground(dark_mode ? QColorConstants::Blue.lighter() : QColorConstants::DarkBlue);
+	_formats[fTypedef].setFontItalic(true);
 	// Labels
-	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Magenta : QColorConstants::DarkMagenta);
-		rule.format.setFontWeight(QFont::Bold);
-		rule.pattern = QRegularExpression(QStringLiteral("(?<=:)\\b([A-Za-z0-9_]+)(?=;)"));
-		_rules.append(rule);
-	}
+	_formats[fLabel].setForeground(dark_mode ? QColorConstants::Magenta : QColorConstants::DarkMagenta);
+	_formats[fLabel].setFontWeight(QFont::Bold);
 	// Functions: None global
+	_formats[fFunction].setForeground(dark_mode ? QColorConstants::Magenta : QColorConstants::DarkMagenta);
+	// Functions: Global registered.
+	_formats[fGlobalFunction].setForeground(dark_mode ? QColorConstants::Magenta : QColorConstants::DarkMagenta);
+	_formats[fGlobalFunction].setFontItalic(true);
+	// Double quoted strings.
+	_formats[fString].setForeground(dark_mode ? QColorConstants::Green : QColorConstants::DarkGreen);
+	// Single line and block comments.
+	_formats[fComment].setForeground(QColorConstants::Gray);
+	// Sets for classifying names.
+	for (auto& id: script->getIdentifiers(ScriptObject::idKeyword))
 	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Magenta : QColorConstants::DarkMagenta);
-		rule.pattern = QRegularExpression(QStringLiteral("\\b[A-Za-z0-9_]+(?=\\()"));
-		_rules.append(rule);
+		_keywords.insert(QString::fromStdString(id));
 	}
-	// Functions: Global registered.
+	for (auto& id: script->getIdentifiers(ScriptObject::idConstant))
 	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Magenta : QColorConstants::DarkMagenta);
-		rule.format.setFontItalic(true);
-		for (auto& keyword: script->getIdentifiers(ScriptObject::idFunction))
-		{
-			rule.pattern = QRegularExpression(QStringLiteral("\\b%1\\b(?=\\()").arg(keyword.c_str()));
-			_rules.append(rule);
-		}
+		_constants.insert(QString::fromStdString(id));
 	}
-	// Double quoted strings.
+	for (auto& id: script->getIdentifiers(ScriptObject::idTypedef))
 	{
-		HighlightingRule rule;
-		rule.format.setForeground(dark_mode ? QColorConstants::Green : QColorConstants::DarkGreen);
-		rule.pattern = QRegularExpression(QStringLiteral("\".*?(?<!\\\\)\""));
-		_rules.append(rule);
+		_typedefs.insert(QString::fromStdString(id));
 	}
-	// Single line comment.
+	for (auto& id: script->getIdentifiers(ScriptObject::idFunction))
 	{
-		HighlightingRule rule;
-		rule.format.setForeground(QColorConstants::Gray);
-		rule.pattern = QRegularExpression(QStringLiteral("//[^\n]*"));
-		_rules.append(rule);
+		_functions.insert(QString::fromStdString(id));
 	}
 	if (pte)
 	{
@@ -142,17 +82,79 @@ void ScriptHighlighter::highlightCurrentLine()
 	}
 }
 
+void ScriptHighlighter::formatName(const QString& text, const ScriptTokenizer::Vector& tokens, size_t index)
+{
+	auto& token = tokens[index];
+	auto start = static_cast<int>(token.start);
+	auto length = static_cast<int>(token.length);
+	auto name = QStringView(text).mid(start, length).toString();
+	auto next = index + 1 < tokens.count() ? &tokens[index + 1] : nullptr;
+	// Functions are names directly followed by a parenthesis.
+	if (next && next->start == token.end() && text[static_cast<int>(next->start)] == '(')
+	{
+		setFormat(start, length, _formats[_functions.contains(name) ? fGlobalFunction : fFunction]);
+		return;
+	}
+	// Labels are names directly between a colon and a semicolon.
+	if (index > 0 && next && tokens[index - 1].end() == token.start && next->start == token.end() &&
+		text[static_cast<int>(tokens[index - 1].start)] == ':' && text[static_cast<int>(next->start)] == ';')
+	{
+		setFormat(start, length, _formats[fLabel]);
+		return;
+	}
+	if (_typedefs.contains(name))
+	{
+		setFormat(start, length, _formats[fTypedef]);
+	}
+	else if (_constants.contains(name))
+	{
+		setFormat(start, length, _formats[fConstant]);
+	}
+	else if (_keywords.contains(name))
+	{
+		setFormat(start, length, _formats[fKeyword]);
+	}
+}
+
 void ScriptHighlighter::highlightBlock(const QString& text)
 {
-	for (const HighlightingRule& rule : std::as_const(_rules))
+	auto state = previousBlockState() == ScriptTokenizer::tsComment ? ScriptTokenizer::tsComment : ScriptTokenizer::tsCode;
+	state = _tokenizer.tokenize(text.utf16(), text.length(), state, _tokens);
+	for (size_t i = 0; i < _tokens.count(); i++)
 	{
-		auto matchIterator = rule.pattern.globalMatch(text);
-		while (matchIterator.hasNext())
+		auto& token = _tokens[i];
+		auto start = static_cast<int>(token.start);
+		auto length = static_cast<int>(token.length);
+		switch (token.type)
 		{
-			auto match = matchIterator.next();
-			setFormat((int) match.capturedStart(), (int) match.capturedLength(), rule.format);
+			case ScriptTokenizer::tkName:
+				formatName(text, _tokens, i);
+				break;
+			case ScriptTokenizer::tkNumber:
+				setFormat(start, length, _formats[fNumber]);
+				break;
+			case ScriptTokenizer::tkString:
+				setFormat(start, length, _formats[fString]);
+				break;
+			case ScriptTokenizer::tkComment:
+				setFormat(start, length, _formats[fComment]);
+				break;
+			case ScriptTokenizer::tkOperator:
+				setFormat(start, length, _formats[fOperator]);
+				break;
+			case ScriptTokenizer::tkPunctuator:
+				// Member access is not emphasized.
+				if (text[start] != '.')
+				{
+					setFormat(start, length, _formats[fPunctuator]);
+				}
+				break;
+			default:
+				break;
 		}
 	}
+	// Only when the state changes the next block is highlighted again by the base class.
+	setCurrentBlockState(state);
 }
 
 }
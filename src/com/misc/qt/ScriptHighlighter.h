@@ -2,8 +2,9 @@
 
 #include <QSyntaxHighlighter>
 #include <QTextCharFormat>
-#include <QRegularExpression>
+#include <QSet>
 #include "../gen/ScriptInterpreter.h"
+#include "../gen/ScriptTokenizer.h"
 #include "../global.h"
 
 class QTextDocument;
@@ -15,6 +16,8 @@ namespace sf
  * @brief Highlighter of a document class used by edit widgets.
  *
  * Highlights the document according the passed script interpreter.
+ * Each block is tokenized in a single pass and names are classified using hash sets of the identifiers.
+ * Since the block state holds an open block comment only changed blocks and blocks affected by it are highlighted again.
  */
 class _MISC_CLASS ScriptHighlighter :public QSyntaxHighlighter
 {
@@ -34,13 +37,38 @@ class _MISC_CLASS ScriptHighlighter :public QSyntaxHighlighter
 
 		void highlightCurrentLine();
 
-		struct HighlightingRule
+		// Applies the format of a name token depending on its identifier type and surrounding tokens.
+		void formatName(const QString& text, const ScriptTokenizer::Vector& tokens, size_t index);
+
+		enum EFormat
 		{
-			QRegularExpression pattern;
-			QTextCharFormat format;
+			fKeyword,
+			fConstant,
+			fTypedef,
+			fPunctuator,
+			fOperator,
+			fNumber,
+			fLabel,
+			fFunction,
+			fGlobalFunction,
+			fString,
+			fComment,
+			fCount
 		};
 
-		QVector<HighlightingRule> _rules;
+		QTextCharFormat _formats[fCount];
+
+		QSet<QString> _keywords;
+
+		QSet<QString> _constants;
+
+		QSet<QString> _typedefs;
+
+		QSet<QString> _functions;
+
+		ScriptTokenizer _tokenizer;
+
+		ScriptTokenizer::Vector _tokens;
 
 		QColor _curLineColor;
 };
@@ -0,0 +1,65 @@
+#include <memory>
+#include <misc/gen/TClassRegistration.h>
+#include <test/catch.h>
+
+namespace
+{
+
+struct Base
+{
+	struct Parameters
+	{
+		int value;
+	};
+
+	explicit Base(const Parameters& params)
+		:_value(params.value) {}
+
+	virtual ~Base() = default;
+
+	int _value;
+
+	SF_DECL_IFACE(Base, Parameters, Interface)
+};
+
+SF_IMPL_IFACE(Base, Base::Parameters, Interface)
+
+struct Derived :Base
+{
+	explicit Derived(const Parameters& params)
+		:Base(params) {}
+};
+
+}
+
+TEST_CASE("sf::TClassRegistration", "[con][generic][dl]")
+{
+	SECTION("Require")
+	{
+		std::vector<std::string> required;
+		// Registers the class as a lazy library would when it is loaded.
+		sf::setRequireHandler(sf::RequireClosure([&](const std::string& name) -> bool
+		{
+			required.push_back(name);
+			if (name != "Late")
+			{
+				return false;
+			}
+			Base::Interface().registerClass("Late", "Registered on first use.", sf::TClassRegistration<Base, Base::Parameters>::callback_t([](const Base::Parameters& params) -> Base*
+			{
+				return new Derived(params);
+			}));
+			return true;
+		}));
+		CHECK(Base::Interface().create("Other", {1}) == nullptr);
+		std::unique_ptr<Base> inst(Base::Interface().create("Late", {2}));
+		REQUIRE(inst);
+		CHECK(inst->_value == 2);
+		// Once registered the handler is no longer called.
+		inst.reset(Base::Interface().create("Late", {3}));
+		CHECK(inst->_value == 3);
+		CHECK(required == std::vector<std::string>{"Other", "Late"});
+		sf::setRequireHandler();
+		CHECK_FALSE(sf::requireProvider("Other"));
+	}
+}
@@ -0,0 +1,62 @@
+#include <misc/gen/TClassRegistration.h>
+#include <misc/gen/IniProfile.h>
+#include <misc/gen/gen_utils.h>
+#include <test/catch.h>
+
+SF_DL_INFORMATION_EX("Test Library", R"(Description of the test library
+having multiple lines.)", "lazy; depends=Library A, Library B; provides=sf::TestClass, *.tst")
+
+TEST_CASE("sf::DynamicLibraryInfo", "[con][generic][dl]")
+{
+	auto dir = sf::fileDirName(sf::getExecutableFilepath());
+	auto fn = sf::fileBaseName(sf::getExecutableFilepath());
+
+	SECTION("Read")
+	{
+		sf::DynamicLibraryInfo dli;
+		REQUIRE(dli.read(dir, fn));
+		CHECK(dli.name == "Test Library");
+		CHECK(dli.description == "Description of the test library\nhaving multiple lines.");
+		CHECK(dli.filename == fn);
+		CHECK(dli.lazy);
+		CHECK(dli.dependencies == std::vector<std::string>{"Library A", "Library B"});
+		CHECK(dli.provides == std::vector<std::string>{"sf::TestClass", "*.tst"});
+	}
+
+	SECTION("Options")
+	{
+		sf::DynamicLibraryInfo dli;
+		dli.setOptions("depends=Other");
+		CHECK_FALSE(dli.lazy);
+		CHECK(dli.dependencies == std::vector<std::string>{"Other"});
+		CHECK(dli.provides.empty());
+		dli.setOptions("");
+		CHECK(dli.dependencies.empty());
+	}
+
+	SECTION("Cache")
+	{
+		auto cache_path = sf::getWorkingDirectory() + sf::getDirectorySeparator() + "dl-info.cache";
+		if (sf::fileExists(cache_path))
+		{
+			sf::fileUnlink(cache_path);
+		}
+		sf::DynamicLibraryInfo::setCacheFile(cache_path);
+		sf::DynamicLibraryInfo dli;
+		REQUIRE(dli.read(dir, fn));
+		REQUIRE(sf::DynamicLibraryInfo::syncCache());
+		// Second read is served from the cache.
+		REQUIRE(dli.read(dir, fn));
+		CHECK(dli.description == "Description of the test library\nhaving multiple lines.");
+		CHECK(dli.lazy);
+		CHECK(dli.dependencies.size() == 2);
+		CHECK(dli.provides.size() == 2);
+		sf::DynamicLibraryInfo::setCacheFile({});
+		{
+			sf::IniProfile ini(cache_path);
+			REQUIRE(ini.selectSection(dli.path()));
+			CHECK(ini.getString("Name") == "Test Library");
+		}
+		sf::fileUnlink(cache_path);
+	}
+}
@@ -1,3 +1,4 @@
+#include <filesystem>
 #include <iostream>
 #include <misc/gen/IniProfile.h>
 #include <misc/gen/gen_utils.h>
@@ -9,8 +10,8 @@ TEST_CASE("sf::IniProfile", "[con][generic][ini]")
 
 	SECTION("sf::Create")
 	{
-		// Use test file in the working directory.
-		auto ini_path = sf::getWorkingDirectory() + sf::getDirectorySeparator() + "default.ini";
+		// Use a test file in the temporary directory so it does not end up in the source tree.
+		auto ini_path = (std::filesystem::temp_directory_path() / "sf-test-ini-profile.ini").string();
 		// Keys and values to compare.
 		std::string key1("StringKey1");
 		std::string value1("This is micro [\U000000B5] and this is squared [\U000000B2]");
@@ -92,4 +93,44 @@ Integer=987654321
 
 		//ini.write(std::clog);
 	}
+
+	SECTION("sf::Index")
+	{
+		const char* IniContent = R"(
+[Section A]
+#Comment converted on write
+Key1=Value1
+Key2=Value2
+Key1=Duplicate
+[Section B]
+Key3=Value3
+[Section A]
+Key4=Value4
+)";
+		std::istringstream is(IniContent);
+		sf::IniProfile ini(is);
+		// The first section and first key having the name is found.
+		REQUIRE(ini.findSection("Section A") == 0);
+		REQUIRE(ini.setSection("Section A"));
+		REQUIRE(ini.getString("Key1") == "Value1");
+		REQUIRE_FALSE(ini.keyExists("Key4"));
+		// Inserting a comment shifts the positions.
+		REQUIRE(ini.insertComment("Key2", "Inserted comment"));
+		REQUIRE(ini.getString("Key2") == "Value2");
+		REQUIRE(ini.removeEntry("Key1"));
+		REQUIRE(ini.getString("Key1") == "Duplicate");
+		REQUIRE(ini.setString("Key5", "Value5"));
+		REQUIRE(ini.getString("Key5") == "Value5");
+		// Removing a section shifts the positions.
+		REQUIRE(ini.removeSection(0));
+		REQUIRE(ini.findSection("Section A") == 1);
+		REQUIRE(ini.setSection("Section C"));
+		REQUIRE(ini.findSection("Section C") == 2);
+		REQUIRE(ini.setSection("Section B"));
+		REQUIRE(ini.getString("Key3") == "Value3");
+		// Section not accessed are written in the same way they were parsed.
+		std::ostringstream os;
+		ini.write(os);
+		REQUIRE(os.str() == "[Section B]\nKey3=Value3\n\n[Section A]\nKey4=Value4\n\n[Section C]\n\n");
+	}
 }
@@ -102,5 +102,18 @@ TEST_CASE("sf::RangeManager", "[con][generic][range]")
 		REQUIRE(rm.getActualRequests() == sf::Range::Vector{{{60, 70, 0}}});
 	}
 
+	SECTION("Request Flush", "Flushing a single request")
+	{
+		requests = {{{5, 35, -1}, {55, 75, -2}, {5, 35, -1}}};
+		actual = {{{20, 30}, {60, 70}}};
+		rm.unitTest(&accessibles, &actual, &requests);
+		// Only one of the identical requests is flushed.
+		REQUIRE(rm.flushRequest({5, 35, -1}));
+		REQUIRE(rm.getRequests() == sf::Range::Vector{{{5, 35, -1}, {55, 75, -2}}});
+		REQUIRE_FALSE(rm.flushRequest({55, 75, -1}));
+		REQUIRE(rm.flushRequest({5, 35, -1}));
+		REQUIRE(rm.getRequests() == sf::Range::Vector{{{55, 75, -2}}});
+	}
+
 	sf::RangeCompareExact = false;
 }
@@ -0,0 +1,67 @@
+#include <misc/gen/ScriptTokenizer.h>
+#include <string>
+#include <test/catch.h>
+
+namespace
+{
+
+// Gets the tokens as type and text pairs for comparing.
+std::string tokenize(const sf::ScriptTokenizer& tokenizer, const std::string& text, sf::ScriptTokenizer::EState& state)
+{
+	sf::ScriptTokenizer::Vector tokens;
+	state = tokenizer.tokenize(text.data(), text.length(), state, tokens);
+	std::string rv;
+	for (auto& token: tokens)
+	{
+		rv += std::to_string(token.type) + ':' + text.substr(token.start, token.length) + ' ';
+	}
+	return rv;
+}
+
+}
+
+TEST_CASE("sf::ScriptTokenizer", "[con][script]")
+{
+	sf::ScriptTokenizer tokenizer;
+	auto state = sf::ScriptTokenizer::tsCode;
+
+	SECTION("Tokens")
+	{
+		CHECK(tokenize(tokenizer, "int a_1 = 0x1F + 1.5e-3;", state) == "0:int 0:a_1 4:= 1:0x1F 4:+ 1:1.5e-3 5:; ");
+		CHECK(tokenize(tokenizer, "Print(\"a\\\"b\", .5) // End", state) == "0:Print 5:( 2:\"a\\\"b\" 5:, 1:.5 5:) 3:// End ");
+		CHECK(tokenize(tokenizer, "goto :label; a<=b", state) == "0:goto 5:: 0:label 5:; 0:a 4:<= 0:b ");
+		// A string not terminated ends at the end of the line.
+		CHECK(tokenize(tokenizer, "s = \"open", state) == "0:s 4:= 2:\"open ");
+		CHECK(state == sf::ScriptTokenizer::tsCode);
+	}
+
+	SECTION("Comments")
+	{
+		// A division followed by a comment is not a single operator.
+		CHECK(tokenize(tokenizer, "a /= b/* one */ c /* two", state) == "0:a 4:/= 0:b 3:/* one */ 0:c 3:/* two ");
+		CHECK(state == sf::ScriptTokenizer::tsComment);
+		CHECK(tokenize(tokenizer, "still comment", state) == "3:still comment ");
+		CHECK(state == sf::ScriptTokenizer::tsComment);
+		CHECK(tokenize(tokenizer, "end */ d", state) == "3:end */ 0:d ");
+		CHECK(state == sf::ScriptTokenizer::tsCode);
+	}
+
+	SECTION("Quotes")
+	{
+		sf::ScriptTokenizer js("\"'`");
+		CHECK(tokenize(js, "f('x', `y`)", state) == "0:f 5:( 2:'x' 5:, 2:`y` 5:) ");
+		// Only configured quotes start a string.
+		CHECK(tokenize(tokenizer, "'x'", state) == "6:' 0:x 6:' ");
+	}
+
+	SECTION("Wide")
+	{
+		std::u16string text(u"abc é 12");
+		sf::ScriptTokenizer::Vector tokens;
+		CHECK(tokenizer.tokenize(text.data(), text.length(), state, tokens) == sf::ScriptTokenizer::tsCode);
+		REQUIRE(tokens.count() == 3);
+		CHECK(tokens[1].type == sf::ScriptTokenizer::tkOther);
+		CHECK(tokens[2].type == sf::ScriptTokenizer::tkNumber);
+		CHECK(tokens[2].start == 6);
+	}
+}
@@ -0,0 +1,165 @@
+#include <misc/gen/Sustain.h>
+#include <misc/gen/gen_utils.h>
+#include <test/catch.h>
+#include <atomic>
+
+namespace
+{
+
+struct Counter
+{
+	explicit Counter(sf::SustainGroup* group, int priority = sf::SustainBase::spDefault)
+		: _entry(this, &Counter::sustain, priority, group)
+	{}
+
+	bool sustain(const timespec& t)
+	{
+		_calls++;
+		return _again;
+	}
+
+	std::atomic<int> _calls{0};
+	bool _again{true};
+	sf::TSustain<Counter> _entry;
+};
+
+struct SelfDeleter
+{
+	SelfDeleter(sf::SustainGroup* group, int priority, int& deleted)
+		: _deleted(deleted)
+		, _entry(this, &SelfDeleter::sustain, priority, group)
+	{
+		_entry.setInterval(sf::TimeSpec(0.0));
+	}
+
+	bool sustain(const timespec&)
+	{
+		_deleted++;
+		delete this;
+		return true;
+	}
+
+	int& _deleted;
+	sf::TSustain<SelfDeleter> _entry;
+};
+
+}// namespace
+
+TEST_CASE("sf::Sustain", "[con][generic][sustain]")
+{
+	sf::SustainGroup group;
+
+	SECTION("Polled")
+	{
+		Counter c1(&group), c2(&group);
+		group.call();
+		group.call();
+		CHECK(c1._calls == 2);
+		CHECK(c2._calls == 2);
+		// Returning false disables the entry.
+		c1._again = false;
+		group.call();
+		group.call();
+		CHECK(c1._calls == 3);
+		CHECK_FALSE(c1._entry.isEnabled());
+		CHECK(group.count() == 2);
+	}
+
+	SECTION("EventDriven")
+	{
+		Counter c(&group);
+		c._entry.setEventDriven(true);
+		group.call();
+		CHECK(c._calls == 0);
+		// Multiple notifications before a tick result in a single call.
+		c._entry.notify();
+		c._entry.notify();
+		group.call();
+		group.call();
+		CHECK(c._calls == 1);
+		// Back to being polled.
+		c._entry.setEventDriven(false);
+		group.call();
+		CHECK(c._calls == 2);
+	}
+
+	SECTION("Timer")
+	{
+		Counter c(&group, sf::SustainBase::spTimer);
+		group.call();
+		// Timer entries are disabled until the interval is set.
+		CHECK(c._calls == 0);
+		c._entry.setInterval(sf::TimeSpec(0.05));
+		group.call();
+		CHECK(c._calls == 0);
+		sf::TimeSpec end(sf::TimeSpec(sf::getTime()) + sf::TimeSpec(1.0));
+		while (!c._calls && sf::TimeSpec(sf::getTime()) < end)
+		{
+			group.call();
+		}
+		CHECK(c._calls == 1);
+		c._entry.disable();
+		sf::TimeSpec stop(sf::TimeSpec(sf::getTime()) + sf::TimeSpec(0.1));
+		while (sf::TimeSpec(sf::getTime()) < stop)
+		{
+			group.call();
+		}
+		CHECK(c._calls == 1);
+	}
+
+	SECTION("Thread")
+	{
+		Counter c(&group);
+		c._entry.setEventDriven(true);
+		// A long poll interval makes the thread only wake up on a notification.
+		REQUIRE(group.start(sf::TimeSpec(10.0)));
+		CHECK_FALSE(group.start(sf::TimeSpec(10.0)));
+		c._entry.notify();
+		sf::TimeSpec end(sf::TimeSpec(sf::getTime()) + sf::TimeSpec(2.0));
+		while (!c._calls && sf::TimeSpec(sf::getTime()) < end)
+		{
+			std::this_thread::yield();
+		}
+		group.stop();
+		CHECK(c._calls == 1);
+	}
+
+	SECTION("Metrics")
+	{
+		Counter c(&group);
+		group.setMetrics(true);
+		group.call();
+		group.call();
+		CHECK(group.getMetrics().ticks == 2);
+		CHECK(group.getMetrics().calls == 2);
+		CHECK(c._entry.getMetrics().calls == 2);
+		CHECK(c._entry.getMetrics().maximum <= c._entry.getMetrics().total);
+		group.resetMetrics();
+		CHECK(group.getMetrics().ticks == 0);
+		CHECK(c._entry.getMetrics().calls == 0);
+	}
+
+	SECTION("SelfDelete")
+	{
+		// Entries deleting themselves during the call must not be touched afterwards.
+		group.setMetrics(true);
+		int deleted = 0;
+		new SelfDeleter(&group, sf::SustainBase::spDefault, deleted);
+		new SelfDeleter(&group, sf::SustainBase::spTimer, deleted);
+		sf::TimeSpec end(sf::TimeSpec(sf::getTime()) + sf::TimeSpec(1.0));
+		while (deleted < 2 && sf::TimeSpec(sf::getTime()) < end)
+		{
+			group.call();
+		}
+		CHECK(deleted == 2);
+		CHECK(group.count() == 0);
+	}
+
+	SECTION("Flush")
+	{
+		Counter c(&group);
+		group.flush();
+		CHECK(group.count() == 0);
+		CHECK(c._entry.getGroup() == nullptr);
+	}
+}
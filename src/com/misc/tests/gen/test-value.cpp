@@ -275,4 +275,41 @@ TEST_CASE("sf::Value", "[con][generic][value]")
 	{
 		//CHECK(!sf::Value(sf::Value::vitBinary, nullptr, 0).IsZero());
 	}
+
+	SECTION("Inline Storage")
+	{
+		// Strings around the size stored without allocating.
+		for (std::string s: {"", "12345678901234", "123456789012345", "1234567890123456", "A string which is allocated for sure."})
+		{
+			sf::Value v(s);
+			CHECK(v.getString() == s);
+			sf::Value copy(v);
+			CHECK(copy.getString() == s);
+			// Assigning a value of a different size replacing the content.
+			copy = sf::Value(s + s);
+			CHECK(copy.getString() == s + s);
+			copy = v;
+			CHECK(copy == v);
+			sf::Value moved(std::move(copy));
+			CHECK(moved.getString() == s);
+			CHECK(copy.getType() == sf::Value::vitInvalid);
+			moved.assign(sf::Value("Short"));
+			CHECK(moved.getString() == "Short");
+			CHECK(moved.getType() == sf::Value::vitString);
+		}
+		// Binary data converted to and from a string.
+		const char data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+		sf::Value b(data, sizeof(data));
+		CHECK(b.getString() == "0102030405060708");
+		CHECK(sf::Value(b).compare(b) == 0);
+		sf::Value s(b.getString());
+		CHECK(s.setType(sf::Value::vitBinary));
+		CHECK(s.getSize() == sizeof(data));
+		CHECK(!memcmp(s.getBinary(), data, sizeof(data)));
+		// Moving into an instance keeps the type as assign does.
+		sf::Value f(1.5);
+		f.assign(sf::Value(3));
+		CHECK(f.getType() == sf::Value::vitFloat);
+		CHECK(f.getFloat() == 3.0);
+	}
 }
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <misc/gen/Exception.h>
 #include <misc/lnx/FileMapper.h>
+#include <misc/lnx/FileMapperArena.h>
 #include <misc/lnx/SegmentFaultHandler.h>
 #include <misc/lnx/lnx_utils.h>
 #include <test/catch.h>
@@ -76,3 +77,16 @@ TEST_CASE("sf::lnx::FileMapper", "[con][linux][file]")
 		REQUIRE(!sf::fileExists(fp));
 	}
 }
+
+TEST_CASE("sf::lnx::FileMapperArena", "[con][linux][file]")
+{
+	sf::lnx::FileMapperArena arena(true, false);
+	auto ofs = arena.allocate(100);
+	CHECK(arena.getAllocated() == arena.getAlignment());
+	// Empty ranges allocate nothing instead of failing.
+	CHECK(arena.allocate(0) == 0);
+	arena.release(0, 0);
+	CHECK(arena.getAllocated() == arena.getAlignment());
+	arena.release(ofs, 100);
+	CHECK(arena.getAllocated() == 0);
+}
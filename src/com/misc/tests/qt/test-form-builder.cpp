@@ -0,0 +1,292 @@
+#include <test/catch.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFormLayout>
+#include <QGridLayout>
+#include <QLabel>
+#include <QTabWidget>
+#include <QTemporaryDir>
+#include <misc/qt/FormBuilder.h>
+#include <misc/qt/qt_utils.h>
+
+extern int debug_level;
+
+namespace
+{
+
+const char* FormXml = R"(<?xml version="1.0" encoding="UTF-8"?>
+<ui version="4.0">
+ <class>Form</class>
+ <widget class="QWidget" name="Form">
+  <property name="geometry">
+   <rect>
+    <x>0</x>
+    <y>0</y>
+    <width>320</width>
+    <height>240</height>
+   </rect>
+  </property>
+  <property name="windowTitle">
+   <string>Form Test</string>
+  </property>
+  <layout class="QGridLayout" name="gridLayout">
+   <property name="leftMargin">
+    <number>2</number>
+   </property>
+   <property name="horizontalSpacing">
+    <number>3</number>
+   </property>
+   <item row="0" column="0">
+    <widget class="QLabel" name="label">
+     <property name="text">
+      <string>&amp;Name</string>
+     </property>
+     <property name="buddy">
+      <cstring>lineEdit</cstring>
+     </property>
+    </widget>
+   </item>
+   <item row="0" column="1">
+    <widget class="QLineEdit" name="lineEdit">
+     <property name="toolTip">
+      <string>Name tip</string>
+     </property>
+     <property name="alignment">
+      <set>Qt::AlignRight|Qt::AlignVCenter</set>
+     </property>
+     <property name="custom" stdset="0">
+      <string>value</string>
+     </property>
+    </widget>
+   </item>
+   <item row="1" column="0" colspan="2">
+    <widget class="QTabWidget" name="tabWidget">
+     <property name="currentIndex">
+      <number>1</number>
+     </property>
+     <widget class="QWidget" name="tabFirst">
+      <attribute name="title">
+       <string>First</string>
+      </attribute>
+     </widget>
+     <widget class="QWidget" name="tabSecond">
+      <attribute name="title">
+       <string>Second</string>
+      </attribute>
+      <layout class="QVBoxLayout" name="verticalLayout">
+       <item>
+        <widget class="QCheckBox" name="checkBox">
+         <property name="text">
+          <string>Check</string>
+         </property>
+        </widget>
+       </item>
+       <item>
+        <spacer name="verticalSpacer">
+         <property name="orientation">
+          <enum>Qt::Vertical</enum>
+         </property>
+         <property name="sizeHint" stdset="0">
+          <size>
+           <width>20</width>
+           <height>40</height>
+          </size>
+         </property>
+        </spacer>
+       </item>
+      </layout>
+     </widget>
+    </widget>
+   </item>
+   <item row="2" column="0">
+    <widget class="Line" name="line">
+     <property name="orientation">
+      <enum>Qt::Horizontal</enum>
+     </property>
+    </widget>
+   </item>
+   <item row="2" column="1">
+    <layout class="QHBoxLayout" name="horizontalLayout" stretch="1,0">
+     <item>
+      <widget class="QPushButton" name="pushButton">
+       <property name="text">
+        <string>Push</string>
+       </property>
+      </widget>
+     </item>
+     <item>
+      <spacer name="horizontalSpacer">
+       <property name="orientation">
+        <enum>Qt::Horizontal</enum>
+       </property>
+      </spacer>
+     </item>
+    </layout>
+   </item>
+  </layout>
+ </widget>
+ <tabstops>
+  <tabstop>lineEdit</tabstop>
+  <tabstop>pushButton</tabstop>
+ </tabstops>
+ <connections/>
+</ui>
+)";
+
+// Describes the widget tree for comparing the results of the load paths.
+QString describe(QObject* obj, int depth = 0)
+{
+	QString rv = QString(depth, ' ') + obj->metaObject()->className() + ' ' + obj->objectName();
+	if (auto w = qobject_cast<QWidget*>(obj))
+	{
+		rv += QString(" tip=%1 title=%2").arg(w->toolTip(), w->windowTitle());
+	}
+	if (auto lbl = qobject_cast<QLabel*>(obj))
+	{
+		rv += QString(" text=%1 buddy=%2").arg(lbl->text(), lbl->buddy() ? lbl->buddy()->objectName() : QString());
+	}
+	if (auto frm = qobject_cast<QFrame*>(obj))
+	{
+		rv += QString(" shape=%1").arg(frm->frameShape());
+	}
+	if (auto tw = qobject_cast<QTabWidget*>(obj))
+	{
+		rv += QString(" current=%1").arg(tw->currentIndex());
+		for (int i = 0; i < tw->count(); i++)
+		{
+			rv += QString(" tab=%1:%2").arg(tw->tabText(i), tw->widget(i)->objectName());
+		}
+	}
+	if (auto lay = qobject_cast<QLayout*>(obj))
+	{
+		auto m = lay->contentsMargins();
+		rv += QString(" margins=%1,%2,%3,%4 items=%5").arg(m.left()).arg(m.top()).arg(m.right()).arg(m.bottom()).arg(lay->count());
+		if (auto grid = qobject_cast<QGridLayout*>(lay))
+		{
+			rv += QString(" hspacing=%1").arg(grid->horizontalSpacing());
+			for (int i = 0; i < grid->count(); i++)
+			{
+				int r, c, rs, cs;
+				grid->getItemPosition(i, &r, &c, &rs, &cs);
+				rv += QString(" [%1,%2,%3,%4]").arg(r).arg(c).arg(rs).arg(cs);
+			}
+		}
+		if (auto box = qobject_cast<QBoxLayout*>(lay))
+		{
+			for (int i = 0; i < box->count(); i++)
+			{
+				rv += QString(" stretch=%1").arg(box->stretch(i));
+			}
+		}
+	}
+	for (auto& name: obj->dynamicPropertyNames())
+	{
+		if (!name.startsWith("_q_"))
+		{
+			rv += QString(" %1=%2").arg(QString(name), obj->property(name).toString());
+		}
+	}
+	rv += '\n';
+	// Sort the children since the order is not relevant.
+	QStringList children;
+	for (auto child: obj->children())
+	{
+		children.append(describe(child, depth + 1));
+	}
+	children.sort();
+	return rv + children.join(QString());
+}
+
+QString load(const QString& filepath)
+{
+	sf::FormBuilder builder;
+	QFile file(filepath);
+	REQUIRE(file.open(QFile::ReadOnly | QFile::Text));
+	QScopedPointer<QWidget> widget(builder.load(&file, nullptr));
+	REQUIRE(widget);
+	return describe(widget.get());
+}
+
+}
+
+TEST_CASE("sf::FormBuilder", "[gui][qt]")
+{
+	// When not GUI application has been started skip this test.
+	if (!sf::isGuiApplication())
+	{
+		SKIP("QApplication is not running.");
+	}
+
+	QTemporaryDir dir;
+	REQUIRE(dir.isValid());
+	auto filepath = dir.filePath("form.ui");
+	auto cachepath = dir.filePath(".form.ui.cache");
+	{
+		QFile file(filepath);
+		REQUIRE(file.open(QFile::WriteOnly));
+		file.write(FormXml);
+	}
+
+	SECTION("Load paths")
+	{
+		sf::FormBuilder::clearCache();
+		auto xml = sf::FormBuilder::getLoadTime(sf::FormBuilder::lpXml).count;
+		auto memory = sf::FormBuilder::getLoadTime(sf::FormBuilder::lpMemory).count;
+		auto cache = sf::FormBuilder::getLoadTime(sf::FormBuilder::lpFile).count;
+		// First load parses the XML and writes the cache file.
+		auto fromXml = load(filepath);
+		CHECK(sf::FormBuilder::getLoadTime(sf::FormBuilder::lpXml).count == xml + 1);
+		CHECK(QFile::exists(cachepath));
+		// Second load uses the compiled layout in memory.
+		CHECK(load(filepath) == fromXml);
+		CHECK(sf::FormBuilder::getLoadTime(sf::FormBuilder::lpMemory).count == memory + 1);
+		// Third load reads the cache file.
+		sf::FormBuilder::clearCache();
+		CHECK(load(filepath) == fromXml);
+		CHECK(sf::FormBuilder::getLoadTime(sf::FormBuilder::lpFile).count == cache + 1);
+		// The geometry is available without loading.
+		QFile file(filepath);
+		REQUIRE(file.open(QFile::ReadOnly | QFile::Text));
+		CHECK(sf::FormBuilder::peekGeometry(&file) == QRect(0, 0, 320, 240));
+		if (debug_level)
+		{
+			qDebug().noquote() << fromXml;
+			qDebug().noquote() << sf::FormBuilder::getLoadReport();
+		}
+	}
+
+	SECTION("Changed file")
+	{
+		sf::FormBuilder::clearCache();
+		load(filepath);
+		// Changing the content changes the key so the XML is loaded again.
+		{
+			QFile file(filepath);
+			REQUIRE(file.open(QFile::WriteOnly));
+			file.write(QByteArray(FormXml).replace("Name tip", "Other tip"));
+		}
+		auto xml = sf::FormBuilder::getLoadTime(sf::FormBuilder::lpXml).count;
+		CHECK(load(filepath).contains("tip=Other tip"));
+		CHECK(sf::FormBuilder::getLoadTime(sf::FormBuilder::lpXml).count == xml + 1);
+	}
+
+	SECTION("Not compilable")
+	{
+		sf::FormBuilder::clearCache();
+		// Connections are not represented by the compiled layout.
+		{
+			QFile file(filepath);
+			REQUIRE(file.open(QFile::WriteOnly));
+			file.write(QByteArray(FormXml).replace("<connections/>",
+				"<connections><connection><sender>pushButton</sender><signal>clicked()</signal>"
+				"<receiver>Form</receiver><slot>close()</slot></connection></connections>"));
+		}
+		QFile::remove(cachepath);
+		auto xml = sf::FormBuilder::getLoadTime(sf::FormBuilder::lpXml).count;
+		load(filepath);
+		load(filepath);
+		CHECK(sf::FormBuilder::getLoadTime(sf::FormBuilder::lpXml).count == xml + 2);
+		CHECK_FALSE(QFile::exists(cachepath));
+	}
+}
@@ -1,3 +1,8 @@
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <misc/gen/gen_utils.h>
 
 #include "RsaEmulator.h"
@@ -5,10 +10,19 @@
 namespace sf
 {
 
-#define EMU_CHANNELCOUNT 8
-#define EMU_MAXGATES 8
+// Gates available for each channel when the gates are fixed and the minimum available.
+#define EMU_FIXED_GATES 8
 #define EMU_INPUTCOUNT 2
+// The TCG point ids are consecutive which limits the amount of points.
 #define EMU_MAX_TCG_POINTS 16
+// Maximum amount of threads generating the channel data.
+#define EMU_MAX_THREADS 64
+// Shots generated for each channel in a single round when in throughput mode.
+#define EMU_THROUGHPUT_BATCH 64
+// Time in milliseconds spent generating in a single sustain call when in throughput mode.
+#define EMU_THROUGHPUT_BUDGET 50
+// Virtual time in seconds advanced by a single sustain call in deterministic mode.
+#define EMU_VIRTUAL_STEP 0.05
 //
 // Parameter ID manipulation parameters.
 //
@@ -22,6 +36,9 @@ namespace sf
 #define NO_GATE 0xFF
 // Define for a no channel number.
 #define NO_CHANNEL 0xFF
+// The channel and gate numbers must fit in the id below the reserved values.
+#define EMU_MAX_CHANNELS NO_CHANNEL
+#define EMU_MAX_GATES NO_GATE
 
 // Macro's for mapping parameter enumerates PID numbers.
 #define PID_MAP(n)         (n)
@@ -53,6 +70,14 @@ namespace sf
 //
 #define PID_ONESHOTDELAY   PID_ADDED(12)
 #define PID_ONESHOTSTATE   PID_ADDED(13)
+#define PID_THREADS        PID_ADDED(14)
+#define PID_THROUGHPUT     PID_ADDED(15)
+// Ids following the TCG record.
+#define PID_SYNC_RATE      PID_ADDED(48)
+#define PID_DATA_RATE      PID_ADDED(49)
+#define PID_SEED           PID_ADDED(50)
+#define PID_SYNC_LIMIT     PID_ADDED(51)
+#define PID_CHECKSUM       PID_ADDED(52)
 // Map default channel parameters to our own ID's.
 #define PID_REPRATE         PID_CHANNEL_MAP(apChannel_RepRate)
 #define PID_SYNCMODE        PID_CHANNEL_MAP(apChannel_SyncMode)
@@ -98,6 +123,7 @@ namespace sf
 #define PID_TCG_SLAVETO         PID_CHANNEL_ADDED(16)
 #define PID_TCG_DELAY           PID_CHANNEL_ADDED(17)
 #define PID_TCG_RANGE           PID_CHANNEL_ADDED(18)
+#define PID_PROCESSING          PID_CHANNEL_ADDED(19)
 //
 #define PID_GATE_MODE           PID_GATE_ADDED(1)
 #define PID_GATE_DETECTION      PID_GATE_ADDED(2)
@@ -133,7 +159,8 @@ void FillDataBuffer(
 	double gain,
 	int delay1,
 	int delay2,
-	int delay3
+	int delay3,
+	std::minstd_rand& random
 );
 
 /**
@@ -155,9 +182,105 @@ bool PeakNormal(
 	unsigned& peakval
 );
 
+/**
+ * Seeds the generator of a channel so each channel has its own sequence for the same seed.
+ */
+void SeedRandom(std::minstd_rand& random, uint64_t seed, size_t channel)
+{
+	std::seed_seq sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32), static_cast<uint32_t>(channel)};
+	random.seed(sequence);
+}
+
+/**
+ * @brief Pool of threads calling a function for a range of indices.
+ */
+struct AcquisitionEmulator::TWorkers
+{
+	explicit TWorkers(unsigned count)
+	{
+		for (unsigned i = 0; i < count; i++)
+		{
+			Threads.emplace_back(&TWorkers::Run, this);
+		}
+	}
+
+	~TWorkers()
+	{
+		{
+			std::lock_guard lock(Mutex);
+			Terminate = true;
+		}
+		Condition.notify_all();
+		for (auto& thread: Threads)
+		{
+			thread.join();
+		}
+	}
+
+	// Calls the function for each index using the threads and the calling thread and returns when all are done.
+	void Execute(size_t count, const std::function<void(size_t)>& function)
+	{
+		std::unique_lock lock(Mutex);
+		Function = &function;
+		Count = count;
+		Next = 0;
+		Done = 0;
+		Condition.notify_all();
+		Work(lock);
+		DoneCondition.wait(lock, [this] {return Done == Count;});
+		Function = nullptr;
+	}
+
+	// Takes indices until none are left where the lock is held on entry and exit.
+	void Work(std::unique_lock<std::mutex>& lock)
+	{
+		while (Function && Next < Count)
+		{
+			auto index = Next++;
+			auto function = Function;
+			lock.unlock();
+			(*function)(index);
+			lock.lock();
+			if (++Done == Count)
+			{
+				DoneCondition.notify_all();
+			}
+		}
+	}
+
+	// Thread function.
+	void Run()
+	{
+		std::unique_lock lock(Mutex);
+		while (!Terminate)
+		{
+			Work(lock);
+			Condition.wait(lock, [this] {return Terminate || (Function && Next < Count);});
+		}
+	}
+
+	// Guards the members below.
+	std::mutex Mutex;
+	// Wakes the threads when there is work.
+	std::condition_variable Condition;
+	// Wakes the calling thread when all work is done.
+	std::condition_variable DoneCondition;
+	// Function called for each index.
+	const std::function<void(size_t)>* Function{nullptr};
+	// Amount of indices.
+	size_t Count{0};
+	// Next index to take.
+	size_t Next{0};
+	// Amount of indices done.
+	size_t Done{0};
+	// Flag for the threads to stop.
+	bool Terminate{false};
+	// The threads.
+	std::vector<std::thread> Threads;
+};
+
 AcquisitionEmulator::AcquisitionEmulator(const Parameters& parameters)
 	:RsaInterface(parameters)
-	 , FChannelInfo(new TChannelInfo[EMU_CHANNELCOUNT])
 	 , SustainEntry(this, &AcquisitionEmulator::sustain, SustainBase::spDefault)
 {
 	SF_RTTI_NOTIFY(DO_DEFAULT, "Constructor of " << parameters._mode);
@@ -170,31 +293,7 @@ AcquisitionEmulator::AcquisitionEmulator(const Parameters& parameters)
 	{
 		FlagFixed = true;
 	}
-	// Initialize channel structures.
-	for (int i = 0; i < EMU_CHANNELCOUNT; i++)
-	{
-		FChannelInfo[i].GateCount = (FlagFixed) ? EMU_MAXGATES : 0;
-		FChannelInfo[i].TimeUnits = 1e-7;
-		FChannelInfo[i].Gain = 30;
-		FChannelInfo[i].RepRate = 1000;
-		FChannelInfo[i].PopDivider = 1;
-		FChannelInfo[i].CopyEnabled = true;
-		FChannelInfo[i].CopyRange = 100;
-
-		for (int j = 0; j < EMU_MAXGATES; j++)
-		{
-			FChannelInfo[i].GateInfo[j].MethodId = MID_COPY;
-			FChannelInfo[i].GateInfo[j].Delay = 100 + j * 100;
-			if (j == 0)
-			{
-				FChannelInfo[i].GateInfo[j].Name = "IF Gate";
-			}
-			else
-			{
-				FChannelInfo[i].GateInfo[j].Name = stringf("Gate %u", j);
-			}
-		}
-	}
+	// Channel structures are initialized when the channel count is set below.
 	//*
 	// Dik hout zagen van planken methode.
 	// Get the current ids
@@ -216,7 +315,55 @@ AcquisitionEmulator::AcquisitionEmulator(const Parameters& parameters)
 
 AcquisitionEmulator::~AcquisitionEmulator()
 {
-	delete[] FChannelInfo;
+	// Stop the threads before the channel info they work on is destroyed.
+	Workers.reset();
+}
+
+void AcquisitionEmulator::ReserveChannels(unsigned count)
+{
+	while (FChannelInfo.size() < count)
+	{
+		auto& ci(FChannelInfo.emplace_back());
+		ci.GateCount = (FlagFixed) ? EMU_FIXED_GATES : 0;
+		ci.TimeUnits = 1e-7;
+		ci.Gain = 30;
+		ci.RepRate = 1000;
+		ci.PopDivider = 1;
+		ci.CopyEnabled = true;
+		ci.CopyRange = 100;
+		// Each channel has its own noise.
+		SeedRandom(ci.Random, Seed, FChannelInfo.size() - 1);
+		// The first gates always exist since slaving refers to them.
+		ReserveGates(ci, EMU_FIXED_GATES);
+	}
+}
+
+void AcquisitionEmulator::ReserveGates(TChannelInfo& ci, unsigned count)
+{
+	while (ci.GateInfo.size() < count)
+	{
+		auto j = ci.GateInfo.size();
+		auto& gi(ci.GateInfo.emplace_back());
+		gi.MethodId = MID_COPY;
+		gi.Delay = 100 + static_cast<long>(j) * 100;
+		if (j == 0)
+		{
+			gi.Name = "IF Gate";
+		}
+		else
+		{
+			gi.Name = stringf("Gate %u", j);
+		}
+	}
+}
+
+void AcquisitionEmulator::TChannelInfo::RandomizeSweep()
+{
+	// Taken directly from the engine since the output of the standard distributions differs between libraries.
+	for (double& i: Sweep)
+	{
+		i = (Random() - Random.min()) % 4;
+	}
 }
 
 bool AcquisitionEmulator::doInitialize(bool init)
@@ -244,10 +391,90 @@ bool AcquisitionEmulator::setRunMode(bool runMode, bool clear)
 			FChannelInfo[i].SyncCounter = 0;
 			FChannelInfo[i].SyncTimeOffset = 0.0;
 		}
+		// Start over the same data stream.
+		if (Seed)
+		{
+			ResetDeterministic();
+		}
 	}
 	return true;
 }
 
+double AcquisitionEmulator::GetRunTime() const
+{
+	return Seed ? VirtualTime : TimeSpec(getTime()).toDouble() - SyncTimeStart;
+}
+
+void AcquisitionEmulator::ResetDeterministic()
+{
+	VirtualTime = 0.0;
+	for (size_t i = 0; i < FChannelInfo.size(); i++)
+	{
+		SeedRandom(FChannelInfo[i].Random, Seed, i);
+	}
+	Checksums.clear();
+	ChecksumsReported = false;
+}
+
+void AcquisitionEmulator::DeliverResult(IdType id)
+{
+	callResultHook(id);
+	if (Seed)
+	{
+		// Checksum the same buffer the server copies from.
+		BufferInfo bufInfo;
+		if (handleResult(id, nullptr, &bufInfo) && bufInfo.Buffer)
+		{
+			Checksums[id].update(static_cast<const uint8_t*>(bufInfo.Buffer), bufInfo.BlockBufSize);
+		}
+	}
+}
+
+std::map<RsaTypes::IdType, std::string> AcquisitionEmulator::getChecksums() const
+{
+	std::map<IdType, std::string> rv;
+	for (auto& [id, hash]: Checksums)
+	{
+		// Finalizing a copy allows the checksum to continue.
+		rv[id] = Md5Hash(hash).finalize().hexDigest();
+	}
+	return rv;
+}
+
+std::string AcquisitionEmulator::getChecksum() const
+{
+	Md5Hash hash;
+	for (auto& [id, digest]: getChecksums())
+	{
+		auto text = stringf("%llX:", (unsigned long long) id) + digest;
+		hash.update(text.data(), text.length());
+	}
+	return hash.finalize().hexDigest();
+}
+
+void AcquisitionEmulator::ReportChecksums()
+{
+	if (!Seed || !SyncLimit || ChecksumsReported)
+	{
+		return;
+	}
+	for (unsigned channel = 0; channel < ChannelCount; channel++)
+	{
+		if (!FChannelInfo[channel].SyncMode && FChannelInfo[channel].SyncCounter < SyncLimit)
+		{
+			return;
+		}
+	}
+	ChecksumsReported = true;
+	// Checksums per result help finding which one differs.
+	for (auto& [id, digest]: getChecksums())
+	{
+		SF_COND_RTTI_NOTIFY(isDebug(), DO_CLOG, "Checksum " << stringf("0x%lX", id) << ": " << digest)
+	}
+	SF_RTTI_NOTIFY(DO_CLOG, "Checksum of " << SyncLimit << " syncs with seed " << Seed << ": " << getChecksum())
+	callParamHook(MAKE_ID(NO_CHANNEL, NO_GATE, PID_CHECKSUM));
+}
+
 long AcquisitionEmulator::TimeUnits(const TChannelInfo& ci, const Value& value) const
 {
 	return static_cast<long>(round<Value::flt_type>(value.getFloat() / ci.TimeUnits, 1.0));
@@ -356,7 +583,8 @@ bool AcquisitionEmulator::handleParam
 			case PID_CHANNELS:
 				if (setval)
 				{
-					ChannelCount = setval->getInteger();
+					ChannelCount = static_cast<unsigned>(clip<Value::int_type>(setval->getInteger(), 1, EMU_MAX_CHANNELS));
+					ReserveChannels(ChannelCount);
 				}
 				if (getval)
 				{
@@ -371,11 +599,183 @@ bool AcquisitionEmulator::handleParam
 					info->Default.set(1);
 					info->Round.set(1);
 					info->Minimum.set(1);
-					info->Maximum.set(4);
+					info->Maximum.set(EMU_MAX_CHANNELS);
 					info->Flags = pfSystem | pfEffectsParameter | pfEffectsResult;
 				}
 				break;
 
+			case PID_THREADS:
+				if (setval)
+				{
+					auto count = static_cast<unsigned>(clip<Value::int_type>(setval->getInteger(), 1, EMU_MAX_THREADS));
+					if (count != ThreadCount)
+					{
+						ThreadCount = count;
+						// The sustain thread is one of the generating threads.
+						Workers.reset(ThreadCount > 1 ? new TWorkers(ThreadCount - 1) : nullptr);
+					}
+				}
+				if (getval)
+				{
+					getval->set(ThreadCount);
+				}
+				if (info)
+				{
+					info->Id = id;
+					info->Name = "Emulation|Threads";
+					info->Unit = "!";
+					info->Description += "Amount of threads generating the data of the channels.";
+					info->Default.set(1);
+					info->Round.set(1);
+					info->Minimum.set(1);
+					info->Maximum.set(EMU_MAX_THREADS);
+				}
+				break;
+
+			case PID_THROUGHPUT:
+				if (setval)
+				{
+					auto throughput = setval->getInteger() != 0;
+					if (throughput != Throughput)
+					{
+						Throughput = throughput;
+						if (!Throughput)
+						{
+							// Continue at the repetition rate from the current sync counters.
+							auto runTime = GetRunTime();
+							for (auto& ci: FChannelInfo)
+							{
+								ci.SyncTimeOffset = ((double) ci.SyncCounter / ci.RepRate) - runTime;
+							}
+						}
+						updateThroughput(true);
+					}
+				}
+				if (getval)
+				{
+					getval->set(Throughput);
+				}
+				if (info)
+				{
+					info->Id = id;
+					info->Name = "Emulation|Throughput";
+					info->Unit = "!";
+					info->Description += "Generates shots as fast as possible ignoring the repetition rate.";
+					info->Default.set(0);
+					info->Round.set(1);
+					info->Minimum.set(0);
+					info->Maximum.set(1);
+					info->Flags = 0;
+					info->States.add(ParamState("Disabled", Value(0)));
+					info->States.add(ParamState("Enabled", Value(1)));
+				}
+				break;
+
+			case PID_SYNC_RATE:
+				if (getval)
+				{
+					getval->set(SyncRate);
+				}
+				if (info)
+				{
+					info->Id = id;
+					info->Name = "Emulation|Sync Rate";
+					info->Unit = "1/s";
+					info->Description += "Shots delivered per second for all channels together.";
+					info->Default.set(0.0);
+					info->Round.set(1.0);
+					info->Minimum.set(0.0);
+					info->Maximum.set(1e9);
+					info->Flags = pfReadonly;
+				}
+				break;
+
+			case PID_DATA_RATE:
+				if (getval)
+				{
+					getval->set(DataRate);
+				}
+				if (info)
+				{
+					info->Id = id;
+					info->Name = "Emulation|Data Rate";
+					info->Unit = "MB/s";
+					info->Description += "Result data delivered per second for all channels together.";
+					info->Default.set(0.0);
+					info->Round.set(0.01);
+					info->Minimum.set(0.0);
+					info->Maximum.set(1e6);
+					info->Flags = pfReadonly;
+				}
+				break;
+
+			case PID_SEED:
+				if (setval)
+				{
+					auto seed = static_cast<uint64_t>(std::max<Value::int_type>(setval->getInteger(), 0));
+					if (seed != Seed)
+					{
+						Seed = seed;
+						ResetDeterministic();
+					}
+				}
+				if (getval)
+				{
+					getval->set(static_cast<Value::int_type>(Seed));
+				}
+				if (info)
+				{
+					info->Id = id;
+					info->Name = "Emulation|Seed";
+					info->Unit = "!";
+					info->Description += "Seed of the deterministic mode using a virtual clock where zero disables it.";
+					info->Default.set(0);
+					info->Round.set(1);
+					info->Minimum.set(0);
+					info->Maximum.set(std::numeric_limits<int32_t>::max());
+					info->Flags = 0;
+				}
+				break;
+
+			case PID_SYNC_LIMIT:
+				if (setval)
+				{
+					SyncLimit = static_cast<uint32_t>(clip<Value::int_type>(setval->getInteger(), 0, std::numeric_limits<uint32_t>::max()));
+					ChecksumsReported = false;
+				}
+				if (getval)
+				{
+					getval->set(SyncLimit);
+				}
+				if (info)
+				{
+					info->Id = id;
+					info->Name = "Emulation|Sync Limit";
+					info->Unit = "!";
+					info->Description += "Amount of syncs after which generating stops where zero means no limit.";
+					info->Default.set(0);
+					info->Round.set(1);
+					info->Minimum.set(0);
+					info->Maximum.set(std::numeric_limits<uint32_t>::max());
+					info->Flags = 0;
+				}
+				break;
+
+			case PID_CHECKSUM:
+				if (getval)
+				{
+					getval->set(Seed ? getChecksum() : std::string());
+				}
+				if (info)
+				{
+					info->Id = id;
+					info->Name = "Emulation|Checksum";
+					info->Description += "MD5 checksum of the results delivered in deterministic mode.";
+					info->Default.set(std::string());
+					info->Flags = pfReadonly;
+				}
+				break;
+
 			case PID_AMPUNITS:
 				if (setval)
 				{
@@ -476,6 +876,11 @@ bool AcquisitionEmulator::handleParam
 				if (setval)
 				{
 					Tcg[index].Time = setval->getFloat();
+					// The table is shared by all channels.
+					for (auto& ci: FChannelInfo)
+					{
+						ci.SetupChanged = true;
+					}
 				}
 				if (getval)
 				{
@@ -518,6 +923,11 @@ bool AcquisitionEmulator::handleParam
 				if (setval)
 				{
 					Tcg[index].Gain = setval->getFloat();
+					// The table is shared by all channels.
+					for (auto& ci: FChannelInfo)
+					{
+						ci.SetupChanged = true;
+					}
 				}
 				if (getval)
 				{
@@ -545,8 +955,19 @@ bool AcquisitionEmulator::handleParam
 	}
 	else
 	{
+		// Channels beyond the reserved ones do not exist.
+		if (GETCHANNEL(id) >= FChannelInfo.size())
+		{
+			SF_RTTI_NOTIFY(DO_DEFAULT, "Channel Param ID 0x" << itostr(id, 16) << " does not exist!");
+			return false;
+		}
 		// Create temporary easy to use reference.
 		TChannelInfo& ci(FChannelInfo[GETCHANNEL(id)]);
+		// Any channel or gate parameter can affect the software processing setup.
+		if (setval)
+		{
+			ci.SetupChanged = true;
+		}
 		// Switch between gate and non gate parameter ID's.
 		if (GETGATE(id) == NO_GATE)
 		{
@@ -562,7 +983,7 @@ bool AcquisitionEmulator::handleParam
 					{
 						ci.RepRate = setval->getFloat();
 						//ci.SyncCounter = (time - SyncTimeStart + ci.SyncTimeOffset) * ci.RepRate;
-						ci.SyncTimeOffset = ((double) ci.SyncCounter / ci.RepRate) + SyncTimeStart - TimeSpec(getTime()).toDouble();
+						ci.SyncTimeOffset = ((double) ci.SyncCounter / ci.RepRate) - GetRunTime();
 					}
 					if (getval)
 					{
@@ -608,7 +1029,8 @@ bool AcquisitionEmulator::handleParam
 				case PID_GATES:
 					if (setval)
 					{
-						ci.GateCount = setval->getInteger();
+						ci.GateCount = static_cast<unsigned>(clip<Value::int_type>(setval->getInteger(), 0, EMU_MAX_GATES));
+						ReserveGates(ci, ci.GateCount);
 					}
 					if (getval)
 					{
@@ -623,7 +1045,7 @@ bool AcquisitionEmulator::handleParam
 						info->Default.set(FlagFixed ? ci.GateCount : 0);
 						info->Round.set(1);
 						info->Minimum.set(FlagFixed ? ci.GateCount : 0);
-						info->Maximum.set(FlagFixed ? ci.GateCount : 3);
+						info->Maximum.set(FlagFixed ? ci.GateCount : EMU_MAX_GATES);
 						info->Flags |= pfEffectsParameter | pfEffectsResult;
 						if (FlagFixed)
 						{
@@ -893,6 +1315,39 @@ bool AcquisitionEmulator::handleParam
 					}
 					break;
 
+				case PID_PROCESSING:
+					if (setval)
+					{
+						// Processing in software needs a pipeline having a worker thread.
+						if (setval->getInteger() && !ci.Pipeline)
+						{
+							ci.Pipeline = new AscanPipeline();
+							ci.Pipeline->start(1);
+						}
+						else if (!setval->getInteger())
+						{
+							delete_null(ci.Pipeline);
+						}
+					}
+					if (getval)
+					{
+						getval->set(ci.Pipeline ? 1 : 0);
+					}
+					if (info)
+					{
+						info->Id = id;
+						info->Name = "A-scan|Processing";
+						info->Unit = "!";
+						info->Description += "Where the raw A-scan is processed.";
+						info->Default.set(0);
+						info->Round.set(1);
+						info->Minimum.set(0);
+						info->Maximum.set(1);
+						info->States.add(ParamState("Hardware", Value(0)));
+						info->States.add(ParamState("Software", Value(1)));
+					}
+					break;
+
 				case PID_TCG_ENABLE:
 					if (setval)
 					{
@@ -993,6 +1448,11 @@ bool AcquisitionEmulator::handleParam
 		else
 		{
 			int gate = GETGATE(id);
+			if (gate >= static_cast<int>(ci.GateInfo.size()))
+			{
+				SF_RTTI_NOTIFY(DO_DEFAULT, "Gate Param ID 0x" << itostr(id, 16) << " does not exist!");
+				return false;
+			}
 			// Create temporary easy to use reference.
 			TGateInfo& gi(ci.GateInfo[gate]);
 			// Preset the gate related flag
@@ -1294,6 +1754,13 @@ bool AcquisitionEmulator::enumParamIds(IdList& ids)
 	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_ONESHOTDELAY));
 	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_ONESHOTSTATE));
 	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_AMPUNITS));
+	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_THREADS));
+	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_THROUGHPUT));
+	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_SYNC_RATE));
+	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_DATA_RATE));
+	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_SEED));
+	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_SYNC_LIMIT));
+	ids.add(MAKE_ID(NO_CHANNEL, NO_GATE, PID_CHECKSUM));
 	// Add the TCG ID's
 	for (int i = 0; i < EMU_MAX_TCG_POINTS; i++)
 	{
@@ -1321,6 +1788,7 @@ bool AcquisitionEmulator::enumParamIds(IdList& ids)
 		// Emulation added
 		ids.add(MAKE_ID(channel, NO_GATE, PID_GAIN));
 		ids.add(MAKE_ID(channel, NO_GATE, PID_ASCAN_RECTIFY));
+		ids.add(MAKE_ID(channel, NO_GATE, PID_PROCESSING));
 		ids.add(MAKE_ID(channel, NO_GATE, PID_POPDIV));
 		ids.add(MAKE_ID(channel, NO_GATE, PID_IF_POSITION));
 		// Add gate parameters
@@ -1390,8 +1858,19 @@ bool AcquisitionEmulator::handleResult(IdType id, ResultInfo* info, BufferInfo*
 	}
 	else
 	{
+		// Channels and gates beyond the reserved ones do not exist.
+		if (GETCHANNEL(id) >= FChannelInfo.size() || (GETGATE(id) != NO_GATE && GETGATE(id) >= FChannelInfo[GETCHANNEL(id)].GateInfo.size()))
+		{
+			SF_RTTI_NOTIFY(DO_DEFAULT, "Result ID " << stringf("0x%lX", id) << " does not exist!");
+			return false;
+		}
 		// Create temporary easy to use reference.
 		TChannelInfo& ci(FChannelInfo[GETCHANNEL(id)]);
+		// All results of a channel originate from the same shot.
+		if (bufInfo)
+		{
+			bufInfo->Timestamp = ci.ShotTime;
+		}
 		// Switch between gate and non gate parameter ID's.
 		if (GETGATE(id) == NO_GATE)
 		{
@@ -1459,7 +1938,7 @@ bool AcquisitionEmulator::handleResult(IdType id, ResultInfo* info, BufferInfo*
 						info->Id = id;
 						info->Name = "Copy|Data";
 						info->Description += "";
-						info->Flags |= rfAsync;
+						info->Flags |= rfAsync | rfTimestamp;
 						info->Bits = ci.AscanRectify ? 7 : 8;
 						info->Offset = ci.AscanRectify ? 0 : 127;
 						info->WordSize = sizeof(uint8_t);
@@ -1499,6 +1978,7 @@ bool AcquisitionEmulator::handleResult(IdType id, ResultInfo* info, BufferInfo*
 						info->Id = id;
 						info->Name = "Copy|Amplitude Array";
 						info->Description += "Amplitude array with length of the range.";
+						info->Flags |= rfTimestamp;
 						info->Bits = 8;
 						info->Offset = 127;
 						info->WordSize = sizeof(uint8_t);
@@ -1579,6 +2059,26 @@ bool AcquisitionEmulator::handleResult(IdType id, ResultInfo* info, BufferInfo*
 	return true;
 }
 
+bool AcquisitionEmulator::getAffectedParamIds(IdType id, IdList& ids)
+{
+	// The amount of channels affects all parameters.
+	if (GETCHANNEL(id) == NO_CHANNEL)
+	{
+		return false;
+	}
+	// Channel and gate parameters only affect the parameters of the same channel.
+	IdList all;
+	enumParamIds(all);
+	for (auto i: all)
+	{
+		if (GETCHANNEL(i) == GETCHANNEL(id))
+		{
+			ids.add(i);
+		}
+	}
+	return true;
+}
+
 bool AcquisitionEmulator::enumResultIds(IdList& ids)
 {
 	// Add channel results
@@ -1624,204 +2124,61 @@ bool AcquisitionEmulator::sustain(const timespec& t)
 	if (RunMode)
 	{
 		// Amount of time (seconds) since the start of the run mode.
-		auto runTime = TimeSpec(t).toDouble() - SyncTimeStart;
-		//
-		for (int channel = 0; channel < ChannelCount; channel++)
+		auto runTime = Seed ? VirtualTime : TimeSpec(t).toDouble() - SyncTimeStart;
+		// In throughput mode generating is limited by time to keep the sustain loop going.
+		auto budget = std::chrono::steady_clock::now() + std::chrono::milliseconds(EMU_THROUGHPUT_BUDGET);
+		// Channels generated by the emulated hardware and the sync count to reach.
+		std::vector<std::pair<unsigned, uint32_t>> pending;
+		do
 		{
-			auto& ci(FChannelInfo[channel]);
-			// When the sync mode is internal generate data.
-			if (!ci.SyncMode)
+			pending.clear();
+			for (unsigned channel = 0; channel < ChannelCount; channel++)
 			{
-				// Sync counter expected value.
-				uint32_t syncCount = std::floor((runTime + ci.SyncTimeOffset) * ci.RepRate);
-				// Generate the amount syncs which is needed so far.
-				while (ci.SyncCounter <= syncCount)
+				auto& ci(FChannelInfo[channel]);
+				// When the sync mode is internal generate data.
+				if (!ci.SyncMode)
 				{
-					// Generate a result at each n-th sync.
-					if (ci.SyncCounter && ci.SyncCounter % ci.PopDivider == 0)
-					{
-						ci.PopIndex = ci.SyncCounter;
-						callResultHook(MAKE_ID(channel, NO_GATE, RID_POPINDEX));
-					}
-					// Set the data for retrieval.
-					ci.CopySyncIndex = ci.SyncCounter;
-					// Signal the owner that data is available.
-					callResultHook(MAKE_ID(channel, NO_GATE, RID_COPYINDEX));
-					// Iterate through the gates.
-					for (double& i: ci.Sweep)
-					{
-						i = random(0, 3);
-					}
-					//
-					FillDataBuffer(
-						ci.CopyBuf,
-						ci.CopyRange,
-						1,
-						8,
-						pow(10, ci.Gain / 20.0),
-						ci.Sweep[0] - ci.CopyDelay + ci.IfPos + 100.0,
-						ci.Sweep[1] - ci.CopyDelay + ci.IfPos + 250.0,
-						ci.Sweep[2] - ci.CopyDelay + ci.IfPos + 350.0
-					);
-					//
-					switch (ci.AscanRectify)
-					{
-						default:
-							break;
-						case 1:
-							for (int i = 0; i < ci.CopyRange; i++)
-							{
-								auto amp = ci.CopyBuf[i];
-								if (amp > 0)
-								{
-									amp = 0;
-								}
-								else
-								{
-									amp = 127 - clip(std::abs(amp), 0, 127);
-								}
-								ci.CopyBuf[i] = static_cast<uint8_t>(amp);
-							}
-							break;
-
-						case 2:
-							for (int i = 0; i < ci.CopyRange; i++)
-							{
-								int amp = ci.CopyBuf[i];
-								if (amp < 0)
-								{
-									amp = 0;
-								}
-								else
-								{
-									amp = 127 - clip(abs(amp), 0, 127);
-								}
-								ci.CopyBuf[i] = static_cast<uint8_t>(amp);
-							}
-							break;
-
-						case 3:
-							for (int i = 0; i < ci.CopyRange; i++)
-							{
-								auto amp = ci.CopyBuf[i];
-								amp = 127 - clip(abs(amp), 0, 127);
-								ci.CopyBuf[i] = static_cast<uint8_t>(amp);
-							}
-							break;
-					}
-					// Signal the owner that data is available.
-					callResultHook(MAKE_ID(channel, NO_GATE, RID_COPYDATA));
-					// Iterate through the gates.
-					for (unsigned gate = 0; gate < ci.GateCount; gate++)
-					{
-						TGateInfo& gi(ci.GateInfo[gate]);
-						//
-						double delay = gi.Delay;
-						// Calculate the delay for the slave mode.
-						if (gi.SlavedTo >= 0)
-						{
-							delay += ci.GateInfo[gi.SlavedTo].PeakTof - TOF_OFFSET;
-						}
-						else if (gi.SlavedTo == -2)
+					// Sync counter expected value.
+					uint32_t syncCount = Throughput ?
+						ci.SyncCounter + EMU_THROUGHPUT_BATCH - 1 : std::floor((runTime + ci.SyncTimeOffset) * ci.RepRate);
+					// Stop at the limit so runs can be compared.
+					if (SyncLimit)
+					{
+						if (ci.SyncCounter >= SyncLimit)
 						{
-							delay += ci.GateInfo[0].Delay;
-						}
-						//
-						FillDataBuffer
-							(
-								gi.CopyBuf,
-								gi.Range,
-								1,
-								8,
-								pow(10, ci.Gain / 20.0),
-								ci.Sweep[0] - delay + ci.IfPos + 100.0,
-								ci.Sweep[1] - delay + ci.IfPos + 250.0,
-								ci.Sweep[2] - delay + ci.IfPos + 350.0
-							);
-						//
-						switch (gi.MethodId)
-						{
-							case MID_PEAK:
-							{
-								gi.PeakFound = PeakNormal(gi.Polarity, gi.Threshold, gi.Range, (uint8_t*) gi.CopyBuf.data(), gi.PeakTof,gi.PeakAmp);
-								//SF_RTTI_NOTIFY(DO_CLOG, "Gate: " << gate << " Tof: " << gi.PeakTof << " Amp: " << gi.PeakAmp)
-								// Correct found peak with delay and result offset.
-								gi.PeakTof += gi.Delay + TOF_OFFSET;
-/*
-							//
-							// List of frequencies and amplitude combinations.
-							struct
-							{
-								double Amp;
-								double Freq;
-							}
-							static comp[] =
-							{
-								{1.0, 1.0},
-				//        {0.4, 2},
-				//        {1.0, 10},
-				//        {0.2, 20},
-				//        {0.1, 50}
-							};
-							//
-							long ti = ci.SyncCounter % ci.PopDivider;
-							int count = sizeof(comp) / sizeof(comp[0]);
-							double val = 0.0;
-							for (int k = 0; k < count; k++)
-								val += 0.5 * comp[k].Amp *
-									sin(calc_offset(ti, 0L, ci.PopDivider, 2.0 * M_PI * comp[k].Freq, true));
-							// Apply the gain on the amplitude.
-							val *= pow(10, (ci.Gain - 40.0) / 20.0);
-							//
-							gi.PeakAmp = calc_offset(val, -0.5, 0.5, 255, true);
-*/
-								/*
-								if ((ci.SyncCounter) % ci.PopDivider == 0)
-									gi.PeakTof = gi.Range + gi.Delay;
-								*/
-								/*
-								if (ci.SyncCounter)
-								{
-									if ((ci.SyncCounter) % (ci.PopDivider*2) == 0)
-										gi.PeakAmp = 200;
-									else
-										gi.PeakAmp = 127;
-									//
-									gi.PeakAmp += (ci.SyncCounter % ci.PopDivider) * 4;
-								}
-								else
-									gi.PeakAmp = 255;
-								*/
-								//
-								callResultHook(MAKE_ID(channel, gate, RID_PEAK_AMP));
-								callResultHook(MAKE_ID(channel, gate, RID_PEAK_TOF));
-								// Update the gate amplitude value.
-								if (gate)
-								{
-									callParamHook(MAKE_ID(channel, gate, PID_GATE_AMP));
-									callParamHook(MAKE_ID(channel, gate, PID_GATE_TOF));
-								}
-								break;
-							}
-
-							case MID_COPY:
-								callResultHook(MAKE_ID(channel, gate, RID_COPY));
-								break;
+							continue;
 						}
+						syncCount = std::min(syncCount, SyncLimit - 1);
+					}
+					// Raw shots are processed in software which leaves nothing for the hardware.
+					if (ci.Pipeline)
+					{
+						processSoftware(channel, syncCount);
+					}
+					else if (ci.SyncCounter <= syncCount)
+					{
+						pending.emplace_back(channel, syncCount);
 					}
-					// Increment the sync counter.
-					FChannelInfo[channel].SyncCounter++;
 				}
 			}
-			// Check if the single shot has finished.
-			if (SingleShotTimer)
-			{
-				// Prevent reentry.
-				SingleShotTimer.disable();
-				// Update the client's parameter.
-				callParamHook(MAKE_ID(NO_CHANNEL, NO_GATE, PID_ONESHOTSTATE));
-			}
+			processHardware(pending);
+		}
+		while (Throughput && !pending.empty() && std::chrono::steady_clock::now() < budget);
+		// Check if the single shot has finished.
+		if (SingleShotTimer)
+		{
+			// Prevent reentry.
+			SingleShotTimer.disable();
+			// Update the client's parameter.
+			callParamHook(MAKE_ID(NO_CHANNEL, NO_GATE, PID_ONESHOTSTATE));
+		}
+		// The virtual clock advances the same amount each call.
+		if (Seed)
+		{
+			VirtualTime += EMU_VIRTUAL_STEP;
 		}
+		ReportChecksums();
+		updateThroughput(false);
 	}
 	// Allow reentry again.
 	sentry = false;
@@ -1829,6 +2186,372 @@ bool AcquisitionEmulator::sustain(const timespec& t)
 	return true;
 }
 
+void AcquisitionEmulator::processHardware(const std::vector<std::pair<unsigned, uint32_t>>& pending)
+{
+	// Each round generates a single shot for the channels behind.
+	std::vector<unsigned> round;
+	std::function<void(size_t)> generate([&](size_t index)
+	{
+		GenerateShot(FChannelInfo[round[index]]);
+	});
+	for (;;)
+	{
+		round.clear();
+		for (auto& [channel, syncCount]: pending)
+		{
+			if (FChannelInfo[channel].SyncCounter <= syncCount)
+			{
+				round.push_back(channel);
+			}
+		}
+		if (round.empty())
+		{
+			break;
+		}
+		// Channels are independent so their shots are generated in parallel.
+		if (Workers && round.size() > 1)
+		{
+			Workers->Execute(round.size(), generate);
+		}
+		else
+		{
+			for (size_t i = 0; i < round.size(); i++)
+			{
+				generate(i);
+			}
+		}
+		// The results are delivered from this thread only.
+		for (auto channel: round)
+		{
+			DeliverShot(channel);
+		}
+	}
+}
+
+void AcquisitionEmulator::GenerateShot(TChannelInfo& ci)
+{
+	// Stamps the results of the shot with the moment of acquisition instead of delivery.
+	ci.ShotTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	// Random echo positions for this shot.
+	ci.RandomizeSweep();
+	//
+	FillDataBuffer(
+		ci.CopyBuf,
+		ci.CopyRange,
+		1,
+		8,
+		pow(10, ci.Gain / 20.0),
+		ci.Sweep[0] - ci.CopyDelay + ci.IfPos + 100.0,
+		ci.Sweep[1] - ci.CopyDelay + ci.IfPos + 250.0,
+		ci.Sweep[2] - ci.CopyDelay + ci.IfPos + 350.0,
+		ci.Random
+	);
+	//
+	switch (ci.AscanRectify)
+	{
+		default:
+			break;
+		case 1:
+			for (int i = 0; i < ci.CopyRange; i++)
+			{
+				auto amp = ci.CopyBuf[i];
+				if (amp > 0)
+				{
+					amp = 0;
+				}
+				else
+				{
+					amp = 127 - clip(std::abs(amp), 0, 127);
+				}
+				ci.CopyBuf[i] = static_cast<uint8_t>(amp);
+			}
+			break;
+
+		case 2:
+			for (int i = 0; i < ci.CopyRange; i++)
+			{
+				int amp = ci.CopyBuf[i];
+				if (amp < 0)
+				{
+					amp = 0;
+				}
+				else
+				{
+					amp = 127 - clip(abs(amp), 0, 127);
+				}
+				ci.CopyBuf[i] = static_cast<uint8_t>(amp);
+			}
+			break;
+
+		case 3:
+			for (int i = 0; i < ci.CopyRange; i++)
+			{
+				auto amp = ci.CopyBuf[i];
+				amp = 127 - clip(abs(amp), 0, 127);
+				ci.CopyBuf[i] = static_cast<uint8_t>(amp);
+			}
+			break;
+	}
+	// Iterate through the gates.
+	for (unsigned gate = 0; gate < ci.GateCount; gate++)
+	{
+		TGateInfo& gi(ci.GateInfo[gate]);
+		//
+		double delay = gi.Delay;
+		// Calculate the delay for the slave mode.
+		if (gi.SlavedTo >= 0)
+		{
+			delay += ci.GateInfo[gi.SlavedTo].PeakTof - TOF_OFFSET;
+		}
+		else if (gi.SlavedTo == -2)
+		{
+			delay += ci.GateInfo[0].Delay;
+		}
+		//
+		FillDataBuffer
+			(
+				gi.CopyBuf,
+				gi.Range,
+				1,
+				8,
+				pow(10, ci.Gain / 20.0),
+				ci.Sweep[0] - delay + ci.IfPos + 100.0,
+				ci.Sweep[1] - delay + ci.IfPos + 250.0,
+				ci.Sweep[2] - delay + ci.IfPos + 350.0,
+				ci.Random
+			);
+		//
+		if (gi.MethodId == MID_PEAK)
+		{
+			gi.PeakFound = PeakNormal(gi.Polarity, gi.Threshold, gi.Range, (uint8_t*) gi.CopyBuf.data(), gi.PeakTof,gi.PeakAmp);
+			//SF_RTTI_NOTIFY(DO_CLOG, "Gate: " << gate << " Tof: " << gi.PeakTof << " Amp: " << gi.PeakAmp)
+			// Correct found peak with delay and result offset.
+			gi.PeakTof += gi.Delay + TOF_OFFSET;
+		}
+	}
+}
+
+void AcquisitionEmulator::DeliverShot(unsigned channel)
+{
+	auto& ci(FChannelInfo[channel]);
+	// Generate a result at each n-th sync.
+	if (ci.SyncCounter && ci.SyncCounter % ci.PopDivider == 0)
+	{
+		ci.PopIndex = ci.SyncCounter;
+		DeliverResult(MAKE_ID(channel, NO_GATE, RID_POPINDEX));
+		DeliveredBytes += sizeof(uint32_t);
+	}
+	// Set the data for retrieval.
+	ci.CopySyncIndex = ci.SyncCounter;
+	// Signal the owner that data is available.
+	DeliverResult(MAKE_ID(channel, NO_GATE, RID_COPYINDEX));
+	// Signal the owner that data is available.
+	DeliverResult(MAKE_ID(channel, NO_GATE, RID_COPYDATA));
+	DeliveredBytes += sizeof(uint32_t) + ci.CopyRange;
+	// Iterate through the gates.
+	for (unsigned gate = 0; gate < ci.GateCount; gate++)
+	{
+		TGateInfo& gi(ci.GateInfo[gate]);
+		switch (gi.MethodId)
+		{
+			case MID_PEAK:
+				DeliverResult(MAKE_ID(channel, gate, RID_PEAK_AMP));
+				DeliverResult(MAKE_ID(channel, gate, RID_PEAK_TOF));
+				DeliveredBytes += sizeof(uint8_t) + sizeof(uint32_t);
+				// Update the gate amplitude value.
+				if (gate)
+				{
+					callParamHook(MAKE_ID(channel, gate, PID_GATE_AMP));
+					callParamHook(MAKE_ID(channel, gate, PID_GATE_TOF));
+				}
+				break;
+
+			case MID_COPY:
+				DeliverResult(MAKE_ID(channel, gate, RID_COPY));
+				DeliveredBytes += gi.Range;
+				break;
+		}
+	}
+	DeliveredSyncs++;
+	// Increment the sync counter.
+	ci.SyncCounter++;
+}
+
+void AcquisitionEmulator::updateThroughput(bool force)
+{
+	auto now = TimeSpec(getTime()).toDouble();
+	auto elapsed = now - ThroughputTime;
+	if (!force && elapsed < 1.0)
+	{
+		return;
+	}
+	SyncRate = elapsed > 0 ? double(DeliveredSyncs) / elapsed : 0.0;
+	DataRate = elapsed > 0 ? double(DeliveredBytes) / elapsed / 1e6 : 0.0;
+	DeliveredSyncs = 0;
+	DeliveredBytes = 0;
+	ThroughputTime = now;
+	// Only report when measuring to prevent needless parameter events.
+	if (Throughput || force)
+	{
+		if (!force)
+		{
+			SF_RTTI_NOTIFY(DO_CLOG, "Throughput: " << ChannelCount << " channels, " << ThreadCount << " threads, "
+				<< std::lround(SyncRate) << " syncs/s, " << DataRate << " MB/s")
+		}
+		callParamHook(MAKE_ID(NO_CHANNEL, NO_GATE, PID_SYNC_RATE));
+		callParamHook(MAKE_ID(NO_CHANNEL, NO_GATE, PID_DATA_RATE));
+	}
+}
+
+void AcquisitionEmulator::processSoftware(unsigned channel, uint32_t syncCount)
+{
+	auto& ci(FChannelInfo[channel]);
+	AscanPipeline::Setup setup;
+	setup.offset = 127;
+	setup.sampleInterval = ci.TimeUnits;
+	// Same sweep reference as the hardware generation.
+	setup.delay = -ci.TcgDelay * ci.TimeUnits;
+	if (ci.TcgEnable)
+	{
+		setup.stages.push_back({AscanPipeline::stTcg});
+		// Only the points having an increasing time are in use.
+		for (int i = 0; i < EMU_MAX_TCG_POINTS; i++)
+		{
+			if (!i || Tcg[i].Time > setup.tcg.back().time)
+			{
+				setup.tcg.push_back({Tcg[i].Time, Tcg[i].Gain});
+			}
+		}
+	}
+	if (ci.AscanRectify)
+	{
+		setup.stages.push_back({AscanPipeline::stRectify, ci.AscanRectify});
+	}
+	// The A-scan must hold the copy range and all gates.
+	long length = ci.CopyDelay + ci.CopyRange;
+	for (unsigned gate = 0; gate < ci.GateCount; gate++)
+	{
+		auto& gi(ci.GateInfo[gate]);
+		AscanPipeline::Gate g{static_cast<size_t>(std::max(gi.Delay, 0L)), static_cast<size_t>(gi.Range)};
+		g.threshold = static_cast<float>(gi.ThresholdValue);
+		g.polarity = gi.Polarity;
+		long end = gi.Delay + gi.Range;
+		if (gi.SlavedTo >= 0 && gi.SlavedTo < static_cast<long>(gate))
+		{
+			g.slavedTo = static_cast<int>(gi.SlavedTo);
+			// The peak of the master can be at the end of its gate.
+			end += ci.GateInfo[gi.SlavedTo].Delay + ci.GateInfo[gi.SlavedTo].Range;
+		}
+		else if (gi.SlavedTo == -2)
+		{
+			g.start += ci.GateInfo[0].Delay;
+			end += ci.GateInfo[0].Delay;
+		}
+		length = std::max(length, end);
+		setup.gates.push_back(g);
+	}
+	// Preparing a setup rebuilds its tables and TCG curve so it is only done after a parameter change.
+	if (ci.SetupChanged)
+	{
+		ci.Pipeline->setSetup(setup);
+		ci.SetupChanged = false;
+	}
+	// Delivers a processed shot.
+	auto deliver = [&](AscanPipeline::Output& out)
+	{
+		// Generate a result at each n-th sync.
+		if (out.counter && out.counter % ci.PopDivider == 0)
+		{
+			ci.PopIndex = out.counter;
+			DeliverResult(MAKE_ID(channel, NO_GATE, RID_POPINDEX));
+			DeliveredBytes += sizeof(uint32_t);
+		}
+		ci.CopySyncIndex = out.counter;
+		DeliverResult(MAKE_ID(channel, NO_GATE, RID_COPYINDEX));
+		// Copies a window of the processed samples into the buffer.
+		auto copy = [&out](DynamicBuffer& buf, long start, long count)
+		{
+			buf.resize(count);
+			memset(buf.data(), 127, count);
+			if (start >= 0 && start < static_cast<long>(out.samples.size()))
+			{
+				AscanPipeline::toWords(out.samples.data() + start, std::min<size_t>(count, out.samples.size() - start), buf.data(), 1, 8, 127);
+			}
+		};
+		copy(ci.CopyBuf, ci.CopyDelay, ci.CopyRange);
+		DeliverResult(MAKE_ID(channel, NO_GATE, RID_COPYDATA));
+		DeliveredBytes += sizeof(uint32_t) + ci.CopyRange;
+		for (unsigned gate = 0; gate < ci.GateCount && gate < out.gates.size(); gate++)
+		{
+			auto& gi(ci.GateInfo[gate]);
+			auto& gr(out.gates[gate]);
+			auto& g(setup.gates[gate]);
+			// Start of the gate in the A-scan.
+			long start = static_cast<long>(g.start);
+			if (g.slavedTo >= 0 && out.gates[g.slavedTo].found)
+			{
+				start += static_cast<long>(out.gates[g.slavedTo].index);
+			}
+			switch (gi.MethodId)
+			{
+				case MID_PEAK:
+					gi.PeakFound = gr.found;
+					gi.PeakAmp = gr.found ? clip<long>(std::lround(gr.amplitude) + 127, 0, 255) : 127;
+					gi.PeakTof = (gr.found ? gr.index : start) + TOF_OFFSET;
+					DeliverResult(MAKE_ID(channel, gate, RID_PEAK_AMP));
+					DeliverResult(MAKE_ID(channel, gate, RID_PEAK_TOF));
+					DeliveredBytes += sizeof(uint8_t) + sizeof(uint32_t);
+					if (gate)
+					{
+						callParamHook(MAKE_ID(channel, gate, PID_GATE_AMP));
+						callParamHook(MAKE_ID(channel, gate, PID_GATE_TOF));
+					}
+					break;
+
+				case MID_COPY:
+					copy(gi.CopyBuf, start, gi.Range);
+					DeliverResult(MAKE_ID(channel, gate, RID_COPY));
+					DeliveredBytes += gi.Range;
+					break;
+			}
+		}
+		DeliveredSyncs++;
+	};
+	// Processed shots are delivered later so they are stamped when stored.
+	ci.ShotTime = 0;
+	// Generate the raw shots needed so far.
+	while (ci.SyncCounter <= syncCount)
+	{
+		ci.RandomizeSweep();
+		FillDataBuffer(
+			ci.RawBuf,
+			length,
+			1,
+			8,
+			pow(10, ci.Gain / 20.0),
+			ci.Sweep[0] + ci.IfPos + 100.0,
+			ci.Sweep[1] + ci.IfPos + 250.0,
+			ci.Sweep[2] + ci.IfPos + 350.0,
+			ci.Random
+		);
+		// Processed directly in deterministic mode since pushing drops shots when too many are pending.
+		if (Seed)
+		{
+			AscanPipeline::Output out;
+			out.counter = ci.SyncCounter;
+			ci.Pipeline->process(ci.RawBuf.data(), length, out);
+			deliver(out);
+		}
+		else
+		{
+			ci.Pipeline->push(ci.SyncCounter, ci.RawBuf.data(), length);
+		}
+		ci.SyncCounter++;
+	}
+	// Deliver the shots processed so far in order.
+	ci.Pipeline->collect(AscanPipeline::Handler(deliver));
+}
+
 double FormWave
 	(
 		double x,     // x-position
@@ -1871,7 +2594,8 @@ void FillDataBuffer
 		double gain,
 		int delay1,
 		int delay2,
-		int delay3
+		int delay3,
+		std::minstd_rand& random
 	)
 {
 	uint32_t amplitude = (1 << bits) - 1;
@@ -1882,6 +2606,11 @@ void FillDataBuffer
 	double freq = 4;
 	// Give the gain an of set of -40 dB.
 	gain /= 100.0;
+	// Generator per channel so channels can be filled from different threads.
+	// Scaled onto [0, 1) directly so the noise is the same with every standard library.
+	auto noise = [&random]() {
+		return double(random() - random.min()) / (double(random.max() - random.min()) + 1.0);
+	};
 	//
 	for (int i = 0; i < (int) width; i++)
 	{
@@ -1889,7 +2618,7 @@ void FillDataBuffer
 		value -= FormWave(i - delay2, delta, slope - 0.3, freq);
 		value -= FormWave(i - delay3, delta, slope - 0.6, freq);
 		// Add some noise dependent on the gain starting with 2%.
-		value += 0.02 * double(rand()) / double(RAND_MAX);//  (gain*gain/10.0)
+		value += 0.02 * noise();//  (gain*gain/10.0)
 		value *= gain;
 		// Clip after multiplying.
 		uint32_t amp = calculateOffset(clip(value, -1.0, 1.0), -1.0, 1.0, amplitude, true);
@@ -1,10 +1,16 @@
 #pragma once
 
-
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
 #include <misc/gen/Sustain.h>
 #include <misc/gen/TDynamicBuffer.h>
 #include <misc/gen/ElapseTimer.h>
+#include <misc/gen/Md5Hash.h>
 #include <rsa/iface/RsaInterface.h>
+#include <rsa/iface/AscanPipeline.h>
 
 namespace sf
 {
@@ -33,7 +39,13 @@ class AcquisitionEmulator : public RsaInterface
 		// Overridden from base class.
 		bool enumParamIds(IdList& ids) override;
 		// Overridden from base class.
+		bool getAffectedParamIds(IdType id, IdList& ids) override;
+		// Overridden from base class.
 		bool enumResultIds(IdList& ids) override;
+		// Gets the MD5 checksum in hex of each delivered result in deterministic mode.
+		[[nodiscard]] std::map<IdType, std::string> getChecksums() const;
+		// Gets a single MD5 checksum in hex over the checksums of all results.
+		[[nodiscard]] std::string getChecksum() const;
 
 		/**
 		 * Polarity enumeration.
@@ -53,6 +65,12 @@ class AcquisitionEmulator : public RsaInterface
 		bool doInitialize(bool init) override;
 		// Sustain function.
 		bool sustain(const timespec& t);
+		// Generates raw shots up to the sync count and delivers the ones processed by the pipeline.
+		void processSoftware(unsigned channel, uint32_t syncCount);
+		// Generates and delivers the shots of the channels up to their sync count.
+		void processHardware(const std::vector<std::pair<unsigned, uint32_t>>& pending);
+		// Updates the throughput rates once a second.
+		void updateThroughput(bool force);
 		// Hook for the sustain interface.
 		TSustain<AcquisitionEmulator> SustainEntry;
 		// Holds the run mode flag.
@@ -65,6 +83,38 @@ class AcquisitionEmulator : public RsaInterface
 		double AmplitudeUnit{0.01};
 		// Holds the amount of channels supported by this interface.
 		unsigned ChannelCount{0};
+		// Holds the amount of threads generating the channel data.
+		unsigned ThreadCount{1};
+		// When set shots are generated as fast as possible instead of at the repetition rate.
+		bool Throughput{false};
+		// Holds the amount of shots delivered since the last throughput update.
+		uint64_t DeliveredSyncs{0};
+		// Holds the amount of bytes delivered since the last throughput update.
+		uint64_t DeliveredBytes{0};
+		// Holds the time of the last throughput update.
+		double ThroughputTime{0.0};
+		// Holds the last measured shots per second.
+		double SyncRate{0.0};
+		// Holds the last measured data rate in MB/s.
+		double DataRate{0.0};
+		// Seed of the deterministic mode which is disabled when zero.
+		uint64_t Seed{0};
+		// Sync count at which generating stops when non-zero.
+		uint32_t SyncLimit{0};
+		// Run time in seconds advanced by each sustain call in deterministic mode.
+		double VirtualTime{0.0};
+		// Checksums of the results delivered in deterministic mode.
+		std::map<IdType, Md5Hash> Checksums;
+		// Set when the checksums were reported after reaching the sync limit.
+		bool ChecksumsReported{false};
+		// Gets the time since the start of the run mode in seconds which is virtual in deterministic mode.
+		[[nodiscard]] double GetRunTime() const;
+		// Calls the result hook and updates the checksum of the result.
+		void DeliverResult(IdType id);
+		// Reseeds the channels and clears the checksums for a new deterministic run.
+		void ResetDeterministic();
+		// Reports the checksums once all channels reached the sync limit.
+		void ReportChecksums();
 		//
 		struct TGateInfo
 		{
@@ -100,8 +150,7 @@ class AcquisitionEmulator : public RsaInterface
 		//
 		struct TChannelInfo
 		{
-			TChannelInfo() :GateInfo(new TGateInfo[8]){}
-			~TChannelInfo() {delete[] GateInfo;}
+			~TChannelInfo() {delete Pipeline;}
 
 			// Holds the time offset when the RepRate was changed on the fly.
 			double SyncTimeOffset{0.0};
@@ -120,8 +169,8 @@ class AcquisitionEmulator : public RsaInterface
 			// Divider used to generate the position orientation pulse result.
 			long PopDivider{100};
 			int PopManual{0};
-			//
-			TGateInfo* GateInfo;
+			// Grows when the gate count is increased.
+			std::deque<TGateInfo> GateInfo;
 			// Current sync counter value.
 			uint32_t SyncCounter{0};
 			// Buffer used for copy info transport.
@@ -130,6 +179,8 @@ class AcquisitionEmulator : public RsaInterface
 			uint32_t CopySyncIndex{0};
 			// Position orientation pulse sync counter value.
 			uint32_t PopIndex{0};
+			// Steady clock nanoseconds at which the current shot was generated or zero when unknown.
+			int64_t ShotTime{0};
 			//
 			bool CopyEnabled{false};
 			// TCG gate info.
@@ -143,9 +194,30 @@ class AcquisitionEmulator : public RsaInterface
 			int AscanRectify{0};
 			// Offset for the indications.
 			double Sweep[3]{0, 0, 0};
+			// Software processing pipeline which is null when processing is done by the emulated hardware.
+			AscanPipeline* Pipeline{nullptr};
+			// Set when a parameter changed which the pipeline setup is derived from.
+			bool SetupChanged{true};
+			// Buffer holding the raw shot for the pipeline.
+			DynamicBuffer RawBuf;
+			// Generator for the noise and echo positions of this channel.
+			std::minstd_rand Random;
+			// Randomizes the echo positions for the next shot.
+			void RandomizeSweep();
 		};
-		//
-		TChannelInfo* FChannelInfo{nullptr};
+		// Grows when the channel count is increased.
+		std::deque<TChannelInfo> FChannelInfo;
+		// Makes sure the info of the channels exists initializing the new ones.
+		void ReserveChannels(unsigned count);
+		// Makes sure the info of the gates exists initializing the new ones.
+		static void ReserveGates(TChannelInfo& ci, unsigned count);
+		// Generates the data of a single shot of a channel.
+		void GenerateShot(TChannelInfo& ci);
+		// Delivers the results of the shot generated for the channel.
+		void DeliverShot(unsigned channel);
+		// Pool of threads generating the shots of the channels in parallel.
+		struct TWorkers;
+		std::unique_ptr<TWorkers> Workers;
 		//
 		int ErrorValue{0};
 		// Holds status of single shot generation
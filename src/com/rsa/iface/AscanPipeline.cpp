@@ -0,0 +1,653 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <misc/gen/dbgutils.h>
+#include "AscanPipeline.h"
+
+namespace sf
+{
+
+struct AscanPipeline::Prepared
+{
+	/**
+	 * @brief Configuration it was prepared from.
+	 */
+	Setup setup;
+	/**
+	 * @brief Index of the first average stage or the amount of stages.
+	 */
+	size_t parallelStages{0};
+	/**
+	 * @brief Incremented each time the stages change to restart the averaging.
+	 */
+	size_t generation{0};
+	/**
+	 * @brief Taps per stage for the FIR and envelope stages.
+	 */
+	std::vector<std::vector<float>> taps;
+	/**
+	 * @brief Guards the TCG curve.
+	 */
+	mutable std::mutex mutex;
+	/**
+	 * @brief Linear gain per sample for the last amount of samples processed.
+	 */
+	mutable std::shared_ptr<const std::vector<float>> tcgCurve;
+
+	/**
+	 * @brief Gets the TCG curve for the amount of samples.
+	 */
+	[[nodiscard]] std::shared_ptr<const std::vector<float>> getTcgCurve(size_t samples) const;
+};
+
+namespace
+{
+
+constexpr double pi = 3.14159265358979323846;
+
+/**
+ * @brief Converts raw samples to floats removing the offset.
+ */
+template<typename T>
+void convert(const T* __restrict src, float* __restrict dst, size_t count, float offset)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		dst[i] = static_cast<float>(src[i]) - offset;
+	}
+}
+
+void rectify(float* __restrict x, size_t count, int mode)
+{
+	switch (mode)
+	{
+		case AscanPipeline::rtPositive:
+			for (size_t i = 0; i < count; i++)
+			{
+				x[i] = x[i] > 0.0f ? x[i] : 0.0f;
+			}
+			break;
+
+		case AscanPipeline::rtNegative:
+			for (size_t i = 0; i < count; i++)
+			{
+				x[i] = x[i] < 0.0f ? -x[i] : 0.0f;
+			}
+			break;
+
+		case AscanPipeline::rtFull:
+			for (size_t i = 0; i < count; i++)
+			{
+				x[i] = std::fabs(x[i]);
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**
+ * @brief Filters with the taps centered on each sample and zeros outside the signal.
+ *
+ * Accumulates one tap over all samples at the time which vectorizes.
+ */
+void fir(const float* __restrict x, float* __restrict y, size_t count, const std::vector<float>& taps, std::vector<float>& padded)
+{
+	auto half = taps.size() / 2;
+	padded.assign(count + taps.size(), 0.0f);
+	std::memcpy(padded.data() + half, x, count * sizeof(float));
+	std::fill(y, y + count, 0.0f);
+	for (size_t k = 0; k < taps.size(); k++)
+	{
+		auto c = taps[k];
+		const float* __restrict xs = padded.data() + k;
+		for (size_t i = 0; i < count; i++)
+		{
+			y[i] += c * xs[i];
+		}
+	}
+}
+
+/**
+ * @brief Cascaded biquads in transposed direct form II which is inherently sequential.
+ */
+void iir(float* x, size_t count, const std::vector<float>& coefficients)
+{
+	for (size_t s = 0; s + 5 <= coefficients.size(); s += 5)
+	{
+		auto b0 = coefficients[s], b1 = coefficients[s + 1], b2 = coefficients[s + 2];
+		auto a1 = coefficients[s + 3], a2 = coefficients[s + 4];
+		float z1 = 0, z2 = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			auto in = x[i];
+			auto out = b0 * in + z1;
+			z1 = b1 * in - a1 * out + z2;
+			z2 = b2 * in - a2 * out;
+			x[i] = out;
+		}
+	}
+}
+
+void multiply(float* __restrict x, const float* __restrict gain, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] *= gain[i];
+	}
+}
+
+/**
+ * @brief Combines the signal with its Hilbert transform into the envelope.
+ */
+void envelope(float* __restrict x, const float* __restrict h, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		x[i] = std::sqrt(x[i] * x[i] + h[i] * h[i]);
+	}
+}
+
+/**
+ * @brief Creates a Hamming windowed Hilbert transformer having an odd amount of taps.
+ */
+std::vector<float> hilbertTaps(int count)
+{
+	count = std::max(count, 3) | 1;
+	std::vector<float> rv(count, 0.0f);
+	int mid = count / 2;
+	for (int i = 0; i < count; i++)
+	{
+		int n = i - mid;
+		if (n & 1)
+		{
+			auto window = 0.54 - 0.46 * std::cos(2.0 * pi * i / (count - 1));
+			rv[i] = static_cast<float>(2.0 / (pi * n) * window);
+		}
+	}
+	// Reversed since the filter correlates instead of convolves.
+	std::reverse(rv.begin(), rv.end());
+	return rv;
+}
+
+/**
+ * @brief Finds the peak in the same way the emulated hardware does.
+ *
+ * The index is the middle of the samples having the peak value.
+ */
+AscanPipeline::GateResult findPeak(const float* x, size_t start, size_t count, float threshold, int polarity)
+{
+	AscanPipeline::GateResult rv;
+	if (!count)
+	{
+		return rv;
+	}
+	const float sign = polarity < 0 ? -1.0f : 1.0f;
+	float peak = -std::numeric_limits<float>::max();
+	// Maximum reduction over the polarity corrected values.
+	for (size_t i = start; i < start + count; i++)
+	{
+		auto v = polarity ? x[i] * sign : std::fabs(x[i]);
+		peak = v > peak ? v : peak;
+	}
+	if (peak < threshold)
+	{
+		return rv;
+	}
+	size_t last = start, same = 0;
+	for (size_t i = start; i < start + count; i++)
+	{
+		auto v = polarity ? x[i] * sign : std::fabs(x[i]);
+		if (v == peak)
+		{
+			last = i;
+			same++;
+		}
+	}
+	rv.found = true;
+	rv.index = last - same / 2;
+	rv.amplitude = x[rv.index];
+	return rv;
+}
+
+}// namespace
+
+std::shared_ptr<const std::vector<float>> AscanPipeline::Prepared::getTcgCurve(size_t samples) const
+{
+	std::lock_guard lock(mutex);
+	if (tcgCurve && tcgCurve->size() == samples)
+	{
+		return tcgCurve;
+	}
+	auto curve = std::make_shared<std::vector<float>>(samples, 1.0f);
+	auto& points(setup.tcg);
+	if (!points.empty())
+	{
+		size_t p = 0;
+		for (size_t i = 0; i < samples; i++)
+		{
+			auto t = setup.delay + static_cast<double>(i) * setup.sampleInterval;
+			// Find the points surrounding the time.
+			while (p + 1 < points.size() && points[p + 1].time <= t)
+			{
+				p++;
+			}
+			double db;
+			if (t <= points[0].time)
+			{
+				db = points[0].gain;
+			}
+			else if (p + 1 >= points.size())
+			{
+				db = points.back().gain;
+			}
+			else
+			{
+				auto& a(points[p]);
+				auto& b(points[p + 1]);
+				db = a.gain + (b.gain - a.gain) * (t - a.time) / (b.time - a.time);
+			}
+			(*curve)[i] = static_cast<float>(std::pow(10.0, db / 20.0));
+		}
+	}
+	tcgCurve = curve;
+	return tcgCurve;
+}
+
+AscanPipeline::AscanPipeline()
+{
+	setSetup({});
+}
+
+AscanPipeline::~AscanPipeline()
+{
+	stop();
+}
+
+void AscanPipeline::setSetup(const Setup& setup)
+{
+	auto prepared = std::make_shared<Prepared>();
+	prepared->setup = setup;
+	// Points must be in time order for the interpolation.
+	std::stable_sort(prepared->setup.tcg.begin(), prepared->setup.tcg.end(), [](const TcgPoint& a, const TcgPoint& b)
+	{
+		return a.time < b.time;
+	});
+	auto& stages(prepared->setup.stages);
+	prepared->parallelStages = stages.size();
+	prepared->taps.resize(stages.size());
+	for (size_t i = 0; i < stages.size(); i++)
+	{
+		if (stages[i].type == stAverage && prepared->parallelStages == stages.size())
+		{
+			prepared->parallelStages = i;
+		}
+		else if (stages[i].type == stFir)
+		{
+			// Reversed since the filter correlates instead of convolves.
+			prepared->taps[i].assign(stages[i].coefficients.rbegin(), stages[i].coefficients.rend());
+		}
+		else if (stages[i].type == stEnvelope)
+		{
+			prepared->taps[i] = hilbertTaps(stages[i].mode);
+		}
+	}
+	std::lock_guard lock(_mutex);
+	prepared->generation = _prepared ? _prepared->generation : 0;
+	// Restart averaging when the stages change.
+	if (_prepared)
+	{
+		auto& prev(_prepared->setup.stages);
+		if (prev.size() != stages.size() || !std::equal(prev.begin(), prev.end(), stages.begin(), [](const Stage& a, const Stage& b)
+		{
+			return a.type == b.type && a.mode == b.mode && a.coefficients == b.coefficients;
+		}))
+		{
+			prepared->generation++;
+		}
+	}
+	_prepared = prepared;
+}
+
+AscanPipeline::Setup AscanPipeline::getSetup() const
+{
+	std::lock_guard lock(_mutex);
+	return _prepared->setup;
+}
+
+void AscanPipeline::start(unsigned threads)
+{
+	stop();
+	std::lock_guard lock(_mutex);
+	for (unsigned i = 0; i < threads; i++)
+	{
+		_threads.emplace_back(&AscanPipeline::run, this);
+	}
+}
+
+void AscanPipeline::stop()
+{
+	{
+		std::lock_guard lock(_mutex);
+		_terminate = true;
+		_condition.notify_all();
+	}
+	for (auto& thread: _threads)
+	{
+		thread.join();
+	}
+	std::lock_guard lock(_mutex);
+	_threads.clear();
+	_terminate = false;
+}
+
+void AscanPipeline::setMaxPending(size_t count)
+{
+	std::lock_guard lock(_mutex);
+	_maxPending = std::max<size_t>(count, 1);
+}
+
+bool AscanPipeline::push(uint32_t counter, const void* raw, size_t samples)
+{
+	auto job = std::make_shared<Job>();
+	{
+		std::lock_guard lock(_mutex);
+		if (_jobs.size() >= _maxPending)
+		{
+			_metrics.dropped++;
+			return false;
+		}
+		job->prepared = _prepared;
+	}
+	// Copy the raw data outside the lock.
+	auto p = static_cast<const uint8_t*>(raw);
+	job->raw.assign(p, p + samples * job->prepared->setup.wordSize);
+	job->samples = samples;
+	job->output.counter = counter;
+	std::lock_guard lock(_mutex);
+	_jobs.push_back(job);
+	_condition.notify_one();
+	return true;
+}
+
+void AscanPipeline::run()
+{
+	std::unique_lock lock(_mutex);
+	for (;;)
+	{
+		_condition.wait(lock, [&] {return _terminate || _taken < _jobs.size();});
+		if (_terminate)
+		{
+			break;
+		}
+		auto job = _jobs[_taken++];
+		lock.unlock();
+		auto t0 = std::chrono::steady_clock::now();
+		processParallel(*job->prepared, job->raw.data(), job->samples, job->output);
+		job->time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		lock.lock();
+		job->done = true;
+	}
+}
+
+size_t AscanPipeline::collect(const Handler& handler)
+{
+	size_t rv = 0;
+	for (;;)
+	{
+		std::shared_ptr<Job> job;
+		{
+			std::lock_guard lock(_mutex);
+			if (_jobs.empty())
+			{
+				break;
+			}
+			// Stop at a job still being processed by a worker.
+			if (!_jobs.front()->done && _taken)
+			{
+				break;
+			}
+			job = _jobs.front();
+			_jobs.pop_front();
+			if (_taken)
+			{
+				_taken--;
+			}
+		}
+		auto t0 = std::chrono::steady_clock::now();
+		// Process it here when no worker picked it up.
+		if (!job->done)
+		{
+			processParallel(*job->prepared, job->raw.data(), job->samples, job->output);
+		}
+		processOrdered(*job->prepared, job->output);
+		job->time += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		{
+			std::lock_guard lock(_mutex);
+			_metrics.processed++;
+			_metrics.time += job->time;
+		}
+		if (handler)
+		{
+			handler(job->output);
+		}
+		rv++;
+	}
+	return rv;
+}
+
+void AscanPipeline::process(const void* raw, size_t samples, Output& output)
+{
+	std::shared_ptr<const Prepared> prepared;
+	{
+		std::lock_guard lock(_mutex);
+		prepared = _prepared;
+	}
+	processParallel(*prepared, raw, samples, output);
+	processOrdered(*prepared, output);
+}
+
+AscanPipeline::Metrics AscanPipeline::getMetrics() const
+{
+	std::lock_guard lock(_mutex);
+	return _metrics;
+}
+
+void AscanPipeline::processParallel(const Prepared& prepared, const void* raw, size_t samples, Output& output)
+{
+	auto& setup(prepared.setup);
+	auto& x(output.samples);
+	x.resize(samples);
+	auto offset = static_cast<float>(setup.offset);
+	switch (setup.wordSize)
+	{
+		case 1:
+			setup.isSigned
+				? convert(static_cast<const int8_t*>(raw), x.data(), samples, offset)
+				: convert(static_cast<const uint8_t*>(raw), x.data(), samples, offset);
+			break;
+
+		case 2:
+			setup.isSigned
+				? convert(static_cast<const int16_t*>(raw), x.data(), samples, offset)
+				: convert(static_cast<const uint16_t*>(raw), x.data(), samples, offset);
+			break;
+
+		case 4:
+			setup.isSigned
+				? convert(static_cast<const int32_t*>(raw), x.data(), samples, offset)
+				: convert(static_cast<const uint32_t*>(raw), x.data(), samples, offset);
+			break;
+
+		default:
+			SF_NORM_NOTIFY(DO_DEFAULT, "Unsupported word size " << setup.wordSize << "!")
+			std::fill(x.begin(), x.end(), 0.0f);
+			return;
+	}
+	for (size_t s = 0; s < prepared.parallelStages; s++)
+	{
+		applyStage(prepared, s, x);
+	}
+}
+
+void AscanPipeline::applyStage(const Prepared& prepared, size_t index, std::vector<float>& x)
+{
+	// Scratch buffers reused by the thread.
+	thread_local std::vector<float> tmp, padded;
+	auto& stage(prepared.setup.stages[index]);
+	auto samples = x.size();
+	switch (stage.type)
+	{
+		case stRectify:
+			rectify(x.data(), samples, stage.mode);
+			break;
+
+		case stFir:
+			if (!prepared.taps[index].empty())
+			{
+				tmp.resize(samples);
+				fir(x.data(), tmp.data(), samples, prepared.taps[index], padded);
+				x.swap(tmp);
+			}
+			break;
+
+		case stIir:
+			iir(x.data(), samples, stage.coefficients);
+			break;
+
+		case stTcg:
+			multiply(x.data(), prepared.getTcgCurve(samples)->data(), samples);
+			break;
+
+		case stEnvelope:
+			tmp.resize(samples);
+			fir(x.data(), tmp.data(), samples, prepared.taps[index], padded);
+			envelope(x.data(), tmp.data(), samples);
+			break;
+
+		case stAverage:
+			// Handled in order by processOrdered().
+			break;
+	}
+}
+
+void AscanPipeline::processOrdered(const Prepared& prepared, Output& output)
+{
+	auto& setup(prepared.setup);
+	auto& x(output.samples);
+	auto samples = x.size();
+	for (size_t s = prepared.parallelStages; s < setup.stages.size(); s++)
+	{
+		auto& stage(setup.stages[s]);
+		switch (stage.type)
+		{
+			case stAverage:
+			{
+				// Only the first average stage has state and is applied.
+				if (s != prepared.parallelStages)
+				{
+					break;
+				}
+				if (_averageGeneration != prepared.generation || _averageSum.size() != samples)
+				{
+					_averageGeneration = prepared.generation;
+					_averageSum.assign(samples, 0.0f);
+					_averageShots.clear();
+				}
+				auto sum = _averageSum.data();
+				for (size_t i = 0; i < samples; i++)
+				{
+					sum[i] += x[i];
+				}
+				_averageShots.push_back(x);
+				while (_averageShots.size() > static_cast<size_t>(std::max(stage.mode, 1)))
+				{
+					auto old = _averageShots.front().data();
+					for (size_t i = 0; i < samples; i++)
+					{
+						sum[i] -= old[i];
+					}
+					_averageShots.pop_front();
+				}
+				auto factor = 1.0f / static_cast<float>(_averageShots.size());
+				for (size_t i = 0; i < samples; i++)
+				{
+					x[i] = sum[i] * factor;
+				}
+				break;
+			}
+
+			default:
+				applyStage(prepared, s, x);
+				break;
+		}
+	}
+	// Extract the gates in order so slaved gates have their master's peak.
+	output.gates.resize(setup.gates.size());
+	for (size_t g = 0; g < setup.gates.size(); g++)
+	{
+		auto& gate(setup.gates[g]);
+		auto start = gate.start;
+		output.gates[g] = {};
+		if (gate.slavedTo >= 0)
+		{
+			if (static_cast<size_t>(gate.slavedTo) >= g || !output.gates[gate.slavedTo].found)
+			{
+				continue;
+			}
+			start += output.gates[gate.slavedTo].index;
+		}
+		if (start >= samples)
+		{
+			continue;
+		}
+		output.gates[g] = findPeak(x.data(), start, std::min(gate.count, samples - start), gate.threshold, gate.polarity);
+	}
+}
+
+void AscanPipeline::toWords(const float* samples, size_t count, void* dst, unsigned word_size, unsigned bits, int offset)
+{
+	// Largest float below 2^32 for 32 bits since the conversion would overflow.
+	auto maximum = bits >= 32 ? 4294967040.0f : static_cast<float>((1ULL << bits) - 1);
+	auto ofs = static_cast<float>(offset) + 0.5f;
+	switch (word_size)
+	{
+		case 1:
+		{
+			auto p = static_cast<uint8_t*>(dst);
+			for (size_t i = 0; i < count; i++)
+			{
+				p[i] = static_cast<uint8_t>(std::clamp(samples[i] + ofs, 0.0f, maximum));
+			}
+			break;
+		}
+
+		case 2:
+		{
+			auto p = static_cast<uint16_t*>(dst);
+			for (size_t i = 0; i < count; i++)
+			{
+				p[i] = static_cast<uint16_t>(std::clamp(samples[i] + ofs, 0.0f, maximum));
+			}
+			break;
+		}
+
+		case 4:
+		{
+			auto p = static_cast<uint32_t*>(dst);
+			for (size_t i = 0; i < count; i++)
+			{
+				p[i] = static_cast<uint32_t>(std::clamp(samples[i] + ofs, 0.0f, maximum));
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+}
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <misc/gen/TClosure.h>
+#include "RsaTypes.h"
+#include "global.h"
+
+namespace sf
+{
+
+/**
+ * @brief Software A-scan signal processing chain for digitisers delivering raw RF samples.
+ *
+ * Each pushed shot has its raw samples converted to floating point after which the configured stages are applied in order.
+ * Finally, the peak amplitude and time-of-flight is extracted for each gate.
+ * The kernels work on contiguous float arrays and are written for the compiler to vectorize them.
+ *
+ * Shots are processed by worker threads and collected in the order they were pushed.
+ * Stages up to the first #stAverage stage run on the worker threads.
+ * Averaging and the stages after it depend on the previous shots and run when collected.
+ *
+ * @code
+ * AscanPipeline::Setup setup;
+ * setup.offset = 127;
+ * setup.stages.push_back({AscanPipeline::stTcg});
+ * setup.stages.push_back({AscanPipeline::stRectify, AscanPipeline::rtFull});
+ * setup.gates.push_back({100, 50, 20.0f});
+ * pipeline.setSetup(setup);
+ * pipeline.start(2);
+ * // From the acquisition thread.
+ * pipeline.push(counter, raw, samples);
+ * // From the thread writing the results.
+ * pipeline.collect(AscanPipeline::Handler([&](AscanPipeline::Output& out) {...}));
+ * @endcode
+ */
+class _RSA_CLASS AscanPipeline :public RsaTypes
+{
+	public:
+		/**
+		 * @brief Types of processing stages.
+		 */
+		enum EStage :int
+		{
+			/** Rectifies using the stage mode of type #ERectify. */
+			stRectify = 0,
+			/** Finite impulse response filter using the stage coefficients as taps and compensating the delay. */
+			stFir,
+			/** Infinite impulse response filter of cascaded biquads having 5 coefficients (b0, b1, b2, a1, a2) each. */
+			stIir,
+			/** Time corrected gain using the setup TCG points. */
+			stTcg,
+			/** Envelope using a Hilbert transformer having the stage mode as amount of taps. */
+			stEnvelope,
+			/** Averages the last amount of shots given by the stage mode. */
+			stAverage,
+		};
+
+		/**
+		 * @brief Rectification modes having the same values as the A-scan rectify parameter.
+		 */
+		enum ERectify :int
+		{
+			/** Leaves the RF signal. */
+			rtNone = 0,
+			/** Half wave keeping the positive part. */
+			rtPositive,
+			/** Half wave keeping the negative part inverted. */
+			rtNegative,
+			/** Full wave. */
+			rtFull,
+		};
+
+		/**
+		 * @brief Processing stage.
+		 */
+		struct Stage
+		{
+			/**
+			 * @brief Type of the stage.
+			 */
+			EStage type{stRectify};
+			/**
+			 * @brief Mode or count depending on the type.
+			 */
+			int mode{0};
+			/**
+			 * @brief Coefficients for the filter stages.
+			 */
+			std::vector<float> coefficients{};
+		};
+
+		/**
+		 * @brief Time corrected gain point.
+		 */
+		struct TcgPoint
+		{
+			/**
+			 * @brief Time in seconds.
+			 */
+			double time{0};
+			/**
+			 * @brief Gain in dB.
+			 */
+			double gain{0};
+		};
+
+		/**
+		 * @brief Gate to extract the peak from.
+		 */
+		struct Gate
+		{
+			/**
+			 * @brief First sample of the gate.
+			 */
+			size_t start{0};
+			/**
+			 * @brief Amount of samples of the gate.
+			 */
+			size_t count{0};
+			/**
+			 * @brief Threshold the peak must reach in processed amplitude units.
+			 */
+			float threshold{0};
+			/**
+			 * @brief Polarity where less than zero looks for a negative, larger for a positive and zero for either peak.
+			 */
+			int polarity{0};
+			/**
+			 * @brief Index of a preceding gate this gate starts relative to its peak or -1 for none.
+			 */
+			int slavedTo{-1};
+		};
+
+		/**
+		 * @brief Configuration of the pipeline.
+		 */
+		struct Setup
+		{
+			/**
+			 * @brief Size of a raw sample in bytes being 1, 2 or 4.
+			 */
+			unsigned wordSize{1};
+			/**
+			 * @brief True when the raw samples are signed.
+			 */
+			bool isSigned{false};
+			/**
+			 * @brief Raw value of the zero level.
+			 */
+			int offset{0};
+			/**
+			 * @brief Time between samples in seconds.
+			 */
+			double sampleInterval{1e-7};
+			/**
+			 * @brief Time of the first sample relative to the TCG points.
+			 */
+			double delay{0};
+			/**
+			 * @brief Stages applied in order.
+			 */
+			std::vector<Stage> stages{};
+			/**
+			 * @brief Points of the time corrected gain interpolated in dB and holding the last gain.
+			 */
+			std::vector<TcgPoint> tcg{};
+			/**
+			 * @brief Gates to extract the peaks from.
+			 */
+			std::vector<Gate> gates{};
+		};
+
+		/**
+		 * @brief Peak found in a gate.
+		 */
+		struct GateResult
+		{
+			/**
+			 * @brief True when the threshold was reached.
+			 */
+			bool found{false};
+			/**
+			 * @brief Processed amplitude of the peak.
+			 */
+			float amplitude{0};
+			/**
+			 * @brief Sample index of the peak relative to the start of the A-scan.
+			 */
+			size_t index{0};
+		};
+
+		/**
+		 * @brief Result of a processed shot.
+		 */
+		struct Output
+		{
+			/**
+			 * @brief Sync counter passed with the shot.
+			 */
+			uint32_t counter{0};
+			/**
+			 * @brief Processed samples.
+			 */
+			std::vector<float> samples;
+			/**
+			 * @brief Peak per setup gate.
+			 */
+			std::vector<GateResult> gates;
+		};
+
+		/**
+		 * @brief Handler type passed to #collect().
+		 */
+		typedef TClosure<void, Output&> Handler;
+
+		/**
+		 * @brief Counters of the pipeline.
+		 */
+		struct Metrics
+		{
+			/**
+			 * @brief Amount of shots collected.
+			 */
+			size_t processed{0};
+			/**
+			 * @brief Amount of shots dropped because too many were pending.
+			 */
+			size_t dropped{0};
+			/**
+			 * @brief Accumulated processing time in seconds.
+			 */
+			double time{0};
+		};
+
+		/**
+		 * @brief Default constructor.
+		 */
+		AscanPipeline();
+
+		/**
+		 * @brief Destructor stopping the threads.
+		 */
+		~AscanPipeline();
+
+		/**
+		 * @brief Sets the configuration for the shots pushed from now on.
+		 *
+		 * Averaging restarts when the amount of samples or the stages change.
+		 */
+		void setSetup(const Setup& setup);
+
+		/**
+		 * @brief Gets the current configuration.
+		 */
+		[[nodiscard]] Setup getSetup() const;
+
+		/**
+		 * @brief Starts worker threads.
+		 *
+		 * Without threads the shots are processed by #collect().
+		 * @param threads Amount of threads.
+		 */
+		void start(unsigned threads);
+
+		/**
+		 * @brief Stops the worker threads leaving the pending shots for #collect().
+		 */
+		void stop();
+
+		/**
+		 * @brief Sets the maximum amount of shots pending before pushing drops them.
+		 */
+		void setMaxPending(size_t count);
+
+		/**
+		 * @brief Pushes a shot of raw samples which are copied.
+		 *
+		 * Can be called from any thread.
+		 * @param counter Sync counter passed to the output.
+		 * @param raw Raw samples of the setup word size.
+		 * @param samples Amount of samples.
+		 * @return False when dropped.
+		 */
+		bool push(uint32_t counter, const void* raw, size_t samples);
+
+		/**
+		 * @brief Calls the handler for each processed shot in the order pushed.
+		 *
+		 * @return Amount of shots passed to the handler.
+		 */
+		size_t collect(const Handler& handler);
+
+		/**
+		 * @brief Processes a shot directly bypassing the threads but not the averaging.
+		 */
+		void process(const void* raw, size_t samples, Output& output);
+
+		/**
+		 * @brief Gets the counters.
+		 */
+		[[nodiscard]] Metrics getMetrics() const;
+
+		/**
+		 * @brief Converts processed samples to raw words with clipping.
+		 *
+		 * @param samples Processed samples.
+		 * @param count Amount of samples.
+		 * @param dst Destination for the words.
+		 * @param word_size Size of a word in bytes being 1, 2 or 4.
+		 * @param bits Significant bits of the unsigned words.
+		 * @param offset Value added to the samples.
+		 */
+		static void toWords(const float* samples, size_t count, void* dst, unsigned word_size, unsigned bits, int offset);
+
+	private:
+		/**
+		 * @brief Setup with the derived tables.
+		 */
+		struct Prepared;
+
+		/**
+		 * @brief Shot passed from push to collect.
+		 */
+		struct Job
+		{
+			std::shared_ptr<const Prepared> prepared;
+			std::vector<uint8_t> raw;
+			size_t samples{0};
+			Output output;
+			bool done{false};
+			double time{0};
+		};
+
+		/**
+		 * @brief Thread function.
+		 */
+		void run();
+
+		/**
+		 * @brief Converts and applies the stages up to the first average stage.
+		 */
+		static void processParallel(const Prepared& prepared, const void* raw, size_t samples, Output& output);
+
+		/**
+		 * @brief Applies a stage other than averaging.
+		 */
+		static void applyStage(const Prepared& prepared, size_t index, std::vector<float>& x);
+
+		/**
+		 * @brief Applies averaging, the stages after it and extracts the gates.
+		 */
+		void processOrdered(const Prepared& prepared, Output& output);
+
+		/**
+		 * @brief Guards the queues and setup.
+		 */
+		mutable std::mutex _mutex;
+		/**
+		 * @brief Wakes the workers.
+		 */
+		std::condition_variable _condition;
+		/**
+		 * @brief Current prepared setup.
+		 */
+		std::shared_ptr<const Prepared> _prepared;
+		/**
+		 * @brief Jobs in the order pushed.
+		 */
+		std::deque<std::shared_ptr<Job>> _jobs;
+		/**
+		 * @brief Amount of jobs at the front already taken by a worker.
+		 */
+		size_t _taken{0};
+		/**
+		 * @brief Maximum amount of jobs pending.
+		 */
+		size_t _maxPending{1024};
+		/**
+		 * @brief Worker threads.
+		 */
+		std::vector<std::thread> _threads;
+		/**
+		 * @brief Flag for the threads to stop.
+		 */
+		bool _terminate{false};
+		/**
+		 * @brief Counters.
+		 */
+		Metrics _metrics;
+		/**
+		 * @brief Sum of the averaged shots.
+		 */
+		std::vector<float> _averageSum;
+		/**
+		 * @brief Shots in the average.
+		 */
+		std::deque<std::vector<float>> _averageShots;
+		/**
+		 * @brief Stages generation the average was built with.
+		 */
+		size_t _averageGeneration{0};
+};
+
+}
@@ -107,6 +107,11 @@ bool RsaInterface::getParamInfo(IdType id, ParamInfo& info) const
 	return const_cast<RsaInterface*>(this)->handleParam(id, &info, nullptr, nullptr);
 }
 
+bool RsaInterface::getAffectedParamIds(IdType, IdList&)
+{
+	return false;
+}
+
 bool RsaInterface::getParam(IdType id, Value& value) const
 {
 	return const_cast<RsaInterface*>(this)->handleParam(id, nullptr, nullptr, &value);
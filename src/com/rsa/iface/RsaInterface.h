@@ -200,6 +200,18 @@ class _RSA_CLASS RsaInterface :public RsaTypes
 		 */
 		virtual bool enumParamIds(IdList& ids) = 0;
 
+		/**
+		 * @brief Gets the ids of the parameters of which the information could have changed by setting
+		 * the passed parameter having the #pfEffectsParameter flag.
+		 *
+		 * Parameters added or removed are found by the enumeration and do not need to be reported.
+		 * The default implementation returns false so all parameters are evaluated.
+		 * @param id Parameter id having the #pfEffectsParameter flag.
+		 * @param ids Receives the affected parameter ids.
+		 * @return True when the list is complete and false when all parameters need evaluation.
+		 */
+		virtual bool getAffectedParamIds(IdType id, IdList& ids);
+
 		/**
 		 * @brief Sets a procedure hook for the interface implementation to be called
 		 * when the value changes as a result of the implementation itself.
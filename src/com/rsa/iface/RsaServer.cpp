@@ -1,3 +1,5 @@
+#include <chrono>
+#include <unordered_set>
 #include "RsaInterface.h"
 #include "RsaServer.h"
 #include "MakeIds.h"
@@ -321,19 +323,14 @@ void RsaServer::createInterface()
 	evaluateInterfaceResults();
 }
 
-std::string RsaServer::createSetupString(const ParamInfo& info, long vid)
+Variable::Definition RsaServer::createDefinition(const ParamInfo& info, long vid)
 {
-	// Separator to separate fields.
-	std::string sep = ",";
-	//  vfId
-	std::string rv = "0x" + itostr(vid, 16);
-	rv += sep;
-	//  vfName
+	Variable::Definition def;
+	def._valid = true;
+	def._id = vid;
 	// Add the path for the parameter.
-	rv += getNameOffset(info) + info.Name + sep;
-	//  vfUnit
-	rv += info.Unit + sep;
-	//  vfFlags
+	def._name = getNameOffset(info) + info.Name;
+	def._unit = info.Unit;
 	flags_type flags = Variable::flgShare;
 	// Set archive flag and/or parameter flag.
 	if (info.Flags & pfArchive)
@@ -353,155 +350,95 @@ std::string RsaServer::createSetupString(const ParamInfo& info, long vid)
 		// When read only remove parameter flag.
 		flags &= ~Variable::flgParameter;
 	}
-	//
-	rv += Variable::getFlagsString(flags) + sep;
-	//  vfDescription,
-	rv += escape(getDescription(info), '"') + sep;
-	//  vfType
-	rv += Variable::getType(info.Default.getType()) + sep;
-	//  vfConversionType,
-	rv += "" + sep;
-	//  vfRound,
-	rv += info.Round.getString() + sep;
-	//  vfDefault,
-	rv += info.Default.getString() + sep;
-	//  vfMinimum,
-	rv += info.Minimum.getString() + sep;
-	//  vfMaximum,
-	rv += info.Maximum.getString() + sep;
-	//  vfFirstState
-	for (unsigned i = 0; i < info.States.count(); i++)
+	def._flags = flags;
+	def._description = getDescription(info);
+	// The type is determined by the default value.
+	def._type = info.Default.getType();
+	def._roundValue = info.Round;
+	def._defaultValue = info.Default;
+	def._minValue = info.Minimum;
+	def._maxValue = info.Maximum;
+	for (auto& state: info.States)
 	{
-		rv += info.States[i].name + "=" + info.States[i].value.getString() + sep;
+		def._states.add(Variable::State(state.name, state.value));
 	}
-	// Return the setup string.
-	return rv;
+	return def;
 }
 
-std::string RsaServer::createSetupString(const ResultInfo& info, long vid)
+ResultData::Definition RsaServer::createDefinition(const ResultInfo& info, long vid)
 {
-	// Separator to separate fields.
-	std::string sep = ",";
-	// rfeID
-	std::string rv = "0x" + itostr(vid, 16);
-	rv += sep;
-	// rfName
+	ResultData::Definition def;
+	def._id = vid;
 	// Add the path for the parameter.
-	rv += getNameOffset(info) + info.Name + sep;
-	// rfFlags
-	flags_type flags = ResultData::flgShare;
+	def._name = getNameOffset(info) + info.Name;
+	def._flags = ResultData::flgShare;
 	// When not generating data the result is put in recycle mode.
 	if (info.Flags & rfStored)
 	{
-		flags |= ResultData::flgArchive;
+		def._flags |= ResultData::flgArchive;
 	}
 	else
 	{
-		flags |= ResultData::flgRecycle;
+		def._flags |= ResultData::flgRecycle;
+	}
+	if (info.Flags & rfTimestamp)
+	{
+		def._flags |= ResultData::flgTimestamp;
 	}
-	rv += ResultData::getFlagsString(flags) + sep;
-	// rfDescription
-	rv += escape(getDescription(info), '"') + sep;
-	// rfeTYPE
-	ResultData::EType type = ResultData::rtInvalid;
+	def._description = getDescription(info);
 	switch (info.WordSize)
 	{
 		case 1:
-			type = ResultData::rtInt8;
+			def._type = ResultData::rtInt8;
 			break;
 		case 2:
-			type = ResultData::rtInt16;
+			def._type = ResultData::rtInt16;
 			break;
 		case 4:
-			type = ResultData::rtInt32;
+			def._type = ResultData::rtInt32;
 			break;
 		case 8:
-			type = ResultData::rtInt64;
+			def._type = ResultData::rtInt64;
 			break;
 		default: SF_RTTI_NOTIFY(DO_CLOG, _serverName << " not correct implemented!");
 			break;
 	}
+	def._blockSize = info.ArraySize;
 	// The array size cannot be zero.
-	//
-	rv += ResultData::getType(type) + sep;
-	// rfBlockSize
-	rv += stringf("%u", info.ArraySize) + sep;
-	// rfSegmentSize
-	unsigned segByteSize;
+	def._valid = def._blockSize > 0;
 	// Prevent division by zero.
 	if (info.ArraySize)
 	{
 		// Use 1 megabyte for small results.
-		segByteSize = (1024 * 1024) / info.ArraySize;
+		def._segmentSize = (1024 * 1024) / info.ArraySize;
 		// Use 10 megabyte for large results.
 		if (info.Flags & rfHugeData)
 		{
-			segByteSize = (10 * 1024 * 1024) / info.ArraySize;
+			def._segmentSize = (10 * 1024 * 1024) / info.ArraySize;
 		}
 	}
 	else
 	{
-		segByteSize = 1024 * 1024;
+		def._segmentSize = 1024 * 1024;
 	}
-	rv += itostr(segByteSize) + sep;
-	// rfSigBits
-	rv += itostr(info.Bits) + sep;
-	// rfOffset
-	rv += itostr(info.Offset);
-	// Return the setup string.
-	return rv;
+	def._significantBits = info.Bits;
+	def._offset = info.Offset;
+	return def;
 }
 
-Variable::PtrVector::size_type RsaServer::variableListFind(id_type id) const
+Variable* RsaServer::variableFind(IdType id) const
 {
-	for (Variable::PtrVector::size_type i = 0; i < _variableVector.size(); i++)
-	{
-		ExtraInfo* ei = const_cast<RsaServer*>(this)->castExtraInfo(_variableVector[i]);
-		if (ei && ei->_id == id)
-		{
-			return i;
-		}
-	}
-	return Variable::PtrVector::npos;
+	auto it = _variableMap.find(id);
+	return it == _variableMap.end() ? nullptr : it->second;
 }
 
-ResultData::PtrVector::size_type RsaServer::resultListFind(id_type id) const
+ResultData* RsaServer::resultFind(IdType id) const
 {
-	for (ResultData::PtrVector::size_type i = 0; i < _resultVector.size(); i++)
-	{
-		ExtraInfo* ei = const_cast<RsaServer*>(this)->castExtraInfo(_resultVector[i]);
-		if (ei && ei->_id == id)
-		{
-			return i;
-		}
-	}
-	return Variable::PtrVector::npos;
+	auto it = _resultMap.find(id);
+	return it == _resultMap.end() ? nullptr : it->second;
 }
 
-/**
- *
- * TODO: This comparing of setup strings should be avoided. Use the VariableTypes::Definition structure instead and add compare method there.
- * Returns a bit map of fields that differ.
- */
-unsigned CompareCsfFields(const std::string& s1, const std::string& s2)
-{
-	unsigned rv = 0;
-	strings sl1, sl2;
-	sl1.split(s1, ',', '"');
-	sl2.split(s2, ',', '"');
-	auto count = std::max(sl1.count(), sl2.count());
-	for (size_t i = 0; i < count; i++)
-	{
-		if (sl1.at(i) != sl2.at(i))
-		{
-			// Set the bit of the field.
-			rv += 1 << i;
-		}
-	}
-	return rv;
-}
-
-bool RsaServer::createVariable(Variable*& var, ParamInfo& info, const std::string& setup)
+bool RsaServer::createVariable(Variable*& var, ParamInfo& info, const Variable::Definition& def)
 {
 	// Flag for indicating that this function created the variable instance.
 	bool newed = false;
@@ -518,7 +455,7 @@ bool RsaServer::createVariable(Variable*& var, ParamInfo& info, const std::strin
 	// Set the variable global if export flag has not been set and the system is.
 	var->setGlobal(((info.Flags & (pfSystem | pfExport)) == pfSystem) ? false : true);
 	// Set up the variable.
-	var->setup(setup);
+	var->setup(def);
 	// Check the creation of the variable
 	if (var->getId())
 	{
@@ -530,8 +467,8 @@ bool RsaServer::createVariable(Variable*& var, ParamInfo& info, const std::strin
 			// Assign the pointer to the variable.
 			var->setData((uint64_t) ei);
 		}
-		// Set the setup string from the variable for later comparison.
-		ei->_setupString = setup;
+		// Keep the definition for later comparison.
+		ei->_definition = def;
 		// Set the ID.
 		ei->_id = info.Id;
 		// Set the channel.
@@ -542,6 +479,7 @@ bool RsaServer::createVariable(Variable*& var, ParamInfo& info, const std::strin
 		if (newed)
 		{
 			_variableVector.append(var);
+			_variableMap[info.Id] = var;
 		}
 		// Link the variable.
 		var->setHandler(&_serverVariableHandler);
@@ -570,7 +508,7 @@ bool RsaServer::createVariable(Variable*& var, ParamInfo& info, const std::strin
 	return false;
 }
 
-bool RsaServer::createResultData(ResultData*& res, ResultInfo& info, const std::string& setup)
+bool RsaServer::createResultData(ResultData*& res, ResultInfo& info, const ResultData::Definition& def)
 {
 	// Flag for indicating that this function created the instance.
 	bool newed = false;
@@ -585,7 +523,7 @@ bool RsaServer::createResultData(ResultData*& res, ResultInfo& info, const std::
 		//SF_RTTI_NOTIFY(DO_CLOG, "Recreating " << res->getName());
 	}
 	// Set up the result-data instance.
-	res->setup(setup);
+	res->setup(def, 0);
 	// Check the creation of the result instance.
 	if (res->getId())
 	{
@@ -597,8 +535,8 @@ bool RsaServer::createResultData(ResultData*& res, ResultInfo& info, const std::
 			// Assign the pointer to the variable.
 			res->setData((uint64_t) ei);
 		}
-		// Set the setup string from the result for later comparison.
-		ei->_setupString = setup;
+		// Keep the definition for later comparison.
+		ei->_resultDefinition = def;
 		// Set the ID.
 		ei->_id = info.Id;
 		// Set the channel.
@@ -610,6 +548,7 @@ bool RsaServer::createResultData(ResultData*& res, ResultInfo& info, const std::
 		{
 			// Add the variable to the list.
 			_resultVector.append(res);
+			_resultMap[info.Id] = res;
 		}
 		// Link the result.
 		res->setHandler(&_serverResultDataHandler);
@@ -618,9 +557,12 @@ bool RsaServer::createResultData(ResultData*& res, ResultInfo& info, const std::
 		//
 		return res;
 	}
-	// Delete the result.
-	delete res;
-	SF_RTTI_NOTIFY(DO_CLOG, "Creation of ResultData instance failed\n\t" << setup);
+	// If the result was created in this function it should also be deleted.
+	if (newed)
+	{
+		delete res;
+	}
+	SF_RTTI_NOTIFY(DO_CLOG, "Creation of ResultData instance failed\n\t" << def._name);
 	// Signal failure.
 	return false;
 }
@@ -637,6 +579,11 @@ void RsaServer::destroyVariable(Variable* var)
 		_variableVector.detach(var);
 		// Cast the data of the variable;
 		ExtraInfo* ei = castExtraInfo(var);
+		// Remove the lookup entry when it refers to this variable.
+		if (ei && variableFind(ei->_id) == var)
+		{
+			_variableMap.erase(ei->_id);
+		}
 		//
 		SF_COND_RTTI_NOTIFY(isDebug(), DO_CLOG, "Destroying Variable: " << var->getName());
 		// Delete the structure if it exists.
@@ -661,6 +608,11 @@ void RsaServer::destroyResultData(ResultData* res)
 		res->setHandler(nullptr);
 		// Cast the data of the variable;
 		ExtraInfo* ei = castExtraInfo(res);
+		// Remove the lookup entry when it refers to this result.
+		if (ei && resultFind(ei->_id) == res)
+		{
+			_resultMap.erase(ei->_id);
+		}
 		//
 		SF_COND_RTTI_NOTIFY(isDebug(), DO_CLOG, "Destroying ResultData: " << res->getName());
 		// Delete the structure if it exists.
@@ -670,12 +622,21 @@ void RsaServer::destroyResultData(ResultData* res)
 	}
 }
 
-void RsaServer::evaluateInterfaceParams()
+void RsaServer::evaluateInterfaceParams(const IdList* affected)
 {
+	// Keep the start time for reporting the duration.
+	auto start = std::chrono::steady_clock::now();
 	// Vector to hold all parameter ids.
 	IdList ids;
 	// Get all the parameters.
 	_acquisition->enumParamIds(ids);
+	// Set of the enumerated and affected ids for lookups in constant time.
+	std::unordered_set<IdType> id_set(ids.begin(), ids.end());
+	std::unordered_set<IdType> affected_set;
+	if (affected)
+	{
+		affected_set.insert(affected->begin(), affected->end());
+	}
 	// Check if the list size is non-zero.
 	if (!_variableVector.empty())
 	{
@@ -687,7 +648,7 @@ void RsaServer::evaluateInterfaceParams()
 			// If the info struct is present continue.
 			if (ei)
 			{ // Check if the ID is found in not wanted list of ID's.
-				if (ids.find(ei->_id) == Variable::PtrVector::npos)
+				if (!id_set.count(ei->_id))
 				{
 					// Call the special function to delete a variable from the VarList.
 					destroyVariable(*it);
@@ -695,9 +656,18 @@ void RsaServer::evaluateInterfaceParams()
 			}
 		}
 	}
+	// Variables set up of which the current value is synchronised after all have been set up.
+	Variable::PtrVector updated;
 	// Iterate through all parameter ids.
 	for (auto id: ids)
 	{
+		// Lookup an existing entry in the variable list.
+		auto var = variableFind(id);
+		// Existing variables which are not affected do not need evaluation.
+		if (var && affected && !affected_set.count(id))
+		{
+			continue;
+		}
 		// Declare an parameter info structure.
 		ParamInfo info;
 		// Get the parameter information of the id.
@@ -762,49 +732,43 @@ void RsaServer::evaluateInterfaceParams()
 				}
 				break;
 		}
-		// Get the setup string for comparison.
-		std::string setup = createSetupString(info, vid);
-		// Lookup an existing entry in the variable list.
-		auto index = variableListFind(id);
+		// Get the definition for comparison.
+		auto def = createDefinition(info, vid);
 		// When the entry was found check if it has to be changed.
-		if (index != Variable::PtrVector::npos)
+		if (var)
 		{
-			ExtraInfo* ei = castExtraInfo(_variableVector[index]);
-			// If the setup string does match, the variable does not have
-			// to be recreated.
-			if (setup != ei->_setupString || ei->_flags != info.Flags)
+			ExtraInfo* ei = castExtraInfo(var);
+			// If the definition and flags match the variable does not have to be set up again.
+			if (!ei->_definition.compare(def) && ei->_flags == info.Flags)
 			{
-				// Get the current value from the interface for setting later on.
-				Value curval;
-				_acquisition->getParam(ei->_id, curval);
-				// Create a new one.
-				Variable* var = _variableVector[index];
-				// Check if the variable successfully was created.
-				if (!createVariable(var, info, setup))
-				{ // Remove the current variable.
-					destroyVariable(var);
-				}
-				// Do not call our own event handler for this event.
-				var->setCur(curval, true);
+				continue;
 			}
-		}
-		else
-		{ // Create a new one.
-			Variable* var = nullptr;
-			if (createVariable(var, info, setup))
-			{
-				// Synchronise the variables and interface parameters.
-				// Get the current value of the implementation.
-				Value curval;
-				if (var && _acquisition->getParam(info.Id, curval))
-				{
-					// On success update the variable counter-part.
-					// Do not call our own event handler for this event.
-					var->setCur(curval, true);
-				}
+			// Check if the variable successfully was set up again.
+			if (!createVariable(var, info, def))
+			{ // Remove the current variable.
+				destroyVariable(var);
+				continue;
 			}
 		}
+		else if (!createVariable(var, info, def))
+		{
+			continue;
+		}
+		updated.append(var);
 	}
+	// Synchronise the variables with the interface parameters in a single pass.
+	for (auto var: updated)
+	{
+		Value curval;
+		if (_acquisition->getParam(castExtraInfo(var)->_id, curval))
+		{
+			// Do not call our own event handler for this event.
+			var->setCur(curval, true);
+		}
+	}
+	auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	SF_COND_RTTI_NOTIFY(isDebug(), DO_CLOG, "Evaluated " << (affected ? affected->count() : ids.count()) << " of " << ids.count()
+		<< " parameters and set up " << updated.count() << " in " << elapsed << "us.");
 }
 
 void RsaServer::evaluateInterfaceResults()
@@ -813,6 +777,8 @@ void RsaServer::evaluateInterfaceResults()
 	IdList ids;
 	// Get all the results ids.
 	_acquisition->enumResultIds(ids);
+	// Set of the enumerated ids for lookups in constant time.
+	std::unordered_set<IdType> id_set(ids.begin(), ids.end());
 	// Check if the list size is non-zero.
 	if (_resultVector.count())
 	{
@@ -823,7 +789,7 @@ void RsaServer::evaluateInterfaceResults()
 			// If the info struct is present continue.
 			if (auto ei = castExtraInfo(*it))
 			{ // Check if the ID is found in not wanted list of ID's.
-				if (ids.find(ei->_id) == IdList::npos)
+				if (!id_set.count(ei->_id))
 				{
 					// Call the special function to delete a variable from the VarList.
 					destroyResultData(*it);
@@ -899,45 +865,30 @@ void RsaServer::evaluateInterfaceResults()
 				}
 				break;
 		}
-		// Get the setup string for comparison.
-		std::string setup = createSetupString(info, rid);
+		// Get the definition for comparison.
+		auto def = createDefinition(info, rid);
 		// Lookup an existing entry in the result list.
-		auto index = resultListFind(ids[i]);
+		auto res = resultFind(ids[i]);
 		// When the entry was found check if it has to be changed.
-		if (index != ResultData::PtrVector::npos)
+		if (res)
 		{
-			ResultData* res = _resultVector[index];
 			ExtraInfo* ei = castExtraInfo(res);
-			// If the setup string does match the result
-			// does not have to be recreated.
-			if (setup != ei->_setupString)
+			// If the definition does match the result does not have to be recreated.
+			if (auto fields = ei->_resultDefinition.compare(def))
 			{
 				// Check if only the flags fields has changed.
-				auto fields = CompareCsfFields(setup, ei->_setupString);
-				if ((fields & ~(1L << ResultData::rfFlags)) == 0)
+				if ((fields & ~(1u << ResultData::rfFlags)) == 0)
 				{
-					//SF_RTTI_NOTIFY(DO_CLOG, "Applying new Flags " << res->getName());
-					// rfeFLAGS
-					flags_type flags = ResultData::flgShare;
-					// When not generating data the result is put in recycle mode.
-					if (info.Flags & rfStored)
-					{
-						flags |= ResultData::flgArchive;
-					}
-					else
-					{
-						flags |= ResultData::flgRecycle;
-					}
 					// Update the flags on the result.
-					if (res->updateFlags(flags, true))
+					if (res->updateFlags(def._flags, true))
 					{
-						// Assign the new setup string.
-						ei->_setupString = setup;
+						// Assign the new definition.
+						ei->_resultDefinition = def;
 					}
 				}
 				else
 				{ // Check if the instance was successfully created.
-					if (!createResultData(res, info, setup))
+					if (!createResultData(res, info, def))
 					{  // If not, destroy it.
 						destroyResultData(res);
 					}
@@ -946,9 +897,8 @@ void RsaServer::evaluateInterfaceResults()
 		}
 		else
 		{
-			ResultData* res = nullptr;
 			// Create a new one.
-			createResultData(res, info, setup);
+			createResultData(res, info, def);
 		}
 	}
 
@@ -1089,10 +1039,11 @@ void RsaServer::serverVariableHandler
 			{ // Get the flags now from the extra info because it could be that
 				// this variable does not exist anymore after the SetGetParam() call.
 				int flags = castExtraInfo(&link)->_flags;
+				auto id = castExtraInfo(&link)->_id;
 				// Temporary storage of current run mode.
 				bool runmode = _acquisition->getRunMode();
 				// When param notify function was called prevent unneeded extra work.
-				if (!sameInst || _handledParamId != castExtraInfo(&link)->_id)
+				if (!sameInst || _handledParamId != id)
 				{
 					// Create a temporary value for the current value and the return value.
 					Value value(link.getCur());
@@ -1107,7 +1058,7 @@ void RsaServer::serverVariableHandler
 					}
 					// Set parameter value to the current variable value.
 					// Skip the event because an unbreakable loop is eminent.
-					_acquisition->paramSetGet(castExtraInfo(&link)->_id, value, true);
+					_acquisition->paramSetGet(id, value, true);
 					// Check if the variable is still valid.
 					// which means it means in this case it is not deleted by
 					// the previous call to SetGetParam.
@@ -1119,8 +1070,9 @@ void RsaServer::serverVariableHandler
 				// Check if this parameter has effect on other parameter's geometry.
 				if (flags & pfEffectsParameter)
 				{
-					// If so  reevaluate the parameters.
-					evaluateInterfaceParams();
+					// If so reevaluate the parameters limited to the ones reported by the implementation.
+					IdList affected;
+					evaluateInterfaceParams(_acquisition->getAffectedParamIds(id, affected) ? &affected : nullptr);
 				}
 				// Check if this parameter had an effect on other result's geometry.
 				if (flags & pfEffectsResult)
@@ -1170,10 +1122,9 @@ void RsaServer::paramNotify(id_type id)
 		{
 			// Set the kind of sentry when handling a parameter.
 			_handledParamId = id;
-			auto i = variableListFind(id);
-			if (i != Variable::PtrVector::npos)
+			if (auto var = variableFind(id))
 			{
-				_variableVector[i]->setCur(value, false);
+				var->setCur(value, false);
 			}
 			else
 			{
@@ -1194,11 +1145,10 @@ void RsaServer::resultNotify(InformationTypes::id_type id)
 {
 //  RTTI_NOTIFY(DO_DEFAULT, "ResultNotify("<< id << ")");
 	// Looks up a result data id.
-	auto idx = resultListFind(id);
+	auto res = resultFind(id);
 	// When found process the available.
-	if (idx != ResultData::PtrVector::npos)
-	{ // Get a pointer to the result.
-		ResultData* res = _resultVector[idx];
+	if (res)
+	{
 		unsigned blkByteSize = res->getBufferSize(1);
 		// Declare buffer info structure to receive
 		BufferInfo bufInfo;
@@ -1212,7 +1162,7 @@ void RsaServer::resultNotify(InformationTypes::id_type id)
 				{
 					throw Exception("ResultNotify(): Block size '%s' is not of the expected size!", res->getName(2).c_str());
 				}
-				if (!res->blockWrite(-1L, bufInfo.Size, bufInfo.Buffer, true))
+				if (!res->blockWrite(-1L, bufInfo.Size, bufInfo.Buffer, true, bufInfo.Timestamp))
 				{
 					SF_RTTI_NOTIFY(DO_CLOG, "BlockWrite() Failed!");
 					break;
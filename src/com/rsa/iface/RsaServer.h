@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include <gii/gen/InformationServer.h>
 #include "RsaTypes.h"
 #include "global.h"
@@ -85,13 +86,14 @@ class _RSA_CLASS RsaServer :public InformationServer, public RsaTypes
 
 		/**
 		 * @brief Looks up a parameter which is represented by the interface id.
+		 * @return Nullptr when not found.
 		 */
-		[[nodiscard]] Variable::PtrVector::size_type variableListFind(id_type id) const;
+		[[nodiscard]] Variable* variableFind(IdType id) const;
 
 		/**
 		 * @brief Creates a variable with a extra info structure attached.
 		 */
-		bool createVariable(Variable*& var, RsaTypes::ParamInfo& info, const std::string& setup);
+		bool createVariable(Variable*& var, RsaTypes::ParamInfo& info, const Variable::Definition& def);
 
 		/**
 		 * @brief Destroys a variable including the attached extra info structure.
@@ -99,14 +101,18 @@ class _RSA_CLASS RsaServer :public InformationServer, public RsaTypes
 		void destroyVariable(Variable* var);
 
 		/**
-		 * @brief Creates a setup string from the passed parameter info structure.
+		 * @brief Creates a variable definition from the passed parameter info structure.
 		 */
-		std::string createSetupString(const RsaTypes::ParamInfo& info, long vid);
+		Variable::Definition createDefinition(const RsaTypes::ParamInfo& info, long vid);
 
 		/**
 		 * @brief Evaluate parameters after the configuration has changed.
+		 *
+		 * Parameters are added and removed according the enumerated ids.
+		 * Existing variables are only set up again when their definition differs.
+		 * @param affected When not null only the existing parameters in this list are evaluated.
 		 */
-		void evaluateInterfaceParams();
+		void evaluateInterfaceParams(const IdList* affected = nullptr);
 
 		/**
 		 * @brief Gets the name of the channel using the device name.
@@ -120,13 +126,14 @@ class _RSA_CLASS RsaServer :public InformationServer, public RsaTypes
 
 		/**
 		 * @brief Looks up a result data which is represented by the interface id.
+		 * @return Nullptr when not found.
 		 */
-		[[nodiscard]] ResultData::PtrVector::size_type resultListFind(id_type id) const;
+		[[nodiscard]] ResultData* resultFind(IdType id) const;
 
 		/**
 		 * @brief Creates a variable with a extra info structure attached.
 		 */
-		bool createResultData(ResultData*& res, RsaTypes::ResultInfo& info, const std::string& setup);
+		bool createResultData(ResultData*& res, RsaTypes::ResultInfo& info, const ResultData::Definition& def);
 
 		/**
 		 * @brief Destroys a variable including the attached extra info structure.
@@ -134,9 +141,9 @@ class _RSA_CLASS RsaServer :public InformationServer, public RsaTypes
 		void destroyResultData(ResultData* var);
 
 		/**
-		 * @brief Creates a setup string from the passed result info structure.
+		 * @brief Creates a result data definition from the passed result info structure.
 		 */
-		std::string createSetupString(const RsaTypes::ResultInfo& info,long vid);
+		ResultData::Definition createDefinition(const RsaTypes::ResultInfo& info, long vid);
 
 		/**
 		 * @brief Evaluate results after the configuration has changed.
@@ -162,8 +169,10 @@ class _RSA_CLASS RsaServer :public InformationServer, public RsaTypes
 			unsigned _channel;
 			/** Holds the interface id. */
 			IdType _id;
-			/** Holds the last setup-string for comparison. */
-			std::string _setupString;
+			/** Holds the last variable definition for comparison. */
+			Variable::Definition _definition;
+			/** Holds the last result data definition for comparison. */
+			ResultData::Definition _resultDefinition;
 			/** Flags copied from the ParamInfo structure. */
 			int _flags;
 		};
@@ -232,6 +241,10 @@ class _RSA_CLASS RsaServer :public InformationServer, public RsaTypes
 		 * @brief Holds all created variables for the selected implementation.
 		 */
 		Variable::PtrVector _variableVector;
+		/**
+		 * @brief Looks up the created variables by interface id.
+		 */
+		std::unordered_map<IdType, Variable*> _variableMap;
 		/**
 		 * @brief Callback hook for result events.
 		 */
@@ -244,6 +257,10 @@ class _RSA_CLASS RsaServer :public InformationServer, public RsaTypes
 		 * @brief Holds all created results for this instance.
 		 */
 		ResultData::PtrVector _resultVector;
+		/**
+		 * @brief Looks up the created results by interface id.
+		 */
+		std::unordered_map<IdType, ResultData*> _resultMap;
 		/**
 		 * @brief Holds the device number passed at the constructor.
 		 */
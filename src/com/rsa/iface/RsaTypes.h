@@ -113,6 +113,7 @@ struct _RSA_CLASS RsaTypes
 		rfAsyncIndex = 1 << 3, // Result keeps track of sync counter values at the time async data was generated.
 		rfHugeData = 1 << 4, // Result that generates a huge amount of data.
 		rfStored = 1 << 5, // Generates data to be stored.
+		rfTimestamp = 1 << 6, // Blocks are stored with a timestamp for looking them up by time.
 	};
 
 	/**
@@ -342,6 +343,7 @@ struct _RSA_CLASS RsaTypes
 			BlockBufSize = 0;
 			Remain = 0;
 			Counter = 0;
+			Timestamp = 0;
 		}
 
 		/**
@@ -364,6 +366,10 @@ struct _RSA_CLASS RsaTypes
 		 * Possible sync counter value.
 		 */
 		size_t Counter{0};
+		/**
+		 * Acquisition time in nanoseconds of the steady clock where zero means the time of storing.
+		 */
+		int64_t Timestamp{0};
 	};
 
 	/**
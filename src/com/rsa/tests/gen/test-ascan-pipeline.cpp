@@ -0,0 +1,215 @@
+#include <test/catch.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <rsa/iface/AscanPipeline.h>
+
+namespace
+{
+
+/**
+ * Processes signed sample values as raw 8-bit words having an offset of 127.
+ */
+sf::AscanPipeline::Output process(sf::AscanPipeline& pipeline, const std::vector<int>& values)
+{
+	std::vector<uint8_t> raw;
+	for (auto v: values)
+	{
+		raw.push_back(static_cast<uint8_t>(v + 127));
+	}
+	sf::AscanPipeline::Output out;
+	pipeline.process(raw.data(), raw.size(), out);
+	return out;
+}
+
+}
+
+TEST_CASE("sf::AscanPipeline", "[rsa][pipeline]")
+{
+	using Pipeline = sf::AscanPipeline;
+	Pipeline pipeline;
+	Pipeline::Setup setup;
+	setup.offset = 127;
+
+	SECTION("Rectify")
+	{
+		const std::vector<int> values{10, -20, 0, 5};
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, values).samples == std::vector<float>{10, -20, 0, 5});
+		setup.stages = {{Pipeline::stRectify, Pipeline::rtFull}};
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, values).samples == std::vector<float>{10, 20, 0, 5});
+		setup.stages = {{Pipeline::stRectify, Pipeline::rtPositive}};
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, values).samples == std::vector<float>{10, 0, 0, 5});
+		setup.stages = {{Pipeline::stRectify, Pipeline::rtNegative}};
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, values).samples == std::vector<float>{0, 20, 0, 0});
+	}
+
+	SECTION("Filters")
+	{
+		// The impulse response of the FIR filter is centered on the impulse.
+		setup.stages = {{Pipeline::stFir, 0, {1, 2, 3}}};
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, {0, 0, 0, 0, 10, 0, 0, 0, 0}).samples == std::vector<float>{0, 0, 0, 10, 20, 30, 0, 0, 0});
+		// First order low pass y[n] = x[n] + y[n-1] / 2 as a single biquad.
+		setup.stages = {{Pipeline::stIir, 0, {1, 0, 0, -0.5f, 0}}};
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, {8, 0, 0, 0}).samples == std::vector<float>{8, 4, 2, 1});
+	}
+
+	SECTION("TCG")
+	{
+		setup.stages = {{Pipeline::stTcg}};
+		// Points are sorted by time.
+		setup.tcg = {{2e-7, 20}, {0, 0}};
+		setup.sampleInterval = 1e-7;
+		pipeline.setSetup(setup);
+		auto out = process(pipeline, {1, 1, 1, 1});
+		REQUIRE(out.samples.size() == 4);
+		CHECK(out.samples[0] == Approx(1.0f));
+		CHECK(out.samples[1] == Approx(std::pow(10.0, 0.5)));
+		CHECK(out.samples[2] == Approx(10.0f));
+		// The last gain holds after the last point.
+		CHECK(out.samples[3] == Approx(10.0f));
+		CHECK(pipeline.getSetup().tcg.front().time == 0);
+	}
+
+	SECTION("Envelope")
+	{
+		setup.stages = {{Pipeline::stEnvelope, 31}};
+		pipeline.setSetup(setup);
+		std::vector<int> values;
+		for (int i = 0; i < 200; i++)
+		{
+			values.push_back(static_cast<int>(std::lround(100 * std::sin(2 * 3.14159265358979 * i / 16))));
+		}
+		auto out = process(pipeline, values);
+		// Away from the edges the envelope is the amplitude of the sine.
+		for (size_t i = 50; i < 150; i++)
+		{
+			CHECK(out.samples[i] == Approx(100).margin(5));
+		}
+	}
+
+	SECTION("Average")
+	{
+		setup.stages = {{Pipeline::stAverage, 2}, {Pipeline::stRectify, Pipeline::rtFull}};
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, {-10}).samples == std::vector<float>{10});
+		CHECK(process(pipeline, {-20}).samples == std::vector<float>{15});
+		CHECK(process(pipeline, {-40}).samples == std::vector<float>{30});
+		// Setting the same stages keeps the averaged shots.
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, {0}).samples == std::vector<float>{20});
+		// Changing the stages restarts the averaging.
+		setup.stages.front().mode = 3;
+		pipeline.setSetup(setup);
+		CHECK(process(pipeline, {-6}).samples == std::vector<float>{6});
+	}
+
+	SECTION("Gates")
+	{
+		setup.gates = {
+			{0, 5, 20},
+			{3, 6, 40, -1},
+			{0, 9, 60},
+			// Slaved to the peak of the first gate.
+			{1, 3, 1, 0, 0},
+			// Slaved to a gate without a peak.
+			{0, 9, 0, 0, 2},
+		};
+		pipeline.setSetup(setup);
+		auto out = process(pipeline, {0, 0, 30, 0, 5, 0, -50, -50, 0});
+		REQUIRE(out.gates.size() == 5);
+		CHECK(out.gates[0].found);
+		CHECK(out.gates[0].index == 2);
+		CHECK(out.gates[0].amplitude == 30);
+		// The index is the middle of the samples having the peak value.
+		CHECK(out.gates[1].found);
+		CHECK(out.gates[1].index == 6);
+		CHECK(out.gates[1].amplitude == -50);
+		CHECK_FALSE(out.gates[2].found);
+		CHECK(out.gates[3].found);
+		CHECK(out.gates[3].index == 4);
+		CHECK(out.gates[3].amplitude == 5);
+		CHECK_FALSE(out.gates[4].found);
+	}
+
+	SECTION("Words")
+	{
+		const float samples[] = {-200, 0, 100.4f, 300};
+		uint8_t bytes[4];
+		Pipeline::toWords(samples, 4, bytes, 1, 8, 127);
+		CHECK(std::vector<uint8_t>(bytes, bytes + 4) == std::vector<uint8_t>{0, 127, 227, 255});
+		uint16_t words[4];
+		Pipeline::toWords(samples, 4, words, 2, 8, 0);
+		CHECK(std::vector<uint16_t>(words, words + 4) == std::vector<uint16_t>{0, 0, 100, 255});
+		uint32_t dwords[1];
+		const float large[] = {1e10f};
+		Pipeline::toWords(large, 1, dwords, 4, 32, 0);
+		CHECK(dwords[0] == 4294967040u);
+	}
+
+	SECTION("Ordering")
+	{
+		// Averaging depends on the previous shot so it only matches when collected in order.
+		setup.stages = {{Pipeline::stRectify, Pipeline::rtFull}, {Pipeline::stAverage, 2}};
+		pipeline.setSetup(setup);
+		pipeline.start(3);
+		const uint32_t count = 500;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint8_t raw[64];
+			memset(raw, static_cast<uint8_t>(127 - i % 100), sizeof(raw));
+			REQUIRE(pipeline.push(i, raw, sizeof(raw)));
+		}
+		std::vector<uint32_t> counters;
+		bool matches = true;
+		auto handler = [&](Pipeline::Output& out)
+		{
+			auto i = out.counter;
+			auto expected = i ? float(i % 100 + (i - 1) % 100) / 2 : 0.0f;
+			matches &= out.samples.size() == 64 && out.samples.front() == expected && out.samples.back() == expected;
+			counters.push_back(i);
+		};
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (counters.size() < count && std::chrono::steady_clock::now() < deadline)
+		{
+			pipeline.collect(Pipeline::Handler(handler));
+			std::this_thread::yield();
+		}
+		pipeline.stop();
+		REQUIRE(counters.size() == count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			CHECK(counters[i] == i);
+		}
+		CHECK(matches);
+		CHECK(pipeline.getMetrics().processed == count);
+		CHECK(pipeline.getMetrics().dropped == 0);
+	}
+
+	SECTION("Drop")
+	{
+		// Without threads the shots are processed when collected.
+		pipeline.setSetup(setup);
+		pipeline.setMaxPending(2);
+		const uint8_t raw[] = {137, 117};
+		CHECK(pipeline.push(1, raw, 2));
+		CHECK(pipeline.push(2, raw, 2));
+		CHECK_FALSE(pipeline.push(3, raw, 2));
+		std::vector<uint32_t> counters;
+		CHECK(pipeline.collect(Pipeline::Handler([&](Pipeline::Output& out)
+		{
+			CHECK(out.samples == std::vector<float>{10, -10});
+			counters.push_back(out.counter);
+		})) == 2);
+		CHECK(counters == std::vector<uint32_t>{1, 2});
+		CHECK(pipeline.getMetrics().processed == 2);
+		CHECK(pipeline.getMetrics().dropped == 1);
+	}
+}
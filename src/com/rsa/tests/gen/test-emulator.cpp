@@ -0,0 +1,88 @@
+#include <test/catch.h>
+
+#include <chrono>
+#include <misc/gen/Sustain.h>
+#include <rsa/emulator/RsaEmulator.h>
+
+extern int debug_level;
+
+namespace
+{
+
+/**
+ * Finds the id of a parameter using its name.
+ */
+sf::RsaTypes::IdType findParam(sf::RsaInterface& rsa, const std::string& name)
+{
+	sf::RsaTypes::IdList ids;
+	rsa.enumParamIds(ids);
+	for (auto id: ids)
+	{
+		sf::RsaTypes::ParamInfo info;
+		if (rsa.handleParam(id, &info, nullptr, nullptr) && info.Name == name)
+		{
+			return id;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Sets an integer parameter using its name.
+ */
+bool setParam(sf::RsaInterface& rsa, const std::string& name, sf::Value::int_type value)
+{
+	auto id = findParam(rsa, name);
+	sf::Value setval;
+	setval.set(value);
+	return id && rsa.handleParam(id, nullptr, &setval, nullptr);
+}
+
+/**
+ * Runs the emulator in deterministic mode up to the sync limit and returns the checksum.
+ */
+std::string runDeterministic(uint64_t seed, uint32_t limit)
+{
+	sf::AcquisitionEmulator emu(sf::RsaInterface::Parameters(0));
+	// Hooks are only called when initialized.
+	REQUIRE(emu.initialize());
+	REQUIRE(setParam(emu, "Emulation|Throughput", 1));
+	REQUIRE(setParam(emu, "Emulation|Seed", static_cast<sf::Value::int_type>(seed)));
+	REQUIRE(setParam(emu, "Emulation|Sync Limit", limit));
+	// The checksum parameter is signaled when all channels reached the limit.
+	struct Done
+	{
+		sf::RsaTypes::IdType id;
+		bool flag;
+	} done{findParam(emu, "Emulation|Checksum"), false};
+	REQUIRE(done.id);
+	emu.setParamHook([](void* data, sf::RsaTypes::IdType id) {
+		auto d = static_cast<Done*>(data);
+		d->flag |= d->id == id;
+	}, &done);
+	REQUIRE(emu.setRunMode(true, true));
+	auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+	while (!done.flag && std::chrono::steady_clock::now() < timeout)
+	{
+		sf::SustainBase::callSustain();
+	}
+	emu.setRunMode(false, false);
+	emu.uinitialize();
+	REQUIRE(done.flag);
+	return emu.getChecksum();
+}
+
+}// namespace
+
+TEST_CASE("sf::AcquisitionEmulator", "[rsa][emulator]")
+{
+	SECTION("Deterministic")
+	{
+		auto checksum = runDeterministic(1234, 200);
+		CHECK(checksum.length() == 32);
+		// Same seed and limit give the same data.
+		CHECK(runDeterministic(1234, 200) == checksum);
+		// Another seed gives other noise.
+		CHECK(runDeterministic(4321, 200) != checksum);
+	}
+}
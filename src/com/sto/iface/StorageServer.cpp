@@ -1,3 +1,4 @@
+#include <rsa/iface/MakeIds.h>
 #include "StorageInterface.h"
 #include "StorageServer.h"
 
@@ -8,7 +9,8 @@ StorageServer::StorageServer(id_type deviceNumber, const std::string& serverName
 : _deviceNumber(deviceNumber)
 , _serverName(serverName.empty() ? "Storage" : serverName)
 {
-
+	// Storage is shared by all results so the budget is independent of the implementation.
+	_governor.setup(MAKE_VID(_deviceNumber, 0x1), _serverName);
 }
 
 StorageServer::~StorageServer()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <gii/gen/InformationBase.h>
+#include <gii/gen/ResultDataGovernor.h>
 #include "global.h"
 
 namespace sf
@@ -10,6 +11,8 @@ class StorageInterface;
 
 /**
  * @brief Storage server
+ *
+ * Also exposes the storage budget and usage of all results through a #sf::ResultDataGovernor.
  */
 class _STO_CLASS StorageServer :public InformationTypes
 {
@@ -85,6 +88,11 @@ class _STO_CLASS StorageServer :public InformationTypes
 		 * @brief Holds the device name for creating the variable names.
 		 */
 		std::string _serverName;
+
+		/**
+		 * @brief Exposes the storage budget and usage of all results.
+		 */
+		ResultDataGovernor _governor;
 };
 
 }
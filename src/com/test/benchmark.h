@@ -0,0 +1,426 @@
+#pragma once
+
+/*
+ * Minimal benchmark harness shared by the library benchmark executables.
+ *
+ * Each benchmark runs a fixed workload so runs are comparable between builds.
+ * The workload is timed for a number of repetitions after a single warmup run.
+ * Results are reported as a table on the log stream and optionally as JSON
+ * which the 'bin/bench-compare.sh' script compares between 2 runs.
+ *
+ * Like:
+ *   SF_BENCHMARK("misc/Value/add-float")
+ *   {
+ *     sf::Value a(1.5), b(2.5);
+ *     state.run(100000, [&]() {
+ *       sf::bench::keep(a + b);
+ *     });
+ *   }
+ *
+ * Options of the executable:
+ *   --filter <text>      Only runs benchmarks having the text in their name.
+ *   --repetitions <n>    Amount of timed repetitions (default 10).
+ *   --json <file>        Writes the results as JSON to the file or '-' for stdout.
+ *   --list               Lists the benchmark names only.
+ *
+ * The source file having the 'main()' function must define 'SF_BENCHMARK_MAIN' before including
+ * this header to have heap allocations counted which is only available for glibc.
+ * Counted are malloc(), calloc(), realloc() and the aligned aligned_alloc(), memalign() and posix_memalign().
+ */
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace sf::bench
+{
+
+/**
+ * @brief Prevents the compiler from optimizing away the passed value.
+ */
+template<typename T>
+inline void keep(T&& value)
+{
+#if defined(__GNUC__)
+	asm volatile("" : : "g"(&value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+/**
+ * @brief Counts the heap allocations when 'SF_BENCHMARK_MAIN' is defined.
+ */
+inline std::atomic<size_t> allocationCount{0};
+
+/**
+ * @brief Result of a single benchmark.
+ */
+struct Result
+{
+	std::string name;
+	size_t iterations{0};
+	size_t repetitions{0};
+	// Times per iteration in nanoseconds.
+	double minimum{0};
+	double median{0};
+	double mean{0};
+	double deviation{0};
+	// Amount of bytes and items processed per iteration.
+	size_t bytes{0};
+	size_t items{0};
+	// Heap allocations per iteration.
+	double allocations{0};
+};
+
+/**
+ * @brief Passed to each benchmark function for running the timed workload.
+ */
+class State
+{
+	public:
+		explicit State(size_t repetitions)
+			:_repetitions(repetitions)
+		{}
+
+		/**
+		 * @brief Runs the function the amount of iterations for each repetition.
+		 *
+		 * Only the first call in a benchmark is timed.
+		 */
+		template<typename Func>
+		void run(size_t iterations, Func&& func)
+		{
+			if (_iterations)
+			{
+				return;
+			}
+			_iterations = iterations;
+			// Warmup run which is not timed.
+			for (size_t i = 0; i < iterations; i++)
+			{
+				func();
+			}
+			auto allocations = allocationCount.load(std::memory_order_relaxed);
+			for (size_t r = 0; r < _repetitions; r++)
+			{
+				auto t0 = std::chrono::steady_clock::now();
+				for (size_t i = 0; i < iterations; i++)
+				{
+					func();
+				}
+				auto t1 = std::chrono::steady_clock::now();
+				_samples.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(iterations));
+			}
+			_allocations = static_cast<double>(allocationCount.load(std::memory_order_relaxed) - allocations) / static_cast<double>(iterations * _repetitions);
+		}
+
+		/**
+		 * @brief Sets the amount of bytes processed per iteration to report the throughput.
+		 */
+		void setBytes(size_t bytes)
+		{
+			_bytes = bytes;
+		}
+
+		/**
+		 * @brief Sets the amount of items processed per iteration to report the throughput.
+		 */
+		void setItems(size_t items)
+		{
+			_items = items;
+		}
+
+		/**
+		 * @brief Gets the result from the timed samples.
+		 */
+		[[nodiscard]] Result getResult(const std::string& name) const
+		{
+			Result rv;
+			rv.name = name;
+			rv.iterations = _iterations;
+			rv.repetitions = _samples.size();
+			rv.bytes = _bytes;
+			rv.items = _items;
+			rv.allocations = _allocations;
+			if (_samples.empty())
+			{
+				return rv;
+			}
+			auto sorted = _samples;
+			std::sort(sorted.begin(), sorted.end());
+			rv.minimum = sorted.front();
+			rv.median = sorted.size() % 2 ? sorted[sorted.size() / 2] : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2;
+			for (auto s: sorted)
+			{
+				rv.mean += s;
+			}
+			rv.mean /= static_cast<double>(sorted.size());
+			for (auto s: sorted)
+			{
+				rv.deviation += (s - rv.mean) * (s - rv.mean);
+			}
+			rv.deviation = std::sqrt(rv.deviation / static_cast<double>(sorted.size()));
+			return rv;
+		}
+
+	private:
+		size_t _repetitions;
+		size_t _iterations{0};
+		size_t _bytes{0};
+		size_t _items{0};
+		double _allocations{0};
+		std::vector<double> _samples;
+};
+
+/**
+ * @brief Registered benchmark.
+ */
+struct Entry
+{
+	const char* name;
+	void (*func)(State&);
+};
+
+/**
+ * @brief Gets the registered benchmarks.
+ */
+inline std::vector<Entry>& getEntries()
+{
+	static std::vector<Entry> entries;
+	return entries;
+}
+
+/**
+ * @brief Registers a benchmark function at static initialization.
+ */
+struct Registrar
+{
+	Registrar(const char* name, void (*func)(State&))
+	{
+		getEntries().push_back({name, func});
+	}
+};
+
+/**
+ * @brief Escapes a string for JSON.
+ */
+inline std::string jsonEscape(const std::string& s)
+{
+	std::string rv;
+	for (auto c: s)
+	{
+		if (c == '"' || c == '\\')
+		{
+			rv += '\\';
+		}
+		rv += c;
+	}
+	return rv;
+}
+
+/**
+ * @brief Writes the results as JSON.
+ */
+inline void writeJson(std::ostream& os, const std::string& executable, const std::vector<Result>& results)
+{
+	char date[32];
+	auto now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+	os << "{\n";
+	os << "\t\"executable\": \"" << jsonEscape(executable) << "\",\n";
+	os << "\t\"date\": \"" << date << "\",\n";
+#if defined(NDEBUG)
+	os << "\t\"debug\": false,\n";
+#else
+	os << "\t\"debug\": true,\n";
+#endif
+	os << "\t\"benchmarks\": [";
+	os << std::setprecision(6) << std::fixed;
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		auto& r(results[i]);
+		os << (i ? "," : "") << "\n\t\t{";
+		os << "\"name\": \"" << jsonEscape(r.name) << "\", ";
+		os << "\"iterations\": " << r.iterations << ", ";
+		os << "\"repetitions\": " << r.repetitions << ", ";
+		os << "\"min_ns\": " << r.minimum << ", ";
+		os << "\"median_ns\": " << r.median << ", ";
+		os << "\"mean_ns\": " << r.mean << ", ";
+		os << "\"stddev_ns\": " << r.deviation << ", ";
+		os << "\"bytes\": " << r.bytes << ", ";
+		os << "\"items\": " << r.items << ", ";
+		os << "\"allocs_per_iter\": " << r.allocations << "}";
+	}
+	os << "\n\t]\n}\n";
+}
+
+/**
+ * @brief Runs the registered benchmarks using the command line options.
+ */
+inline int main(int argc, char* argv[])
+{
+	std::string filter, json;
+	size_t repetitions = 10;
+	bool list = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg == "--filter" && i + 1 < argc)
+		{
+			filter = argv[++i];
+		}
+		else if (arg == "--repetitions" && i + 1 < argc)
+		{
+			repetitions = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--json" && i + 1 < argc)
+		{
+			json = argv[++i];
+		}
+		else if (arg == "--list")
+		{
+			list = true;
+		}
+		else
+		{
+			std::clog << "Usage: " << argv[0] << " [--filter <text>] [--repetitions <n>] [--json <file>|-] [--list]" << std::endl;
+			return arg == "--help" || arg == "-h" ? 0 : 1;
+		}
+	}
+	std::vector<Result> results;
+	for (auto& entry: getEntries())
+	{
+		if (!filter.empty() && std::string(entry.name).find(filter) == std::string::npos)
+		{
+			continue;
+		}
+		if (list)
+		{
+			std::cout << entry.name << std::endl;
+			continue;
+		}
+		if (results.empty())
+		{
+			std::clog << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(12) << "Median(ns)" << std::setw(12) << "Min(ns)"
+				<< std::setw(12) << "StdDev(ns)" << std::setw(12) << "MB/s" << std::setw(12) << "Allocs" << std::endl;
+		}
+		State state(repetitions);
+		entry.func(state);
+		results.push_back(state.getResult(entry.name));
+		auto& r(results.back());
+		std::clog << std::left << std::setw(48) << r.name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(12) << r.median << std::setw(12) << r.minimum << std::setw(12) << r.deviation << std::setw(12);
+		if (r.bytes && r.median > 0)
+		{
+			std::clog << static_cast<double>(r.bytes) * 1e3 / r.median;
+		}
+		else
+		{
+			std::clog << "-";
+		}
+		std::clog << std::setw(12) << std::setprecision(2) << r.allocations << std::endl;
+	}
+	if (!json.empty() && !list)
+	{
+		if (json == "-")
+		{
+			writeJson(std::cout, argv[0], results);
+		}
+		else
+		{
+			std::ofstream os(json);
+			if (!os)
+			{
+				std::clog << "Unable to write file: " << json << std::endl;
+				return 1;
+			}
+			writeJson(os, argv[0], results);
+		}
+	}
+	return 0;
+}
+
+}// namespace sf::bench
+
+#define SF_BENCHMARK_CONCAT_(a, b) a##b
+#define SF_BENCHMARK_CONCAT(a, b) SF_BENCHMARK_CONCAT_(a, b)
+
+/**
+ * @brief Declares a benchmark function having a 'state' argument of type sf::bench::State.
+ */
+#define SF_BENCHMARK(name) \
+	static void SF_BENCHMARK_CONCAT(sfBenchmark, __LINE__)(sf::bench::State& state); \
+	static sf::bench::Registrar SF_BENCHMARK_CONCAT(sfBenchmarkRegistrar, __LINE__)(name, &SF_BENCHMARK_CONCAT(sfBenchmark, __LINE__)); \
+	static void SF_BENCHMARK_CONCAT(sfBenchmark, __LINE__)([[maybe_unused]] sf::bench::State& state)
+
+#if defined(SF_BENCHMARK_MAIN) && defined(__GLIBC__)
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+// Interposes the allocation functions of the C library for counting which covers operator new as well.
+void* malloc(size_t size)
+{
+	sf::bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+	sf::bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+	sf::bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return __libc_realloc(ptr, size);
+}
+
+// Aligned allocations are used by operator new for over-aligned types and aligned containers.
+void* aligned_alloc(size_t alignment, size_t size)
+{
+	sf::bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return __libc_memalign(alignment, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+	sf::bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+	// The alignment must be a power of 2 multiple of the pointer size.
+	if (alignment % sizeof(void*) || alignment & (alignment - 1))
+	{
+		return EINVAL;
+	}
+	sf::bench::allocationCount.fetch_add(1, std::memory_order_relaxed);
+	auto p = __libc_memalign(alignment, size);
+	if (!p)
+	{
+		return ENOMEM;
+	}
+	*ptr = p;
+	return 0;
+}
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "BscanGraphPrivate.h"
+#include <cstring>
 #include <QImage>
 #include <misc/gen/Sustain.h>
 #include <misc/qt/Draw.h>
@@ -127,6 +128,12 @@ void BscanGraph::Private::initialize()
 	//
 	connect(&_paletteServer, &PaletteServer::changed, [&]()
 	{
+		// Colorize the current image again using the new palette.
+		_flagColorize = true;
+		if (_rangeCurrent.getSize())
+		{
+			generateData(_rangeCurrent);
+		}
 		if (_rcPalette.isValid())
 		{
 			_w->update(_rcPalette);
@@ -245,6 +252,8 @@ void BscanGraph::Private::handlerResultData(ResultDataTypes::EEvent event, const
 
 		case ResultData::reIdChanged:
 		{
+			// Rows colorized before could be of another result.
+			_flagColorize = true;
 			// Check if drawing is possible.
 			setCanDraw();
 			break;
@@ -319,21 +328,10 @@ bool BscanGraph::Private::draw(QPainter& painter, const QRect& rect, const QRegi
 	// Is there any data to draw.
 	if (_rangeCurrent.getSize())
 	{
-		// Draw the image into the graph area.
+		// Draw the image into the graph area which is already colorized.
 		if (!_image.isNull())
 		{
-			// Check if the palette server has an implementation.
-			if (_paletteServer.isAvailable())
-			{
-				// Convert the image to an 8-bit indexed format and set the color table for each index.
-				auto img = _image.convertToFormat(QImage::Format_Indexed8);
-				img.setColorTable(_paletteServer.getColorTable());
-				painter.drawImage(rect, img);
-			}
-			else
-			{
-				painter.drawImage(rect, _image);
-			}
+			painter.drawImage(rect, _image);
 		}
 		// Now we draw other things
 		drawMark(painter, _mark);
@@ -359,20 +357,80 @@ bool BscanGraph::Private::generateData(const Range& range)
 		_dataRange.getStart() + calculateOffset(_scan.Left, 0.0, 1.0, _dataRange.getSize(), true),
 		_dataRange.getStart() + calculateOffset(_scan.Right, 0.0, 1.0, _dataRange.getSize(), true)
 	);
-	// Adjust the data buffer size to hold the image data.
-	_imageData.grow(_rData.getBlockSize() * (rng.getSize() + 1));
+	auto width = static_cast<int>(_rData.getBlockSize());
+	// Pass the data format and palette to the colorizer which rebuilds its lookup table only when they changed.
+	if (!_colorizer.setFormat(_rData))
+	{
+		SF_RTTI_NOTIFY(DO_CLOG, "Data type of result '" << _rData.getName() << "' cannot be drawn!");
+		return false;
+	}
+	if (_flagColorize)
+	{
+		_flagColorize = false;
+		if (_paletteServer.isAvailable())
+		{
+			auto table = _paletteServer.getColorTable();
+			_colorizer.setPalette({table.begin(), table.end()});
+		}
+		else
+		{
+			_colorizer.setPalette(ResultDataColorizer::grayscale());
+		}
+		// All rows need to be colorized again.
+		_rangeImage.clear();
+	}
 	// Create new image.
-	QImage img(static_cast<const uchar*>(_imageData.data()), static_cast<int>(_rData.getBlockSize()), static_cast<int>(rng.getSize()),
-		static_cast<qsizetype>(_rData.getBlockSize()), QImage::Format_Grayscale8);
+	QImage img(width, static_cast<int>(rng.getSize()), QImage::Format_ARGB32);
+	// Rows of the previous image still visible are copied so only new or re-zoomed rows are colorized.
+	Range kept;
+	if (_image.width() == width && !_rangeImage.isEmpty())
+	{
+		kept = rng & _rangeImage;
+	}
+	if (kept.isEmpty())
+	{
+		if (!colorizeRows(rng, img, 0))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		for (auto i = kept.getStart(); i < kept.getStop(); i++)
+		{
+			std::memcpy(img.scanLine(static_cast<int>(i - rng.getStart())), _image.constScanLine(static_cast<int>(i - _rangeImage.getStart())),
+				width * sizeof(ResultDataColorizer::color_type));
+		}
+		if (!colorizeRows({rng.getStart(), kept.getStart()}, img, 0) ||
+			!colorizeRows({kept.getStop(), rng.getStop()}, img, static_cast<int>(kept.getStop() - rng.getStart())))
+		{
+			return false;
+		}
+	}
 	// Swap the old with the new image.
 	_image.swap(img);
-	// Fill the dib data buffer at the specified position.
+	_rangeImage = rng;
+	return true;
+}
+
+bool BscanGraph::Private::colorizeRows(const Range& rng, QImage& img, int row)
+{
+	if (rng.isEmpty())
+	{
+		return true;
+	}
+	// Adjust the data buffer size to hold the raw data.
+	_imageData.grow(_rData.getBufferSize(rng.getSize()));
+	// Fill the data buffer with the range.
 	if (!_rData.blockRead(rng, _imageData.data()))
 	{
 		// Notify an error which actually cannot occur.
 		SF_RTTI_NOTIFY(DO_CLOG, "Retrieving data range " << rng << " !");
+		_rangeImage.clear();
 		return false;
 	}
+	_colorizer.colorize(_imageData.data(), _rData.getBlockSize(), rng.getSize(),
+		reinterpret_cast<ResultDataColorizer::color_type*>(img.scanLine(row)), img.bytesPerLine());
 	return true;
 }
 
@@ -724,6 +782,8 @@ void BscanGraph::Private::reinitialize(bool clear)
 		//FDib.clear();
 		// Force GenerateData to rebuild array content by clearing PlotRange.
 		_rangeCurrent.clear();
+		// The data format could have changed as well.
+		_flagColorize = true;
 		// Also clear the new range.
 		_rangeNext.clear();
 		// Make the draw function call for new data.
@@ -4,6 +4,7 @@
 #include <gii/gen/ResultData.h>
 #include <gii/gen/Variable.h>
 #include <gii/gen/ResultDataRequester.h>
+#include <gii/gen/ResultDataColorizer.h>
 #include <misc/qt/Graph.h>
 
 namespace sf
@@ -85,6 +86,9 @@ struct BscanGraph::Private
 	// Called using the valid access data range.
 	bool generateData(const Range& rng);
 
+	// Reads and colorizes the data range into the image rows starting at the passed row.
+	bool colorizeRows(const Range& rng, QImage& img, int row);
+
 	// Maximum allowed scan lines.
 	static constexpr int MaxScanSize{3000};
 
@@ -111,8 +115,14 @@ struct BscanGraph::Private
 	bool _flagGenerate{false};
 	// Reference to the timer of the sustain entry.
 	ElapseTimer _generateTimer{TimeSpec(0.1)};
-	// Holds the data for the bitmap.
+	// Holds the raw data read for colorizing.
 	DynamicBuffer _imageData;
+	// Maps the raw data through the palette into the image.
+	ResultDataColorizer _colorizer;
+	// Range of data blocks colorized in the image rows.
+	Range _rangeImage;
+	// True when the palette or data format must be passed to the colorizer.
+	bool _flagColorize{true};
 	// Structure holding all scan related members.
 	struct
 	{
@@ -38,7 +38,21 @@ struct LayoutTabs::Private :QObject, VariableWidgetBase::PrivateBase
 		QSize _fixedSizeHint;
 	};
 
+	/**
+	 * @brief Layout of a tab page which is loaded when the tab becomes current.
+	 */
+	struct Page
+	{
+		// Absolute path of the ui-file.
+		QString filePath;
+		// Offset for the ID's in GII widgets.
+		Gii::IdType idOffset{0};
+		// True when loaded or loading failed.
+		bool loaded{false};
+	};
+
 	QStringList _tabsConfig;
+	QList<Page> _pages;
 	LayoutTabs* _w{nullptr};
 	QVBoxLayout* _layout{nullptr};
 	TabWidget* _tabWidget{nullptr};
@@ -72,6 +86,7 @@ struct LayoutTabs::Private :QObject, VariableWidgetBase::PrivateBase
 		}
 		connect(_tabWidget, &QTabWidget::currentChanged, [&](int index)
 		{
+			loadPage(index);
 			_variable.setCur(Value(index), true);
 		});
 	}
@@ -84,6 +99,8 @@ struct LayoutTabs::Private :QObject, VariableWidgetBase::PrivateBase
 
 	void recreateTabs();
 
+	void loadPage(int index);
+
 	void variableEventHandler
 		(
 			EEvent event,
@@ -176,6 +193,7 @@ void LayoutTabs::Private::recreateTabs()
 	{
 		delete _tabWidget->widget(--i);
 	}
+	_pages.clear();
 	// Reset this member so the size is invalid.
 	_tabWidget->_fixedSizeHint = {};
 	// Add the tab passing an empty widget and empty tab name.
@@ -211,34 +229,16 @@ void LayoutTabs::Private::recreateTabs()
 				mb.exec();
 				return;
 			}
-			// TODO: Work-around using a dummy widget for https://bugreports.qt.io/browse/QTBUG-96693
-			// Create the parent container widget without a parent and initialized the directory and id-offset.
-			QScopedPointer cw(new QWidget);
-			cw->setObjectName("dummy_layout_container");
-			auto ldc = new LayoutData(cw.get());
-			ldc->setDirectory(QFileInfo(file).absoluteDir());
-			ldc->setIdOffset(fields.at(1).toULongLong(nullptr, 0));
-			// Create widget from the ui-file.
-			auto tab = FormBuilderLoad(&file, cw.get());
-			// When loading was not successful.
-			if (!tab)
-			{
-				QMessageBox mb(_w);
-				mb.setIcon(QMessageBox::Warning);
-				mb.setWindowTitle(tr("UI loading failed!"));
-				mb.setText(tr("Could not load UI file '%1'").arg(file.fileName()));
-				mb.exec();
-				return;
-			}
-			else
-			{
-				// Grow to the largest geometry of all layouts.
-				rcCombined |= tab->geometry();
-				// Assign a new parent for the layout-data instance.
-				ldc->setParent(tab);
-				// Add the tab passing the widget and name.
-				_tabWidget->addTab(tab, fields.at(0));
-			}
+			// Grow to the largest geometry of all layouts without loading them.
+			rcCombined |= FormBuilderGeometry(&file);
+			// Page holding the layout when loaded.
+			auto tab = new QWidget(_tabWidget);
+			tab->setObjectName(QString("%1Page").arg(fields.at(2)));
+			auto layout = new QVBoxLayout(tab);
+			layout->setContentsMargins(0, 0, 0, 0);
+			_pages.append({QFileInfo(file).absoluteFilePath(), fields.at(1).toULongLong(nullptr, 0)});
+			// Add the tab passing the widget and name.
+			_tabWidget->addTab(tab, fields.at(0));
 		}
 		else
 		{
@@ -254,6 +254,51 @@ void LayoutTabs::Private::recreateTabs()
 	{
 		_tabWidget->_fixedSizeHint = rcCombined.size() + szFirst;
 	}
+	// Only the current page is loaded now.
+	loadPage(_tabWidget->currentIndex());
+}
+
+void LayoutTabs::Private::loadPage(int index)
+{
+	if (index < 0 || index >= _pages.size() || _pages.at(index).loaded)
+	{
+		return;
+	}
+	auto& page = _pages[index];
+	page.loaded = true;
+	QFile file(page.filePath);
+	if (!file.open(QFile::ReadOnly | QFile::Text))
+	{
+		QMessageBox mb(_w);
+		mb.setIcon(QMessageBox::QMessageBox::Warning);
+		mb.setWindowTitle(tr("Open file failed!"));
+		mb.setText(tr("Could open file '%1'").arg(file.fileName()));
+		mb.exec();
+		return;
+	}
+	// TODO: Work-around using a dummy widget for https://bugreports.qt.io/browse/QTBUG-96693
+	// Create the parent container widget without a parent and initialized the directory and id-offset.
+	QScopedPointer cw(new QWidget);
+	cw->setObjectName("dummy_layout_container");
+	auto ldc = new LayoutData(cw.get());
+	ldc->setDirectory(QFileInfo(file).absoluteDir());
+	ldc->setIdOffset(page.idOffset);
+	// Create widget from the ui-file.
+	auto tab = FormBuilderLoad(&file, cw.get());
+	// When loading was not successful.
+	if (!tab)
+	{
+		QMessageBox mb(_w);
+		mb.setIcon(QMessageBox::Warning);
+		mb.setWindowTitle(tr("UI loading failed!"));
+		mb.setText(tr("Could not load UI file '%1'").arg(file.fileName()));
+		mb.exec();
+		return;
+	}
+	// Assign a new parent for the layout-data instance.
+	ldc->setParent(tab);
+	// Put the layout in the page.
+	_tabWidget->widget(index)->layout()->addWidget(tab);
 }
 
 SF_IMPL_PROP_GSP(QTabWidget::TabPosition, LayoutTabs, TabPosition, LayoutTabs::Private::cast(_p)->_tabWidget, tabPosition)